@@ -1,21 +1,29 @@
 """
-Reading raw data from /dev/ttyACM0 port for graphing purposes.
+Live graph of wheel speed against setpoint from the robot's telemetry stream.
+Decoding lives in telemetry.py, this only plots the motor records.
 - Franco H
 """
 
+import sys
 import time
-import serial
 import matplotlib.pyplot as plt
 
-ser = serial.Serial(port='/dev/ttyACM0', baudrate=115200, timeout=1)
+from telemetry import Decoder, open_port
+
+PORT = sys.argv[1] if len(sys.argv) > 1 else '/dev/ttyACM0'
+WINDOW = 2000           # Motor records shown, 2 s at the 1 kHz control rate
+REDRAW_S = 0.05
+
+ser = open_port(PORT)
 time.sleep(2)  # wait for ESP32 to reboot
-ser.reset_input_buffer()
+if hasattr(ser, 'reset_input_buffer'):
+    ser.reset_input_buffer()
 
 plt.ion()
 fig, ax = plt.subplots()
-ax.set_title("TT DC Motor PI Controller")
-ax.set_xlabel("Samples")
-ax.set_ylabel("Velocity (Ticks/s)")
+ax.set_title("TT DC Motor PID Controller")
+ax.set_xlabel("Time (s)")
+ax.set_ylabel("Velocity (Ticks/100 ms)")
 
 desiredVelocity, actualVelocity, xData = [], [], []
 line1, = ax.plot([], [], label="Desired Velocity")
@@ -23,41 +31,37 @@ line2, = ax.plot([], [], label="Actual Velocity")
 ax.legend()
 ax.set_ylim(bottom=0, top=30)
 
-inc = 0
+decoder = Decoder()
+lastDraw = 0.0
 
 try:
     while True:
-        try:
-            line = ser.readline().decode().strip()
-            if not line:
-                continue
+        chunk = ser.read(4096)
+        if not chunk:
+            continue
 
-            floatData = [float(x) for x in line.split(',')]
-            if len(floatData) < 2:
+        for record in decoder.feed(chunk):
+            if record['record'] != 'motor':
                 continue
+            xData.append(record['time_us'] / 1e6)
+            desiredVelocity.append(record['setpoint_a'])
+            actualVelocity.append(record['speed_a'])
+
+        del xData[:-WINDOW], desiredVelocity[:-WINDOW], actualVelocity[:-WINDOW]
 
-            inc += 1
-            if inc == 500:
-                inc = 0
-                xData.clear()
-                desiredVelocity.clear()
-                actualVelocity.clear()
-
-            xData.append(inc)
-            desiredVelocity.append(floatData[0])
-            actualVelocity.append(floatData[1])
-
-            line1.set_data(xData, desiredVelocity)
-            line2.set_data(xData, actualVelocity)
-
-            ax.relim()
-            ax.autoscale_view(tight=True, scalex=True, scaley=True)
-            fig.canvas.draw()
-            fig.canvas.flush_events()
-            
-        except ValueError:
+        # Records arrive far faster than matplotlib can draw
+        if time.time() - lastDraw < REDRAW_S:
             continue
+        lastDraw = time.time()
+        line1.set_data(xData, desiredVelocity)
+        line2.set_data(xData, actualVelocity)
+
+        ax.relim()
+        ax.autoscale_view(tight=True, scalex=True, scaley=True)
+        fig.canvas.draw()
+        fig.canvas.flush_events()
 
 except KeyboardInterrupt:
     print("Closing serial connection...")
+    print("%d records, %d missing, %d CRC errors" % (decoder.records, decoder.gaps, decoder.crc_errors))
     ser.close()
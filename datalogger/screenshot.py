@@ -0,0 +1,245 @@
+"""
+Receiver for the HUD screenshots in the robot's telemetry stream (include/Screenshot.h).
+The firmware captures the bands the display task draws, compresses them and sends them
+as 'screen' records; this puts them back together into a picture of the panel.
+
+    python3 screenshot.py /dev/ttyACM0                  show the HUD live
+    python3 screenshot.py /dev/ttyACM0 --save shots     write every screenshot to shots/NNNNN.ppm
+    python3 screenshot.py --selftest .pio/build/native/program
+        runs the simulator into a pty and checks every screenshot decodes
+"""
+
+import argparse
+import os
+import re
+import struct
+import subprocess
+import sys
+import threading
+import tty
+
+from telemetry import Decoder, open_port, read_chunks
+
+SCREEN_HEADER = struct.Struct('<HHHB')
+KEY = 0x01
+
+BAND_SAME = 0x00
+BAND_OPS = 0x01
+
+
+def decode_band(data, p, image, start, width, pixels):
+    """Ops from data[p:] into image from pixel start, returns where they ended."""
+    i = 0
+    while i < pixels:
+        op = data[p]
+        p += 1
+        count = op + 1 if op < 0x80 else (op & 0x3F) + 1
+        if i + count > pixels:
+            raise ValueError('op past the end of the band')
+        at = 2 * (start + i)
+        if op < 0x80:
+            image[at:at + 2 * count] = data[p:p + 2 * count]
+            p += 2 * count
+        elif op < 0xC0:
+            image[at:at + 2 * count] = data[p:p + 2] * count
+            p += 2
+        else:
+            if i < width:
+                raise ValueError('row above outside the band')
+            for k in range(0, 2 * count, 2 * width):     # In steps that are already written
+                n = min(2 * width, 2 * count - k)
+                image[at + k:at + k + n] = image[at + k - 2 * width:at + k - 2 * width + n]
+        i += count
+    return p
+
+
+class Assembler:
+    """Feed decoded telemetry records, get whole screenshots back as (width, height, pixels),
+    pixels being RGB565 high byte first."""
+
+    def __init__(self):
+        self.capture = None
+        self.data = bytearray()
+        self.length = 0
+        self.broken = False         # Chunk missing from the capture being received
+        self.image = None           # Last screenshot, delta screenshots build on it
+        self.size = None
+        self.screenshots = 0
+        self.incomplete = 0         # Captures with chunks missing
+        self.waiting = 0            # Deltas with nothing to build on, until the next key
+        self.errors = 0             # Did not decode
+
+    def feed(self, record):
+        if record['record'] != 'screen':
+            return None
+        if record['capture'] != self.capture:
+            if self.capture is not None and not self.broken and len(self.data) < self.length:
+                self.lost()
+            self.capture, self.data, self.length, self.broken = record['capture'], bytearray(), record['length'], False
+        if self.broken:
+            return None
+        if record['offset'] != len(self.data) or record['length'] != self.length:
+            self.lost()
+            self.broken = True
+            return None
+        self.data += record['data']
+        if len(self.data) != self.length:
+            return None
+        return self.decode(bytes(self.data))
+
+    def lost(self):
+        """Part of a capture went missing, the deltas after it cannot be trusted."""
+        self.incomplete += 1
+        self.image = None
+
+    def decode(self, data):
+        width, height, rows, flags = SCREEN_HEADER.unpack_from(data)
+        if not flags & KEY and (self.image is None or self.size != (width, height)):
+            self.waiting += 1
+            return None
+        image = bytearray(2 * width * height) if flags & KEY else bytearray(self.image)
+        try:
+            p = SCREEN_HEADER.size
+            for y in range(0, height, rows):
+                band = data[p]
+                p += 1
+                if band == BAND_OPS:
+                    p = decode_band(data, p, image, y * width, width, width * min(rows, height - y))
+                elif band != BAND_SAME or flags & KEY:
+                    raise ValueError('bad band tag')
+            if p != len(data):
+                raise ValueError('bytes left over')
+        except (ValueError, IndexError):
+            self.errors += 1
+            self.image = None
+            return None
+        self.image, self.size = image, (width, height)
+        self.screenshots += 1
+        return width, height, bytes(image)
+
+
+def to_rgb888(pixels):
+    out = bytearray(len(pixels) // 2 * 3)
+    for i in range(0, len(pixels) // 2):
+        v = pixels[2 * i] << 8 | pixels[2 * i + 1]
+        out[3 * i:3 * i + 3] = ((v >> 11) * 255 // 31, (v >> 5 & 0x3F) * 255 // 63, (v & 0x1F) * 255 // 31)
+    return out
+
+
+def save_ppm(path, width, height, pixels):
+    with open(path, 'wb') as f:
+        f.write(b'P6\n%d %d\n255\n' % (width, height))
+        f.write(to_rgb888(pixels))
+
+
+def receive(port, save_dir):
+    decoder = Decoder()
+    assembler = Assembler()
+    source = open_port(port)
+    shown = None
+    if save_dir:
+        os.makedirs(save_dir, exist_ok=True)
+    else:
+        import matplotlib.pyplot as plt
+        import numpy as np
+        plt.ion()
+        fig, ax = plt.subplots()
+        ax.set_axis_off()
+    try:
+        for chunk in read_chunks(source):
+            for record in decoder.feed(chunk):
+                screenshot = assembler.feed(record)
+                if screenshot is None:
+                    continue
+                width, height, pixels = screenshot
+                if save_dir:
+                    save_ppm(os.path.join(save_dir, '%05d.ppm' % assembler.screenshots), width, height, pixels)
+                    continue
+                rgb = np.frombuffer(to_rgb888(pixels), dtype=np.uint8).reshape(height, width, 3)
+                if shown is None:
+                    shown = ax.imshow(rgb)
+                else:
+                    shown.set_data(rgb)
+                plt.pause(0.001)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        source.close()
+        print('%d screenshots, %d incomplete, %d waiting for a key, %d did not decode'
+              % (assembler.screenshots, assembler.incomplete, assembler.waiting, assembler.errors), file=sys.stderr)
+
+
+def selftest(program, bouts):
+    """Runs the simulator with its telemetry on a pty and decodes every screenshot. The
+    simulator's strip only keeps the HUD background, so every screenshot is one colour."""
+    master, slave = os.openpty()
+    tty.setraw(slave)
+    slave_path = os.ttyname(slave)
+
+    decoder = Decoder()
+    assembler = Assembler()
+    colours = {}
+    mixed = [0]
+
+    def reader():
+        while True:
+            try:
+                chunk = os.read(master, 65536)
+            except OSError:         # EIO once the last writer closes the slave
+                return
+            if not chunk:
+                return
+            for record in decoder.feed(chunk):
+                screenshot = assembler.feed(record)
+                if screenshot is None:
+                    continue
+                pixels = screenshot[2]
+                if pixels != pixels[:2] * (len(pixels) // 2):
+                    mixed[0] += 1
+                colour = pixels[0] << 8 | pixels[1]
+                colours[colour] = colours.get(colour, 0) + 1
+
+    thread = threading.Thread(target=reader, daemon=True)
+    thread.start()
+    result = subprocess.run([program, '--bouts', str(bouts), '--telemetry', slave_path],
+                            stdout=subprocess.PIPE, universal_newlines=True)
+    os.close(slave)
+    thread.join(timeout=10)
+    os.close(master)
+
+    match = re.search(r'screenshots\s*:\s*(\d+) captures \((\d+) key\), (\d+) bytes, (\d+) skipped', result.stdout)
+    if result.returncode != 0 or not match:
+        print(result.stdout)
+        print('FAIL: simulator did not report screenshots')
+        return 1
+    captures, keys, _, skipped = (int(x) for x in match.groups())
+
+    print('%d captures (%d key, %d skipped), %d screenshots decoded in colours %s'
+          % (captures, keys, skipped, assembler.screenshots, ', '.join('%04X' % c for c in sorted(colours))))
+    print('%d incomplete, %d waiting for a key, %d did not decode, %d not one colour'
+          % (assembler.incomplete, assembler.waiting, assembler.errors, mixed[0]))
+    # The run can end with the last capture partly queued
+    ok = (captures > 0 and captures - 1 <= assembler.screenshots <= captures and assembler.incomplete == 0
+          and assembler.waiting == 0 and assembler.errors == 0 and mixed[0] == 0 and len(colours) > 1)
+    print('ok' if ok else 'FAIL')
+    return 0 if ok else 1
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('port', nargs='?', help='serial port, pty or capture file')
+    parser.add_argument('--save', metavar='DIR', help='write screenshots to DIR as PPM files instead of showing them')
+    parser.add_argument('--selftest', metavar='PROGRAM', help='native simulator build to test against')
+    parser.add_argument('--bouts', type=int, default=2)
+    args = parser.parse_args()
+
+    if args.selftest:
+        return selftest(args.selftest, args.bouts)
+    if not args.port:
+        parser.error('a port is required')
+    receive(args.port, args.save)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,240 @@
+"""
+Decoder for the robot's binary telemetry stream (include/Telemetry.h).
+Every record arrives as COBS(record + CRC-16/CCITT-FALSE) followed by 0x00.
+
+    python3 telemetry.py /dev/ttyACM0                  print records
+    python3 telemetry.py /dev/ttyACM0 --csv run.csv    log every record to CSV
+    python3 telemetry.py --selftest .pio/build/native/program
+        runs the simulator into a pty and checks every frame end to end
+"""
+
+import argparse
+import csv
+import os
+import re
+import struct
+import subprocess
+import sys
+import threading
+import tty
+
+VERSION = 1
+
+HEADER = struct.Struct('<BBHI')
+HEADER_FIELDS = ('type', 'version', 'seq', 'time_us')
+
+# type: (name, body layout, field names), as in Telemetry.h
+RECORDS = {
+    1: ('motor', struct.Struct('<iihhhhHHB'),
+        ('encoder_a', 'encoder_b', 'speed_a', 'speed_b', 'setpoint_a', 'setpoint_b', 'pwm_a', 'pwm_b', 'flags')),
+    2: ('sensors', struct.Struct('<hhHBB'),
+        ('left_cm', 'right_cm', 'line_adc', 'line_mask', 'state')),
+    3: ('screen', struct.Struct('<HHH'),
+        ('capture', 'offset', 'length')),
+}
+
+# Records followed by up to this many bytes of their own, returned as 'data'
+TRAILING = {'screen': 18}
+
+# Fields sent in 1/100 units
+CENTI_FIELDS = ('speed_a', 'speed_b', 'setpoint_a', 'setpoint_b')
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+        crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(frame):
+    out = bytearray()
+    i = 0
+    while i < len(frame):
+        code = frame[i]
+        if code == 0 or i + code > len(frame) + 1:
+            raise ValueError('bad COBS code')
+        out += frame[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(frame):
+            out.append(0)
+    return bytes(out)
+
+
+class Decoder:
+    """Feed raw bytes, get decoded records back as dicts."""
+
+    def __init__(self):
+        self.buffer = bytearray()
+        self.records = 0
+        self.crc_errors = 0
+        self.framing_errors = 0
+        self.gaps = 0               # Records missing according to the sequence numbers
+        self.last_seq = {}
+
+    def feed(self, data):
+        self.buffer += data
+        records = []
+        while True:
+            end = self.buffer.find(0)
+            if end < 0:
+                break
+            frame = bytes(self.buffer[:end])
+            del self.buffer[:end + 1]
+            if frame:
+                record = self.decode_frame(frame)
+                if record is not None:
+                    records.append(record)
+        return records
+
+    def decode_frame(self, frame):
+        try:
+            payload = cobs_decode(frame)
+        except ValueError:
+            self.framing_errors += 1
+            return None
+        if len(payload) < HEADER.size + 2:
+            self.framing_errors += 1
+            return None
+        body, crc = payload[:-2], struct.unpack('<H', payload[-2:])[0]
+        if crc16(body) != crc:
+            self.crc_errors += 1
+            return None
+
+        header = dict(zip(HEADER_FIELDS, HEADER.unpack_from(body)))
+        layout = RECORDS.get(header['type'])
+        size = HEADER.size + layout[1].size if layout else 0
+        trailing = TRAILING.get(layout[0], 0) if layout else 0
+        if layout is None or header['version'] != VERSION or not size <= len(body) <= size + trailing:
+            self.framing_errors += 1
+            return None
+        name, fmt, fields = layout
+        record = dict(header, record=name)
+        record.update(zip(fields, fmt.unpack_from(body, HEADER.size)))
+        if trailing:
+            record['data'] = body[size:]
+        for field in CENTI_FIELDS:
+            if field in record:
+                record[field] /= 100.0
+
+        last = self.last_seq.get(name)
+        if last is not None:
+            self.gaps += (header['seq'] - last - 1) & 0xFFFF
+        self.last_seq[name] = header['seq']
+        self.records += 1
+        return record
+
+
+def open_port(port):
+    """A serial device through pyserial, anything else (a pty, a capture file) as a plain file."""
+    if os.path.exists(port) and not port.startswith('/dev/pts/') and not os.path.isfile(port):
+        import serial
+        return serial.Serial(port=port, baudrate=2000000, timeout=0.1)
+    return open(port, 'rb', buffering=0)
+
+
+def read_chunks(source, size=4096):
+    while True:
+        chunk = source.read(size)
+        if chunk is None:
+            continue
+        if not chunk and not hasattr(source, 'in_waiting'):
+            return
+        yield chunk
+
+
+def log(port, csv_path):
+    decoder = Decoder()
+    writers = {}
+    files = []
+    source = open_port(port)
+    try:
+        for chunk in read_chunks(source):
+            for record in decoder.feed(chunk):
+                if record['record'] == 'screen':
+                    continue                # screenshot.py puts these together
+                if csv_path is None:
+                    print(record)
+                    continue
+                name = record['record']
+                if name not in writers:
+                    base, ext = os.path.splitext(csv_path)
+                    f = open('%s_%s%s' % (base, name, ext or '.csv'), 'w', newline='')
+                    files.append(f)
+                    writers[name] = csv.DictWriter(f, fieldnames=list(record))
+                    writers[name].writeheader()
+                writers[name].writerow(record)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        source.close()
+        for f in files:
+            f.close()
+        print('%d records, %d missing, %d CRC errors, %d framing errors'
+              % (decoder.records, decoder.gaps, decoder.crc_errors, decoder.framing_errors), file=sys.stderr)
+
+
+def selftest(program, bouts):
+    """Runs the simulator with its telemetry on a pty and checks the stream end to end."""
+    master, slave = os.openpty()
+    tty.setraw(slave)
+    slave_path = os.ttyname(slave)
+
+    decoder = Decoder()
+    counts = {}
+
+    def reader():
+        while True:
+            try:
+                chunk = os.read(master, 65536)
+            except OSError:         # EIO once the last writer closes the slave
+                return
+            if not chunk:
+                return
+            for record in decoder.feed(chunk):
+                counts[record['record']] = counts.get(record['record'], 0) + 1
+
+    thread = threading.Thread(target=reader, daemon=True)
+    thread.start()
+    result = subprocess.run([program, '--bouts', str(bouts), '--telemetry', slave_path],
+                            stdout=subprocess.PIPE, universal_newlines=True)
+    os.close(slave)
+    thread.join(timeout=10)
+    os.close(master)
+
+    match = re.search(r'telemetry\s*:\s*(\d+) records, (\d+) bytes, (\d+) dropped', result.stdout)
+    if result.returncode != 0 or not match:
+        print(result.stdout)
+        print('FAIL: simulator did not report telemetry')
+        return 1
+    sent, _, dropped = (int(x) for x in match.groups())
+
+    print('sent %d records (%d dropped by the firmware), decoded %s' % (sent, dropped, counts))
+    print('%d missing, %d CRC errors, %d framing errors' % (decoder.gaps, decoder.crc_errors, decoder.framing_errors))
+    ok = (decoder.records == sent and decoder.crc_errors == 0 and decoder.framing_errors == 0
+          and decoder.gaps == dropped and counts.get('motor', 0) > 0 and counts.get('sensors', 0) > 0)
+    print('ok' if ok else 'FAIL')
+    return 0 if ok else 1
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('port', nargs='?', help='serial port, pty or capture file')
+    parser.add_argument('--csv', help='write records to <name>_motor.csv, <name>_sensors.csv')
+    parser.add_argument('--selftest', metavar='PROGRAM', help='native simulator build to test against')
+    parser.add_argument('--bouts', type=int, default=2)
+    args = parser.parse_args()
+
+    if args.selftest:
+        return selftest(args.selftest, args.bouts)
+    if not args.port:
+        parser.error('a port is required')
+    log(args.port, args.csv)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,53 @@
+#ifndef DISPLAY_H
+#define DISPLAY_H
+#include "Hal.h"
+#include <TFT_eSPI.h>
+
+// HUD display service.
+// loop() posts a snapshot of what the HUD shows, which only copies it into a
+// mailbox. A low priority task on the control task's core takes the latest
+// snapshot and renders the whole HUD a band of rows at a time through a strip
+// of a few rows, sending the panel only the bands that differ from the frame
+// shown last, so the strategy loop never waits on the panel. The same bands
+// are captured for screenshots (include/Screenshot.h), the panel is never read.
+
+// ===================== CONFIGURATION =====================
+#define DISPLAY_REFRESH_MS      100
+#define DISPLAY_CORE            0       // loop() runs on core 1
+#define DISPLAY_PRIORITY        1       // Far below the control and line sampling tasks
+#define DISPLAY_STRIP_ROWS      16      // Rows drawn, compared and sent together
+
+// Everything the HUD shows that loop() knows, copied whole on every post
+typedef struct {
+    int16_t leftCm;
+    int16_t rightCm;
+    int16_t avgCm;
+    uint16_t lineAdc;
+    uint8_t lineMask;
+    uint8_t state;
+    const char *stateName;      // Static string, only the pointer is copied
+    uint16_t statusColor;       // HUD background for the state
+    uint16_t loopHz;
+} HudSnapshot_t;
+
+typedef struct {
+    uint32_t posted;
+    uint32_t frames;            // Rendered and flushed
+    uint32_t pixelsSent;
+    uint32_t maxFrameUs;        // Longest render and flush
+    bool buffered;              // False before the task's first run, or without memory for the strip
+} DisplayStats_t;
+
+// ===================== FUNCTION PROTOTYPES =====================
+// Hands tft over to the display task, nothing else may draw on it afterwards.
+// The task sets up DMA and the strip on its own core when it first runs.
+// Without memory for the strip the task draws straight on the panel instead,
+// and no screenshots are taken.
+void startDisplay(TFT_eSPI *tft);
+
+// Lock-free and never blocks, the task only ever renders the latest snapshot
+void displayPost(const HudSnapshot_t *snapshot);
+
+void getDisplayStats(DisplayStats_t *stats);
+
+#endif // DISPLAY_H
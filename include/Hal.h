@@ -0,0 +1,96 @@
+#ifndef HAL_H
+#define HAL_H
+
+// Thin hardware abstraction layer.
+// Robot code calls these instead of the Arduino core directly so the same
+// sources build for the ESP32-S3 (src/Hal_Esp32.cpp) and for the host
+// simulator (sim/Hal_Native.cpp, [env:native]).
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <algorithm>
+
+#define LOW             0
+#define HIGH            1
+
+#define INPUT           0x01
+#define OUTPUT          0x03
+#define INPUT_PULLUP    0x05
+
+#define RISING          0x01
+#define FALLING         0x02
+#define CHANGE          0x03
+
+#define IRAM_ATTR
+
+using std::max;
+using std::min;
+
+template <typename T>
+static inline T constrain(T x, T lo, T hi) { return (x < lo) ? lo : (x > hi) ? hi : x; }
+#endif
+
+// ===================== GPIO =====================
+void halPinMode(uint8_t pin, uint8_t mode);
+void halDigitalWrite(uint8_t pin, uint8_t level);
+int halDigitalRead(uint8_t pin);
+void halAttachInterrupt(uint8_t pin, void (*isr)(void), int mode);
+
+// ===================== LEDC PWM =====================
+void halPwmSetup(uint8_t channel, uint32_t freqHz, uint8_t resolutionBits);
+void halPwmAttachPin(uint8_t pin, uint8_t channel);
+void halPwmWrite(uint8_t channel, uint32_t duty);
+
+// ===================== ADC =====================
+int halAnalogRead(uint8_t pin);
+
+// Samples one pin continuously by DMA and hands each frame of frameSamples readings
+// to onFrame from a task pinned to a core. Returns false if the pin cannot be
+// sampled this way, halAnalogRead() must not be used on it once this succeeds.
+bool halAdcStartContinuous(uint8_t pin, uint32_t sampleRateHz, uint16_t frameSamples,
+                           void (*onFrame)(const uint16_t *samples, size_t count), uint8_t core, uint8_t priority);
+
+// ===================== PULSE TIMING =====================
+// Blocks until a full pulse at 'level' has been measured, returns its width in us or 0 on timeout
+unsigned long halPulseIn(uint8_t pin, uint8_t level, unsigned long timeoutUs);
+
+// ===================== CLOCK =====================
+unsigned long halMillis(void);
+unsigned long halMicros(void);
+void halDelay(unsigned long ms);
+void halDelayMicroseconds(unsigned int us);
+
+// ===================== CRITICAL SECTIONS =====================
+// Short sections shared between tasks on both cores and ISRs, must not block
+void halCriticalEnter(void);
+void halCriticalExit(void);
+
+// ===================== TASKS =====================
+// Runs fn at a fixed rate, paced by a hardware timer, in its own task pinned to a core.
+// Only one periodic task is supported, later calls are ignored.
+void halStartPeriodicTask(const char *name, void (*fn)(void), uint32_t rateHz, uint8_t core, uint8_t priority);
+
+// Runs fn every intervalMs in a low priority task pinned to a core, for work that may
+// wait on I/O and must never delay the control task. Up to HAL_MAX_BACKGROUND_TASKS,
+// starting a function that already runs is ignored.
+#define HAL_MAX_BACKGROUND_TASKS    2
+void halStartBackgroundTask(const char *name, void (*fn)(void), uint32_t intervalMs, uint8_t core, uint8_t priority);
+
+// ===================== SERIAL =====================
+// USB CDC on the T-Display S3, baud only matters for a UART
+void halSerialBegin(uint32_t baud);
+// Never blocks: writes what the transmit buffer accepts and returns that many bytes
+size_t halSerialWrite(const uint8_t *data, size_t length);
+
+// ===================== NVS (Preferences) =====================
+void halNvsBegin(const char *name);
+bool halNvsIsKey(const char *key);
+int32_t halNvsGetInt(const char *key, int32_t defaultValue = 0);
+void halNvsPutInt(const char *key, int32_t value);
+
+#endif // HAL_H
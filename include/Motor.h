@@ -1,6 +1,7 @@
 #ifndef MOTOR_H
 #define MOTOR_H
-#include <Arduino.h>
+#include "Hal.h"
+#include "Pid.h"
 
 // ===================== CONFIGURATION =====================
 // Motor driver pin mappings
@@ -17,6 +18,16 @@
 // Encoder pins
 #define ENCA 16
 #define ENCB 21
+// Optional second (quadrature) phase per wheel, -1 when not wired.
+// Without it the count direction follows the commanded direction of that wheel.
+#define ENCA_PHASE -1
+#define ENCB_PHASE -1
+
+// Encoder backend: the hardware pulse counter on the ESP32-S3, GPIO interrupts otherwise.
+// Build with -DENCODER_USE_ISR to force the interrupt fallback.
+#if defined(ARDUINO) && defined(CONFIG_IDF_TARGET_ESP32S3) && !defined(ENCODER_USE_ISR)
+#define ENCODER_USE_PCNT
+#endif
 
 // LEDC PWM Configuration
 #define PWM_CHANNEL_A 0
@@ -24,11 +35,23 @@
 #define PWM_FREQ 1000
 #define PWM_RESOLUTION 8  // 8-bit (0-255)
 
-// PI Controller tuning
-constexpr float kp = 7.0f;
-constexpr float ki = 2.0f;
+// Wheel speed PID tuning: speed in ticks per 100 ms, output in PWM duty
+constexpr float kp = 3.0f;
+constexpr float ki = 10.0f;             // Per second
+constexpr float kd = 0.0f;              // Seconds, velocity is too coarse at this encoder resolution
+constexpr float kff = 255.0f / 42.0f;   // Full duty free-runs at ~42 ticks per 100 ms
+constexpr float kt = 50.0f;             // Anti-windup tracking, per second
+constexpr float derivativeTauS = 0.05f;
 constexpr float maxTickSpeed = 25.0f;  // Changed: ticks per 10ms (desired speed)
-constexpr unsigned long PI_UPDATE_INTERVAL_MS = 500;  
+constexpr unsigned long PI_UPDATE_INTERVAL_MS = 20;   // PID sample period, decimated from the control task rate
+
+// Motor control task: paced by a hardware timer on the core the Arduino loop() does not use
+constexpr uint32_t MOTOR_CONTROL_RATE_HZ = 1000;
+#define MOTOR_CONTROL_CORE      0
+#define MOTOR_CONTROL_PRIORITY  20      // Above loop() (1), below the esp_timer task (22)
+
+// Edge reflex: drive away from the line at full duty for this long, then resume the posted setpoint
+constexpr unsigned long MOTOR_REFLEX_PULSE_MS = 40;
 
 enum Direction {
     FORWARD,
@@ -52,23 +75,46 @@ typedef struct {
     Direction direction;
 } Motor_t;
 
+// Control task period statistics, all in microseconds
+typedef struct {
+    uint32_t periods;
+    uint32_t minPeriodUs;
+    uint32_t maxPeriodUs;
+    uint32_t p99PeriodUs;
+    uint32_t overruns;      // Periods longer than 1.5x nominal
+} MotorTaskStats_t;
+
 // ===================== GLOBAL VARIABLES =====================
-extern volatile long encoderCountA;
-extern volatile long encoderCountB;
 extern int rMotNewA;
 extern int rMotNewB;
 
 // ===================== FUNCTION PROTOTYPES =====================
 void initMotors(void);
+// Starts the fixed-rate control task, move()/stopMotors() then only post setpoints to it
+void startMotorControlTask(uint32_t rateHz = MOTOR_CONTROL_RATE_HZ);
+void getMotorTaskStats(MotorTaskStats_t *stats);
+void resetMotorTaskStats(void);
 void initEncoderA(void);
 void initEncoderB(void);
 void move(Motor_t *motor);
 void stopMotors(void);
+// Cuts the drive immediately and has the control task pulse in 'direction' (or brake if
+// stop) for MOTOR_REFLEX_PULSE_MS, ahead of any posted setpoint. Callable from any task
+// but only one at a time; ignored while a pulse is already running.
+void motorReflex(Direction direction, bool stop);
+bool motorReflexActive(void);
+// Runs one sample of each wheel's PID and writes the PWM duty
 void updatePIController(Motor_t *motor, float velA, float velB);
-long getEncoderCountA(void);
-long getEncoderCountB(void);
+// Clears integrators and filters, e.g. before restarting from a stop
+void resetPIController(void);
+void getSpeedPidConfig(PidConfig_t *config);
+// Signed tick counts, positive when the wheel turns forward
+int64_t getEncoderCountA(void);
+int64_t getEncoderCountB(void);
 void resetEncoders(void);
+#if !defined(ENCODER_USE_PCNT)
 void IRAM_ATTR handleEncoderA(void);
 void IRAM_ATTR handleEncoderB(void);
+#endif
 
 #endif // MOTOR_H
@@ -0,0 +1,67 @@
+#ifndef PID_H
+#define PID_H
+#include "Hal.h"
+
+// Fixed-point PID controller.
+// All state and coefficients are Q16.16 (16 integer bits, 16 fraction bits), so
+// an update is a handful of integer multiplies and no float math. Gains are
+// given in float once, in configure(), and folded with the sample period there.
+//
+//   u = kff * setpoint + kp * e + I + D
+//   I += ki * Ts * e + kt * Ts * (clamp(u) - u)        back-calculation anti-windup
+//   D  = low-pass(-kd * d(measurement)/dt)             on measurement, no setpoint kick
+
+typedef int32_t q16_t;
+
+#define Q16_SHIFT   16
+#define Q16_ONE     ((q16_t)1 << Q16_SHIFT)
+
+static inline q16_t q16FromFloat(float x) { return (q16_t)(x * (float)Q16_ONE + (x >= 0.0f ? 0.5f : -0.5f)); }
+static inline float q16ToFloat(q16_t x) { return (float)x / (float)Q16_ONE; }
+static inline q16_t q16FromInt(int32_t x) { return (q16_t)((uint32_t)x << Q16_SHIFT); }
+// Rounds to nearest
+static inline int32_t q16ToInt(q16_t x) { return (x + (Q16_ONE >> 1)) >> Q16_SHIFT; }
+static inline q16_t q16Mul(q16_t a, q16_t b) {
+    return (q16_t)(((int64_t)a * b + (Q16_ONE >> 1)) >> Q16_SHIFT);
+}
+
+typedef struct {
+    float kp;
+    float ki;                   // Per second
+    float kd;                   // Seconds
+    float kff;                  // Output per unit of setpoint
+    float kt;                   // Anti-windup tracking gain per second, 0 disables back-calculation
+    float derivativeTauS;       // Derivative low-pass time constant, 0 for none
+    float samplePeriodS;
+    float outMin;
+    float outMax;
+} PidConfig_t;
+
+class PidController {
+public:
+    PidController();
+    explicit PidController(const PidConfig_t &config);
+
+    // Precomputes the fixed-point coefficients, also resets the state
+    void configure(const PidConfig_t &config);
+    void reset(void);
+
+    // One sample, expected every samplePeriodS. Returns the clamped output.
+    q16_t update(q16_t setpoint, q16_t measurement);
+    float update(float setpoint, float measurement);
+
+    q16_t output(void) const { return out; }
+    q16_t integral(void) const { return integ; }
+
+private:
+    q16_t kp, kiTs, kdOverTs, kff, ktTs, derivAlpha;
+    q16_t outMin, outMax;
+
+    q16_t integ;
+    q16_t deriv;
+    q16_t lastMeasurement;
+    q16_t out;
+    bool primed;
+};
+
+#endif // PID_H
@@ -0,0 +1,63 @@
+#ifndef SCREENSHOT_H
+#define SCREENSHOT_H
+#include "Hal.h"
+
+// Screenshots of the HUD over the telemetry stream.
+// The panel is never read back: the display task hands every band of a captured
+// frame to screenshotBand() from the strip it renders through, while the pixels
+// are still in RAM. Each band is compressed into a buffer and the display task
+// then queues the buffer as TLM_SCREEN records on its own telemetry channel, only
+// as fast as the ring has room, so nothing waits and nothing is dropped. The next
+// screenshot is taken once the last one is queued. datalogger/screenshot.py puts
+// the screenshots back together, keep the two in step.
+//
+// An encoded screenshot is a header, then every band in turn:
+//
+//   width u16, height u16, strip rows u16, flags u8 (SCREENSHOT_KEY)
+//   band: 0x00                         same as in the last screenshot
+//         0x01 op...                   ops until the band's pixels are covered
+//   op:   0x00 + n, pixels             n + 1 pixels follow, n < 128
+//         0x80 + n, pixel              one pixel repeated n + 1 times, n < 64
+//         0xC0 + n                     n + 1 pixels the same as the row above, n < 64
+//
+// Pixels are RGB565, high byte first, as sent to the panel. Fields are little
+// endian. The row above is only referred to inside a band.
+
+// ===================== CONFIGURATION =====================
+#define SCREENSHOT_INTERVAL_MS  250     // A few screenshots a second at most
+#define SCREENSHOT_BUFFER       8192    // Encoded screenshot, larger ones are skipped
+#define SCREENSHOT_MAX_BANDS    32      // 320 rows of 16 row bands take 20
+#define SCREENSHOT_KEY_EVERY    16      // Every band sent again, for a reader joining late
+
+#define SCREENSHOT_KEY          0x01    // Flags: no band refers to an earlier screenshot
+#define SCREENSHOT_HEADER       7
+
+typedef struct {
+    uint32_t captures;          // Encoded and queued
+    uint32_t keys;              // Of them with every band
+    uint32_t skipped;           // Larger than SCREENSHOT_BUFFER
+    uint32_t bytes;             // Encoded bytes queued
+    uint32_t pixels;            // Pixels covered by the captures
+} ScreenshotStats_t;
+
+// ===================== FUNCTION PROTOTYPES =====================
+// Screenshots are taken while started and the telemetry runs
+void startScreenshots(void);
+void stopScreenshots(void);
+
+// Display task only. screenshotBegin() returns true if the frame about to be drawn
+// is to be captured; if so its bands go to screenshotBand(), the strip's band
+// callback, then screenshotEnd() is called. screenshotFlush() queues what it can
+// of the last capture and is called every display period.
+bool screenshotBegin(int16_t width, int16_t height, uint16_t rows);
+void screenshotBand(const uint16_t *pixels, int32_t y, int32_t width, int32_t rows, uint32_t hash, void *data);
+void screenshotEnd(void);
+void screenshotFlush(void);
+
+void getScreenshotStats(ScreenshotStats_t *stats);
+
+// Band compression, exposed for the host bench. Encodes rows of width pixels as
+// ops into out, returns the bytes written or 0 if they did not fit in room.
+size_t screenshotEncodeBand(const uint16_t *pixels, int32_t width, int32_t rows, uint8_t *out, size_t room);
+
+#endif // SCREENSHOT_H
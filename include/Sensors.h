@@ -1,8 +1,7 @@
 #ifndef SENSORS_H
 #define SENSORS_H
-#include <Arduino.h>
+#include "Hal.h"
 #include <TFT_eSPI.h>
-#include <Preferences.h>
 
 // Pins may need to be changed
 #define LEFT_TRIGGER			18
@@ -18,13 +17,33 @@
 // Set the maximum time we will wait for the echo pulse: this determines what is "OUT OF RANGE" for the sensor!
 // From my testing, 15000 us timeout limits the distance range to ~200 cm
 #define ULTRASONIC_TIMEOUT_US	15000
+// The HC-SR04 raises its echo line roughly 450 us after the trigger, allow some margin
+#define ULTRASONIC_ECHO_DELAY_US	1000
 
-extern Preferences botSettings; 
+// Continuous (DMA) sampling of the line detector, see startLineSampling()
+#define LINE_SAMPLE_RATE_HZ     40000
+#define LINE_FRAME_SAMPLES      16      // One frame every 0.4 ms
+#define LINE_FILTER_TAPS        5       // A corner reads black once it does in 3 of the last 5 samples
+#define LINE_SAMPLING_CORE      0
+#define LINE_SAMPLING_PRIORITY  18      // Below the motor control task
 
 // Lookup table
 extern int ADCLookup[16];
 extern int ADCLookupDefaults[16];
 
+// Every 12-bit ADC reading decoded to its line mask, rebuilt from ADCLookup
+// whenever the thresholds change so detectLine() is a single indexed load
+#define ADC_CODES           4096
+extern uint8_t ADCCodeTable[ADC_CODES];
+
+// lineMask bits, same order as the binary codes in ADCStrings
+#define LINE_REAR_RIGHT     0x01
+#define LINE_REAR_LEFT      0x02
+#define LINE_FRONT_RIGHT    0x04
+#define LINE_FRONT_LEFT     0x08
+#define LINE_FRONT          (LINE_FRONT_LEFT | LINE_FRONT_RIGHT)
+#define LINE_REAR           (LINE_REAR_LEFT | LINE_REAR_RIGHT)
+
 // String keys
 extern const char *ADCStrings[16];
 
@@ -32,6 +51,9 @@ typedef struct {
 	// Ultrasonic sensor distances stored to the nearest cm, 999 is OUT_OF_RANGE
 	int leftCm;
 	int rightCm;
+	// halMicros() timestamp of the most recent reading of each sensor
+	unsigned long leftSampleUs;
+	unsigned long rightSampleUs;
 
 	// Line detector booleans: 0 = WHITE, 1 = BLACK 
 	// 1 (BLACK) indicates a corner has gone over the line
@@ -40,6 +62,11 @@ typedef struct {
     int frontRight;
     int rearLeft;
     int rearRight;
+    // The four booleans packed as LINE_* bits, 0 when no corner is over the line
+    uint8_t lineMask;
+    // With continuous sampling, halMicros() when a corner first crossed the line
+    // since the previous detectLine(); meaningful only while lineMask is non-zero
+    unsigned long lineCrossedUs;
 } Sensors_t;
 
 // Setup pins and preferences (saved to flash memory).
@@ -57,21 +84,49 @@ void resetADCLookup(TFT_eSPI *tft);
 // Initiates a 16-step recalibration of the ADC lookup table
 void recalibrateADC_GUI(TFT_eSPI *tft);
 
+// Rebuild ADCCodeTable from ADCLookup
+void buildADCCodeTable();
+
+static inline uint8_t lineMaskFromADC(int analogValue) { return ADCCodeTable[analogValue & (ADC_CODES - 1)]; }
+
 // Run in an infinite loop
 void sensorsDemo(TFT_eSPI *tft, Sensors_t *sensors);
 
+/**
+ * \brief	    Starts continuous DMA sampling of the line detector. Call after any
+ *              calibration, which still uses single analogRead()s.
+ * \return      false if the ADC cannot sample the pin continuously, detectLine() then
+ *              keeps taking one reading per call.
+ */
+bool startLineSampling();
+
+/**
+ * \brief	    Registers a reflex called from the sampling task the moment the filtered
+ *              line state goes from no corner to some corner over the line, long before
+ *              the strategy loop reads it. Must be short and must not block.
+ * \param       onCross Called with the LINE_* mask that fired, NULL to disable.
+ */
+void setLineReflex(void (*onCross)(uint8_t mask));
+
 /**
  * \brief	    Updates all line detector booleans using DAC.
+ *              With continuous sampling this never blocks: it reports the filtered
+ *              state plus any corner that crossed the line since the previous call.
  * \param       sensors Pointer to Sensors_t struct.
  */
 void detectLine(Sensors_t *sensors);
 
 /**
- * \brief	    Poll distance in cm, alternating between left and right sensors.
+ * \brief	    Non-blocking ultrasonic ranging, call as often as possible.
+ *              Publishes the finished ping (if any) then triggers the other sensor,
+ *              alternating between left and right. Echoes are timed by interrupts.
  * \param       sensors Pointer to Sensors_t struct.
+ * \return      true if leftCm or rightCm was updated by this call.
  */
-// pollDistance(sensors) to get the distance in cm
-// Alternates between updating leftCm and rightCm each call
-void pollDistance(Sensors_t *sensors);
+bool pollDistance(Sensors_t *sensors);
+
+// Echo pin interrupts, attached by initSensors()
+void IRAM_ATTR handleLeftEcho(void);
+void IRAM_ATTR handleRightEcho(void);
 
 #endif
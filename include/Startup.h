@@ -1,7 +1,7 @@
 #ifndef STARTUP_H
 #define STARTUP_H
 
-#include <Arduino.h>
+#include "Hal.h"
 #include <TFT_eSPI.h>
 #include "Sensors.h"
 #include "Motor.h"
@@ -0,0 +1,152 @@
+#ifndef STATE_MACHINE_H
+#define STATE_MACHINE_H
+#include "Hal.h"
+
+// Table-driven state machine engine.
+// States and transitions are constant tables of plain function pointers, the
+// engine owns no heap memory. Transitions are grouped by source state so the
+// candidates for the current state are found with one index lookup, and every
+// transition taken is recorded with its timestamp in a fixed-size trace ring.
+//
+// Neither state ticks nor guards nor actions may block: the engine is stepped
+// once per loop() and time spent in a state is measured by the engine instead.
+
+typedef struct {
+    uint32_t atMs;
+    uint8_t from;
+    uint8_t to;
+} StateTrace_t;
+
+typedef struct {
+    const char *name;
+    uint32_t entries;
+    uint32_t dwellMs;           // Total time spent in the state, including the current visit
+} StateDwell_t;
+
+template <typename Context>
+struct SmState {
+    const char *name;
+    void (*onEnter)(Context &ctx);                          // NULL for none
+    void (*onTick)(Context &ctx);                           // Every step before the guards, NULL for none
+};
+
+template <typename Context>
+struct SmTransition {
+    uint8_t from;
+    uint8_t to;
+    bool (*guard)(Context &ctx, uint32_t inStateMs);        // NULL to always take it
+    void (*action)(Context &ctx);                           // Before entering 'to', NULL for none
+};
+
+// Compile-time table checks, use in a static_assert next to the tables
+template <typename Context>
+constexpr bool smTransitionsSorted(const SmTransition<Context> *t, size_t n, size_t i = 1) {
+    return i >= n || (t[i - 1].from <= t[i].from && smTransitionsSorted(t, n, i + 1));
+}
+
+template <typename Context>
+constexpr bool smTransitionsInRange(const SmTransition<Context> *t, size_t n, size_t numStates, size_t i = 0) {
+    return i >= n || (t[i].from < numStates && t[i].to < numStates && smTransitionsInRange(t, n, numStates, i + 1));
+}
+
+template <typename Context, uint8_t NumStates, size_t NumTransitions, size_t TraceSize = 32>
+class StateMachine {
+    static_assert(NumStates > 0, "A state machine needs at least one state");
+    static_assert(TraceSize > 0 && (TraceSize & (TraceSize - 1)) == 0, "TraceSize must be a power of two");
+
+public:
+    StateMachine(const SmState<Context> (&states)[NumStates],
+                 const SmTransition<Context> (&transitions)[NumTransitions])
+        : states(states), transitions(transitions) {
+        // first[s] .. first[s + 1] spans the transitions leaving s
+        size_t t = 0;
+        for (uint8_t s = 0; s < NumStates; s++) {
+            first[s] = t;
+            while (t < NumTransitions && transitions[t].from == s) t++;
+        }
+        first[NumStates] = t;
+        clearStats(0);
+        current = 0;
+    }
+
+    void reset(Context &ctx, uint8_t initial, uint32_t nowMs) {
+        clearStats(nowMs);
+        current = initial;
+        entries[current]++;
+        if (states[current].onEnter) states[current].onEnter(ctx);
+    }
+
+    // Runs the current state's tick, then takes the first transition whose guard
+    // holds. Returns true if the state changed.
+    bool step(Context &ctx, uint32_t nowMs) {
+        if (states[current].onTick) states[current].onTick(ctx);
+
+        uint32_t inState = nowMs - enteredMs;
+        for (size_t t = first[current]; t < first[current + 1]; t++) {
+            const SmTransition<Context> &tr = transitions[t];
+            if (tr.guard && !tr.guard(ctx, inState)) continue;
+
+            if (tr.action) tr.action(ctx);
+            record(tr.from, tr.to, nowMs);
+            dwellMs[current] += inState;
+            current = tr.to;
+            enteredMs = nowMs;
+            entries[current]++;
+            if (states[current].onEnter) states[current].onEnter(ctx);
+            return true;
+        }
+        return false;
+    }
+
+    uint8_t state(void) const { return current; }
+    const char *stateName(uint8_t s) const { return (s < NumStates) ? states[s].name : "?"; }
+    uint32_t inStateMs(uint32_t nowMs) const { return nowMs - enteredMs; }
+
+    // Transitions since reset(), the ring keeps only the last TraceSize
+    uint32_t transitionCount(void) const { return traceCount; }
+
+    // Copies up to max of the most recent transitions, oldest first
+    size_t trace(StateTrace_t *out, size_t max) const {
+        size_t kept = (traceCount < TraceSize) ? traceCount : TraceSize;
+        size_t n = (kept < max) ? kept : max;
+        for (size_t i = 0; i < n; i++) out[i] = ring[(traceCount - n + i) & (TraceSize - 1)];
+        return n;
+    }
+
+    // One entry per state
+    void dwell(StateDwell_t *out, uint32_t nowMs) const {
+        for (uint8_t s = 0; s < NumStates; s++) {
+            out[s].name = states[s].name;
+            out[s].entries = entries[s];
+            out[s].dwellMs = dwellMs[s] + ((s == current) ? nowMs - enteredMs : 0);
+        }
+    }
+
+private:
+    void clearStats(uint32_t nowMs) {
+        for (uint8_t s = 0; s < NumStates; s++) entries[s] = dwellMs[s] = 0;
+        traceCount = 0;
+        enteredMs = nowMs;
+    }
+
+    void record(uint8_t from, uint8_t to, uint32_t nowMs) {
+        StateTrace_t &entry = ring[traceCount & (TraceSize - 1)];
+        entry.atMs = nowMs;
+        entry.from = from;
+        entry.to = to;
+        traceCount++;
+    }
+
+    const SmState<Context> (&states)[NumStates];
+    const SmTransition<Context> (&transitions)[NumTransitions];
+    size_t first[NumStates + 1];
+
+    uint8_t current;
+    uint32_t enteredMs;
+    uint32_t entries[NumStates];
+    uint32_t dwellMs[NumStates];
+    StateTrace_t ring[TraceSize];
+    uint32_t traceCount;
+};
+
+#endif // STATE_MACHINE_H
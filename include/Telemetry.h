@@ -0,0 +1,117 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+#include "Hal.h"
+
+// Binary telemetry stream.
+// Producers copy fixed-layout records into a single-producer ring each and never
+// wait; a low priority background task drains the rings and writes every record
+// as one frame:
+//
+//   COBS(record, CRC-16/CCITT-FALSE of the record, little endian) 0x00
+//
+// COBS leaves no zero byte inside a frame, so a reader resynchronises at the next
+// 0x00 after any loss. Records start with TelemetryHeader_t, all fields are little
+// endian. datalogger/telemetry.py decodes the stream, keep the two in step.
+
+// ===================== CONFIGURATION =====================
+#define TELEMETRY_VERSION           1
+#define TELEMETRY_BAUD              2000000
+#define TELEMETRY_RING_RECORDS      256     // Per producer, a power of two
+#define TELEMETRY_MAX_RECORD        32
+#define TELEMETRY_FLUSH_MS          5
+#define TELEMETRY_CORE              1
+#define TELEMETRY_PRIORITY          1       // Same as loop(), far below the control task
+
+// Each producing context owns one ring, a channel must only be pushed from one task
+enum TelemetryChannel : uint8_t {
+    TLM_CHANNEL_CONTROL,        // Motor control task
+    TLM_CHANNEL_LOOP,           // Arduino loop()
+    TLM_CHANNEL_DISPLAY,        // Display task, screenshots
+    TLM_CHANNELS
+};
+
+enum TelemetryType : uint8_t {
+    TLM_MOTOR = 1,
+    TLM_SENSORS = 2,
+    TLM_SCREEN = 3,
+};
+
+// ===================== RECORDS =====================
+typedef struct __attribute__((packed)) {
+    uint8_t type;               // TelemetryType
+    uint8_t version;
+    uint16_t seq;               // Per channel, a gap means records were dropped
+    uint32_t timeUs;
+} TelemetryHeader_t;
+
+// One per control task period
+typedef struct __attribute__((packed)) {
+    TelemetryHeader_t header;
+    int32_t encoderA;
+    int32_t encoderB;
+    int16_t speedA;             // Last measured, 1/100 tick per 100 ms
+    int16_t speedB;
+    int16_t setpointA;          // 1/100 tick per 100 ms
+    int16_t setpointB;
+    uint16_t pwmA;
+    uint16_t pwmB;
+    uint8_t flags;              // TLM_MOTOR_* bits
+} TelemetryMotor_t;
+
+#define TLM_MOTOR_STOPPED   0x01
+#define TLM_MOTOR_REFLEX    0x02
+
+// Whenever the strategy sees new sensor data or changes state
+typedef struct __attribute__((packed)) {
+    TelemetryHeader_t header;
+    int16_t leftCm;
+    int16_t rightCm;
+    uint16_t lineAdc;
+    uint8_t lineMask;
+    uint8_t state;
+} TelemetrySensors_t;
+
+// A piece of an encoded screenshot (include/Screenshot.h). Variable length, the
+// last chunk of a capture is shorter
+#define TLM_SCREEN_CHUNK    18
+
+typedef struct __attribute__((packed)) {
+    TelemetryHeader_t header;
+    uint16_t capture;           // Number of the screenshot
+    uint16_t offset;            // Of data in the encoded screenshot
+    uint16_t length;            // Of the whole encoded screenshot
+    uint8_t data[TLM_SCREEN_CHUNK];
+} TelemetryScreen_t;
+
+static_assert(sizeof(TelemetryMotor_t) <= TELEMETRY_MAX_RECORD, "Record too large for a ring slot");
+static_assert(sizeof(TelemetrySensors_t) <= TELEMETRY_MAX_RECORD, "Record too large for a ring slot");
+static_assert(sizeof(TelemetryScreen_t) <= TELEMETRY_MAX_RECORD, "Record too large for a ring slot");
+
+typedef struct {
+    uint32_t records;           // Written to the serial port
+    uint32_t dropped;           // Pushed while the ring was full
+    uint32_t bytes;             // Framed bytes written
+} TelemetryStats_t;
+
+// ===================== FUNCTION PROTOTYPES =====================
+// Opens the serial port and starts the writer task, pushes are ignored until then
+void startTelemetry(void);
+// Pushes are ignored again, records already queued are still written
+void stopTelemetry(void);
+bool telemetryRunning(void);
+
+// Fills in the header's version, seq and timeUs and queues a copy of the record.
+// Lock-free and never blocks; returns false if the ring was full (the record is dropped).
+bool telemetryPush(TelemetryChannel channel, uint8_t type, void *record, uint8_t size);
+// Records that can be pushed on channel now without one being dropped, for producers
+// that would rather wait than lose data. Only meaningful to the channel's producer.
+uint32_t telemetryRoom(TelemetryChannel channel);
+
+void getTelemetryStats(TelemetryStats_t *stats);
+
+// Frame encoding, exposed for the host tests
+uint16_t telemetryCrc16(const uint8_t *data, size_t length);
+// Encodes one record as a complete frame into out (at least length + 4 bytes), returns its size
+size_t telemetryEncodeFrame(const uint8_t *record, size_t length, uint8_t *out);
+
+#endif // TELEMETRY_H
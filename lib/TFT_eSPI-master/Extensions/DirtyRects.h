@@ -0,0 +1,111 @@
+/***************************************************************************************
+// A small bounded set of rectangles used by TFT_eSprite to remember which areas of
+// the sprite have been drawn into since the last pushDirty(). Rectangles that overlap
+// or nearly fill their union are merged, and when the set is full the new area is
+// merged into whichever rectangle grows the least. The set therefore always
+// covers every damaged pixel, it may also cover a few that did not change.
+//
+// Plain C++ with no Arduino dependencies so it can be tested on a host.
+***************************************************************************************/
+
+#ifndef _TFT_DIRTY_RECTS_H_
+#define _TFT_DIRTY_RECTS_H_
+
+#include <stdint.h>
+
+#ifndef SPRITE_DIRTY_RECTS
+  #define SPRITE_DIRTY_RECTS  8   // Rectangles held before areas are merged together
+#endif
+
+#ifndef SPRITE_DIRTY_SLACK
+  // Pixels that may be sent unchanged to save one address window, a window costs
+  // about 11 command and parameter bytes, a 16-bit pixel 2 bytes
+  #define SPRITE_DIRTY_SLACK  32
+#endif
+
+typedef struct {
+  int32_t x0, y0, x1, y1;  // Inclusive corners
+} dirty_rect_t;
+
+class TFT_DirtyRects {
+
+ public:
+
+  TFT_DirtyRects(void) : _count(0) {}
+
+           // Forget all rectangles
+  void     clear(void) { _count = 0; }
+
+           // Add the area x,y,w,h (already clipped to the sprite)
+  void     add(int32_t x, int32_t y, int32_t w, int32_t h)
+  {
+    if ((w < 1) || (h < 1)) return;
+
+    dirty_rect_t r = { x, y, x + w - 1, y + h - 1 };
+
+    // Absorb every rectangle that is worth merging, the union may then reach others
+    uint8_t i = 0;
+    while (i < _count) {
+      if (worthMerging(_rect[i], r)) {
+        r = join(_rect[i], r);
+        _rect[i] = _rect[--_count];
+        i = 0;
+      }
+      else i++;
+    }
+
+    if (_count < SPRITE_DIRTY_RECTS) {
+      _rect[_count++] = r;
+      return;
+    }
+
+    // Full, merge into the rectangle whose area grows the least
+    uint8_t  best = 0;
+    uint32_t bestGrowth = 0xFFFFFFFF;
+    for (i = 0; i < _count; i++) {
+      uint32_t growth = area(join(_rect[i], r)) - area(_rect[i]);
+      if (growth < bestGrowth) { bestGrowth = growth; best = i; }
+    }
+    r = join(_rect[best], r);
+    _rect[best] = _rect[--_count];
+    add(r.x0, r.y0, r.x1 - r.x0 + 1, r.y1 - r.y0 + 1);
+  }
+
+  uint8_t  count(void) const { return _count; }
+
+  const dirty_rect_t& operator[](uint8_t i) const { return _rect[i]; }
+
+           // Pixels covered, rectangles never overlap once merged
+  uint32_t pixels(void) const
+  {
+    uint32_t sum = 0;
+    for (uint8_t i = 0; i < _count; i++) sum += area(_rect[i]);
+    return sum;
+  }
+
+ private:
+
+  static uint32_t area(const dirty_rect_t& r) { return (uint32_t)(r.x1 - r.x0 + 1) * (uint32_t)(r.y1 - r.y0 + 1); }
+
+  static dirty_rect_t join(const dirty_rect_t& a, const dirty_rect_t& b)
+  {
+    dirty_rect_t r;
+    r.x0 = a.x0 < b.x0 ? a.x0 : b.x0;
+    r.y0 = a.y0 < b.y0 ? a.y0 : b.y0;
+    r.x1 = a.x1 > b.x1 ? a.x1 : b.x1;
+    r.y1 = a.y1 > b.y1 ? a.y1 : b.y1;
+    return r;
+  }
+
+  static bool worthMerging(const dirty_rect_t& a, const dirty_rect_t& b)
+  {
+    // Overlapping rectangles always merge, so no pixel is sent twice
+    if ((a.x0 <= b.x1) && (b.x0 <= a.x1) && (a.y0 <= b.y1) && (b.y0 <= a.y1)) return true;
+    return area(join(a, b)) <= area(a) + area(b) + SPRITE_DIRTY_SLACK;
+  }
+
+  dirty_rect_t _rect[SPRITE_DIRTY_RECTS];
+  uint8_t      _count;
+};
+
+#endif // _TFT_DIRTY_RECTS_H_
@@ -0,0 +1,813 @@
+/**************************************************************************************
+// The following class records graphics into a list in RAM and draws the list on the
+// TFT in one transaction with as few address windows as cover what was drawn. The
+// class inherits the graphics functions from the TFT_eSPI class, the primitives they
+// use are overridden so that they are recorded rather than drawn.
+***************************************************************************************/
+
+/***************************************************************************************
+// Commands are kept in drawing order, already clipped and in screen coordinates. Each
+// is a fill, an image in processor byte order, a one bit mask of a character or the
+// scanline of an anti-aliased shape. A fill that carries on the last one extends it
+// instead, as long as nothing recorded since overlaps the part added. pushList() renders the commands that touch each band of
+// rows into a band buffer, marking every pixel drawn, then sends the marked runs,
+// stacked into one window where rows below start and end alike.
+***************************************************************************************/
+
+/***************************************************************************************
+** Function name:           TFT_eDisplayList
+** Description:             Class constructor
+***************************************************************************************/
+TFT_eDisplayList::TFT_eDisplayList(TFT_eSPI *tft)
+{
+  _tft = tft;     // Pointer to tft class so we can call member functions
+  _arena    = nullptr;
+  _size     = 0;
+  _used     = 0;
+  _last     = 0;
+  _glyph    = 0;
+  _band     = nullptr;
+  _drawn    = nullptr;
+  _bandUsed = nullptr;
+  _bandRows = DL_BAND_ROWS;
+  _xs = 0;  // window bounds for pushColor
+  _ys = 0;
+  _xe = 0;
+  _ye = 0;
+  _xptr = 0; // pushColor coordinate
+  _yptr = 0;
+  _vpOoB = true;
+  clearListStats();
+
+  // Ensure inherited functions never open or close a transaction on the TFT
+  locked = false;
+  inTransaction = true;
+  lockTransaction = true;
+}
+
+
+/***************************************************************************************
+** Function name:           ~TFT_eDisplayList
+** Description:             Class destructor
+***************************************************************************************/
+TFT_eDisplayList::~TFT_eDisplayList(void)
+{
+  deleteList();
+
+#ifdef SMOOTH_FONT
+  if(fontLoaded) unloadFont();
+  setGlyphCache(0);
+#endif
+}
+
+
+/***************************************************************************************
+** Function name:           createList
+** Description:             Reserve RAM for the commands and the band they are drawn in
+***************************************************************************************/
+bool TFT_eDisplayList::createList(uint32_t bytes, uint16_t bandRows)
+{
+  if (_arena) return true;
+
+  _width  = _tft->width();
+  _height = _tft->height();
+  rotation = _tft->getRotation();
+  if (bandRows < 1) bandRows = 1;
+  if (bandRows > _height) bandRows = _height;
+  _bandRows = bandRows;
+
+  // Room for at least one row of an image
+  if (bytes < sizeof(dl_cmd_t) + _width * 2) bytes = sizeof(dl_cmd_t) + _width * 2;
+
+  uint32_t bands = (_height + _bandRows - 1) / _bandRows;
+  _arena    = (uint8_t*)  malloc(bytes);
+  _band     = (uint16_t*) malloc(_width * _bandRows * 2);
+  _drawn    = (uint8_t*)  malloc(_width * _bandRows);
+  _bandUsed = (uint8_t*)  calloc(bands, 1);
+
+  if (!_arena || !_band || !_drawn || !_bandUsed) {
+    deleteList();
+    return false;
+  }
+
+  _size = bytes;
+  clearList();
+  resetViewport();
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           deleteList
+** Description:             Delete the list to free up memory (RAM)
+***************************************************************************************/
+void TFT_eDisplayList::deleteList(void)
+{
+  free(_arena);
+  free(_band);
+  free(_drawn);
+  free(_bandUsed);
+  _arena    = nullptr;
+  _band     = nullptr;
+  _drawn    = nullptr;
+  _bandUsed = nullptr;
+  _size = 0;
+  _used = 0;
+  _vpOoB = true;
+}
+
+
+/***************************************************************************************
+** Function name:           clearList
+** Description:             Forget every recorded command
+***************************************************************************************/
+void TFT_eDisplayList::clearList(void)
+{
+  _used  = 0;
+  _last  = _size;
+  _glyph = _size;
+  _after = { 0, 0, -1, -1 };
+  if (_bandUsed) memset(_bandUsed, 0, (_height + _bandRows - 1) / _bandRows);
+}
+
+
+/***************************************************************************************
+** Function name:           clearListStats
+** Description:             Zero the recording and push counts
+***************************************************************************************/
+void TFT_eDisplayList::clearListStats(void)
+{
+  memset(&_stats, 0, sizeof(_stats));
+}
+
+
+/***************************************************************************************
+** Function name:           pushList
+** Description:             Draw the recorded commands on the TFT and empty the list
+***************************************************************************************/
+void TFT_eDisplayList::pushList(void)
+{
+  if (!_used) return;
+
+  bool swap = _tft->getSwapBytes();
+  _tft->setSwapBytes(true); // Band pixels are in processor byte order
+  _tft->startWrite();
+
+  for (int32_t by = 0; by < _height; by += _bandRows) {
+    if (!_bandUsed[by / _bandRows]) continue;
+
+    int32_t rows = _height - by;
+    if (rows > _bandRows) rows = _bandRows;
+    memset(_drawn, 0, _width * rows);
+
+    // Replay, in order, every command that reaches into the band
+    uint32_t p = 0;
+    while (p < _used) {
+      const dl_cmd_t* c = (const dl_cmd_t*)(_arena + p);
+      const uint8_t* data = (const uint8_t*)(c + 1);
+      p += sizeof(dl_cmd_t) + dataBytes(c);
+
+      int32_t y0 = c->y > by ? c->y : by;
+      int32_t y1 = c->y + c->h < by + rows ? c->y + c->h : by + rows;
+      for (int32_t y = y0; y < y1; y++) {
+        uint16_t* dst  = _band + (y - by) * _width + c->x;
+        uint8_t*  mark = _drawn + (y - by) * _width + c->x;
+        if (c->type == DL_FILL) {
+          for (int32_t i = 0; i < c->w; i++) dst[i] = c->color;
+          memset(mark, 1, c->w);
+        }
+        else if (c->type == DL_IMAGE) {
+          memcpy(dst, (const uint16_t*)data + (y - c->y) * c->w, c->w * 2);
+          memset(mark, 1, c->w);
+        }
+        else if (c->type == DL_MASK) {
+          uint32_t b = (y - c->y) * c->w;
+          for (int32_t i = 0; i < c->w; i++, b++) {
+            if (data[b >> 3] & (0x80 >> (b & 7))) { dst[i] = c->color; mark[i] = 1; }
+          }
+        }
+        else {
+          const uint16_t* edge = (const uint16_t*)data;
+          int32_t n = edge[0], m = edge[1];
+          memcpy(dst, edge + 2, n * 2);
+          for (int32_t i = n; i < c->w - m; i++) dst[i] = c->color;
+          memcpy(dst + c->w - m, edge + 2 + n, m * 2);
+          memset(mark, 1, c->w);
+        }
+      }
+    }
+
+    pushBand(by, rows);
+  }
+
+  _tft->endWrite();
+  _tft->setSwapBytes(swap);
+
+  clearList();
+}
+
+
+/***************************************************************************************
+** Function name:           pushBand
+** Description:             Send the drawn pixels of the band as rectangles
+***************************************************************************************/
+void TFT_eDisplayList::pushBand(int32_t by, int32_t rows)
+{
+  for (int32_t r = 0; r < rows; r++) {
+    uint8_t* m = _drawn + r * _width;
+    int32_t x = 0;
+    while (x < _width) {
+      if (!m[x]) { x++; continue; }
+
+      int32_t x0 = x;
+      while (x < _width && m[x]) x++;
+      int32_t n = x - x0;
+
+      // Take in the rows below with exactly the same run
+      int32_t r1 = r + 1;
+      while (r1 < rows) {
+        const uint8_t* mb = _drawn + r1 * _width;
+        if ((x0 > 0 && mb[x0 - 1]) || (x < _width && mb[x])) break;
+        int32_t i = 0;
+        while (i < n && mb[x0 + i]) i++;
+        if (i < n) break;
+        memset(_drawn + r1 * _width + x0, 0, n);
+        r1++;
+      }
+
+      _tft->setWindow(x0, by + r, x - 1, by + r1 - 1);
+      if (n == _width) _tft->pushPixels(_band + r * _width, n * (r1 - r));
+      else for (int32_t i = r; i < r1; i++) _tft->pushPixels(_band + i * _width + x0, n);
+
+      _stats.windows++;
+      _stats.pixels     += n * (r1 - r);
+      _stats.cmdBytes   += DL_WINDOW_BYTES;
+      _stats.pixelBytes += n * (r1 - r) * 2;
+    }
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           reserve
+** Description:             Room for a command, the list is pushed first if it is full
+***************************************************************************************/
+TFT_eDisplayList::dl_cmd_t* TFT_eDisplayList::reserve(uint32_t bytes)
+{
+  endMask();
+
+  if (_used + bytes > _size) {
+    pushList();
+    _stats.flushes++;
+    if (bytes > _size) return nullptr;
+  }
+
+  dl_cmd_t* c = (dl_cmd_t*)(_arena + _used);
+  _used += bytes;
+  return c;
+}
+
+
+/***************************************************************************************
+** Function name:           dataBytes
+** Description:             Bytes of pixels or bits following a command
+***************************************************************************************/
+uint32_t TFT_eDisplayList::dataBytes(const dl_cmd_t* c)
+{
+  if (c->type == DL_IMAGE) return (uint32_t)c->w * c->h * 2;
+  if (c->type == DL_MASK)  return ((uint32_t)c->w * c->h + 15) / 16 * 2;
+  if (c->type == DL_SPAN)  return (2 + ((const uint16_t*)(c + 1))[0] + ((const uint16_t*)(c + 1))[1]) * 2;
+  return 0;
+}
+
+
+/***************************************************************************************
+** Function name:           markBands
+** Description:             Note the bands rows y to y + h - 1 fall in
+***************************************************************************************/
+void TFT_eDisplayList::markBands(int32_t y, int32_t h)
+{
+  for (int32_t b = y / _bandRows; b <= (y + h - 1) / _bandRows; b++) _bandUsed[b] = 1;
+}
+
+
+/***************************************************************************************
+** Function name:           addAfter
+** Description:             Grow the bounds of what follows the last fill
+***************************************************************************************/
+void TFT_eDisplayList::addAfter(int32_t x, int32_t y, int32_t w, int32_t h)
+{
+  if (_after.x1 < _after.x0) { _after = { x, y, x + w - 1, y + h - 1 }; return; }
+  if (x < _after.x0) _after.x0 = x;
+  if (y < _after.y0) _after.y0 = y;
+  if (x + w - 1 > _after.x1) _after.x1 = x + w - 1;
+  if (y + h - 1 > _after.y1) _after.y1 = y + h - 1;
+}
+
+
+/***************************************************************************************
+** Function name:           record
+** Description:             Add a clipped fill in screen coordinates to the list
+***************************************************************************************/
+void TFT_eDisplayList::record(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color)
+{
+  _stats.commands++;
+  _stats.drawn += w * h;
+
+  // Inside the character being drawn it is only bits of its mask
+  if (_glyph < _size) {
+    dl_cmd_t* m = (dl_cmd_t*)(_arena + _glyph);
+    if ((color == m->color) && (x >= m->x) && (y >= m->y) && (x + w <= m->x + m->w) && (y + h <= m->y + m->h)) {
+      uint8_t* bits = (uint8_t*)(m + 1);
+      for (int32_t j = y - m->y; j < y - m->y + h; j++) {
+        uint32_t b = j * m->w + x - m->x;
+        for (int32_t i = 0; i < w; i++, b++) bits[b >> 3] |= 0x80 >> (b & 7);
+      }
+      return;
+    }
+    endMask();
+  }
+
+  // Extend the last fill when this one carries it on along the row or down the column,
+  // as the runs of text, character cells and the lines of a filled shape do
+  if (_last < _used) {
+    dl_cmd_t* c = (dl_cmd_t*)(_arena + _last);
+    bool clear = (x > _after.x1) || (x + w - 1 < _after.x0) || (y > _after.y1) || (y + h - 1 < _after.y0);
+    if ((c->color == color) && clear) {
+      if ((c->y == y) && (c->h == h) && (c->x + c->w == x)) { c->w += w; return; }
+      if ((c->x == x) && (c->w == w) && (c->y + c->h == y)) { c->h += h; markBands(y, h); return; }
+    }
+  }
+
+  dl_cmd_t* c = reserve(sizeof(dl_cmd_t));
+  if (!c) return;
+  c->x = x;
+  c->y = y;
+  c->w = w;
+  c->h = h;
+  c->color = color;
+  c->type = DL_FILL;
+  markBands(y, h);
+
+  _last  = (uint8_t*)c - _arena;
+  _after = { 0, 0, -1, -1 };
+}
+
+
+/***************************************************************************************
+** Function name:           recordImage
+** Description:             Add clipped image rows in screen coordinates to the list
+***************************************************************************************/
+// data holds h rows of w pixels, stride pixels apart. swap converts colours that are in
+// TFT byte order to processor order
+void TFT_eDisplayList::recordImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* data, int32_t stride, bool swap)
+{
+  _stats.commands++;
+  _stats.drawn += w * h;
+
+  while (h > 0) {
+    // As many rows as fit in what is left of the list, at least one when it is empty
+    int32_t rows = 1;
+    if (_used + sizeof(dl_cmd_t) + w * 2 <= _size) rows = (_size - _used - sizeof(dl_cmd_t)) / (w * 2);
+    if (rows > h) rows = h;
+
+    dl_cmd_t* c = reserve(sizeof(dl_cmd_t) + rows * w * 2);
+    if (!c) return;
+    c->x = x;
+    c->y = y;
+    c->w = w;
+    c->h = rows;
+    c->color = 0;
+    c->type = DL_IMAGE;
+    markBands(y, rows);
+    addAfter(x, y, w, rows);
+
+    uint16_t* dst = (uint16_t*)(c + 1);
+    for (int32_t j = 0; j < rows; j++) {
+      for (int32_t i = 0; i < w; i++) {
+        uint16_t color = pgm_read_word(&data[i]);
+        dst[i] = swap ? (color >> 8 | color << 8) : color;
+      }
+      dst  += w;
+      data += stride;
+    }
+    y += rows;
+    h -= rows;
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           beginMask
+** Description:             Start a mask for the pixels of a character
+***************************************************************************************/
+void TFT_eDisplayList::beginMask(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color)
+{
+  if (_vpOoB) return;
+
+  x+= _xDatum;
+  y+= _yDatum;
+
+  // Clipping
+  if ((x >= _vpW) || (y >= _vpH)) return;
+
+  if (x < _vpX) { w += x - _vpX; x = _vpX; }
+  if (y < _vpY) { h += y - _vpY; y = _vpY; }
+
+  if ((x + w) > _vpW) w = _vpW - x;
+  if ((y + h) > _vpH) h = _vpH - y;
+
+  if ((w < 1) || (h < 1)) return;
+
+  uint32_t bytes = ((uint32_t)w * h + 15) / 16 * 2;
+  dl_cmd_t* c = reserve(sizeof(dl_cmd_t) + bytes);
+  if (!c) return;
+  c->x = x;
+  c->y = y;
+  c->w = w;
+  c->h = h;
+  c->color = color;
+  c->type = DL_MASK;
+  memset(c + 1, 0, bytes);
+
+  _glyph = (uint8_t*)c - _arena;
+}
+
+
+/***************************************************************************************
+** Function name:           endMask
+** Description:             Finish the mask of a character, dropped if nothing was set
+***************************************************************************************/
+void TFT_eDisplayList::endMask(void)
+{
+  if (_glyph >= _size) return;
+
+  dl_cmd_t* c = (dl_cmd_t*)(_arena + _glyph);
+  _glyph = _size;
+
+  const uint8_t* bits = (const uint8_t*)(c + 1);
+  uint32_t bytes = dataBytes(c);
+  uint32_t i = 0;
+  while ((i < bytes) && !bits[i]) i++;
+  if (i == bytes) {
+    _used = (uint8_t*)c - _arena; // The mask is always the last command
+    return;
+  }
+
+  markBands(c->y, c->h);
+  addAfter(c->x, c->y, c->w, c->h);
+}
+
+
+/***************************************************************************************
+** Function name:           drawPixel
+** Description:             Record a pixel at x,y
+***************************************************************************************/
+void TFT_eDisplayList::drawPixel(int32_t x, int32_t y, uint32_t color)
+{
+  if (_vpOoB) return;
+
+  x+= _xDatum;
+  y+= _yDatum;
+
+  // Range checking
+  if ((x < _vpX) || (y < _vpY) || (x >= _vpW) || (y >= _vpH)) return;
+
+  record(x, y, 1, 1, color);
+}
+
+
+/***************************************************************************************
+** Function name:           drawChar
+** Description:             Record a character in the GLCD or GFXFF font
+***************************************************************************************/
+void TFT_eDisplayList::drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color, uint32_t bg, uint8_t size)
+{
+  if (_vpOoB) return;
+
+  int32_t gx = x, gy = y, gw = 0, gh = 0; // Where the character pixels fall
+
+#ifdef LOAD_GLCD
+  bool glcd = true;
+  #ifdef LOAD_GFXFF
+  glcd = !gfxFont;
+  #endif
+  if (glcd) {
+    if (c > 255) return;
+    // TFT_eSPI writes opaque GLCD characters straight to the TFT, record the character
+    // cell and then the character drawn over it
+    if (bg != color) {
+      fillRect(x, y, 6 * size, 8 * size, bg);
+      bg = color;
+    }
+    gw = 5 * size;
+    gh = 8 * size;
+  }
+#endif
+
+#ifdef LOAD_GFXFF
+  if (gfxFont && (c >= pgm_read_word(&gfxFont->first)) && (c <= pgm_read_word(&gfxFont->last))) {
+    GFXglyph *glyph = &(((GFXglyph *)pgm_read_ptr(&gfxFont->glyph))[c - pgm_read_word(&gfxFont->first)]);
+    gx = x + (int8_t)pgm_read_byte(&glyph->xOffset) * size;
+    gy = y + (int8_t)pgm_read_byte(&glyph->yOffset) * size;
+    gw = pgm_read_byte(&glyph->width) * size;
+    gh = pgm_read_byte(&glyph->height) * size;
+  }
+#endif
+
+  beginMask(gx, gy, gw, gh, color);
+  TFT_eSPI::drawChar(x, y, c, color, bg, size);
+  endMask();
+}
+
+
+/***************************************************************************************
+** Function name:           drawFastVLine
+** Description:             Record a vertical line
+***************************************************************************************/
+void TFT_eDisplayList::drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color)
+{
+  fillRect(x, y, 1, h, color);
+}
+
+
+/***************************************************************************************
+** Function name:           drawFastHLine
+** Description:             Record a horizontal line
+***************************************************************************************/
+void TFT_eDisplayList::drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color)
+{
+  fillRect(x, y, w, 1, color);
+}
+
+
+/***************************************************************************************
+** Function name:           fillRect
+** Description:             Record a filled rectangle
+***************************************************************************************/
+void TFT_eDisplayList::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color)
+{
+  if (_vpOoB) return;
+
+  x+= _xDatum;
+  y+= _yDatum;
+
+  // Clipping
+  if ((x >= _vpW) || (y >= _vpH)) return;
+
+  if (x < _vpX) { w += x - _vpX; x = _vpX; }
+  if (y < _vpY) { h += y - _vpY; y = _vpY; }
+
+  if ((x + w) > _vpW) w = _vpW - x;
+  if ((y + h) > _vpH) h = _vpH - y;
+
+  if ((w < 1) || (h < 1)) return;
+
+  record(x, y, w, h, color);
+}
+
+
+/***************************************************************************************
+** Function name:           drawChar
+** Description:             Record a character in font 2 or an RLE font 4, 6, 7 or 8
+***************************************************************************************/
+// TFT_eSPI writes these fonts straight to the TFT, here they are decoded into a fill of
+// the background and fills of the runs of text colour on each line
+int16_t TFT_eDisplayList::drawChar(uint16_t uniCode, int32_t x, int32_t y, uint8_t font)
+{
+  if ((font < 2) || (font > 8)) return TFT_eSPI::drawChar(uniCode, x, y, font);
+
+  if (_vpOoB || (uniCode < 32) || (uniCode > 127)) return 0;
+
+  int32_t width  = 0;
+  int32_t height = 0;
+  const uint8_t* glyph = nullptr;
+  uniCode -= 32;
+
+#ifdef LOAD_FONT2
+  if (font == 2) {
+    glyph  = (const uint8_t*)pgm_read_ptr(&chrtbl_f16[uniCode]);
+    width  = pgm_read_byte(widtbl_f16 + uniCode);
+    height = chr_hgt_f16;
+  }
+#endif
+
+#ifdef LOAD_RLE
+  if (font > 2) {
+    glyph  = (const uint8_t*)pgm_read_ptr( (const uint8_t *)pgm_read_ptr( &(fontdata[font].chartbl ) ) + uniCode*sizeof(void *) );
+    width  = pgm_read_byte( (uint8_t *)pgm_read_ptr( &(fontdata[font].widthtbl ) ) + uniCode );
+    height = pgm_read_byte( &fontdata[font].height );
+  }
+#endif
+
+  if (!glyph) return 0;
+
+  int32_t ts = textsize;
+  if (textcolor != textbgcolor) fillRect(x, y, width * ts, height * ts, textbgcolor);
+  beginMask(x, y, width * ts, height * ts, textcolor);
+
+  if (font == 2) {
+    // Rows of (width + 6) / 8 bytes, most significant bit on the left
+    int32_t bytes = (width + 6) / 8;
+    for (int32_t row = 0; row < height; row++) {
+      int32_t run = 0;
+      for (int32_t px = 0; px <= bytes * 8; px++) {
+        bool set = (px < bytes * 8) && (pgm_read_byte(glyph + row * bytes + px / 8) & (0x80 >> (px & 7)));
+        if (set) { run++; continue; }
+        if (run) fillRect(x + (px - run) * ts, y + row * ts, run * ts, ts, textcolor);
+        run = 0;
+      }
+    }
+  }
+  else {
+    // Runs of up to 128 pixels in raster order, the top bit set for the text colour
+    int32_t pc = 0;
+    while (pc < width * height) {
+      uint8_t line = pgm_read_byte(glyph++);
+      int32_t n = (line & 0x7F) + 1;
+      if (line & 0x80) {
+        int32_t px = pc % width, py = pc / width, left = n;
+        while (left > 0) {
+          int32_t run = width - px < left ? width - px : left;
+          fillRect(x + px * ts, y + py * ts, run * ts, ts, textcolor);
+          left -= run;
+          px = 0;
+          py++;
+        }
+      }
+      pc += n;
+    }
+  }
+
+  endMask();
+  return width * textsize;
+}
+
+
+/***************************************************************************************
+** Function name:           setWindow
+** Description:             Set the area pushColor() records into
+***************************************************************************************/
+void TFT_eDisplayList::setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+{
+  if (x0 > x1) transpose(x0, x1);
+  if (y0 > y1) transpose(y0, y1);
+
+  _xs = x0;
+  _ys = y0;
+  _xe = x1;
+  _ye = y1;
+
+  _xptr = _xs;
+  _yptr = _ys;
+}
+
+
+/***************************************************************************************
+** Function name:           pushColor
+** Description:             Record a pixel at the window position and advance it
+***************************************************************************************/
+void TFT_eDisplayList::pushColor(uint16_t color)
+{
+  if (_arena && (_xptr >= 0) && (_xptr < _width) && (_yptr >= 0) && (_yptr < _height)) {
+    record(_xptr, _yptr, 1, 1, color);
+  }
+
+  // Increment x
+  _xptr++;
+
+  // Wrap on x and y to start, increment y if needed
+  if (_xptr > _xe) {
+    _xptr = _xs;
+    _yptr++;
+    if (_yptr > _ye) _yptr = _ys;
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           readPixel
+** Description:             The colour x,y will be when the list is pushed
+***************************************************************************************/
+// The last recorded command covering the pixel sets it, otherwise the TFT still shows it
+uint16_t TFT_eDisplayList::readPixel(int32_t x, int32_t y)
+{
+  if (_vpOoB) return 0;
+
+  x+= _xDatum;
+  y+= _yDatum;
+
+  if ((x < _vpX) || (y < _vpY) || (x >= _vpW) || (y >= _vpH)) return 0;
+
+  bool found = false;
+  uint16_t color = 0;
+  uint32_t p = 0;
+  while (p < _used) {
+    const dl_cmd_t* c = (const dl_cmd_t*)(_arena + p);
+    const uint8_t* data = (const uint8_t*)(c + 1);
+    p += sizeof(dl_cmd_t) + dataBytes(c);
+    if ((x < c->x) || (x >= c->x + c->w) || (y < c->y) || (y >= c->y + c->h)) continue;
+
+    int32_t i = (y - c->y) * c->w + x - c->x;
+    const uint16_t* edge = (const uint16_t*)data;
+    if (c->type == DL_IMAGE) color = edge[i];
+    else if (c->type == DL_MASK) {
+      if (!(data[i >> 3] & (0x80 >> (i & 7)))) continue;
+      color = c->color;
+    }
+    else if ((c->type == DL_SPAN) && (i < edge[0])) color = edge[2 + i];
+    else if ((c->type == DL_SPAN) && (i >= c->w - edge[1])) color = edge[2 + edge[0] + i - (c->w - edge[1])];
+    else color = c->color;
+    found = true;
+  }
+  if (found) return color;
+
+  return _tft->readPixel(x - _tft->getViewportX(), y - _tft->getViewportY());
+}
+
+
+/***************************************************************************************
+** Function name:           pushImage
+** Description:             Record a 16-bit image, copied into the list
+***************************************************************************************/
+void TFT_eDisplayList::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *data)
+{
+  pushImage(x, y, w, h, (const uint16_t*)data);
+}
+
+void TFT_eDisplayList::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *data)
+{
+  if (!_arena) return;
+
+  PI_CLIP;
+
+  recordImage(x, y, dw, dh, data + dx + dy * w, w, !_swapBytes);
+}
+
+
+/***************************************************************************************
+** Function name:           pushSpan
+** Description:             Record a scanline of an anti-aliased shape
+***************************************************************************************/
+void TFT_eDisplayList::pushSpan(int32_t x, int32_t y, const uint16_t* lead, int32_t n, int32_t len, uint32_t color, const uint16_t* trail, int32_t m)
+{
+  if (_vpOoB) return;
+
+  x+= _xDatum;
+  y+= _yDatum;
+
+  if ((y < _vpY) || (y >= _vpH)) return;
+
+  // Part of the span inside the viewport, from a up to b, and its edge pixels
+  int32_t a = x < _vpX ? _vpX - x : 0;
+  int32_t b = n + len + m;
+  if (x + b > _vpW) b = _vpW - x;
+  if (a >= b) return;
+
+  int32_t ls = a, le = b < n ? b : n;
+  int32_t ts = a > n + len ? a : n + len, te = b;
+  int32_t nl = le > ls ? le - ls : 0;
+  int32_t ml = te > ts ? te - ts : 0;
+
+  if (!nl && !ml) {
+    record(x + a, y, b - a, 1, color);
+    return;
+  }
+
+  _stats.commands++;
+  _stats.drawn += b - a;
+
+  dl_cmd_t* c = reserve(sizeof(dl_cmd_t) + (2 + nl + ml) * 2);
+  if (!c) return;
+  c->x = x + a;
+  c->y = y;
+  c->w = b - a;
+  c->h = 1;
+  c->color = color;
+  c->type = DL_SPAN;
+  markBands(y, 1);
+  addAfter(c->x, y, c->w, 1);
+
+  uint16_t* edge = (uint16_t*)(c + 1);
+  edge[0] = nl;
+  edge[1] = ml;
+  if (nl) memcpy(edge + 2, lead + ls, nl * 2);
+  if (ml) memcpy(edge + 2 + nl, trail + ts - n - len, ml * 2);
+}
+
+
+#ifdef SMOOTH_FONT
+/***************************************************************************************
+** Function name:           drawGlyph
+** Description:             Record a character in the loaded smooth font
+***************************************************************************************/
+// Glyphs pre-blended in the glyph cache are pushed with TFT_eSPI::pushImage() which
+// writes to the TFT, so they are drawn from the alpha map here
+void TFT_eDisplayList::drawGlyph(uint16_t code)
+{
+  bool blend = glyphBlend;
+  glyphBlend = false;
+  TFT_eSPI::drawGlyph(code);
+  glyphBlend = blend;
+}
+#endif
@@ -0,0 +1,155 @@
+/***************************************************************************************
+// The following class records graphics drawn on it into a fixed size list in RAM and
+// then draws the whole list on the TFT in one transaction. Directly, every primitive
+// sets its own address window and a HUD of many small elements spends most of the bus
+// time on CASET, RASET and RAMWR. pushList() instead renders the list a band of rows
+// at a time and sends each band as the fewest rectangles that cover what was drawn,
+// so overlapping and touching elements share windows and overdrawn pixels are sent
+// once. The class inherits the graphics functions from the TFT_eSPI class, the
+// primitives they are built on are overridden to record rather than draw.
+//
+// Recorded: pixels, lines, rectangles and everything made of them, the GLCD, free and
+// RLE fonts, smooth fonts, the anti-aliased shapes, setWindow() and pushColor(), and
+// pushImage() of 16-bit images. Other images, sprites pushed to the TFT and
+// setRotation() are not recorded, call pushList() before using them on the TFT.
+***************************************************************************************/
+
+#ifndef DL_BAND_ROWS
+  #define DL_BAND_ROWS    16  // Screen rows rendered together by pushList()
+#endif
+
+// Command and parameter bytes to set an address window and start writing to it
+// (CASET with 4 parameters, RASET with 4, RAMWR), for the byte counts in the stats
+#define DL_WINDOW_BYTES   11
+
+typedef struct {
+  uint32_t commands;    // Primitives recorded, drawn directly each would set a window
+  uint32_t drawn;       // Pixels they cover, counting every overdraw
+  uint32_t windows;     // Address windows set by pushList()
+  uint32_t pixels;      // Pixels pushList() sent
+  uint32_t cmdBytes;    // Command and parameter bytes of those windows
+  uint32_t pixelBytes;  // Pixel bytes sent
+  uint32_t flushes;     // Times the list filled up and was pushed early
+} display_list_stats_t;
+
+class TFT_eDisplayList : public TFT_eSPI {
+
+ public:
+
+  explicit TFT_eDisplayList(TFT_eSPI *tft);
+  ~TFT_eDisplayList(void);
+
+           // Reserve bytes of RAM for recorded commands, plus one band of bandRows screen
+           // rows (3 bytes a pixel) to render them in. The list covers the whole TFT as it
+           // is rotated now. A fill takes 12 bytes, a character 12 plus a bit a pixel, an
+           // image 12 plus 2 bytes a pixel. Returns false if the RAM is not available
+  bool     createList(uint32_t bytes, uint16_t bandRows = DL_BAND_ROWS);
+
+           // Returns true if the list has been created
+  bool     created(void) { return _arena != nullptr; }
+
+           // Delete the list to free up the RAM
+  void     deleteList(void);
+
+           // Draw everything recorded on the TFT in one transaction and empty the list.
+           // A full list is pushed by itself before more is recorded.
+  void     pushList(void);
+
+           // Forget everything recorded without drawing it
+  void     clearList(void);
+
+           // Bytes of the list in use
+  uint32_t listBytes(void) { return _used; }
+
+           // Counts since the last clearListStats(), per frame if cleared every frame
+  void     getListStats(display_list_stats_t *stats) { *stats = _stats; }
+  void     clearListStats(void);
+
+           // Record a single pixel at x,y
+  void     drawPixel(int32_t x, int32_t y, uint32_t color);
+
+           // Record a single character in the GLCD or GFXFF font
+  void     drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color, uint32_t bg, uint8_t size);
+
+           // Record lines and filled rectangles
+  void     drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color),
+           drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color),
+           fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+
+           // Record a single character in the selected font
+  int16_t  drawChar(uint16_t uniCode, int32_t x, int32_t y, uint8_t font);
+
+           // Define a window to record 16-bit colour pixels into in a raster order
+  void     setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1);
+           // Record a color (aka single pixel) in the set window area
+  void     pushColor(uint16_t color);
+
+           // The colour x,y will have when the list is pushed, read from the TFT where
+           // nothing recorded covers it
+  uint16_t readPixel(int32_t x, int32_t y);
+
+           // Record an image (colour bitmap), copied into the list
+  void     pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *data);
+  void     pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *data);
+
+#ifdef SMOOTH_FONT
+           // Record a single Unicode character using the loaded font
+  void     drawGlyph(uint16_t code);
+#endif
+
+ private:
+
+  enum { DL_FILL, DL_IMAGE, DL_MASK, DL_SPAN };
+
+  typedef struct {
+    int16_t  x, y, w, h;  // Screen area, clipped to the viewport when recorded
+    uint16_t color;       // Colour of a fill or of the set bits of a mask
+    uint16_t type;        // An image is followed by w * h pixels in processor byte order,
+                          // a mask by w * h bits rounded up to 16, rows not byte aligned,
+                          // a span by its lead and trail counts then those pixels
+  } dl_cmd_t;
+
+  TFT_eSPI *_tft;
+
+  uint8_t  *_arena;     // Recorded commands
+  uint32_t _size;       // Bytes of _arena
+  uint32_t _used;
+  uint32_t _last;       // Offset of the last fill, which the next may extend, or _size
+  uint32_t _glyph;      // Offset of the mask a character is drawn into, or _size
+  dirty_rect_t _after;  // Bounds of what was recorded after the last fill
+
+  uint16_t *_band;      // Pixels of one band
+  uint8_t  *_drawn;     // 1 for each band pixel drawn on
+  uint8_t  *_bandUsed;  // 1 for each band a recorded command touches
+  uint16_t _bandRows;
+
+  int32_t  _xs, _ys, _xe, _ye, _xptr, _yptr; // pushColor() window and position
+
+  display_list_stats_t _stats;
+
+           // Record a fill or image rows of the area x,y,w,h given in screen coordinates,
+           // after clipping
+  void     record(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color);
+  void     recordImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* data, int32_t stride, bool swap);
+
+           // Fills of color inside x,y,w,h (before datum and clipping) set bits of one mask
+           // until endMask(), so a character takes a bit a pixel
+  void     beginMask(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color);
+  void     endMask(void);
+
+           // Room for bytes more in the list, pushing it first if it is full
+  dl_cmd_t* reserve(uint32_t bytes);
+  static uint32_t dataBytes(const dl_cmd_t* c);
+  void     markBands(int32_t y, int32_t h);
+  void     addAfter(int32_t x, int32_t y, int32_t w, int32_t h);
+
+           // Send the band of rows from y, the drawn parts of it as rectangles
+  void     pushBand(int32_t y, int32_t rows);
+
+           // Override the non-inlined TFT_eSPI functions
+  void     begin_nin_write(void) { ; }
+  void     end_nin_write(void) { ; }
+
+           // Scanlines of the anti-aliased shapes, recorded as one span each
+  void     pushSpan(int32_t x, int32_t y, const uint16_t* lead, int32_t n, int32_t len, uint32_t color, const uint16_t* trail, int32_t m);
+};
@@ -0,0 +1,217 @@
+/**************************************************************************************
+// Glyph atlases of the built in bitmap fonts, see GlyphAtlas.h. Part of the TFT_eSPI
+// class, the Sprite class writes the cells into its own memory.
+***************************************************************************************/
+
+/***************************************************************************************
+** Function name:           createGlyphAtlas
+** Description:             Hold a built in font in RAM in one size and colour pair
+***************************************************************************************/
+bool TFT_eSPI::createGlyphAtlas(uint8_t font, uint8_t size, uint16_t fg, uint16_t bg, bool digits, bool rgb565)
+{
+  // Only the fonts drawn as bitmaps, and only with the background filled
+  if (font < 1 || font > 8 || font == 3 || font == 5) return false;
+  if (!(fontsloaded & (1 << font)) || size == 0 || fg == bg) return false;
+
+  // Replace the atlas of the same font, size and colours, else take a free slot. The
+  // slots in use are kept together at the start
+  uint8_t slot = 0;
+  while (slot < GLYPH_ATLASES && glyphAtlas[slot] && !glyphAtlas[slot]->matches(font, size, fg, bg)) slot++;
+  if (slot == GLYPH_ATLASES) return false;
+
+  TFT_GlyphAtlas* atlas = new (std::nothrow) TFT_GlyphAtlas(font, size, fg, bg, rgb565);
+  if (!atlas) return false;
+
+  const char* codes = GLYPH_ATLAS_DIGITS;
+  uint8_t count = digits ? strlen(GLYPH_ATLAS_DIGITS) : GLYPH_ATLAS_CODES;
+  for (uint8_t i = 0; i < count; i++) {
+    uint16_t c = digits ? codes[i] : GLYPH_ATLAS_FIRST + i;
+    atlas->addGlyph(c, glyphWidth(font, c) * size);
+  }
+
+  uint8_t height = (font == 1) ? 8 : pgm_read_byte( &fontdata[font].height );
+  if (!atlas->allocate(height * size)) {
+    delete atlas;
+    return false;
+  }
+
+  uint16_t w;
+  for (uint16_t c = GLYPH_ATLAS_FIRST; c < GLYPH_ATLAS_FIRST + GLYPH_ATLAS_CODES; c++) {
+    if (atlas->glyph(c, &w)) rasterGlyph(atlas, font, c);
+  }
+
+  delete glyphAtlas[slot];
+  glyphAtlas[slot] = atlas;
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           deleteGlyphAtlas
+** Description:             Free every glyph atlas
+***************************************************************************************/
+void TFT_eSPI::deleteGlyphAtlas(void)
+{
+  for (uint8_t i = 0; i < GLYPH_ATLASES; i++) {
+    delete glyphAtlas[i];
+    glyphAtlas[i] = nullptr;
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           getGlyphAtlasStats
+** Description:             Characters drawn from the atlases and the RAM they hold
+***************************************************************************************/
+void TFT_eSPI::getGlyphAtlasStats(glyph_atlas_stats_t *stats)
+{
+  stats->hits    = glyphAtlasHits;
+  stats->bytes   = 0;
+  stats->atlases = 0;
+  for (uint8_t i = 0; i < GLYPH_ATLASES; i++) {
+    if (!glyphAtlas[i]) continue;
+    stats->bytes += glyphAtlas[i]->bytes();
+    stats->atlases++;
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           clearGlyphAtlasStats
+** Description:             Restart the count of characters drawn from the atlases
+***************************************************************************************/
+void TFT_eSPI::clearGlyphAtlasStats(void)
+{
+  glyphAtlasHits = 0;
+}
+
+
+/***************************************************************************************
+** Function name:           glyphWidth
+** Description:             Width of a character of a built in font at text size 1
+***************************************************************************************/
+uint8_t TFT_eSPI::glyphWidth(uint8_t font, uint16_t c)
+{
+  if (font == 1) return 6;
+#ifdef LOAD_FONT2
+  if (font == 2) return pgm_read_byte(widtbl_f16 + c - 32);
+#endif
+  return pgm_read_byte( (uint8_t *)pgm_read_ptr( &(fontdata[font].widthtbl ) ) + c - 32 );
+}
+
+
+/***************************************************************************************
+** Function name:           rasterGlyph
+** Description:             Decode a character of a built in font into an atlas
+***************************************************************************************/
+// The cell is what drawChar() fills with the background filled: GLCD characters are 5
+// columns and a blank one, font 2 rows are bits MSB first and the RLE fonts are runs of
+// background and foreground pixels
+void TFT_eSPI::rasterGlyph(TFT_GlyphAtlas* atlas, uint8_t fontNumber, uint16_t c)
+{
+#ifdef LOAD_GLCD
+  if (fontNumber == 1) {
+    for (int32_t i = 0; i < 5; i++) {
+      uint8_t line = pgm_read_byte(&font[0] + (c * 5) + i);
+      for (int32_t j = 0; j < 8; j++, line >>= 1) if (line & 0x1) atlas->plot(c, i, j);
+    }
+    return;
+  }
+#endif
+
+  int32_t width  = glyphWidth(fontNumber, c);
+  int32_t height = pgm_read_byte( &fontdata[fontNumber].height );
+
+#ifdef LOAD_FONT2
+  if (fontNumber == 2) {
+    const uint8_t* bits = (const uint8_t*)pgm_read_ptr(&chrtbl_f16[c - 32]);
+    int32_t w = (width + 6) / 8; // As drawChar(), a last column beyond the bytes is blank
+    for (int32_t i = 0; i < height; i++) {
+      for (int32_t k = 0; k < w; k++) {
+        uint8_t line = pgm_read_byte(bits + w * i + k);
+        for (int32_t b = 0; b < 8; b++) {
+          if ((line & (0x80 >> b)) && (k * 8 + b < width)) atlas->plot(c, k * 8 + b, i);
+        }
+      }
+    }
+    return;
+  }
+#endif
+
+#ifdef LOAD_RLE
+  const uint8_t* runs = (const uint8_t*)pgm_read_ptr( (const uint8_t *)pgm_read_ptr( &(fontdata[fontNumber].chartbl ) ) + (c - 32) * sizeof(void *) );
+  int32_t pc = 0;
+  while (pc < width * height) {
+    uint8_t line = pgm_read_byte(runs++);
+    bool set = line & 0x80;
+    line = (line & 0x7F) + 1;
+    while (line--) {
+      if (set) atlas->plot(c, pc % width, pc / width);
+      pc++;
+    }
+  }
+#endif
+}
+
+
+/***************************************************************************************
+** Function name:           drawAtlasChar
+** Description:             Draw a character from a glyph atlas, returns its width
+***************************************************************************************/
+// Returns 0 if no atlas holds the character in these colours, to be drawn the usual way
+int16_t TFT_eSPI::drawAtlasChar(uint8_t font, uint16_t c, int32_t x, int32_t y, uint32_t fg, uint32_t bg, uint8_t size)
+{
+  if (!glyphAtlas[0]) return 0;
+
+  uint8_t slot = 0;
+  while (slot < GLYPH_ATLASES && glyphAtlas[slot] && !glyphAtlas[slot]->matches(font, size, fg, bg)) slot++;
+  if (slot == GLYPH_ATLASES || !glyphAtlas[slot]) return 0;
+
+  TFT_GlyphAtlas* atlas = glyphAtlas[slot];
+  uint16_t w;
+  const uint8_t* cell = atlas->glyph(c, &w);
+  if (!cell) return 0;
+
+  // Clip the cell to the viewport
+  int32_t xd = x + _xDatum;
+  int32_t yd = y + _yDatum;
+  int32_t dx = (xd < _vpX) ? _vpX - xd : 0;
+  int32_t dy = (yd < _vpY) ? _vpY - yd : 0;
+  int32_t dw = ((xd + w > _vpW) ? _vpW - xd : w) - dx;
+  int32_t dh = ((yd + atlas->height() > _vpH) ? _vpH - yd : atlas->height()) - dy;
+
+  if (dw > 0 && dh > 0) pushAtlasCell(atlas, cell, w, xd + dx, yd + dy, dx, dy, dw, dh);
+  glyphAtlasHits++;
+  return w;
+}
+
+
+/***************************************************************************************
+** Function name:           pushAtlasCell
+** Description:             Push part of a glyph atlas cell to the TFT
+***************************************************************************************/
+void TFT_eSPI::pushAtlasCell(const TFT_GlyphAtlas* atlas, const uint8_t* cell, uint16_t w, int32_t x, int32_t y, int32_t dx, int32_t dy, int32_t dw, int32_t dh)
+{
+  // The cells are byte swapped already
+  bool swap = _swapBytes;
+  _swapBytes = false;
+
+  begin_tft_write();
+  setWindow(x, y, x + dw - 1, y + dh - 1);
+
+  if (atlas->rgb565()) {
+    const uint16_t* img = (const uint16_t*)cell + dy * w + dx;
+    if (dw == w) pushPixels(img, dw * dh);
+    else for (int32_t r = 0; r < dh; r++) pushPixels(img + r * w, dw);
+  }
+  else {
+    uint16_t line[GLYPH_ATLAS_MAX_WIDTH + 8];
+    for (int32_t r = 0; r < dh; r++) {
+      atlas->expand(cell, w, dy + r, line);
+      pushPixels(line + dx, dw);
+    }
+  }
+
+  end_tft_write();
+  _swapBytes = swap;
+}
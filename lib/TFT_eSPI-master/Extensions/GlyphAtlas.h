@@ -0,0 +1,153 @@
+/***************************************************************************************
+// A glyph atlas holds the characters of one of the built in bitmap fonts (GLCD, font 2
+// or an RLE font) in RAM, already scaled by the text size, for one foreground/background
+// pair. Drawing a character held is then a block copy of its cell rather than decoding
+// the font and plotting it run by run or pixel by pixel. Each cell is kept either at 1
+// bit a pixel, expanded to colours four pixels at a time through a 16 entry table, or as
+// RGB565 ready to push, which is faster again for 16 times the RAM. Colours are held in
+// the byte order the TFT is sent and a 16 bit Sprite stores, so the pixels are copied as
+// they are.
+//
+// The atlas holds printable ASCII (32 to 127), or just what numbers are drawn with.
+***************************************************************************************/
+
+#ifndef _TFT_GLYPH_ATLAS_H_
+#define _TFT_GLYPH_ATLAS_H_
+
+#include <new>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef GLYPH_ATLASES
+  #define GLYPH_ATLASES       4   // Atlases one TFT_eSPI or Sprite can hold at once
+#endif
+
+#define GLYPH_ATLAS_FIRST     32  // Codes held, 32 to 127
+#define GLYPH_ATLAS_CODES     96
+#define GLYPH_ATLAS_MAX_WIDTH 128 // Widest cell held, as drawn
+#define GLYPH_ATLAS_DIGITS    " +-.,:0123456789" // Held by a digits only atlas
+
+typedef struct {
+  uint32_t hits;       // Characters drawn from an atlas
+  uint32_t bytes;      // Held by all the atlases
+  uint8_t  atlases;    // Atlases held
+} glyph_atlas_stats_t;
+
+class TFT_GlyphAtlas {
+
+ public:
+
+  TFT_GlyphAtlas(uint8_t font, uint8_t size, uint16_t fg, uint16_t bg, bool rgb565)
+    : _font(font), _size(size), _fg(fg), _bg(bg), _rgb565(rgb565), _height(0), _bytes(0), _data(nullptr)
+  {
+    memset(_width, 0, sizeof(_width));
+    _fgSwapped = fg >> 8 | fg << 8;
+    _bgSwapped = bg >> 8 | bg << 8;
+    for (uint8_t i = 0; i < 16; i++) {
+      for (uint8_t b = 0; b < 4; b++) _expand[i][b] = (i & (0x8 >> b)) ? _fgSwapped : _bgSwapped;
+    }
+  }
+
+  ~TFT_GlyphAtlas(void) { free(_data); }
+
+           // Reserve a cell width pixels wide (as drawn) for code. False if code is not
+           // one held or the cell is too wide
+  bool     addGlyph(uint16_t code, uint16_t width)
+  {
+    if (code < GLYPH_ATLAS_FIRST || code >= GLYPH_ATLAS_FIRST + GLYPH_ATLAS_CODES) return false;
+    if (width == 0 || width > GLYPH_ATLAS_MAX_WIDTH || _data) return false;
+    _width[code - GLYPH_ATLAS_FIRST] = width;
+    return true;
+  }
+
+           // Allocate the cells added, height pixels high as drawn, filled with the
+           // background colour. False if the memory is not available
+  bool     allocate(uint16_t height)
+  {
+    _height = height;
+    _bytes = 0;
+    for (uint8_t i = 0; i < GLYPH_ATLAS_CODES; i++) {
+      if (!_width[i]) continue;
+      _offset[i] = _bytes;
+      _bytes += cellBytes(_width[i], height);
+    }
+    _data = (uint8_t*)malloc(_bytes ? _bytes : 1);
+    if (!_data) return false;
+
+    if (!_rgb565) memset(_data, 0, _bytes);
+    else for (uint32_t i = 0; i < _bytes / 2; i++) ((uint16_t*)_data)[i] = _bgSwapped;
+    return true;
+  }
+
+           // Set the font pixel x,y of code to the foreground colour, a square of size
+           // pixels of the cell
+  void     plot(uint16_t code, int32_t x, int32_t y)
+  {
+    code -= GLYPH_ATLAS_FIRST;
+    uint16_t w = _width[code];
+    uint8_t* cell = _data + _offset[code];
+    for (int32_t yp = y * _size; yp < (y + 1) * _size; yp++) {
+      for (int32_t xp = x * _size; xp < (x + 1) * _size; xp++) {
+        if (xp >= w || yp >= _height) continue;
+        if (_rgb565) ((uint16_t*)cell)[yp * w + xp] = _fgSwapped;
+        else cell[yp * ((w + 7) >> 3) + (xp >> 3)] |= 0x80 >> (xp & 7);
+      }
+    }
+  }
+
+  bool     matches(uint8_t font, uint8_t size, uint32_t fg, uint32_t bg) const
+  {
+    return font == _font && size == _size && fg == _fg && bg == _bg;
+  }
+
+           // The cell of code and its width, NULL when not held. Byte swapped RGB565 pixels
+           // when rgb565() is true, otherwise rows of 1 bit pixels, MSB first
+  const uint8_t* glyph(uint16_t code, uint16_t* width) const
+  {
+    code -= GLYPH_ATLAS_FIRST;
+    if (code >= GLYPH_ATLAS_CODES || !_width[code]) return nullptr;
+    *width = _width[code];
+    return _data + _offset[code];
+  }
+
+           // Colours of row y of a 1 bit cell into line, which must have room for width
+           // rounded up to a multiple of 8
+  void     expand(const uint8_t* cell, uint16_t width, int32_t y, uint16_t* line) const
+  {
+    uint16_t stride = (width + 7) >> 3;
+    const uint8_t* bits = cell + y * stride;
+    while (stride--) {
+      uint8_t b = *bits++;
+      memcpy(line, _expand[b >> 4], 8);
+      memcpy(line + 4, _expand[b & 0xF], 8);
+      line += 8;
+    }
+  }
+
+  uint8_t  font(void)   const { return _font; }
+  uint16_t height(void) const { return _height; }
+  bool     rgb565(void) const { return _rgb565; }
+  uint32_t bytes(void)  const { return _bytes; }
+
+ private:
+
+  uint32_t cellBytes(uint16_t width, uint16_t height) const
+  {
+    return _rgb565 ? (uint32_t)width * height * 2 : (uint32_t)((width + 7) >> 3) * height;
+  }
+
+  uint8_t  _font;
+  uint8_t  _size;
+  uint16_t _fg, _bg;
+  uint16_t _fgSwapped, _bgSwapped;
+  bool     _rgb565;
+  uint16_t _height;
+  uint32_t _bytes;
+  uint8_t* _data;
+  uint16_t _width[GLYPH_ATLAS_CODES];   // 0 when the code is not held
+  uint32_t _offset[GLYPH_ATLAS_CODES];  // Of the cell in _data
+  uint16_t _expand[16][4];              // Four 1 bit pixels, MSB first, as colours
+};
+
+#endif // _TFT_GLYPH_ATLAS_H_
@@ -0,0 +1,147 @@
+/***************************************************************************************
+// A least recently used cache of smooth font glyphs held in RAM. Each entry is either
+// the decoded 8-bit alpha map of a glyph, so drawing it again does not read the font
+// file or array, or the glyph already blended as RGB565 for one foreground/background
+// pair, which opaque text can push as a single image. The cache is limited in bytes,
+// the least recently drawn glyphs are dropped to make room.
+//
+// Entries are found by a linear search and the oldest is dropped by scanning them all,
+// so the cache holds at most SMOOTH_FONT_CACHE_GLYPHS, enough for the text on a screen.
+// Their memory comes from the allocator passed in (malloc or ps_malloc for PSRAM).
+***************************************************************************************/
+
+#ifndef _TFT_GLYPH_CACHE_H_
+#define _TFT_GLYPH_CACHE_H_
+
+#include <new>
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifndef SMOOTH_FONT_CACHE_GLYPHS
+  #define SMOOTH_FONT_CACHE_GLYPHS  48  // Entries held at most, whatever the byte budget
+#endif
+
+typedef void* (*glyph_alloc_t)(size_t size);
+
+typedef struct {
+  uint32_t hits;       // Glyphs drawn from the cache
+  uint32_t misses;     // Glyphs decoded or blended and added
+  uint32_t evictions;  // Entries dropped to make room
+  uint32_t bytes;      // Held now
+  uint16_t glyphs;     // Entries held now
+} glyph_cache_stats_t;
+
+class TFT_GlyphCache {
+
+ public:
+
+  TFT_GlyphCache(uint32_t budget, glyph_alloc_t alloc) : _budget(budget), _alloc(alloc), _count(0), _tick(0), _bytes(0)
+  {
+    clearStats();
+  }
+
+  ~TFT_GlyphCache(void) { clear(); }
+
+           // Free every entry, used when the font changes
+  void     clear(void)
+  {
+    for (uint8_t i = 0; i < _count; i++) free(_entry[i].data);
+    _count = 0;
+    _bytes = 0;
+  }
+
+           // The entry for glyph, an alpha map when blended is false or else the glyph
+           // blended with colors (fg << 16 | bg). NULL when not held
+  uint8_t* find(uint16_t glyph, bool blended, uint32_t colors)
+  {
+    glyph_entry_t* e = lookup(glyph, blended, colors);
+    if (!e) return NULL;
+    e->used = ++_tick;
+    _stats.hits++;
+    return e->data;
+  }
+
+           // As find() but not counted as a use
+  uint8_t* peek(uint16_t glyph, bool blended, uint32_t colors)
+  {
+    glyph_entry_t* e = lookup(glyph, blended, colors);
+    return e ? e->data : NULL;
+  }
+
+           // Room for a new entry of size bytes, to be filled by the caller. Returns NULL
+           // if it can never fit or the memory cannot be allocated
+  uint8_t* add(uint16_t glyph, bool blended, uint32_t colors, uint32_t size)
+  {
+    if (size == 0 || size > _budget) return NULL;
+
+    while (_count && (_count >= SMOOTH_FONT_CACHE_GLYPHS || _bytes + size > _budget)) evict();
+
+    uint8_t* data = (uint8_t*)_alloc(size);
+    if (!data) return NULL;
+
+    glyph_entry_t* e = &_entry[_count++];
+    e->data    = data;
+    e->size    = size;
+    e->colors  = colors;
+    e->used    = ++_tick;
+    e->glyph   = glyph;
+    e->blended = blended;
+    _bytes += size;
+    _stats.misses++;
+    return data;
+  }
+
+  uint32_t budget(void) const { return _budget; }
+
+  void     getStats(glyph_cache_stats_t* stats) const
+  {
+    *stats = _stats;
+    stats->bytes  = _bytes;
+    stats->glyphs = _count;
+  }
+
+  void     clearStats(void) { _stats.hits = _stats.misses = _stats.evictions = 0; }
+
+ private:
+
+  typedef struct {
+    uint8_t* data;
+    uint32_t size;
+    uint32_t colors;   // fg << 16 | bg of a blended entry
+    uint32_t used;     // _tick when last found or added
+    uint16_t glyph;    // Index in the font
+    bool     blended;
+  } glyph_entry_t;
+
+  glyph_entry_t* lookup(uint16_t glyph, bool blended, uint32_t colors)
+  {
+    for (uint8_t i = 0; i < _count; i++) {
+      glyph_entry_t* e = &_entry[i];
+      if (e->glyph == glyph && e->blended == blended && (!blended || e->colors == colors)) return e;
+    }
+    return NULL;
+  }
+
+           // Drop the least recently used entry
+  void     evict(void)
+  {
+    uint8_t oldest = 0;
+    for (uint8_t i = 1; i < _count; i++) {
+      if ((int32_t)(_entry[i].used - _entry[oldest].used) < 0) oldest = i;
+    }
+    free(_entry[oldest].data);
+    _bytes -= _entry[oldest].size;
+    _entry[oldest] = _entry[--_count];
+    _stats.evictions++;
+  }
+
+  uint32_t      _budget;
+  glyph_alloc_t _alloc;
+  uint8_t       _count;
+  uint32_t      _tick;
+  uint32_t      _bytes;
+  glyph_cache_stats_t _stats;
+  glyph_entry_t _entry[SMOOTH_FONT_CACHE_GLYPHS];
+};
+
+#endif // _TFT_GLYPH_CACHE_H_
@@ -245,6 +245,59 @@ void TFT_eSPI::loadMetrics(void)
   gFont.yAdvance = gFont.maxAscent + gFont.maxDescent;
 
   gFont.spaceWidth = (gFont.ascent + gFont.descent) * 2/7;  // Guess at space width
+
+  sortMetrics();
+}
+
+
+/***************************************************************************************
+** Function name:           compareGlyphKeys
+** Description:             qsort() order of (code << 16 | glyph number) keys
+*************************************************************************************x*/
+static int compareGlyphKeys(const void* a, const void* b)
+{
+  uint32_t ka = *(const uint32_t*)a, kb = *(const uint32_t*)b;
+  return (ka > kb) - (ka < kb);
+}
+
+
+/***************************************************************************************
+** Function name:           sortMetrics
+** Description:             Put the glyph codes in order so getUnicodeIndex can bisect them
+*************************************************************************************x*/
+// Fonts made by the Processing sketch list the codes in ascending order, those need no
+// extra memory. Otherwise gSorted holds the glyph numbers in code order, the first glyph
+// of a repeated code first so the same glyph is found as by a linear search. If there is
+// no memory for that the search stays linear.
+void TFT_eSPI::sortMetrics(void)
+{
+  uint16_t gNum = 1;
+  while (gNum < gFont.gCount && gUnicode[gNum - 1] < gUnicode[gNum]) gNum++;
+
+  gSearch = true;
+  if (gNum >= gFont.gCount) return;
+
+  uint32_t* key = (uint32_t*)malloc( gFont.gCount * 4);
+#if defined (ESP32) && defined (CONFIG_SPIRAM_SUPPORT)
+  if ( psramFound() ) gSorted = (uint16_t*)ps_malloc( gFont.gCount * 2);
+  else
+#endif
+  gSorted = (uint16_t*)malloc( gFont.gCount * 2);
+
+  if (key && gSorted)
+  {
+    for (gNum = 0; gNum < gFont.gCount; gNum++) key[gNum] = (uint32_t)gUnicode[gNum] << 16 | gNum;
+    qsort(key, gFont.gCount, 4, compareGlyphKeys);
+    for (gNum = 0; gNum < gFont.gCount; gNum++) gSorted[gNum] = (uint16_t)key[gNum];
+  }
+  else
+  {
+    if (gSorted) free(gSorted);
+    gSorted = NULL;
+    gSearch = false;
+  }
+
+  if (key) free(key);
 }
 
 
@@ -296,8 +349,18 @@ void TFT_eSPI::unloadFont( void )
     gBitmap = NULL;
   }
 
+  if (gSorted)
+  {
+    free(gSorted);
+    gSorted = NULL;
+  }
+
+  gSearch = false;
+
   gFont.gArray = nullptr;
 
+  if (glyphCache) glyphCache->clear();
+
 #ifdef FONT_FS_AVAILABLE
   if (fs_font && fontFile) fontFile.close();
 #endif
@@ -340,18 +403,178 @@ uint32_t TFT_eSPI::readInt32(void)
 *************************************************************************************x*/
 bool TFT_eSPI::getUnicodeIndex(uint16_t unicode, uint16_t *index)
 {
-  for (uint16_t i = 0; i < gFont.gCount; i++)
+  if (!gSearch)
   {
-    if (gUnicode[i] == unicode)
+    for (uint16_t i = 0; i < gFont.gCount; i++)
+    {
+      if (gUnicode[i] == unicode)
+      {
+        *index = i;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  if (gFont.gCount == 0) return false;
+
+  // Fonts usually start with a run of consecutive codes (e.g. printable ASCII), so when
+  // the codes are in order try where the code would be in that run before bisecting
+  if (!gSorted)
+  {
+    uint16_t i = unicode - gUnicode[0];
+    if (unicode >= gUnicode[0] && i < gFont.gCount && gUnicode[i] == unicode)
     {
       *index = i;
       return true;
     }
   }
+
+  // First position whose code is not below unicode
+  uint32_t lo = 0, hi = gFont.gCount;
+  while (lo < hi)
+  {
+    uint32_t mid = (lo + hi) >> 1;
+    uint16_t gNum = gSorted ? gSorted[mid] : mid;
+    if (gUnicode[gNum] < unicode) lo = mid + 1;
+    else hi = mid;
+  }
+
+  if (lo < gFont.gCount)
+  {
+    uint16_t gNum = gSorted ? gSorted[lo] : lo;
+    if (gUnicode[gNum] == unicode)
+    {
+      *index = gNum;
+      return true;
+    }
+  }
   return false;
 }
 
 
+/***************************************************************************************
+** Function name:           setGlyphCache
+** Description:             Keep decoded glyphs in RAM, bytes = 0 frees the cache
+*************************************************************************************x*/
+bool TFT_eSPI::setGlyphCache(uint32_t bytes, bool psram, bool blend)
+{
+  if (glyphCache)
+  {
+    delete glyphCache;
+    glyphCache = nullptr;
+  }
+  glyphBlend = blend;
+  if (bytes == 0) return true;
+
+  glyph_alloc_t alloc = malloc;
+#if defined (ESP32) && defined (CONFIG_SPIRAM_SUPPORT)
+  if (psram && psramFound()) alloc = ps_malloc;
+#else
+  (void)psram;
+#endif
+
+  // A plain new does not return NULL where exceptions are disabled, it aborts
+  glyphCache = new (std::nothrow) TFT_GlyphCache(bytes, alloc);
+  return glyphCache != nullptr;
+}
+
+
+/***************************************************************************************
+** Function name:           getGlyphCacheStats
+** Description:             Get the glyph cache hit and miss counters, zero if none
+*************************************************************************************x*/
+void TFT_eSPI::getGlyphCacheStats(glyph_cache_stats_t *stats)
+{
+  if (glyphCache) glyphCache->getStats(stats);
+  else memset(stats, 0, sizeof(glyph_cache_stats_t));
+}
+
+
+/***************************************************************************************
+** Function name:           clearGlyphCacheStats
+** Description:             Zero the glyph cache hit, miss and eviction counters
+*************************************************************************************x*/
+void TFT_eSPI::clearGlyphCacheStats(void)
+{
+  if (glyphCache) glyphCache->clearStats();
+}
+
+
+/***************************************************************************************
+** Function name:           readGlyph
+** Description:             Copy the whole alpha map of a glyph from the font to RAM
+*************************************************************************************x*/
+void TFT_eSPI::readGlyph(uint16_t gNum, uint8_t* dst)
+{
+  uint32_t size = (uint32_t)gWidth[gNum] * gHeight[gNum];
+
+#ifdef FONT_FS_AVAILABLE
+  if (fs_font)
+  {
+    fontFile.seek(gBitmap[gNum], fs::SeekSet);
+    fontFile.read(dst, size);
+    return;
+  }
+#endif
+
+  const uint8_t* gPtr = (const uint8_t*) gFont.gArray + gBitmap[gNum];
+  for (uint32_t i = 0; i < size; i++) dst[i] = pgm_read_byte(gPtr + i);
+}
+
+
+/***************************************************************************************
+** Function name:           cachedGlyph
+** Description:             Alpha map of a glyph from the cache, read in if not held
+*************************************************************************************x*/
+const uint8_t* TFT_eSPI::cachedGlyph(uint16_t gNum)
+{
+  if (!glyphCache) return nullptr;
+
+  uint8_t* map = glyphCache->find(gNum, false, 0);
+  if (map) return map;
+
+  map = glyphCache->add(gNum, false, 0, (uint32_t)gWidth[gNum] * gHeight[gNum]);
+  if (map) readGlyph(gNum, map);
+  return map;
+}
+
+
+/***************************************************************************************
+** Function name:           blendedGlyph
+** Description:             A glyph blended as fg on bg from the cache, made if not held
+*************************************************************************************x*/
+// The pixels are exactly those drawGlyph() plots when the background is filled
+const uint16_t* TFT_eSPI::blendedGlyph(uint16_t gNum, uint16_t fg, uint16_t bg)
+{
+  if (!glyphCache || !glyphBlend) return nullptr;
+
+  uint32_t colors = (uint32_t)fg << 16 | bg;
+  uint16_t* img = (uint16_t*)glyphCache->find(gNum, true, colors);
+  if (img) return img;
+
+  uint32_t size = (uint32_t)gWidth[gNum] * gHeight[gNum];
+  img = (uint16_t*)glyphCache->add(gNum, true, colors, size * 2);
+  if (!img) return nullptr;
+
+  // Put the alpha map in the top half, each pixel is then blended down over alpha
+  // values already used
+  uint8_t* alpha = (uint8_t*)img + size;
+  const uint8_t* map = glyphCache->peek(gNum, false, 0);
+  if (map) memcpy(alpha, map, size);
+  else readGlyph(gNum, alpha);
+
+  for (uint32_t i = 0; i < size; i++)
+  {
+    uint8_t pixel = alpha[i];
+    if (pixel == 0xFF) img[i] = fg;
+    else if (pixel == 0) img[i] = bg;
+    else img[i] = alphaBlend(pixel, fg, bg);
+  }
+  return img;
+}
+
+
 /***************************************************************************************
 ** Function name:           drawGlyph
 ** Description:             Write a character to the TFT cursor position
@@ -407,17 +630,24 @@ void TFT_eSPI::drawGlyph(uint16_t code)
     uint8_t* pbuffer = nullptr;
     const uint8_t* gPtr = (const uint8_t*) gFont.gArray;
 
+    int16_t cy = cursor_y + gFont.maxAscent - gdY[gNum];
+    int16_t cx = cursor_x + gdX[gNum];
+
+    // Opaque text over a plain background is pushed as one pre-blended image, otherwise
+    // the alpha map is read from the cache rather than the font
+    const uint16_t* bmap = nullptr;
+    const uint8_t*  amap = nullptr;
+    if (_fillbg && !getColor && bg_cursor_x <= cx) bmap = blendedGlyph(gNum, fg, bg);
+    if (!bmap) amap = cachedGlyph(gNum);
+
 #ifdef FONT_FS_AVAILABLE
-    if (fs_font)
+    if (fs_font && !bmap && !amap)
     {
       fontFile.seek(gBitmap[gNum], fs::SeekSet);
       pbuffer =  (uint8_t*)malloc(gWidth[gNum]);
     }
 #endif
 
-    int16_t cy = cursor_y + gFont.maxAscent - gdY[gNum];
-    int16_t cx = cursor_x + gdX[gNum];
-
     //  if (cx > width() && bg_cursor_x > width()) return;
     //  if (cursor_y > height()) return;
 
@@ -428,7 +658,10 @@ void TFT_eSPI::drawGlyph(uint16_t code)
     int16_t  bx = 0;
     uint8_t pixel;
 
-    startWrite(); // Avoid slow ESP32 transaction overhead for every pixel
+    // Avoid slow ESP32 transaction overhead for every pixel, the non-inlined calls do
+    // nothing in classes that override them to draw off screen
+    begin_nin_write();
+    inTransaction = true;
 
     int16_t fillwidth  = 0;
     int16_t fillheight = 0;
@@ -458,10 +691,17 @@ void TFT_eSPI::drawGlyph(uint16_t code)
       }
     }
 
-    for (int32_t y = 0; y < gHeight[gNum]; y++)
+    if (bmap)
+    {
+      bool swap = _swapBytes;
+      _swapBytes = true;
+      pushImage(cx, cy, gWidth[gNum], gHeight[gNum], (uint16_t*)bmap);
+      _swapBytes = swap;
+    }
+    else for (int32_t y = 0; y < gHeight[gNum]; y++)
     {
 #ifdef FONT_FS_AVAILABLE
-      if (fs_font) {
+      if (pbuffer) {
         if (spiffs)
         {
           fontFile.read(pbuffer, gWidth[gNum]);
@@ -469,9 +709,11 @@ void TFT_eSPI::drawGlyph(uint16_t code)
         }
         else
         {
-          endWrite();    // Release SPI for SD card transaction
+          inTransaction = false;
+          end_nin_write();   // Release SPI for SD card transaction
           fontFile.read(pbuffer, gWidth[gNum]);
-          startWrite();  // Re-start SPI for TFT transaction
+          begin_nin_write(); // Re-start SPI for TFT transaction
+          inTransaction = true;
           //Serial.println("Not SPIFFS");
         }
       }
@@ -479,8 +721,10 @@ void TFT_eSPI::drawGlyph(uint16_t code)
 
       for (int32_t x = 0; x < gWidth[gNum]; x++)
       {
+        if (amap) pixel = amap[x + gWidth[gNum] * y];
+        else
 #ifdef FONT_FS_AVAILABLE
-        if (fs_font) pixel = pbuffer[x];
+        if (pbuffer) pixel = pbuffer[x];
         else
 #endif
         pixel = pgm_read_byte(gPtr + gBitmap[gNum] + x + gWidth[gNum] * y);
@@ -529,7 +773,8 @@ void TFT_eSPI::drawGlyph(uint16_t code)
 
     if (pbuffer) free(pbuffer);
     cursor_x += gxAdvance[gNum];
-    endWrite();
+    inTransaction = lockTransaction;
+    end_nin_write();
   }
   else
   {
@@ -16,6 +16,14 @@
 
   void     showFont(uint32_t td);
 
+           // Keep up to bytes of decoded glyphs in RAM so drawing them again does not read the
+           // font, 0 frees the cache. psram places the glyphs in PSRAM if fitted. blend also
+           // keeps glyphs blended in the text colours, pushed as one image when the background
+           // is filled. The cache is emptied when the font is unloaded.
+  bool     setGlyphCache(uint32_t bytes, bool psram = false, bool blend = true);
+  void     getGlyphCacheStats(glyph_cache_stats_t *stats);
+  void     clearGlyphCacheStats(void);
+
  // This is for the whole font
   typedef struct
   {
@@ -39,6 +47,7 @@ fontMetrics gFont = { nullptr, 0, 0, 0, 0, 0, 0, 0 };
   int16_t*  gdY = NULL;       //topExtent
   int8_t*   gdX = NULL;       //leftExtent
   uint32_t* gBitmap = NULL;   //file pointer to greyscale bitmap
+  uint16_t* gSorted = NULL;   //glyph numbers in code order when gUnicode is not in order itself
 
   bool     fontLoaded = false; // Flags when a anti-aliased font is loaded
 
@@ -55,7 +64,18 @@ fontMetrics gFont = { nullptr, 0, 0, 0, 0, 0, 0, 0 };
   private:
 
   void     loadMetrics(void);
+  void     sortMetrics(void);
   uint32_t readInt32(void);
 
+           // Glyph gNum from the cache, added if there is room. NULL if not cached
+  void     readGlyph(uint16_t gNum, uint8_t* dst);
+  const uint8_t*  cachedGlyph(uint16_t gNum);
+  const uint16_t* blendedGlyph(uint16_t gNum, uint16_t fg, uint16_t bg);
+
+  TFT_GlyphCache* glyphCache = nullptr;
+  bool     glyphBlend = false;
+
+  bool     gSearch = false;    // Codes are in order (in gUnicode or via gSorted) so can be bisected
+
   uint8_t* fontPtr = nullptr;
 
@@ -0,0 +1,261 @@
+/***************************************************************************************
+// Span kernels for 16-bit sprites: fill, byte swapped copy, transparent key copy and
+// 8-bit alpha blend over runs of RGB565 pixels. Pixels are handled a word at a time
+// (SWAR), two or four per access, with a scalar loop only for the unaligned ends.
+//
+// Each kernel has a plain per-pixel ...Ref() version with exactly the same result, the
+// kernels are checked against them (see sim/gfx/SpanCheck.cpp).
+//
+// On the ESP32-S3 defining TFT_SPAN_PIE uses the 128-bit PIE vector stores for fills.
+// That and the unaligned loads on x86 and AArch64 hosts are the only target specific
+// paths. Build the host checks with TFT_SPAN_ALIGNED to cover the aligned word code the
+// microcontrollers run.
+***************************************************************************************/
+
+#ifndef _TFT_SPAN_KERNELS_H_
+#define _TFT_SPAN_KERNELS_H_
+
+#include <stdint.h>
+#include <string.h>
+
+// Words hold the lower addressed pixel in the low half, every processor the library
+// supports is little endian
+#if defined (__BYTE_ORDER__) && (__BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__)
+  #error >>>>------>> The span kernels assume a little endian processor
+#endif
+
+// Word accesses to pixel buffers, which are only known to be uint16_t arrays
+typedef uint32_t __attribute__((__may_alias__)) span_word32_t;
+#if UINTPTR_MAX > 0xFFFFFFFFu
+  typedef uint64_t __attribute__((__may_alias__)) span_word_t;
+#else
+  typedef uint32_t __attribute__((__may_alias__)) span_word_t;
+#endif
+
+// Hosts where a word load at any pixel address costs the same as an aligned one.
+// Defining TFT_SPAN_ALIGNED builds the aligned loads the microcontrollers use instead
+#if (defined (__x86_64__) || defined (__i386__) || defined (__aarch64__)) && !defined (TFT_SPAN_ALIGNED)
+  #define SPAN_UNALIGNED_LOADS
+#endif
+
+#if defined (TFT_SPAN_PIE) && defined (CONFIG_IDF_TARGET_ESP32S3)
+  #define SPAN_PIE_FILL
+#endif
+
+/***************************************************************************************
+** Function name:           spanAlphaBlend
+** Description:             Blend 16bit foreground and background, as alphaBlend()
+***************************************************************************************/
+inline uint16_t spanAlphaBlend(uint8_t alpha, uint16_t fgc, uint16_t bgc)
+{
+  uint32_t rxb = bgc & 0xF81F;
+  rxb += ((fgc & 0xF81F) - rxb) * (alpha >> 2) >> 6;
+  uint32_t xgx = bgc & 0x07E0;
+  xgx += ((fgc & 0x07E0) - xgx) * alpha >> 8;
+  return (rxb & 0xF81F) | (xgx & 0x07E0);
+}
+
+/***************************************************************************************
+** Function name:           spanSwap32
+** Description:             Swap the bytes of both pixels in a word
+***************************************************************************************/
+inline uint32_t spanSwap32(uint32_t w)
+{
+  return ((w & 0x00FF00FF) << 8) | ((w >> 8) & 0x00FF00FF);
+}
+
+/***************************************************************************************
+** Function name:           spanLoad32
+** Description:             Load two pixels that may not be word aligned
+***************************************************************************************/
+inline uint32_t spanLoad32(const uint16_t* p)
+{
+#ifdef SPAN_UNALIGNED_LOADS
+  uint32_t w;
+  memcpy(&w, p, 4);
+  return w;
+#else
+  if (((uintptr_t)p & 3) == 0) return *(const span_word32_t*)p;
+  return p[0] | (uint32_t)p[1] << 16;
+#endif
+}
+
+/***************************************************************************************
+** Function name:           spanFill16Ref
+** Description:             Set len pixels to color, one at a time
+***************************************************************************************/
+inline void spanFill16Ref(uint16_t* dst, uint16_t color, uint32_t len)
+{
+  while (len--) *dst++ = color;
+}
+
+/***************************************************************************************
+** Function name:           spanFill16
+** Description:             Set len pixels to color (in the byte order of the buffer)
+***************************************************************************************/
+inline void spanFill16(uint16_t* dst, uint16_t color, uint32_t len)
+{
+  // Align to the word size
+  while (len && ((uintptr_t)dst & (sizeof(span_word_t) - 1))) { *dst++ = color; len--; }
+
+#ifdef SPAN_PIE_FILL
+  // Align to the 16 byte vector size then store 8 pixels at a time
+  while (len && ((uintptr_t)dst & 15)) { *dst++ = color; len--; }
+  uint32_t blocks = len >> 3;
+  if (blocks) {
+    uint16_t c = color;
+    __asm__ __volatile__ (
+      "ee.vldbc.16     q0, %1       \n"
+      "loopnez         %2, 1f       \n"
+      "ee.vst.128.ip   q0, %0, 16   \n"
+      "1:                           \n"
+      : "+r" (dst) : "r" (&c), "r" (blocks) : "memory");
+    len &= 7;
+  }
+#endif
+
+  span_word_t w = color;
+  w |= w << 16;
+  if (sizeof(span_word_t) > 4) w |= w << 16 << 16;
+  const uint32_t perWord = sizeof(span_word_t) / 2;
+
+  span_word_t* wp = (span_word_t*)dst;
+  while (len >= perWord * 4) { wp[0] = w; wp[1] = w; wp[2] = w; wp[3] = w; wp += 4; len -= perWord * 4; }
+  while (len >= perWord) { *wp++ = w; len -= perWord; }
+
+  dst = (uint16_t*)wp;
+  while (len--) *dst++ = color;
+}
+
+/***************************************************************************************
+** Function name:           spanCopySwap16Ref
+** Description:             Copy len pixels swapping the bytes of each, one at a time
+***************************************************************************************/
+inline void spanCopySwap16Ref(uint16_t* dst, const uint16_t* src, uint32_t len)
+{
+  while (len--) { uint16_t c = *src++; *dst++ = c << 8 | c >> 8; }
+}
+
+/***************************************************************************************
+** Function name:           spanCopySwap16
+** Description:             Copy len pixels swapping the bytes of each
+***************************************************************************************/
+inline void spanCopySwap16(uint16_t* dst, const uint16_t* src, uint32_t len)
+{
+  if (len && ((uintptr_t)dst & 3)) { uint16_t c = *src++; *dst++ = c << 8 | c >> 8; len--; }
+
+  span_word32_t* wp = (span_word32_t*)dst;
+  if (((uintptr_t)src & 3) == 0) {
+    const span_word32_t* sp = (const span_word32_t*)src;
+    while (len >= 8) {
+      uint32_t a = sp[0], b = sp[1], c = sp[2], d = sp[3];
+      wp[0] = spanSwap32(a); wp[1] = spanSwap32(b); wp[2] = spanSwap32(c); wp[3] = spanSwap32(d);
+      sp += 4; wp += 4; len -= 8;
+    }
+    while (len >= 2) { *wp++ = spanSwap32(*sp++); len -= 2; }
+    src = (const uint16_t*)sp;
+  }
+#ifdef SPAN_UNALIGNED_LOADS
+  else {
+    while (len >= 2) { *wp++ = spanSwap32(spanLoad32(src)); src += 2; len -= 2; }
+  }
+#else
+  else if (len >= 3) {
+    // Source is half a word out: carry one pixel and load whole words after it
+    uint32_t carry = *src++;
+    const span_word32_t* sp = (const span_word32_t*)src;
+    while (len >= 3) {
+      uint32_t s = *sp++;
+      *wp++ = spanSwap32(carry | s << 16);
+      carry = s >> 16;
+      len -= 2;
+    }
+    src = (const uint16_t*)sp;
+    dst = (uint16_t*)wp;
+    *dst++ = (uint16_t)(carry << 8 | carry >> 8);
+    len--;
+    wp = (span_word32_t*)dst;
+  }
+#endif
+
+  dst = (uint16_t*)wp;
+  while (len--) { uint16_t c = *src++; *dst++ = c << 8 | c >> 8; }
+}
+
+/***************************************************************************************
+** Function name:           spanCopyKey16Ref
+** Description:             Copy len pixels except those equal to key, one at a time
+***************************************************************************************/
+inline void spanCopyKey16Ref(uint16_t* dst, const uint16_t* src, uint32_t len, uint16_t key)
+{
+  while (len--) { uint16_t c = *src++; if (c != key) *dst = c; dst++; }
+}
+
+/***************************************************************************************
+** Function name:           spanCopyKey16
+** Description:             Copy len pixels except those equal to key (transparent)
+***************************************************************************************/
+inline void spanCopyKey16(uint16_t* dst, const uint16_t* src, uint32_t len, uint16_t key)
+{
+  if (len && ((uintptr_t)dst & 3)) { uint16_t c = *src++; if (c != key) *dst = c; dst++; len--; }
+
+  uint32_t kk = key | (uint32_t)key << 16;
+  span_word32_t* wp = (span_word32_t*)dst;
+  while (len >= 2) {
+    uint32_t s = spanLoad32(src);
+    uint32_t x = s ^ kk;           // A lane is zero where the pixel is the key
+    if ((x & 0xFFFF) && (x >> 16)) *wp = s;
+    else if (x) {
+      if (x & 0xFFFF) ((uint16_t*)wp)[0] = (uint16_t)s;
+      else            ((uint16_t*)wp)[1] = (uint16_t)(s >> 16);
+    }
+    wp++; src += 2; len -= 2;
+  }
+
+  dst = (uint16_t*)wp;
+  if (len && *src != key) *dst = *src;
+}
+
+/***************************************************************************************
+** Function name:           spanBlend16Ref
+** Description:             Blend src over dst with alpha, one pixel at a time
+***************************************************************************************/
+// Pixels are in sprite order (bytes swapped), alpha 255 is the source and 0 the destination
+inline void spanBlend16Ref(uint16_t* dst, const uint16_t* src, uint32_t len, uint8_t alpha)
+{
+  while (len--) {
+    uint16_t fg = *src++, bg = *dst;
+    uint16_t c = spanAlphaBlend(alpha, fg << 8 | fg >> 8, bg << 8 | bg >> 8);
+    *dst++ = c << 8 | c >> 8;
+  }
+}
+
+/***************************************************************************************
+** Function name:           spanBlend16
+** Description:             Blend src over dst with alpha, two pixels per word
+***************************************************************************************/
+// Same result as spanBlend16Ref(). Each channel of both pixels sits in its own 16-bit
+// lane and is blended as (bg * (1 - a) + fg * a), which equals the rounding of
+// alphaBlend() exactly: 6-bit alpha for red and blue, 8-bit alpha for green.
+inline void spanBlend16(uint16_t* dst, const uint16_t* src, uint32_t len, uint8_t alpha)
+{
+  if (alpha == 0) return;
+  if (len && ((uintptr_t)dst & 3)) { spanBlend16Ref(dst++, src++, 1, alpha); len--; }
+
+  uint32_t a6 = alpha >> 2, ia6 = 64 - a6;
+  uint32_t a8 = alpha,      ia8 = 256 - a8;
+  span_word32_t* wp = (span_word32_t*)dst;
+  while (len >= 2) {
+    uint32_t f = spanSwap32(spanLoad32(src));
+    uint32_t b = spanSwap32(*wp);
+    uint32_t bl = ((( b        & 0x001F001F) * ia6 + ( f        & 0x001F001F) * a6) >> 6) & 0x001F001F;
+    uint32_t rd = ((((b >> 11) & 0x001F001F) * ia6 + ((f >> 11) & 0x001F001F) * a6) >> 6) & 0x001F001F;
+    uint32_t gr = ((((b >>  5) & 0x003F003F) * ia8 + ((f >>  5) & 0x003F003F) * a8) >> 8) & 0x003F003F;
+    *wp++ = spanSwap32(rd << 11 | gr << 5 | bl);
+    src += 2; len -= 2;
+  }
+
+  if (len) spanBlend16Ref((uint16_t*)wp, src, 1, alpha);
+}
+
+#endif // _TFT_SPAN_KERNELS_H_
@@ -36,6 +36,8 @@ TFT_eSprite::TFT_eSprite(TFT_eSPI *tft)
 
   _colorMap = nullptr;
 
+  _dirtyTrack = false;
+
   _psram_enable = true;
   
   // Ensure end_tft_write() does nothing in inherited functions.
@@ -104,6 +106,8 @@ void* TFT_eSprite::createSprite(int16_t w, int16_t h, uint8_t frames)
     rotation = 0;
     setViewport(0, 0, _dwidth, _dheight);
     setPivot(_iwidth/2, _iheight/2);
+    _dirty.clear();
+    damage(0, 0, _dwidth, _dheight);
     return _img8_1;
   }
 
@@ -139,9 +143,11 @@ bool TFT_eSprite::created(void)
 TFT_eSprite::~TFT_eSprite(void)
 {
   deleteSprite();
+  deleteGlyphAtlas();
 
 #ifdef SMOOTH_FONT
   if(fontLoaded) unloadFont();
+  setGlyphCache(0);
 #endif
 }
 
@@ -290,6 +296,9 @@ void* TFT_eSprite::frameBuffer(int8_t f)
 
   if (_bpp == 4) _img4 = _img8;
 
+  // Damage recorded so far was against the other frame
+  damage(0, 0, _dwidth, _dheight);
+
   return _img8;
 }
 
@@ -383,6 +392,7 @@ void TFT_eSprite::deleteSprite(void)
     free(_img8_1);
     _img8 = nullptr;
     _created = false;
+    _dirty.clear();
     _vpOoB   = true;  // TFT_eSPI class write() uses this to check for valid sprite
   }
 }
@@ -406,56 +416,7 @@ bool TFT_eSprite::pushRotated(int16_t angle, uint32_t transp)
   // Get the bounding box of this rotated source Sprite relative to Sprite pivot
   if ( !getRotatedBounds(angle, &min_x, &min_y, &max_x, &max_y) ) return false;
 
-  uint16_t sline_buffer[max_x - min_x + 1];
-
-  int32_t xt = min_x - _tft->_xPivot;
-  int32_t yt = min_y - _tft->_yPivot;
-  uint32_t xe = _dwidth << FP_SCALE;
-  uint32_t ye = _dheight << FP_SCALE;
-  uint16_t tpcolor = (uint16_t)transp;
-
-  if (transp != 0x00FFFFFF) {
-    if (_bpp == 4) tpcolor = _colorMap[transp & 0x0F];
-    tpcolor = tpcolor>>8 | tpcolor<<8; // Working with swapped color bytes
-  }
-  _tft->startWrite(); // Avoid transaction overhead for every tft pixel
-
-  // Scan destination bounding box and fetch transformed pixels from source Sprite
-  for (int32_t y = min_y; y <= max_y; y++, yt++) {
-    int32_t x = min_x;
-    uint32_t xs = (_cosra * xt - (_sinra * yt - (_xPivot << FP_SCALE)) + (1 << (FP_SCALE - 1)));
-    uint32_t ys = (_sinra * xt + (_cosra * yt + (_yPivot << FP_SCALE)) + (1 << (FP_SCALE - 1)));
-
-    while ((xs >= xe || ys >= ye) && x < max_x) { x++; xs += _cosra; ys += _sinra; }
-    if (x == max_x) continue;
-
-    uint32_t pixel_count = 0;
-    do {
-      uint32_t rp;
-      int32_t xp = xs >> FP_SCALE;
-      int32_t yp = ys >> FP_SCALE;
-      if (_bpp == 16) {rp = _img[xp + yp * _iwidth]; }
-      else { rp = readPixel(xp, yp); rp = (uint16_t)(rp>>8 | rp<<8); }
-      if (transp != 0x00FFFFFF && tpcolor == rp) {
-        if (pixel_count) {
-          // TFT window is already clipped, so this is faster than pushImage()
-          _tft->setWindow(x - pixel_count, y, x - 1, y);
-          _tft->pushPixels(sline_buffer, pixel_count);
-          pixel_count = 0;
-        }
-      }
-      else {
-        sline_buffer[pixel_count++] = rp;
-      }
-    } while (++x < max_x && (xs += _cosra) < xe && (ys += _sinra) < ye);
-    if (pixel_count) {
-      // TFT window is already clipped, so this is faster than pushImage()
-      _tft->setWindow(x - pixel_count, y, x - 1, y);
-      _tft->pushPixels(sline_buffer, pixel_count);
-    }
-  }
-
-  _tft->endWrite(); // End transaction
+  pushAffine(nullptr, min_x, min_y, max_x, max_y + 1, _cosra, _sinra, FP_SCALE, transp, false);
 
   return true;
 }
@@ -480,51 +441,293 @@ bool TFT_eSprite::pushRotated(TFT_eSprite *spr, int16_t angle, uint32_t transp)
   // Get the bounding box of this rotated source Sprite
   if ( !getRotatedBounds(spr, angle, &min_x, &min_y, &max_x, &max_y) ) return false;
 
-  uint16_t sline_buffer[max_x - min_x + 1];
+  pushAffine(spr, min_x, min_y, max_x, max_y + 1, _cosra, _sinra, FP_SCALE, transp, false);
+
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           pushTransformed
+** Description:             Push a rotated and scaled copy of the Sprite to the TFT
+***************************************************************************************/
+#define FP_SCALE_FINE 16 // Scaled copies step in finer fractions to stay true over large areas
+bool TFT_eSprite::pushTransformed(int16_t angle, float scale, uint32_t transp, bool smooth)
+{
+  return pushTransformed(nullptr, angle, scale, transp, smooth);
+}
+
+
+/***************************************************************************************
+** Function name:           pushTransformed
+** Description:             Push a rotated and scaled copy of the Sprite to another Sprite
+***************************************************************************************/
+// The TFT if spr is nullptr. The destination Sprite cannot be 4bpp
+bool TFT_eSprite::pushTransformed(TFT_eSprite *spr, int16_t angle, float scale, uint32_t transp, bool smooth)
+{
+  if ( !_created || !(scale > 0.0f)) return false;
+  if (spr) { if ( !spr->_created || spr->_bpp == 4) return false; }
+  else if (_tft->_vpOoB) return false;
+
+  // Bounding box of the scaled Sprite relative to its (scaled) pivot
+  int16_t min_x;
+  int16_t min_y;
+  int16_t max_x;
+  int16_t max_y;
+  getRotatedBounds(angle, width() * scale + 1, height() * scale + 1, _xPivot * scale, _yPivot * scale,
+                   &min_x, &min_y, &max_x, &max_y);
+
+  // Move bounding box so source Sprite pivot coincides with destination pivot
+  TFT_eSPI* dst = spr ? (TFT_eSPI*)spr : _tft;
+
+  // Source steps for each destination pixel, the inverse of the scale
+  float radAngle = -angle * 0.0174532925;
+  int32_t ca = round(cos(radAngle) / scale * (1<<FP_SCALE_FINE));
+  int32_t sa = round(sin(radAngle) / scale * (1<<FP_SCALE_FINE));
+
+  return pushAffine(spr, min_x + dst->_xPivot, min_y + dst->_yPivot, max_x + dst->_xPivot + 1, max_y + dst->_yPivot + 1,
+                    ca, sa, FP_SCALE_FINE, transp, smooth);
+}
+
+
+/***************************************************************************************
+** Function name:           affineClip
+** Description:             Narrow steps k0 to k1 to those where 0 <= v + k * dv < lim
+***************************************************************************************/
+// v + k * dv is linear in k so the steps inside the Sprite are always one run. False if none
+static bool affineClip(int64_t v, int32_t dv, int64_t lim, int32_t *k0, int32_t *k1)
+{
+  int64_t lo = *k0, hi = *k1;
+
+  if (dv > 0) {
+    if (v < 0) { int64_t k = (-v + dv - 1) / dv; if (k > lo) lo = k; }
+    if (lim - 1 - v < 0) return false;
+    int64_t k = (lim - 1 - v) / dv; if (k < hi) hi = k;
+  }
+  else if (dv < 0) {
+    if (v >= lim) { int64_t k = (v - lim - dv) / -dv; if (k > lo) lo = k; }
+    if (v < 0) return false;
+    int64_t k = v / -dv; if (k < hi) hi = k;
+  }
+  else if (v < 0 || v >= lim) return false;
+
+  if (lo > hi) return false;
+  *k0 = lo;
+  *k1 = hi;
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           sourcePixel
+** Description:             Read a pixel of this Sprite as 16 bit colour, no clipping
+***************************************************************************************/
+// Memory coordinates, as readPixel() without the viewport and datum
+inline uint16_t TFT_eSprite::sourcePixel(int32_t x, int32_t y)
+{
+  if (_bpp == 16)
+  {
+    uint16_t color = _img[x + y * _iwidth];
+    return (color >> 8) | (color << 8);
+  }
+
+  if (_bpp == 8)
+  {
+    uint16_t color = _img8[x + y * _iwidth];
+    if (color != 0)
+    {
+    uint8_t  blue[] = {0, 11, 21, 31};
+      color =   (color & 0xE0)<<8 | (color & 0xC0)<<5
+              | (color & 0x1C)<<6 | (color & 0x1C)<<3
+              | blue[color & 0x03];
+    }
+    return color;
+  }
+
+  if (_bpp == 4)
+  {
+    if ((x & 0x01) == 0)
+      return _colorMap[_img4[((x+y*_iwidth)>>1)] >> 4];   // even index = bits 7 .. 4
+    else
+      return _colorMap[_img4[((x+y*_iwidth)>>1)] & 0x0F]; // odd index = bits 3 .. 0.
+  }
+
+  // 1bpp
+  if (rotation == 1)
+  {
+    int32_t tx = x;
+    x = _dheight - y - 1;
+    y = tx;
+  }
+  else if (rotation == 2)
+  {
+    x = _dwidth - x - 1;
+    y = _dheight - y - 1;
+  }
+  else if (rotation == 3)
+  {
+    int32_t tx = x;
+    x = y;
+    y = _dwidth - tx - 1;
+  }
+
+  if ((_img8[(x + y * _bitwidth)>>3] << (x & 0x7)) & 0x80) return _tft->bitmap_fg;
+  else return _tft->bitmap_bg;
+}
+
+
+/***************************************************************************************
+** Function name:           readAffine
+** Description:             Read n pixels stepping through the Sprite in fixed point
+***************************************************************************************/
+// Colours are byte swapped, ready to push. The nearest pixel is taken, or if smooth the
+// four around the point are blended with transp (if set) replaced by the nearest colour
+void TFT_eSprite::readAffine(uint16_t *buf, int32_t n, uint32_t xs, uint32_t ys, int32_t dx, int32_t dy,
+                             uint8_t fp, uint32_t transp, bool smooth)
+{
+  if (!smooth) {
+    if (_bpp == 16) {
+      for (int32_t i = 0; i < n; i++, xs += dx, ys += dy) buf[i] = _img[(xs >> fp) + (ys >> fp) * _iwidth];
+    }
+    else {
+      for (int32_t i = 0; i < n; i++, xs += dx, ys += dy) {
+        uint16_t color = sourcePixel(xs >> fp, ys >> fp);
+        buf[i] = color>>8 | color<<8;
+      }
+    }
+    return;
+  }
 
-  int32_t xt = min_x - spr->_xPivot;
-  int32_t yt = min_y - spr->_yPivot;
-  uint32_t xe = _dwidth << FP_SCALE;
-  uint32_t ye = _dheight << FP_SCALE;
+  // Sample points are offset half a pixel so blending is between pixel centres
+  int32_t half = 1 << (fp - 1);
+  for (int32_t i = 0; i < n; i++, xs += dx, ys += dy) {
+    int32_t u  = (int32_t)xs - half;
+    int32_t v  = (int32_t)ys - half;
+    int32_t x0 = u >> fp, y0 = v >> fp;
+    uint32_t fx = (u >> (fp - 5)) & 31, fy = (v >> (fp - 5)) & 31; // 5 bit weights
+    int32_t x1 = x0 + 1, y1 = y0 + 1;
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 >= _dwidth)  x1 = _dwidth - 1;
+    if (y1 >= _dheight) y1 = _dheight - 1;
+
+    uint16_t c00, c01, c10, c11;
+    if (_bpp == 16) {
+      const uint16_t* r0 = _img + y0 * _iwidth;
+      const uint16_t* r1 = _img + y1 * _iwidth;
+      c00 = r0[x0]; c00 = c00>>8 | c00<<8;
+      c01 = r0[x1]; c01 = c01>>8 | c01<<8;
+      c10 = r1[x0]; c10 = c10>>8 | c10<<8;
+      c11 = r1[x1]; c11 = c11>>8 | c11<<8;
+    }
+    else {
+      c00 = sourcePixel(x0, y0); c01 = sourcePixel(x1, y0);
+      c10 = sourcePixel(x0, y1); c11 = sourcePixel(x1, y1);
+    }
+    uint16_t cn  = fy < 16 ? (fx < 16 ? c00 : c01) : (fx < 16 ? c10 : c11);
+
+    if (transp != 0x00FFFFFF) {
+      if (cn == transp) { buf[i] = cn>>8 | cn<<8; continue; }
+      if (c00 == transp) c00 = cn;
+      if (c01 == transp) c01 = cn;
+      if (c10 == transp) c10 = cn;
+      if (c11 == transp) c11 = cn;
+    }
+
+    // Blend with the 565 fields spread out (green in the top half) so they cannot carry
+    uint32_t e00 = (c00 | (uint32_t)c00 << 16) & 0x07E0F81F, e01 = (c01 | (uint32_t)c01 << 16) & 0x07E0F81F;
+    uint32_t e10 = (c10 | (uint32_t)c10 << 16) & 0x07E0F81F, e11 = (c11 | (uint32_t)c11 << 16) & 0x07E0F81F;
+    uint32_t top = ((e00 * (32 - fx) + e01 * fx) >> 5) & 0x07E0F81F;
+    uint32_t bot = ((e10 * (32 - fx) + e11 * fx) >> 5) & 0x07E0F81F;
+    uint32_t mix = ((top * (32 - fy) + bot * fy) >> 5) & 0x07E0F81F;
+    uint16_t color = mix | mix >> 16;
+    buf[i] = color>>8 | color<<8;
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           pushAffine
+** Description:             Push a rotated and/or scaled copy of the Sprite a line at a time
+***************************************************************************************/
+// Destination x,y with xt,yt relative to the destination pivot reads the Sprite at
+// xs = ca * xt - sa * yt and ys = sa * xt + ca * yt from its pivot, in fixed point with fp
+// fraction bits. The run of each line inside the Sprite is found directly, then read and
+// pushed in one go (spans between transparent pixels). To the TFT if spr is nullptr.
+// The area is min_x <= x < max_x, min_y <= y < max_y, clipped here to the destination
+bool TFT_eSprite::pushAffine(TFT_eSprite *spr, int32_t min_x, int32_t min_y, int32_t max_x, int32_t max_y,
+                             int32_t ca, int32_t sa, uint8_t fp, uint32_t transp, bool smooth)
+{
+  TFT_eSPI* dst = spr ? (TFT_eSPI*)spr : _tft;
+
+  // Clip to the TFT viewport, or the destination Sprite as its pushImage() clips to a viewport
+  if (spr) {
+    if (min_x < 0) min_x = 0;
+    if (min_y < 0) min_y = 0;
+    if (max_x > spr->width())  max_x = spr->width();
+    if (max_y > spr->height()) max_y = spr->height();
+  }
+  else {
+    if (min_x < _tft->_vpX) min_x = _tft->_vpX;
+    if (min_y < _tft->_vpY) min_y = _tft->_vpY;
+    if (max_x > _tft->_vpW) max_x = _tft->_vpW;
+    if (max_y > _tft->_vpH) max_y = _tft->_vpH;
+  }
+  if (min_x >= max_x || min_y >= max_y) return false;
+
+  uint16_t sline_buffer[max_x - min_x];
+
+  int32_t xt = min_x - dst->_xPivot;
+  int32_t yt = min_y - dst->_yPivot;
+  int64_t xe = (int64_t)_dwidth << fp;
+  int64_t ye = (int64_t)_dheight << fp;
+  int32_t half = 1 << (fp - 1);
   uint16_t tpcolor = (uint16_t)transp;
-  
+
   if (transp != 0x00FFFFFF) {
     if (_bpp == 4) tpcolor = _colorMap[transp & 0x0F];
+    transp = tpcolor;                   // For readAffine()
     tpcolor = tpcolor>>8 | tpcolor<<8; // Working with swapped color bytes
   }
 
-  bool oldSwapBytes = spr->getSwapBytes();
-  spr->setSwapBytes(false);
+  bool oldSwapBytes = dst->getSwapBytes();
+  if (spr) spr->setSwapBytes(false);
+  else _tft->startWrite(); // Avoid transaction overhead for every tft pixel
 
   // Scan destination bounding box and fetch transformed pixels from source Sprite
-  for (int32_t y = min_y; y <= max_y; y++, yt++) {
-    int32_t x = min_x;
-    uint32_t xs = (_cosra * xt - (_sinra * yt - (_xPivot << FP_SCALE)) + (1 << (FP_SCALE - 1)));
-    uint32_t ys = (_sinra * xt + (_cosra * yt + (_yPivot << FP_SCALE)) + (1 << (FP_SCALE - 1)));
-
-    while ((xs >= xe || ys >= ye) && x < max_x) { x++; xs += _cosra; ys += _sinra; }
-    if (x == max_x) continue;
-
-    uint32_t pixel_count = 0;
-    do {
-      uint32_t rp;
-      int32_t xp = xs >> FP_SCALE;
-      int32_t yp = ys >> FP_SCALE;
-      if (_bpp == 16) rp = _img[xp + yp * _iwidth];
-      else { rp = readPixel(xp, yp); rp = (uint16_t)(rp>>8 | rp<<8); }
-      if (transp != 0x00FFFFFF && tpcolor == rp) {
-        if (pixel_count) {
-          spr->pushImage(x - pixel_count, y, pixel_count, 1, sline_buffer);
-          pixel_count = 0;
-        }
+  for (int32_t y = min_y; y < max_y; y++, yt++) {
+    int64_t xs = (int64_t)ca * xt - ((int64_t)sa * yt - (int64_t)_xPivot * (1 << fp)) + half;
+    int64_t ys = (int64_t)sa * xt + ((int64_t)ca * yt + (int64_t)_yPivot * (1 << fp)) + half;
+
+    // Steps along the line that fall inside the source Sprite
+    int32_t k0 = 0, k1 = max_x - min_x - 1;
+    if (!affineClip(xs, ca, xe, &k0, &k1) || !affineClip(ys, sa, ye, &k0, &k1)) continue;
+
+    int32_t n = k1 - k0 + 1;
+    readAffine(sline_buffer, n, xs + (int64_t)ca * k0, ys + (int64_t)sa * k0, ca, sa, fp, transp, smooth);
+
+    int32_t x = min_x + k0;
+    for (int32_t i = 0; i < n; ) {
+      int32_t s = i;
+      if (transp != 0x00FFFFFF) {
+        while (s < n && sline_buffer[s] == tpcolor) s++;
+        i = s;
+        while (i < n && sline_buffer[i] != tpcolor) i++;
       }
+      else i = n;
+      if (i == s) break;
+      if (spr) spr->pushImage(x + s, y, i - s, 1, sline_buffer + s);
       else {
-        sline_buffer[pixel_count++] = rp;
+        // TFT window is already clipped, so this is faster than pushImage()
+        _tft->setWindow(x + s, y, x + i - 1, y);
+        _tft->pushPixels(sline_buffer + s, i - s);
       }
-    } while (++x < max_x && (xs += _cosra) < xe && (ys += _sinra) < ye);
-    if (pixel_count) spr->pushImage(x - pixel_count, y, pixel_count, 1, sline_buffer);
+    }
   }
-  spr->setSwapBytes(oldSwapBytes);
+
+  if (spr) spr->setSwapBytes(oldSwapBytes);
+  else _tft->endWrite(); // End transaction
+
   return true;
 }
 
@@ -589,8 +792,8 @@ bool TFT_eSprite::getRotatedBounds(TFT_eSprite *spr, int16_t angle, int16_t *min
 
   // Clip bounding box to Sprite boundaries
   // Clipping to a viewport will be done by destination Sprite pushImage function
-  if (*min_x < 0) min_x = 0;
-  if (*min_y < 0) min_y = 0;
+  if (*min_x < 0) *min_x = 0;
+  if (*min_y < 0) *min_y = 0;
   if (*max_x > spr->width())  *max_x = spr->width();
   if (*max_y > spr->height()) *max_y = spr->height();
 
@@ -759,10 +962,17 @@ bool TFT_eSprite::pushToSprite(TFT_eSprite *dspr, int32_t x, int32_t y, uint16_t
   if (_bpp ==  1 && ds_bpp !=  1) return false;
 
   bool oldSwapBytes = dspr->getSwapBytes();
-  uint16_t sline_buffer[width()];
 
   transp = transp>>8 | transp<<8;
 
+  // 16 bpp to 16 bpp copies whole lines skipping the transparent pixels
+  if (_bpp == 16 && ds_bpp == 16 && !oldSwapBytes) {
+    dspr->pushImageKeyed(x, y, _dwidth, _dheight, _img, transp);
+    return true;
+  }
+
+  uint16_t sline_buffer[width()];
+
   // Scan destination bounding box and fetch transformed pixels from source Sprite
   for (int32_t ys = 0; ys < height(); ys++) {
     int32_t ox = x;
@@ -794,6 +1004,64 @@ bool TFT_eSprite::pushToSprite(TFT_eSprite *dspr, int32_t x, int32_t y, uint16_t
 }
 
 
+/***************************************************************************************
+** Function name:           blendToSprite
+** Description:             Blend the sprite into another sprite at x, y
+***************************************************************************************/
+// Both Sprites must be 16bpp, alpha 255 is this Sprite and 0 leaves the destination
+bool TFT_eSprite::blendToSprite(TFT_eSprite *dspr, int32_t x, int32_t y, uint8_t alpha)
+{
+  if ( !_created  || !dspr->_created) return false; // Check Sprites exist
+  if (_bpp != 16 || dspr->_bpp != 16) return false;
+
+  dspr->pushImageBlended(x, y, _dwidth, _dheight, _img, alpha);
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           pushImageKeyed
+** Description:             Copy a 16bpp sprite image into this 16bpp sprite except key
+***************************************************************************************/
+// data and key are in sprite byte order
+void  TFT_eSprite::pushImageKeyed(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *data, uint16_t key)
+{
+  PI_CLIP;
+
+  damage(x, y, dw, dh);
+
+  uint16_t *ptro = data + dx + dy * w;
+  uint16_t *ptrs = _img + x + y * _iwidth;
+  while (dh--)
+  {
+    spanCopyKey16(ptrs, ptro, dw, key);
+    ptro += w;
+    ptrs += _iwidth;
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           pushImageBlended
+** Description:             Blend a 16bpp sprite image into this 16bpp sprite
+***************************************************************************************/
+void  TFT_eSprite::pushImageBlended(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *data, uint8_t alpha)
+{
+  PI_CLIP;
+
+  damage(x, y, dw, dh);
+
+  uint16_t *ptro = data + dx + dy * w;
+  uint16_t *ptrs = _img + x + y * _iwidth;
+  while (dh--)
+  {
+    spanBlend16(ptrs, ptro, dw, alpha);
+    ptro += w;
+    ptrs += _iwidth;
+  }
+}
+
+
 /***************************************************************************************
 ** Function name:           pushSprite
 ** Description:             Push a cropped sprite to the TFT at tx, ty
@@ -802,8 +1070,11 @@ bool TFT_eSprite::pushSprite(int32_t tx, int32_t ty, int32_t sx, int32_t sy, int
 {
   if (!_created) return false;
 
-  // Perform window boundary checks and crop if needed
+  // Perform window boundary checks and crop if needed, the window is only read here
+  bool track = _dirtyTrack;
+  _dirtyTrack = false;
   setWindow(sx, sy, sx + sw - 1, sy + sh - 1);
+  _dirtyTrack = track;
 
   /* These global variables are now populated for the sprite
   _xs = x start coordinate
@@ -891,6 +1162,112 @@ bool TFT_eSprite::pushSprite(int32_t tx, int32_t ty, int32_t sx, int32_t sy, int
 }
 
 
+/***************************************************************************************
+** Function name:           trackDirty
+** Description:             Start or stop recording the areas drawn into
+***************************************************************************************/
+void TFT_eSprite::trackDirty(bool enable)
+{
+  _dirtyTrack = enable;
+  _dirty.clear();
+  // Nothing is known about what the TFT shows yet
+  if (enable && _created) damage(0, 0, _dwidth, _dheight);
+}
+
+
+/***************************************************************************************
+** Function name:           markDirty
+** Description:             Add an area to be sent by the next pushDirty()
+***************************************************************************************/
+void TFT_eSprite::markDirty(int32_t x, int32_t y, int32_t w, int32_t h)
+{
+  if (!_created) return;
+
+  x+= _xDatum;
+  y+= _yDatum;
+
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+
+  if ((x + w) > _dwidth)  w = _dwidth  - x;
+  if ((y + h) > _dheight) h = _dheight - y;
+
+  _dirty.add(x, y, w, h);
+}
+
+
+/***************************************************************************************
+** Function name:           clearDirty
+** Description:             Forget the areas drawn into, e.g. after a full pushSprite()
+***************************************************************************************/
+void TFT_eSprite::clearDirty(void)
+{
+  _dirty.clear();
+}
+
+
+/***************************************************************************************
+** Function name:           dirtyPixels
+** Description:             Number of pixels the next pushDirty() will send
+***************************************************************************************/
+uint32_t TFT_eSprite::dirtyPixels(void)
+{
+  if (_bpp == 1 && rotation && _dirty.count()) return _dwidth * _dheight;
+  return _dirty.pixels();
+}
+
+
+/***************************************************************************************
+** Function name:           pushDirty
+** Description:             Push the areas drawn into since the last push to the TFT
+***************************************************************************************/
+// The sprite must be pushed to the same x,y each time, pushSprite() does not clear the
+// damage so call clearDirty() after it if it is used to send the whole sprite
+bool TFT_eSprite::pushDirty(int32_t x, int32_t y)
+{
+  if (!_created || _dirty.count() == 0) return false;
+
+  // Rotated 1bpp sprites are stored rotated, the damage is not in memory coordinates
+  if (_bpp == 1 && rotation) {
+    pushSprite(x, y);
+    _dirty.clear();
+    return true;
+  }
+
+  // A single window per area is only possible if no TFT clipping is needed
+  bool direct = (_bpp == 16) && _tft->getViewportX() == 0 && _tft->getViewportY() == 0 &&
+                _tft->getViewportWidth() == _tft->width() && _tft->getViewportHeight() == _tft->height();
+
+  bool oldSwapBytes = _tft->getSwapBytes();
+  _tft->setSwapBytes(false);
+  _tft->startWrite();
+
+  for (uint8_t i = 0; i < _dirty.count(); i++)
+  {
+    const dirty_rect_t& r = _dirty[i];
+    int32_t rx = r.x0, rw = r.x1 - r.x0 + 1;
+    int32_t ry = r.y0, rh = r.y1 - r.y0 + 1;
+
+    // The 1bpp line by line push always starts at the left edge
+    if (_bpp == 1) { rx = 0; rw = _dwidth; }
+
+    int32_t tx = x + rx, ty = y + ry;
+    if (direct && tx >= 0 && ty >= 0 && (tx + rw) <= _tft->width() && (ty + rh) <= _tft->height())
+    {
+      _tft->setAddrWindow(tx, ty, rw, rh);
+      uint16_t* ptr = _img + rx + ry * _iwidth;
+      while (rh--) { _tft->pushPixels(ptr, rw); ptr += _iwidth; }
+    }
+    else pushSprite(tx, ty, rx, ry, rw, rh);
+  }
+
+  _tft->endWrite();
+  _tft->setSwapBytes(oldSwapBytes);
+  _dirty.clear();
+  return true;
+}
+
+
 /***************************************************************************************
 ** Function name:           readPixelValue
 ** Description:             Read the color map index of a pixel at defined coordinates
@@ -1034,6 +1411,8 @@ void  TFT_eSprite::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_
 
   PI_CLIP;
 
+  damage(x, y, dw, dh);
+
   if (_bpp == 16) // Plot a 16 bpp image into a 16 bpp Sprite
   {
     // Pointer within original image
@@ -1045,13 +1424,7 @@ void  TFT_eSprite::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_
     {
       while (dh--)
       {
-        // Fast copy with a 1 byte shift
-        memcpy(ptrs+1, ptro, (dw<<1) - 1);
-        // Now correct just the even numbered bytes
-        for (int32_t xp = 0; xp < (dw<<1); xp+=2)
-        {
-          ptrs[xp] = ptro[xp+1];;
-        }
+        spanCopySwap16((uint16_t*)ptrs, (uint16_t*)ptro, dw);
         ptro += w<<1;
         ptrs += _iwidth<<1;
       }
@@ -1177,6 +1550,8 @@ void  TFT_eSprite::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const u
 
   PI_CLIP;
 
+  damage(x, y, dw, dh);
+
   if (_bpp == 16) // Plot a 16 bpp image into a 16 bpp Sprite
   {
     for (int32_t yp = dy; yp < dy + dh; yp++)
@@ -1255,8 +1630,9 @@ void TFT_eSprite::setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
   if (x0 > x1) transpose(x0, x1);
   if (y0 > y1) transpose(y0, y1);
   
-  int32_t w = width();
-  int32_t h = height();
+  // The window is in Sprite pixels whatever the viewport or a derived class reports
+  int32_t w = _dwidth;
+  int32_t h = _dheight;
 
   if ((x0 >= w) || (x1 < 0) || (y0 >= h) || (y1 < 0))
   { // Point to that extra "off screen" pixel
@@ -1276,6 +1652,9 @@ void TFT_eSprite::setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
     _ys = y0;
     _xe = x1;
     _ye = y1;
+
+    // Assume the whole window will be written by pushColor()
+    damage(x0, y0, x1 - x0 + 1, y1 - y0 + 1);
   }
 
   _xptr = _xs;
@@ -1423,6 +1802,8 @@ void TFT_eSprite::scroll(int16_t dx, int16_t dy)
     return;
   }
 
+  damage(_sx, _sy, _sw, _sh);
+
   // Fetch the scroll area width and height set by setScrollRect()
   uint32_t w  = _sw - abs(dx); // line width to copy
   uint32_t h  = _sh - abs(dy); // lines to copy
@@ -1520,6 +1901,7 @@ void TFT_eSprite::fillSprite(uint32_t color)
   // Use memset if possible as it is super fast
   if(_xDatum == 0 && _yDatum == 0  &&  _xWidth == width())
   {
+    damage(0, 0, _dwidth, _yHeight);
     if(_bpp == 16) {
       if ( (uint8_t)color == (uint8_t)(color>>8) ) {
         memset(_img,  (uint8_t)color, _iwidth * _yHeight * 2);
@@ -1637,6 +2019,8 @@ void TFT_eSprite::drawPixel(int32_t x, int32_t y, uint32_t color)
   // Range checking
   if ((x < _vpX) || (y < _vpY) ||(x >= _vpW) || (y >= _vpH)) return;
 
+  damage(x, y, 1, 1);
+
   if (_bpp == 16)
   {
     color = (color >> 8) | (color << 8);
@@ -1761,6 +2145,8 @@ void TFT_eSprite::drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color)
 
   if (h < 1) return;
 
+  damage(x, y, 1, h);
+
   if (_bpp == 16)
   {
     color = (color >> 8) | (color << 8);
@@ -1802,6 +2188,103 @@ void TFT_eSprite::drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color)
 }
 
 
+/***************************************************************************************
+** Function name:           pushSpan
+** Description:             Draw a scanline of edge colours, a run of colour, edge colours
+***************************************************************************************/
+void TFT_eSprite::pushSpan(int32_t x, int32_t y, const uint16_t* lead, int32_t n, int32_t len, uint32_t color, const uint16_t* trail, int32_t m)
+{
+  if (!_created || _vpOoB) return;
+
+  if (_bpp != 16 && _bpp != 8)
+  {
+    // Pixels are packed below a byte, so are set one at a time anyway
+    for (int32_t i = 0; i < n; i++) drawPixel(x + i, y, lead[i]);
+    if (len > 0) drawFastHLine(x + n, y, len, color);
+    for (int32_t i = 0; i < m; i++) drawPixel(x + n + len + i, y, trail[i]);
+    return;
+  }
+
+  x+= _xDatum;
+  y+= _yDatum;
+
+  int32_t w = n + len + m;
+
+  // Clipping
+  if ((y < _vpY) || (x >= _vpW) || (y >= _vpH)) return;
+
+  int32_t dx = 0; // Pixels clipped on the left
+  if (x < _vpX) { dx = _vpX - x; w -= dx; x = _vpX; }
+
+  if ((x + w) > _vpW) w = _vpW - x;
+
+  if (w < 1) return;
+
+  damage(x, y, w, 1);
+
+  uint16_t* p  = _img  + _iwidth * y + x; // Used at 16 bpp
+  uint8_t*  p8 = _img8 + _iwidth * y + x; // Used at 8 bpp
+
+  if (dx < n) {
+    int32_t c = n - dx;
+    if (c > w) c = w;
+    if (_bpp == 16) spanCopySwap16(p, lead + dx, c);
+    else for (int32_t j = 0; j < c; j++) {
+      uint16_t pc = lead[dx + j];
+      p8[j] = (uint8_t)((pc & 0xE000)>>8 | (pc & 0x0700)>>6 | (pc & 0x0018)>>3);
+    }
+    p += c; p8 += c; w -= c; dx = 0;
+  }
+  else dx -= n;
+
+  if (dx < len) {
+    int32_t c = len - dx;
+    if (c > w) c = w;
+    if (c > 0) {
+      if (_bpp == 16) spanFill16(p, (uint16_t)((color >> 8) | (color << 8)), c);
+      else memset(p8, (uint8_t)((color & 0xE000)>>8 | (color & 0x0700)>>6 | (color & 0x0018)>>3), c);
+    }
+    p += c; p8 += c; w -= c; dx = 0;
+  }
+  else dx -= len;
+
+  if (w > 0) {
+    if (_bpp == 16) spanCopySwap16(p, trail + dx, w);
+    else for (int32_t j = 0; j < w; j++) {
+      uint16_t pc = trail[dx + j];
+      p8[j] = (uint8_t)((pc & 0xE000)>>8 | (pc & 0x0700)>>6 | (pc & 0x0018)>>3);
+    }
+  }
+}
+
+
+/***************************************************************************************
+** Function name:           pushAtlasCell
+** Description:             Copy part of a glyph atlas cell into a 16bpp Sprite
+***************************************************************************************/
+// Only called for 16bpp Sprites, which hold the pixels byte swapped as the cells are
+void TFT_eSprite::pushAtlasCell(const TFT_GlyphAtlas* atlas, const uint8_t* cell, uint16_t w, int32_t x, int32_t y, int32_t dx, int32_t dy, int32_t dw, int32_t dh)
+{
+  if (!_created) return;
+
+  damage(x, y, dw, dh);
+
+  uint16_t* p = _img + _iwidth * y + x;
+
+  if (atlas->rgb565()) {
+    const uint16_t* img = (const uint16_t*)cell + dy * w + dx;
+    for (int32_t r = 0; r < dh; r++, p += _iwidth, img += w) memcpy(p, img, dw * 2);
+  }
+  else {
+    uint16_t line[GLYPH_ATLAS_MAX_WIDTH + 8];
+    for (int32_t r = 0; r < dh; r++, p += _iwidth) {
+      atlas->expand(cell, w, dy + r, line);
+      memcpy(p, line + dx, dw * 2);
+    }
+  }
+}
+
+
 /***************************************************************************************
 ** Function name:           drawFastHLine
 ** Description:             draw a horizontal line
@@ -1822,10 +2305,12 @@ void TFT_eSprite::drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color)
 
   if (w < 1) return;
 
+  damage(x, y, w, 1);
+
   if (_bpp == 16)
   {
     color = (color >> 8) | (color << 8);
-    while (w--) _img[_iwidth * y + x++] = (uint16_t) color;
+    spanFill16(_img + _iwidth * y + x, (uint16_t) color, w);
   }
   else if (_bpp == 8)
   {
@@ -1887,19 +2372,17 @@ void TFT_eSprite::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t
 
   if ((w < 1) || (h < 1)) return;
 
+  damage(x, y, w, h);
+
   int32_t yp = _iwidth * y + x;
 
   if (_bpp == 16)
   {
     color = (color >> 8) | (color << 8);
-    uint32_t iw = w;
-    int32_t ys = yp;
-    if(h--)  {while (iw--) _img[yp++] = (uint16_t) color;}
-    yp = ys;
     while (h--)
     {
+      spanFill16(_img + yp, (uint16_t) color, w);
       yp += _iwidth;
-      memcpy( _img+yp, _img+ys, w<<1);
     }
   }
   else if (_bpp == 8)
@@ -2001,6 +2484,8 @@ void TFT_eSprite::drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color, uin
       ((y + 8 * size - 1) < (_vpY - _yDatum)))   // Clip top
     return;
 
+  if (_bpp == 16 && drawAtlasChar(1, c, x, y, color, bg, size)) return;
+
   if (c > 255) return;
   if (!_cp437 && c > 175) c++;
 
@@ -2070,7 +2555,7 @@ void TFT_eSprite::drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color, uin
 //>>>>>>>>>>>>>>>>>>>>>>>>>>>
 
       c -= pgm_read_word(&gfxFont->first);
-      GFXglyph *glyph  = &(((GFXglyph *)pgm_read_dword(&gfxFont->glyph))[c]);
+      GFXglyph *glyph  = &(((GFXglyph *)pgm_read_ptr(&gfxFont->glyph))[c]);
 
       uint8_t  w  = pgm_read_byte(&glyph->width),
                h  = pgm_read_byte(&glyph->height);
@@ -2081,7 +2566,7 @@ void TFT_eSprite::drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color, uin
           ((y + yo + h * size - 1) < (_vpY - _yDatum)))   // Clip top
         return;
 
-      uint8_t  *bitmap = (uint8_t *)pgm_read_dword(&gfxFont->bitmap);
+      uint8_t  *bitmap = (uint8_t *)pgm_read_ptr(&gfxFont->bitmap);
       uint32_t bo = pgm_read_word(&glyph->bitmapOffset);
 
       uint8_t  xx, yy, bits=0, bit=0;
@@ -2176,7 +2661,7 @@ int16_t TFT_eSprite::drawChar(uint16_t uniCode, int32_t x, int32_t y, uint8_t fo
     else {
       if((uniCode >= pgm_read_word(&gfxFont->first)) && (uniCode <= pgm_read_word(&gfxFont->last) )) {
         uint16_t   c2    = uniCode - pgm_read_word(&gfxFont->first);
-        GFXglyph *glyph = &(((GFXglyph *)pgm_read_dword(&gfxFont->glyph))[c2]);
+        GFXglyph *glyph = &(((GFXglyph *)pgm_read_ptr(&gfxFont->glyph))[c2]);
         return pgm_read_byte(&glyph->xAdvance) * textsize;
       }
       else {
@@ -2188,14 +2673,17 @@ int16_t TFT_eSprite::drawChar(uint16_t uniCode, int32_t x, int32_t y, uint8_t fo
 
   if ((font>1) && (font<9) && ((uniCode < 32) || (uniCode > 127))) return 0;
 
+  int16_t cw = (_bpp == 16) ? drawAtlasChar(font, uniCode, x, y, textcolor, textbgcolor, textsize) : 0;
+  if (cw) return cw;
+
   int32_t width  = 0;
   int32_t height = 0;
-  uint32_t flash_address = 0;
+  uintptr_t flash_address = 0;
   uniCode -= 32;
 
 #ifdef LOAD_FONT2
   if (font == 2) {
-    flash_address = pgm_read_dword(&chrtbl_f16[uniCode]);
+    flash_address = (uintptr_t)pgm_read_ptr(&chrtbl_f16[uniCode]);
     width = pgm_read_byte(widtbl_f16 + uniCode);
     height = chr_hgt_f16;
   }
@@ -2207,8 +2695,8 @@ int16_t TFT_eSprite::drawChar(uint16_t uniCode, int32_t x, int32_t y, uint8_t fo
 #ifdef LOAD_RLE
   {
     if ((font>2) && (font<9)) {
-      flash_address = pgm_read_dword( (const void*)(pgm_read_dword( &(fontdata[font].chartbl ) ) + uniCode*sizeof(void *)) );
-      width = pgm_read_byte( (uint8_t *)pgm_read_dword( &(fontdata[font].widthtbl ) ) + uniCode );
+      flash_address = (uintptr_t)pgm_read_ptr( (const uint8_t *)pgm_read_ptr( &(fontdata[font].chartbl ) ) + uniCode*sizeof(void *) );
+      width = pgm_read_byte( (uint8_t *)pgm_read_ptr( &(fontdata[font].widthtbl ) ) + uniCode );
       height= pgm_read_byte( &fontdata[font].height );
     }
   }
@@ -2478,16 +2966,22 @@ void TFT_eSprite::drawGlyph(uint16_t code)
     uint8_t* pbuffer = nullptr;
     const uint8_t* gPtr = (const uint8_t*) gFont.gArray;
 
+    int16_t cy = cursor_y + gFont.maxAscent - gdY[gNum];
+    int16_t cx = cursor_x + gdX[gNum];
+
+    // Opaque text is copied in pre-blended, pushImage() takes 16 bpp images into 16 and 8 bpp
+    const uint16_t* bmap = nullptr;
+    const uint8_t*  amap = nullptr;
+    if (_fillbg && !getBG && _bpp >= 8 && bg_cursor_x <= cx) bmap = blendedGlyph(gNum, fg, bg);
+    if (!bmap) amap = cachedGlyph(gNum);
+
 #ifdef FONT_FS_AVAILABLE
-    if (fs_font) {
+    if (fs_font && !bmap && !amap) {
       fontFile.seek(gBitmap[gNum], fs::SeekSet); // This is slow for a significant position shift!
       pbuffer =  (uint8_t*)malloc(gWidth[gNum]);
     }
 #endif
 
-    int16_t cy = cursor_y + gFont.maxAscent - gdY[gNum];
-    int16_t cx = cursor_x + gdX[gNum];
-
     //  if (cx > width() && bg_cursor_x > width()) return;
     //  if (cursor_y > height()) return;
 
@@ -2525,18 +3019,27 @@ void TFT_eSprite::drawGlyph(uint16_t code)
       }
     }
 
-    for (int32_t y = 0; y < gHeight[gNum]; y++)
+    if (bmap)
+    {
+      bool swap = _swapBytes;
+      _swapBytes = true;
+      pushImage(cx, cy, gWidth[gNum], gHeight[gNum], (uint16_t*)bmap);
+      _swapBytes = swap;
+    }
+    else for (int32_t y = 0; y < gHeight[gNum]; y++)
     {
 #ifdef FONT_FS_AVAILABLE
-      if (fs_font) {
+      if (pbuffer) {
         fontFile.read(pbuffer, gWidth[gNum]);
       }
 #endif
 
       for (int32_t x = 0; x < gWidth[gNum]; x++)
       {
+        if (amap) pixel = amap[x + gWidth[gNum] * y];
+        else
 #ifdef FONT_FS_AVAILABLE
-        if (fs_font) pixel = pbuffer[x];
+        if (pbuffer) pixel = pbuffer[x];
         else
 #endif
         pixel = pgm_read_byte(gPtr + gBitmap[gNum] + x + gWidth[gNum] * y);
@@ -98,6 +98,12 @@ class TFT_eSprite : public TFT_eSPI {
            // Push a rotated copy of Sprite to another different Sprite with optional transparent colour
   bool     pushRotated(TFT_eSprite *spr, int16_t angle, uint32_t transp = 0x00FFFFFF);
 
+           // Push a rotated copy of Sprite scaled by scale to TFT or another Sprite (not 4bpp),
+           // the Sprite pivot placed on the destination pivot. smooth blends the four nearest
+           // pixels (bilinear filtering), edges next to the transparent colour stay sharp
+  bool     pushTransformed(int16_t angle, float scale, uint32_t transp = 0x00FFFFFF, bool smooth = false);
+  bool     pushTransformed(TFT_eSprite *spr, int16_t angle, float scale, uint32_t transp = 0x00FFFFFF, bool smooth = false);
+
            // Get the TFT bounding box for a rotated copy of this Sprite
   bool     getRotatedBounds(int16_t angle, int16_t *min_x, int16_t *min_y, int16_t *max_x, int16_t *max_y);
            // Get the destination Sprite bounding box for a rotated copy of this Sprite
@@ -126,10 +132,27 @@ class TFT_eSprite : public TFT_eSPI {
            // Push a windowed area of the sprite to the TFT at tx, ty
   bool     pushSprite(int32_t tx, int32_t ty, int32_t sx, int32_t sy, int32_t sw, int32_t sh);
 
+           // Record the areas drawn into so pushDirty() only sends what changed. Enabling marks the
+           // whole sprite dirty so the first pushDirty() sends everything. Direct writes to the
+           // pointer returned by getPointer() are not seen, use markDirty() for those.
+  void     trackDirty(bool enable);
+  bool     trackingDirty(void) { return _dirtyTrack; }
+           // Add or forget damaged areas, x,y,w,h are sprite coordinates
+  void     markDirty(int32_t x, int32_t y, int32_t w, int32_t h);
+  void     clearDirty(void);
+           // Pixels the next pushDirty() will send
+  uint32_t dirtyPixels(void);
+           // Push only the areas drawn into since the last push to the TFT with the sprite at x,y
+           // Returns false if there was nothing to send
+  bool     pushDirty(int32_t x, int32_t y);
+
            // Push the sprite to another sprite at x,y. This fn calls pushImage() in the destination sprite (dspr) class.
   bool     pushToSprite(TFT_eSprite *dspr, int32_t x, int32_t y);
   bool     pushToSprite(TFT_eSprite *dspr, int32_t x, int32_t y, uint16_t transparent);
 
+           // Blend the sprite into another sprite at x,y, alpha 255 is opaque. Both must be 16bpp.
+  bool     blendToSprite(TFT_eSprite *dspr, int32_t x, int32_t y, uint8_t alpha);
+
            // Draw a single character in the selected font
   int16_t  drawChar(uint16_t uniCode, int32_t x, int32_t y, uint8_t font),
            drawChar(uint16_t uniCode, int32_t x, int32_t y);
@@ -155,10 +178,30 @@ class TFT_eSprite : public TFT_eSPI {
            // Reserve memory for the Sprite and return a pointer
   void*    callocSprite(int16_t width, int16_t height, uint8_t frames = 1);
 
+           // Record an area in sprite memory coordinates (after datum and viewport clipping)
+  void     damage(int32_t x, int32_t y, int32_t w, int32_t h) { if (_dirtyTrack) _dirty.add(x, y, w, h); }
+
+           // 16bpp line copies into this sprite used by pushToSprite() and blendToSprite()
+  void     pushImageKeyed(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *data, uint16_t key);
+  void     pushImageBlended(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *data, uint8_t alpha);
+
            // Override the non-inlined TFT_eSPI functions
   void     begin_nin_write(void) { ; }
   void     end_nin_write(void) { ; }
 
+           // Scanlines of the anti-aliased shapes, copied straight into 8 and 16bpp Sprites
+  void     pushSpan(int32_t x, int32_t y, const uint16_t* lead, int32_t n, int32_t len, uint32_t color, const uint16_t* trail, int32_t m);
+
+           // Glyph atlas cells, copied straight into 16bpp Sprites
+  void     pushAtlasCell(const TFT_GlyphAtlas* atlas, const uint8_t* cell, uint16_t w, int32_t x, int32_t y, int32_t dx, int32_t dy, int32_t dw, int32_t dh);
+
+           // Rotation and scaling engine for pushRotated() and pushTransformed()
+  bool     pushAffine(TFT_eSprite *spr, int32_t min_x, int32_t min_y, int32_t max_x, int32_t max_y,
+                      int32_t ca, int32_t sa, uint8_t fp, uint32_t transp, bool smooth);
+  void     readAffine(uint16_t *buf, int32_t n, uint32_t xs, uint32_t ys, int32_t dx, int32_t dy,
+                      uint8_t fp, uint32_t transp, bool smooth);
+  uint16_t sourcePixel(int32_t x, int32_t y);
+
  protected:
 
   uint8_t  _bpp;     // bits per pixel (1, 4, 8 or 16)
@@ -176,6 +219,9 @@ class TFT_eSprite : public TFT_eSPI {
   bool     _created; // A Sprite has been created and memory reserved
   bool     _gFont = false; 
 
+  bool     _dirtyTrack;      // Drawing records damaged areas for pushDirty()
+  TFT_DirtyRects _dirty;     // Areas drawn into since the last pushDirty()
+
   int32_t  _xs, _ys, _xe, _ye, _xptr, _yptr; // for setWindow
   int32_t  _sx, _sy; // x,y for scroll zone
   uint32_t _sw, _sh; // w,h for scroll zone
@@ -0,0 +1,250 @@
+/**************************************************************************************
+// The following class draws frames on the TFT a band of rows at a time through one or
+// two Sprite frames of a few rows. The class inherits the Sprite functions, the
+// viewport is kept inside the band so that screen coordinates draw into it.
+***************************************************************************************/
+
+// Processors with the DMA functions
+#if defined (ESP32_DMA) || defined (ESP32_I80_DMA) || defined (RP2040_DMA) || defined (STM32_DMA) || defined (HOST_DMA)
+  #define STRIP_DMA
+#endif
+
+/***************************************************************************************
+** Function name:           TFT_eStrip
+** Description:             Class constructor
+***************************************************************************************/
+TFT_eStrip::TFT_eStrip(TFT_eSPI *tft) : TFT_eSprite(tft)
+{
+  _tft = tft;     // Pointer to tft class so we can call member functions
+  _by     = 0;
+  _rows   = 0;
+  _hash   = nullptr;
+  _hashed = false;
+  _band     = nullptr;
+  _bandData = nullptr;
+  clearStripStats();
+}
+
+
+/***************************************************************************************
+** Function name:           ~TFT_eStrip
+** Description:             Class destructor
+***************************************************************************************/
+TFT_eStrip::~TFT_eStrip(void)
+{
+  deleteStrip();
+}
+
+
+/***************************************************************************************
+** Function name:           createStrip
+** Description:             Reserve RAM for one strip, or two to send one while drawing
+***************************************************************************************/
+bool TFT_eStrip::createStrip(uint16_t rows)
+{
+  if (_created) return true;
+
+  // Screen size, reported by width() and height() and used by fillScreen()
+  _width  = _tft->width();
+  _height = _tft->height();
+  if (rows < 1) rows = 1;
+  if (rows > _height) rows = _height;
+
+  uint8_t frames = 1;
+#ifdef STRIP_DMA
+  if (_tft->DMA_Enabled) frames = 2;
+#endif
+
+  uint32_t bands = (_height + rows - 1) / rows;
+  _hash = (uint32_t*) malloc(bands * sizeof(uint32_t));
+  if (!_hash || !createSprite(_width, rows, frames)) {
+    deleteStrip();
+    return false;
+  }
+  _hashed = false;
+
+  // Drawing outside pushFrame() goes into the first band
+  _by   = 0;
+  _rows = rows;
+  resetViewport();
+  return true;
+}
+
+
+/***************************************************************************************
+** Function name:           deleteStrip
+** Description:             Delete the strip to free up memory (RAM)
+***************************************************************************************/
+void TFT_eStrip::deleteStrip(void)
+{
+  deleteSprite();
+  free(_hash);
+  _hash   = nullptr;
+  _hashed = false;
+}
+
+
+/***************************************************************************************
+** Function name:           clearStripStats
+** Description:             Zero the frame and band counts
+***************************************************************************************/
+void TFT_eStrip::clearStripStats(void)
+{
+  memset(&_stats, 0, sizeof(_stats));
+}
+
+
+/***************************************************************************************
+** Function name:           pushFrame
+** Description:             Draw a frame band by band and send the bands to the TFT
+***************************************************************************************/
+uint32_t TFT_eStrip::pushFrame(drawSceneCallback scene, void* data, bool changedOnly)
+{
+  if (!_created) return 0;
+
+  bool dma = _img8_2 != _img8_1;
+  uint32_t pixels = 0;
+
+  bool swap = _tft->getSwapBytes();
+  _tft->setSwapBytes(false); // Sprite pixels are already in TFT byte order
+  _tft->startWrite();
+
+  uint32_t band = 0;
+  uint8_t frame = 0;  // Frame to draw in, changes only when a band is sent from it
+  for (_by = 0; _by < _height; _by += _dheight, band++) {
+    _rows = _height - _by;
+    if (_rows > _dheight) _rows = _dheight;
+
+    // With DMA the other frame may still be sent, pushImageDMA() waited for the one
+    // before it to finish. A band that is not sent leaves its frame free for the next
+    if (dma) frameBuffer(1 + frame);
+    resetViewport();
+    scene(this, data);
+    _stats.bands++;
+
+    uint32_t hash = bandHash();
+    if (_band) _band(_img, _by, _dwidth, _rows, hash, _bandData);
+    if (changedOnly && _hashed && _hash[band] == hash) continue;
+    _hash[band] = hash;
+
+#ifdef STRIP_DMA
+    if (dma) { _tft->pushImageDMA(0, _by, _dwidth, _rows, _img); frame ^= 1; }
+    else
+#endif
+    _tft->pushImage(0, _by, _dwidth, _rows, _img);
+
+    _stats.sent++;
+    pixels += _dwidth * _rows;
+  }
+  _hashed = true;
+
+#ifdef STRIP_DMA
+  if (dma) _tft->dmaWait(); // The next frame starts drawing in the first strip
+#endif
+  _tft->endWrite();
+  _tft->setSwapBytes(swap);
+
+  if (dma) frameBuffer(1);
+  _by   = 0;
+  _rows = _dheight;
+  resetViewport();
+
+  _stats.frames++;
+  _stats.pixels += pixels;
+  return pixels;
+}
+
+
+/***************************************************************************************
+** Function name:           bandHash
+** Description:             FNV-1a hash of the rows of the band in the current strip
+***************************************************************************************/
+uint32_t TFT_eStrip::bandHash(void)
+{
+  const uint32_t* p = (const uint32_t*)_img;
+  uint32_t n = (_dwidth * _rows) >> 1;
+  uint32_t hash = 2166136261u;
+  while (n--) hash = (hash ^ *p++) * 16777619u;
+  if ((_dwidth * _rows) & 1) hash = (hash ^ _img[_dwidth * _rows - 1]) * 16777619u;
+  return hash;
+}
+
+
+/***************************************************************************************
+** Function name:           width
+** Description:             Return the width of the screen, or of the viewport
+***************************************************************************************/
+int16_t TFT_eStrip::width(void)
+{
+  if (!_created ) return 0;
+  if (_vpDatum) return _xWidth;
+  return _width;
+}
+
+
+/***************************************************************************************
+** Function name:           height
+** Description:             Return the height of the screen, or of the viewport
+***************************************************************************************/
+int16_t TFT_eStrip::height(void)
+{
+  if (!_created ) return 0;
+  if (_vpDatum) return _yHeight;
+  return _height;
+}
+
+
+/***************************************************************************************
+** Function name:           setViewport
+** Description:             Set a viewport in screen coordinates, clipped to the band
+***************************************************************************************/
+void TFT_eStrip::setViewport(int32_t x, int32_t y, int32_t w, int32_t h, bool vpDatum)
+{
+  TFT_eSPI::setViewport(x, y, w, h, vpDatum);
+  clipToBand();
+}
+
+
+/***************************************************************************************
+** Function name:           resetViewport
+** Description:             Reset the viewport to the whole screen, clipped to the band
+***************************************************************************************/
+void TFT_eStrip::resetViewport(void)
+{
+  TFT_eSPI::resetViewport();
+  clipToBand();
+}
+
+
+/***************************************************************************************
+** Function name:           clipToBand
+** Description:             Move the screen viewport into the strip and clip it to the band
+***************************************************************************************/
+void TFT_eStrip::clipToBand(void)
+{
+  if (_vpOoB || !_created) return;
+
+  // Screen row _by is strip row 0
+  _yDatum -= _by;
+  _vpY    -= _by;
+  _vpH    -= _by;
+
+  if (_vpY < 0) _vpY = 0;
+  if (_vpH > _rows) _vpH = _rows;
+
+  // Nothing of the viewport in this band, the datum is kept for the scene
+  if (_vpY >= _vpH) _vpOoB = true;
+}
+
+
+/***************************************************************************************
+** Function name:           fillSprite
+** Description:             Fill the viewport with a colour
+***************************************************************************************/
+void TFT_eStrip::fillSprite(uint32_t color)
+{
+  if (!_created || _vpOoB) return;
+
+  fillRect(_vpX - _xDatum, _vpY - _yDatum, _vpW - _vpX, _vpH - _vpY, color);
+}
+
@@ -0,0 +1,90 @@
+/***************************************************************************************
+// The following class draws whole frames on the TFT through a strip of a few screen
+// rows in RAM instead of a full screen Sprite. A scene function is called once for each
+// band of rows with the strip as its canvas, draws in screen coordinates and everything
+// outside the band is clipped, then the band is sent. With DMA enabled on the TFT (call
+// initDMA() before createStrip()) there are two strips and each band is sent while the
+// next is drawn. Nothing is shown half drawn, so updates do not flicker, and a 320 x 170
+// frame takes two 320 x 16 strips (20 KB) rather than one or two 109 KB Sprites.
+//
+// The scene must draw every pixel (start with fillScreen()) and the same thing each time
+// it is called for a frame. Viewports work in screen coordinates; setOrigin(),
+// frameViewport() and pushing other Sprites to the TFT do not, use pushToSprite().
+***************************************************************************************/
+
+#ifndef STRIP_ROWS
+  #define STRIP_ROWS    16  // Screen rows in a strip
+#endif
+
+// Draws a frame on canvas, called once for every band with the data given to pushFrame()
+typedef void (*drawSceneCallback)(TFT_eSPI* canvas, void* data);
+
+// Given each band of a frame as drawn, sent or not: rows of width pixels in TFT byte
+// order starting at screen row y, and the hash pushFrame() compares
+typedef void (*stripBandCallback)(const uint16_t* pixels, int32_t y, int32_t width, int32_t rows, uint32_t hash, void* data);
+
+typedef struct {
+  uint32_t frames;      // Frames pushed
+  uint32_t bands;       // Bands drawn
+  uint32_t sent;        // Bands sent, the others were the same as in the last frame
+  uint32_t pixels;      // Pixels sent
+} strip_stats_t;
+
+class TFT_eStrip : public TFT_eSprite {
+
+ public:
+
+  explicit TFT_eStrip(TFT_eSPI *tft);
+  ~TFT_eStrip(void);
+
+           // Reserve RAM for a strip of rows screen rows, two if DMA is enabled on the TFT.
+           // The strip covers the whole TFT as it is rotated now. Returns false if the RAM
+           // is not available
+  bool     createStrip(uint16_t rows = STRIP_ROWS);
+
+           // Delete the strip to free up the RAM
+  void     deleteStrip(void);
+
+           // Draw a frame with scene one band at a time and send it to the TFT. If
+           // changedOnly, bands that are the same as last time are not sent. Returns the
+           // number of pixels sent
+  uint32_t pushFrame(drawSceneCallback scene, void* data, bool changedOnly = false);
+
+           // Call band with every band of the frames pushed from now on, NULL to stop.
+           // Lets the frame be captured from RAM without reading the TFT back
+  void     setBandCallback(stripBandCallback band, void* data = nullptr) { _band = band; _bandData = data; }
+
+           // Counts since the last clearStripStats()
+  void     getStripStats(strip_stats_t *stats) { *stats = _stats; }
+  void     clearStripStats(void);
+
+           // The width and height of the screen, or of the viewport if its datum is used
+  int16_t  width(void),
+           height(void);
+
+           // Viewports in screen coordinates, clipped to the band being drawn
+  void     setViewport(int32_t x, int32_t y, int32_t w, int32_t h, bool vpDatum = true);
+  void     resetViewport(void);
+
+           // Fill the viewport, or the whole screen, with a colour
+  void     fillSprite(uint32_t color);
+
+ private:
+
+  TFT_eSPI *_tft;
+
+  int32_t  _by;         // First screen row of the band being drawn
+  int32_t  _rows;       // Rows in it, the last band can be shorter than the strip
+  uint32_t *_hash;      // Hash of each band as last sent
+  bool     _hashed;     // _hash holds the frame on the TFT
+
+  stripBandCallback _band;
+  void*    _bandData;
+
+  strip_stats_t _stats;
+
+           // Shift a screen viewport into the band
+  void     clipToBand(void);
+           // Hash of the rows of the band in the current strip
+  uint32_t bandHash(void);
+};
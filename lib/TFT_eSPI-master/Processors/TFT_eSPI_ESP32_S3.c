@@ -52,6 +52,129 @@
   #endif
 #endif
 
+#ifdef ESP32_I80_DMA
+  // 8-bit parallel DMA through the LCD_CAM peripheral in i80 mode. The peripheral only
+  // owns the data, DC and WR pins while a transfer runs, the rest of the time they are
+  // routed back to plain GPIO so the tft_Write_xx macros keep working unchanged.
+  #include "esp_rom_gpio.h"
+  #include "soc/lcd_periph.h"
+  #include "esp_heap_caps.h"
+  #if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+    #include "esp_memory_utils.h"
+  #else
+    #include "soc/soc_memory_layout.h"
+  #endif
+
+  #ifndef TFT_I80_PCLK_HZ
+    #define TFT_I80_PCLK_HZ     20000000  // Write strobe rate, ST7789 allows a 66ns write cycle
+  #endif
+  #define I80_QUEUE_DEPTH       16        // Transfers queued before a push blocks
+  #define I80_MAX_PIXELS        16384     // Largest single transfer, longer pushes are split
+  #define I80_FILL_PIXELS       2048      // Source buffer for pushBlock() fills, and
+                                          // bounce buffer for pixels DMA cannot read
+  #define I80_MIN_PIXELS        256       // Shorter pushes are quicker bit banged than queued
+
+  // Memory write continue: carries on from the last pixel written after RAMWR
+  #ifndef TFT_RAMWRC
+    #define TFT_RAMWRC 0x3C
+  #endif
+
+  esp_lcd_i80_bus_handle_t  i80Bus    = NULL;
+  esp_lcd_panel_io_handle_t i80Io     = NULL; // Sends colours in memory byte order
+  esp_lcd_panel_io_handle_t i80IoSwap = NULL; // Swaps the two bytes of each colour
+  uint16_t* i80Fill = nullptr;
+  uint32_t  i80FillColor = 0x10000;           // Colour in i80Fill, none yet
+  volatile uint32_t i80Pending = 0;           // Transfers queued and not yet complete
+  // Held while i80Pending and the pin routing change together, by i80Queue() and the
+  // completion interrupt, which may run on the other core
+  static portMUX_TYPE i80Lock = portMUX_INITIALIZER_UNLOCKED;
+
+  static const int8_t i80DataPins[8] = { TFT_D0, TFT_D1, TFT_D2, TFT_D3, TFT_D4, TFT_D5, TFT_D6, TFT_D7 };
+
+/***************************************************************************************
+** Function name:           i80RoutePins
+** Description:             Hand the bus pins to LCD_CAM (true) or back to GPIO (false)
+***************************************************************************************/
+static void IRAM_ATTR i80RoutePins(bool lcd)
+{
+  for (int i = 0; i < 8; i++) {
+    esp_rom_gpio_connect_out_signal(i80DataPins[i], lcd ? lcd_periph_signals.buses[0].data_sigs[i] : SIG_GPIO_OUT_IDX, false, false);
+  }
+  esp_rom_gpio_connect_out_signal(TFT_DC, lcd ? lcd_periph_signals.buses[0].dc_sig : SIG_GPIO_OUT_IDX, false, false);
+  esp_rom_gpio_connect_out_signal(TFT_WR, lcd ? lcd_periph_signals.buses[0].wr_sig : SIG_GPIO_OUT_IDX, false, false);
+}
+
+/***************************************************************************************
+** Function name:           i80TransferDone
+** Description:             Transfer complete interrupt, frees the bus after the last one
+***************************************************************************************/
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+static bool IRAM_ATTR i80TransferDone(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t *edata, void *ctx)
+#else
+static bool IRAM_ATTR i80TransferDone(esp_lcd_panel_io_handle_t io, void *ctx, void *edata)
+#endif
+{
+  portENTER_CRITICAL_ISR(&i80Lock);
+  if (--i80Pending == 0) i80RoutePins(false);
+  portEXIT_CRITICAL_ISR(&i80Lock);
+  return false;
+}
+
+/***************************************************************************************
+** Function name:           i80Queue
+** Description:             Queue pixels for the current window, returns once queued
+***************************************************************************************/
+// Call from the core that ran initDMA(), the completion interrupt is allocated there
+static void i80Queue(esp_lcd_panel_io_handle_t io, const uint16_t* data, uint32_t len)
+{
+  while (len) {
+    uint32_t n = (len > I80_MAX_PIXELS) ? I80_MAX_PIXELS : len;
+    portENTER_CRITICAL(&i80Lock);
+    if (i80Pending++ == 0) i80RoutePins(true);
+    portEXIT_CRITICAL(&i80Lock);
+    esp_lcd_panel_io_tx_color(io, TFT_RAMWRC, data, n * 2);
+    data += n;
+    len  -= n;
+  }
+}
+
+/***************************************************************************************
+** Function name:           i80Wait
+** Description:             Wait until every queued transfer is complete
+***************************************************************************************/
+static void i80Wait(void)
+{
+  while (i80Pending) taskYIELD();
+}
+
+/***************************************************************************************
+** Function name:           i80Push
+** Description:             Send pixels for the current window, returns once they are sent
+***************************************************************************************/
+// Callers reuse or free their buffer as soon as a push returns, and const images may be
+// in flash, which DMA cannot read. Pixels in internal RAM are sent where they are, others
+// are copied through the two halves of the fill buffer, one sent while the other is filled
+static void i80Push(esp_lcd_panel_io_handle_t io, const uint16_t* data, uint32_t len)
+{
+  if (esp_ptr_dma_capable(data)) i80Queue(io, data, len);
+  else {
+    const uint32_t half = I80_FILL_PIXELS / 2;
+    i80Wait();               // Transfers from pushImageDMA() would upset the count below
+    i80FillColor = 0x10000;  // It will not hold a fill colour any more
+    for (uint32_t part = 0; len; part ^= 1) {
+      uint32_t n = (len > half) ? half : len;
+      uint16_t* bounce = i80Fill + part * half;
+      while (i80Pending > 1) taskYIELD(); // The transfer before last, from this half
+      memcpy(bounce, data, n * 2);
+      i80Queue(io, bounce, n);
+      data += n;
+      len  -= n;
+    }
+  }
+  i80Wait();
+}
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////////////
 #if defined (TFT_SDA_READ) && !defined (TFT_PARALLEL_8_BIT)
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -538,6 +661,24 @@ void TFT_eSPI::pushSwapBytePixels(const void* data_in, uint32_t len){
 ** Description:             Write a block of pixels of the same colour
 ***************************************************************************************/
 void TFT_eSPI::pushBlock(uint16_t color, uint32_t len){
+#if defined (ESP32_I80_DMA)
+  // Returns once the fill is sent, the bus pins are plain GPIO again by then
+  if (DMA_Enabled && len >= I80_MIN_PIXELS) {
+    if (color != i80FillColor) {
+      uint16_t swapped = color << 8 | color >> 8;
+      for (uint32_t i = 0; i < I80_FILL_PIXELS; i++) i80Fill[i] = swapped;
+      i80FillColor = color;
+    }
+    while (len) {
+      uint32_t n = (len > I80_FILL_PIXELS) ? I80_FILL_PIXELS : len;
+      i80Queue(i80Io, i80Fill, n);
+      len -= n;
+    }
+    i80Wait();
+    return;
+  }
+  dmaWait();
+#endif
   if ( (color >> 8) == (color & 0x00FF) )
   { if (!len) return;
     tft_Write_16(color);
@@ -561,6 +702,10 @@ void TFT_eSPI::pushBlock(uint16_t color, uint32_t len){
 void TFT_eSPI::pushSwapBytePixels(const void* data_in, uint32_t len){
 
   uint16_t *data = (uint16_t*)data_in;
+#if defined (ESP32_I80_DMA)
+  if (DMA_Enabled && len >= I80_MIN_PIXELS) { i80Push(i80IoSwap, data, len); return; }
+  dmaWait();
+#endif
   while ( len-- ) {tft_Write_16(*data); data++;}
 }
 
@@ -568,9 +713,15 @@ void TFT_eSPI::pushSwapBytePixels(const void* data_in, uint32_t len){
 ** Function name:           pushPixels - for ESP32 and parallel display
 ** Description:             Write a sequence of pixels
 ***************************************************************************************/
+// With DMA the pixels are sent by the time this returns, use pushPixelsDMA() to carry on
+// drawing while they are
 void TFT_eSPI::pushPixels(const void* data_in, uint32_t len){
 
   uint16_t *data = (uint16_t*)data_in;
+#if defined (ESP32_I80_DMA)
+  if (DMA_Enabled && len >= I80_MIN_PIXELS) { i80Push(_swapBytes ? i80IoSwap : i80Io, data, len); return; }
+  dmaWait();
+#endif
   if(_swapBytes) { while ( len-- ) {tft_Write_16(*data); data++; } }
   else { while ( len-- ) {tft_Write_16S(*data); data++;} }
 }
@@ -893,6 +1044,210 @@ void TFT_eSPI::deInitDMA(void)
   DMA_Enabled = false;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////
+#elif defined (ESP32_I80_DMA) //       8-bit parallel DMA FUNCTIONS (LCD_CAM i80 mode)
+////////////////////////////////////////////////////////////////////////////////////////
+
+/***************************************************************************************
+** Function name:           dmaBusy
+** Description:             Check if DMA is busy
+***************************************************************************************/
+bool TFT_eSPI::dmaBusy(void)
+{
+  return i80Pending != 0;
+}
+
+/***************************************************************************************
+** Function name:           dmaWait
+** Description:             Wait until DMA is over (blocking!)
+***************************************************************************************/
+void TFT_eSPI::dmaWait(void)
+{
+  i80Wait();
+}
+
+/***************************************************************************************
+** Function name:           pushPixelsDMA
+** Description:             Push pixels to TFT
+***************************************************************************************/
+// This will byte swap the original image if setSwapBytes(true) was called by sketch.
+void TFT_eSPI::pushPixelsDMA(uint16_t* image, uint32_t len)
+{
+  if ((len == 0) || (!DMA_Enabled)) return;
+
+  dmaWait();
+
+  if(_swapBytes) {
+    for (uint32_t i = 0; i < len; i++) (image[i] = image[i] << 8 | image[i] >> 8);
+  }
+
+  // No 64Kbyte limit as on SPI, i80Queue() splits long pushes into queued transfers
+  i80Queue(i80Io, image, len);
+}
+
+/***************************************************************************************
+** Function name:           pushImageDMA
+** Description:             Push image to a window
+***************************************************************************************/
+// Fixed const data assumed, will NOT clip or swap bytes
+void TFT_eSPI::pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t const* image)
+{
+  if ((w == 0) || (h == 0) || (!DMA_Enabled)) return;
+
+  dmaWait();
+
+  setAddrWindow(x, y, w, h);
+
+  i80Queue(i80Io, image, w*h);
+}
+
+/***************************************************************************************
+** Function name:           pushImageDMA
+** Description:             Push image to a window
+***************************************************************************************/
+// This will clip and also swap bytes if setSwapBytes(true) was called by sketch
+void TFT_eSPI::pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t* image, uint16_t* buffer)
+{
+  if ((x >= _vpW) || (y >= _vpH) || (!DMA_Enabled)) return;
+
+  int32_t dx = 0;
+  int32_t dy = 0;
+  int32_t dw = w;
+  int32_t dh = h;
+
+  if (x < _vpX) { dx = _vpX - x; dw -= dx; x = _vpX; }
+  if (y < _vpY) { dy = _vpY - y; dh -= dy; y = _vpY; }
+
+  if ((x + dw) > _vpW ) dw = _vpW - x;
+  if ((y + dh) > _vpH ) dh = _vpH - y;
+
+  if (dw < 1 || dh < 1) return;
+
+  uint32_t len = dw*dh;
+
+  // The previous push may still be reading either buffer
+  dmaWait();
+  if (buffer == nullptr) buffer = image;
+
+  // If image is clipped, copy pixels into a contiguous block
+  if ( (dw != w) || (dh != h) ) {
+    if(_swapBytes) {
+      for (int32_t yb = 0; yb < dh; yb++) {
+        for (int32_t xb = 0; xb < dw; xb++) {
+          uint32_t src = xb + dx + w * (yb + dy);
+          (buffer[xb + yb * dw] = image[src] << 8 | image[src] >> 8);
+        }
+      }
+    }
+    else {
+      for (int32_t yb = 0; yb < dh; yb++) {
+        memmove((uint8_t*) (buffer + yb * dw), (uint8_t*) (image + dx + w * (yb + dy)), dw << 1);
+      }
+    }
+  }
+  // else, if a buffer pointer has been provided copy whole image to the buffer
+  else if (buffer != image || _swapBytes) {
+    if(_swapBytes) {
+      for (uint32_t i = 0; i < len; i++) (buffer[i] = image[i] << 8 | image[i] >> 8);
+    }
+    else {
+      memcpy(buffer, image, len*2);
+    }
+  }
+
+  setAddrWindow(x, y, dw, dh);
+
+  i80Queue(i80Io, buffer, len);
+}
+
+/***************************************************************************************
+** Function name:           initDMA
+** Description:             Initialise the DMA engine - returns true if init OK
+***************************************************************************************/
+// ctrl_cs is not used: chip select stays under library control, use startWrite() so it
+// is held low for the whole transfer
+bool TFT_eSPI::initDMA(bool ctrl_cs)
+{
+  (void)ctrl_cs;
+  if (DMA_Enabled) return false;
+
+  i80Fill = (uint16_t*)heap_caps_malloc(I80_FILL_PIXELS * 2, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+  if (i80Fill == nullptr) return false;
+  i80FillColor = 0x10000;
+
+  esp_lcd_i80_bus_config_t bus_config = {};
+  bus_config.dc_gpio_num = TFT_DC;
+  bus_config.wr_gpio_num = TFT_WR;
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+  bus_config.clk_src = LCD_CLK_SRC_DEFAULT;
+#endif
+  for (int i = 0; i < 8; i++) bus_config.data_gpio_nums[i] = i80DataPins[i];
+  bus_config.bus_width = 8;
+  bus_config.max_transfer_bytes = I80_MAX_PIXELS * 2;
+
+  if (esp_lcd_new_i80_bus(&bus_config, &i80Bus) != ESP_OK) {
+    heap_caps_free(i80Fill);
+    i80Fill = nullptr;
+    return false;
+  }
+
+  esp_lcd_panel_io_i80_config_t io_config = {};
+  io_config.cs_gpio_num = -1;
+  io_config.pclk_hz = TFT_I80_PCLK_HZ;
+  io_config.trans_queue_depth = I80_QUEUE_DEPTH;
+  io_config.on_color_trans_done = i80TransferDone;
+  io_config.user_ctx = nullptr;
+  io_config.lcd_cmd_bits = 8;
+  io_config.lcd_param_bits = 8;
+  io_config.dc_levels.dc_idle_level = 1;
+  io_config.dc_levels.dc_cmd_level = 0;
+  io_config.dc_levels.dc_dummy_level = 0;
+  io_config.dc_levels.dc_data_level = 1;
+
+  esp_err_t ret = esp_lcd_new_panel_io_i80(i80Bus, &io_config, &i80Io);
+  if (ret == ESP_OK) {
+    io_config.flags.swap_color_bytes = 1;
+    ret = esp_lcd_new_panel_io_i80(i80Bus, &io_config, &i80IoSwap);
+  }
+
+  // Creating the bus took the pins, give them back until the first transfer
+  i80RoutePins(false);
+
+  if (ret != ESP_OK) {
+    if (i80Io) esp_lcd_panel_io_del(i80Io);
+    esp_lcd_del_i80_bus(i80Bus);
+    heap_caps_free(i80Fill);
+    i80Io = NULL; i80Bus = NULL; i80Fill = nullptr;
+    return false;
+  }
+
+  i80Pending = 0;
+  DMA_Enabled = true;
+  return true;
+}
+
+/***************************************************************************************
+** Function name:           deInitDMA
+** Description:             Disconnect the DMA engine from the parallel bus
+***************************************************************************************/
+void TFT_eSPI::deInitDMA(void)
+{
+  if (!DMA_Enabled) return;
+  dmaWait();
+  esp_lcd_panel_io_del(i80IoSwap);
+  esp_lcd_panel_io_del(i80Io);
+  esp_lcd_del_i80_bus(i80Bus);
+  heap_caps_free(i80Fill);
+  i80IoSwap = NULL; i80Io = NULL; i80Bus = NULL; i80Fill = nullptr;
+
+  // Deleting the bus may reset the pins, restore them for the bit banged writes
+  i80RoutePins(false);
+  busDir(GPIO_DIR_MASK, OUTPUT);
+  pinMode(TFT_DC, OUTPUT); DC_D;
+  pinMode(TFT_WR, OUTPUT); WR_H;
+  DMA_Enabled = false;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////
 #endif // End of DMA FUNCTIONS
 ////////////////////////////////////////////////////////////////////////////////////////
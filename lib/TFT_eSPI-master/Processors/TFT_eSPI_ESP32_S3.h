@@ -107,8 +107,15 @@ SPI3_HOST = 2
   #endif
 #endif
 
-#if !defined(DISABLE_ALL_LIBRARY_WARNINGS) && defined (ESP32_PARALLEL)
- #warning >>>>------>> DMA is not supported in parallel mode
+// 8-bit parallel DMA runs on the LCD_CAM peripheral in i80 mode, which sends bytes in
+// memory order, so only displays taking plain 16-bit colour in two strobes can use it
+#if defined (ESP32_PARALLEL) && !defined (SSD1963_DRIVER) && !defined (PSEUDO_16_BIT)
+  #define ESP32_I80_DMA
+  #include "esp_lcd_panel_io.h"
+#endif
+
+#if !defined(DISABLE_ALL_LIBRARY_WARNINGS) && defined (ESP32_PARALLEL) && !defined (ESP32_I80_DMA)
+ #warning >>>>------>> DMA is not supported in parallel mode with this display driver
 #endif
 
 // Processor specific code used by SPI bus transaction startWrite and endWrite functions
@@ -136,11 +143,17 @@ SPI3_HOST = 2
   #define ESP32_DMA
   // Code to check if DMA is busy, used by SPI DMA + transaction + endWrite functions
   #define DMA_BUSY_CHECK  dmaWait()
+#elif defined (ESP32_I80_DMA)
+  #define DMA_BUSY_CHECK  dmaWait()
 #else
   #define DMA_BUSY_CHECK
 #endif
 
-#if defined(TFT_PARALLEL_8_BIT)
+#if defined (ESP32_I80_DMA)
+  // The data pins belong to LCD_CAM while a transfer runs, so any direct GPIO bus
+  // access (setWindow, drawPixel, end of transaction) waits for it first
+  #define SPI_BUSY_CHECK dmaWait()
+#elif defined(TFT_PARALLEL_8_BIT)
   #define SPI_BUSY_CHECK
 #else
   #define SPI_BUSY_CHECK while (*_spi_cmd&SPI_USR)
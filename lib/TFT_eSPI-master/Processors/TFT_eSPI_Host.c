@@ -0,0 +1,576 @@
+        ////////////////////////////////////////////////////
+        //       TFT_eSPI host framebuffer driver         //
+        ////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <string.h>
+
+// MIPI DCS commands the controller model acts on, everything else only has its
+// bytes counted
+#define HOST_SWRESET 0x01
+#define HOST_CASET   0x2A
+#define HOST_RASET   0x2B
+#define HOST_RAMWR   0x2C
+#define HOST_RAMRD   0x2E
+#define HOST_MADCTL  0x36
+#define HOST_RAMWRC  0x3C
+#define HOST_RAMRDC  0x3E
+
+// MADCTL bits
+#define HOST_MAD_MY  0x80
+#define HOST_MAD_MX  0x40
+#define HOST_MAD_MV  0x20
+#define HOST_MAD_BGR 0x08
+
+// Position of the glass in graphics RAM, what CGRAM_OFFSET compensates for
+#define HOST_GLASS_X ((HOST_GRAM_WIDTH  - TFT_WIDTH)  / 2)
+#define HOST_GLASS_Y ((HOST_GRAM_HEIGHT - TFT_HEIGHT) / 2)
+
+#define HOST_OUTSIDE 0xFFFFFFFF
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Global variables
+////////////////////////////////////////////////////////////////////////////////////////
+
+TFT_HostPanel hostPanel;
+
+/***************************************************************************************
+** Function name:           TFT_HostPanel
+** Description:             Constructor, starts in the power on state
+***************************************************************************************/
+TFT_HostPanel::TFT_HostPanel(void)
+{
+  reset();
+}
+
+/***************************************************************************************
+** Function name:           reset
+** Description:             Power on state with the statistics cleared
+***************************************************************************************/
+void TFT_HostPanel::reset(void)
+{
+  memset(_gram, 0, sizeof(_gram));
+  _dc = true;
+  _selected = false;
+  command(HOST_SWRESET);
+  clearStats();
+}
+
+/***************************************************************************************
+** Function name:           clearStats
+** Description:             Zero the bus counters
+***************************************************************************************/
+void TFT_HostPanel::clearStats(void)
+{
+  memset(&_stats, 0, sizeof(_stats));
+}
+
+/***************************************************************************************
+** Function name:           busCycles
+** Description:             Write and read strobes since the counters were cleared
+***************************************************************************************/
+uint32_t TFT_HostPanel::busCycles(void)
+{
+  return _stats.commands + _stats.paramBytes + _stats.pixelBytes + _stats.readBytes;
+}
+
+/***************************************************************************************
+** Function name:           select
+** Description:             Chip select, true drives it low
+***************************************************************************************/
+void TFT_HostPanel::select(bool low)
+{
+  if (low && !_selected) _stats.transactions++;
+  _selected = low;
+}
+
+/***************************************************************************************
+** Function name:           write8
+** Description:             One write strobe, a command or data byte depending on DC
+***************************************************************************************/
+void TFT_HostPanel::write8(uint8_t b)
+{
+  if (!_dc) {
+    _stats.commands++;
+    if (_selected) command(b);
+    return;
+  }
+
+  if ((_cmd == HOST_RAMWR) || (_cmd == HOST_RAMWRC)) {
+    _stats.pixelBytes++;
+    if (!_selected) return;
+    if (!_pixelHigh) { _pixelByte = b; _pixelHigh = true; }
+    else { storePixel((uint16_t)(_pixelByte << 8 | b)); _pixelHigh = false; }
+    return;
+  }
+
+  _stats.paramBytes++;
+  if (_selected) parameter(b);
+}
+
+/***************************************************************************************
+** Function name:           read8
+** Description:             One read strobe, a dummy byte then pixels high byte first
+***************************************************************************************/
+uint8_t TFT_HostPanel::read8(void)
+{
+  _stats.readBytes++;
+  if (!_selected || ((_cmd != HOST_RAMRD) && (_cmd != HOST_RAMRDC))) return 0;
+
+  if (_readPhase == 0) { _readPhase = 1; return 0; }
+  if (_readPhase == 1) {
+    uint16_t color = loadPixel();
+    _pixelByte = (uint8_t)color;
+    _readPhase = 2;
+    return color >> 8;
+  }
+  _readPhase = 1;
+  return _pixelByte;
+}
+
+/***************************************************************************************
+** Function name:           writeBlock
+** Description:             len pixels of one colour
+***************************************************************************************/
+void TFT_HostPanel::writeBlock(uint16_t color, uint32_t len)
+{
+  if (!_selected || !_dc || _pixelHigh || ((_cmd != HOST_RAMWR) && (_cmd != HOST_RAMWRC))) {
+    while (len--) write16(color);
+    return;
+  }
+  _stats.pixelBytes += len * 2;
+  while (len--) storePixel(color);
+}
+
+/***************************************************************************************
+** Function name:           writePixels
+** Description:             len pixels, with swapBytes as TFT_eSPI::setSwapBytes()
+***************************************************************************************/
+void TFT_HostPanel::writePixels(const uint16_t* data, uint32_t len, bool swapBytes)
+{
+  // With swapBytes the value is sent high byte first, otherwise in memory order
+  if (!_selected || !_dc || _pixelHigh || ((_cmd != HOST_RAMWR) && (_cmd != HOST_RAMWRC))) {
+    if (swapBytes) while (len--) write16(*data++);
+    else while (len--) { write16((uint16_t)(*data >> 8 | *data << 8)); data++; }
+    return;
+  }
+  _stats.pixelBytes += len * 2;
+  if (swapBytes) while (len--) storePixel(*data++);
+  else while (len--) { storePixel((uint16_t)(*data >> 8 | *data << 8)); data++; }
+}
+
+/***************************************************************************************
+** Function name:           readPixels
+** Description:             Bulk RAMRD, pixels stored byte swapped like readRect()
+***************************************************************************************/
+void TFT_HostPanel::readPixels(uint16_t* data, int32_t w, int32_t h, int32_t stride)
+{
+  if (!_selected || ((_cmd != HOST_RAMRD) && (_cmd != HOST_RAMRDC))) {
+    _stats.readBytes += 1 + 2 * w * h;
+    while (h--) { memset(data, 0, w * sizeof(uint16_t)); data += stride; }
+    return;
+  }
+
+  if (_readPhase == 0) { _stats.readBytes++; _readPhase = 1; }
+  _stats.readBytes += 2 * w * h;
+  while (h--) {
+    for (int32_t i = 0; i < w; i++) {
+      uint16_t color = loadPixel();
+      data[i] = (uint16_t)(color >> 8 | color << 8);
+    }
+    data += stride;
+  }
+}
+
+/***************************************************************************************
+** Function name:           command
+** Description:             Decode a command byte
+***************************************************************************************/
+void TFT_HostPanel::command(uint8_t cmd)
+{
+  _cmd = cmd;
+  _param = 0;
+  _pixelHigh = false;
+
+  switch (cmd) {
+    case HOST_SWRESET:
+      _madctl = 0;
+      _xs = 0; _xe = HOST_GRAM_WIDTH  - 1;
+      _ys = 0; _ye = HOST_GRAM_HEIGHT - 1;
+      _col = 0; _row = 0;
+      _readPhase = 0;
+      break;
+    case HOST_CASET:
+    case HOST_RASET:
+      _stats.windows++;
+      break;
+    case HOST_RAMWR:
+    case HOST_RAMRD:
+      _col = _xs; _row = _ys;
+      _readPhase = 0;
+      break;
+    case HOST_RAMRDC:
+      _readPhase = 0;
+      break;
+  }
+}
+
+/***************************************************************************************
+** Function name:           parameter
+** Description:             Collect a parameter byte, acting once the last one arrives
+***************************************************************************************/
+void TFT_HostPanel::parameter(uint8_t b)
+{
+  if (_param < sizeof(_args)) _args[_param] = b;
+  _param++;
+
+  if ((_cmd == HOST_MADCTL) && (_param == 1)) _madctl = b;
+  else if ((_cmd == HOST_CASET) && (_param == 4)) {
+    _xs = _args[0] << 8 | _args[1];
+    _xe = _args[2] << 8 | _args[3];
+  }
+  else if ((_cmd == HOST_RASET) && (_param == 4)) {
+    _ys = _args[0] << 8 | _args[1];
+    _ye = _args[2] << 8 | _args[3];
+  }
+}
+
+/***************************************************************************************
+** Function name:           gramIndex
+** Description:             Graphics RAM index of a column and row address
+***************************************************************************************/
+uint32_t TFT_HostPanel::gramIndex(int32_t col, int32_t row)
+{
+  // MV exchanges the roles of columns and rows, MX and MY reverse their order
+  bool    mv   = _madctl & HOST_MAD_MV;
+  int32_t cols = mv ? HOST_GRAM_HEIGHT : HOST_GRAM_WIDTH;
+  int32_t rows = mv ? HOST_GRAM_WIDTH  : HOST_GRAM_HEIGHT;
+
+  if ((col < 0) || (row < 0) || (col >= cols) || (row >= rows)) return HOST_OUTSIDE;
+  if (_madctl & HOST_MAD_MX) col = cols - 1 - col;
+  if (_madctl & HOST_MAD_MY) row = rows - 1 - row;
+
+  return mv ? col * HOST_GRAM_WIDTH + row : row * HOST_GRAM_WIDTH + col;
+}
+
+/***************************************************************************************
+** Function name:           advance
+** Description:             Step the RAM pointer through the address window
+***************************************************************************************/
+void TFT_HostPanel::advance(void)
+{
+  if (++_col > _xe) {
+    _col = _xs;
+    if (++_row > _ye) _row = _ys;
+  }
+}
+
+/***************************************************************************************
+** Function name:           storePixel
+** Description:             Write at the RAM pointer and advance it
+***************************************************************************************/
+void TFT_HostPanel::storePixel(uint16_t color)
+{
+  uint32_t i = gramIndex(_col, _row);
+  if (i != HOST_OUTSIDE) _gram[i] = color;
+  advance();
+}
+
+/***************************************************************************************
+** Function name:           loadPixel
+** Description:             Read at the RAM pointer and advance it
+***************************************************************************************/
+uint16_t TFT_HostPanel::loadPixel(void)
+{
+  uint32_t i = gramIndex(_col, _row);
+  advance();
+  return (i != HOST_OUTSIDE) ? _gram[i] : 0;
+}
+
+/***************************************************************************************
+** Function name:           viewOrigin
+** Description:             Column and row address of the top left of the glass
+***************************************************************************************/
+void TFT_HostPanel::viewOrigin(int32_t* col, int32_t* row)
+{
+  // Map two opposite glass corners back to addresses, the view starts at the smaller
+  bool    mv   = _madctl & HOST_MAD_MV;
+  int32_t cols = mv ? HOST_GRAM_HEIGHT : HOST_GRAM_WIDTH;
+  int32_t rows = mv ? HOST_GRAM_WIDTH  : HOST_GRAM_HEIGHT;
+  int32_t px[2] = { HOST_GLASS_X, HOST_GLASS_X + TFT_WIDTH  - 1 };
+  int32_t py[2] = { HOST_GLASS_Y, HOST_GLASS_Y + TFT_HEIGHT - 1 };
+
+  *col = 0x7FFFFFFF;
+  *row = 0x7FFFFFFF;
+  for (int i = 0; i < 2; i++) {
+    int32_t c = mv ? py[i] : px[i];
+    int32_t r = mv ? px[i] : py[i];
+    if (_madctl & HOST_MAD_MX) c = cols - 1 - c;
+    if (_madctl & HOST_MAD_MY) r = rows - 1 - r;
+    if (c < *col) *col = c;
+    if (r < *row) *row = r;
+  }
+}
+
+/***************************************************************************************
+** Function name:           viewWidth, viewHeight
+** Description:             Size of the glass in the current orientation
+***************************************************************************************/
+int32_t TFT_HostPanel::viewWidth(void)
+{
+  return (_madctl & HOST_MAD_MV) ? TFT_HEIGHT : TFT_WIDTH;
+}
+
+int32_t TFT_HostPanel::viewHeight(void)
+{
+  return (_madctl & HOST_MAD_MV) ? TFT_WIDTH : TFT_HEIGHT;
+}
+
+/***************************************************************************************
+** Function name:           viewPixel
+** Description:             Colour shown at x,y of the view, as RGB565
+***************************************************************************************/
+uint16_t TFT_HostPanel::viewPixel(int32_t x, int32_t y)
+{
+  if ((x < 0) || (y < 0) || (x >= viewWidth()) || (y >= viewHeight())) return 0;
+
+  int32_t col, row;
+  viewOrigin(&col, &row);
+  uint16_t color = _gram[gramIndex(col + x, row + y)];
+
+  // A BGR panel shows the red field as blue and the blue as red
+  if (_madctl & HOST_MAD_BGR) color = (color >> 11) | (color << 11) | (color & 0x07E0);
+  return color;
+}
+
+/***************************************************************************************
+** Function name:           readView
+** Description:             Copy the whole view, row by row
+***************************************************************************************/
+void TFT_HostPanel::readView(uint16_t* data)
+{
+  int32_t w = viewWidth(), h = viewHeight();
+  for (int32_t y = 0; y < h; y++)
+    for (int32_t x = 0; x < w; x++) *data++ = viewPixel(x, y);
+}
+
+/***************************************************************************************
+** Function name:           viewHash
+** Description:             32-bit FNV-1a hash of the view pixels, low byte first
+***************************************************************************************/
+uint32_t TFT_HostPanel::viewHash(void)
+{
+  uint32_t hash = 2166136261u;
+  int32_t w = viewWidth(), h = viewHeight();
+  for (int32_t y = 0; y < h; y++) {
+    for (int32_t x = 0; x < w; x++) {
+      uint16_t color = viewPixel(x, y);
+      hash = (hash ^ (color & 0xFF)) * 16777619u;
+      hash = (hash ^ (color >> 8))   * 16777619u;
+    }
+  }
+  return hash;
+}
+
+/***************************************************************************************
+** Function name:           savePPM
+** Description:             Write the view as a 24-bit binary PPM image
+***************************************************************************************/
+bool TFT_HostPanel::savePPM(const char* path)
+{
+  FILE* f = fopen(path, "wb");
+  if (!f) return false;
+
+  int32_t w = viewWidth(), h = viewHeight();
+  fprintf(f, "P6\n%d %d\n255\n", (int)w, (int)h);
+  for (int32_t y = 0; y < h; y++) {
+    uint8_t line[3 * (TFT_WIDTH > TFT_HEIGHT ? TFT_WIDTH : TFT_HEIGHT)];
+    uint8_t* p = line;
+    for (int32_t x = 0; x < w; x++) {
+      uint16_t color = viewPixel(x, y);
+      // Replicate the top bits into the low ones so full scale maps to 255
+      uint8_t r = (color >> 8) & 0xF8, g = (color >> 3) & 0xFC, b = (color << 3) & 0xF8;
+      *p++ = r | r >> 5;
+      *p++ = g | g >> 6;
+      *p++ = b | b >> 5;
+    }
+    fwrite(line, 3, w, f);
+  }
+  return fclose(f) == 0;
+}
+
+/***************************************************************************************
+** Function name:           pushBlock - for host framebuffer
+** Description:             Write a block of pixels of the same colour
+***************************************************************************************/
+void TFT_eSPI::pushBlock(uint16_t color, uint32_t len)
+{
+  hostPanel.writeBlock(color, len);
+}
+
+/***************************************************************************************
+** Function name:           pushPixels - for host framebuffer
+** Description:             Write a sequence of pixels
+***************************************************************************************/
+void TFT_eSPI::pushPixels(const void* data_in, uint32_t len)
+{
+  hostPanel.writePixels((const uint16_t*)data_in, len, _swapBytes);
+}
+
+/***************************************************************************************
+** Function name:           GPIO direction control  - supports class functions
+** Description:             Nothing to switch, reads and writes share the model
+***************************************************************************************/
+void TFT_eSPI::busDir(uint32_t, uint8_t)
+{
+}
+
+/***************************************************************************************
+** Function name:           GPIO direction control  - supports class functions
+** Description:             Faster GPIO pin input/output switch
+***************************************************************************************/
+void TFT_eSPI::gpioMode(uint8_t, uint8_t)
+{
+}
+
+/***************************************************************************************
+** Function name:           read byte  - supports class functions
+** Description:             Read a byte - parallel bus only
+***************************************************************************************/
+uint8_t TFT_eSPI::readByte(void)
+{
+  return hostPanel.read8();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+//                                DMA FUNCTIONS
+////////////////////////////////////////////////////////////////////////////////////////
+
+// A transfer is only sent when it is waited for: by the next DMA push, dmaWait() or
+// endWrite(). That is the longest a real transfer can take, so a buffer changed while
+// its transfer is queued shows up on the panel.
+
+static const uint16_t* hostDmaData = nullptr;  // Transfer queued, not yet sent
+static uint32_t hostDmaLen = 0;
+
+/***************************************************************************************
+** Function name:           dmaBusy
+** Description:             Check if DMA is busy
+***************************************************************************************/
+bool TFT_eSPI::dmaBusy(void)
+{
+  return hostDmaLen != 0;
+}
+
+/***************************************************************************************
+** Function name:           dmaWait
+** Description:             Send the queued transfer
+***************************************************************************************/
+void TFT_eSPI::dmaWait(void)
+{
+  if (hostDmaLen == 0) return;
+  hostPanel.writePixels(hostDmaData, hostDmaLen, false); // Already in TFT byte order
+  hostDmaData = nullptr;
+  hostDmaLen = 0;
+}
+
+/***************************************************************************************
+** Function name:           pushPixelsDMA
+** Description:             Push pixels to TFT
+***************************************************************************************/
+// This will byte swap the original image if setSwapBytes(true) was called by sketch.
+void TFT_eSPI::pushPixelsDMA(uint16_t* image, uint32_t len)
+{
+  if ((len == 0) || (!DMA_Enabled)) return;
+
+  dmaWait();
+
+  if(_swapBytes) {
+    for (uint32_t i = 0; i < len; i++) (image[i] = image[i] << 8 | image[i] >> 8);
+  }
+
+  hostDmaData = image;
+  hostDmaLen = len;
+}
+
+/***************************************************************************************
+** Function name:           pushImageDMA
+** Description:             Push image to a window
+***************************************************************************************/
+// This will clip and also swap bytes if setSwapBytes(true) was called by sketch
+void TFT_eSPI::pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t* image, uint16_t* buffer)
+{
+  if ((x >= _vpW) || (y >= _vpH) || (!DMA_Enabled)) return;
+
+  int32_t dx = 0;
+  int32_t dy = 0;
+  int32_t dw = w;
+  int32_t dh = h;
+
+  if (x < _vpX) { dx = _vpX - x; dw -= dx; x = _vpX; }
+  if (y < _vpY) { dy = _vpY - y; dh -= dy; y = _vpY; }
+
+  if ((x + dw) > _vpW ) dw = _vpW - x;
+  if ((y + dh) > _vpH ) dh = _vpH - y;
+
+  if (dw < 1 || dh < 1) return;
+
+  uint32_t len = dw*dh;
+
+  // The previous push may still be reading either buffer
+  dmaWait();
+  if (buffer == nullptr) buffer = image;
+
+  // If image is clipped, copy pixels into a contiguous block
+  if ( (dw != w) || (dh != h) ) {
+    if(_swapBytes) {
+      for (int32_t yb = 0; yb < dh; yb++) {
+        for (int32_t xb = 0; xb < dw; xb++) {
+          uint32_t src = xb + dx + w * (yb + dy);
+          (buffer[xb + yb * dw] = image[src] << 8 | image[src] >> 8);
+        }
+      }
+    }
+    else {
+      for (int32_t yb = 0; yb < dh; yb++) {
+        memmove((uint8_t*) (buffer + yb * dw), (uint8_t*) (image + dx + w * (yb + dy)), dw << 1);
+      }
+    }
+  }
+  // else, if a buffer pointer has been provided copy whole image to the buffer
+  else if (buffer != image || _swapBytes) {
+    if(_swapBytes) {
+      for (uint32_t i = 0; i < len; i++) (buffer[i] = image[i] << 8 | image[i] >> 8);
+    }
+    else {
+      memcpy(buffer, image, len*2);
+    }
+  }
+
+  setAddrWindow(x, y, dw, dh);
+
+  hostDmaData = buffer;
+  hostDmaLen = len;
+}
+
+/***************************************************************************************
+** Function name:           initDMA
+** Description:             Initialise the DMA engine - returns true if init OK
+***************************************************************************************/
+bool TFT_eSPI::initDMA(bool)
+{
+  if (DMA_Enabled) return false;
+  DMA_Enabled = true;
+  return true;
+}
+
+/***************************************************************************************
+** Function name:           deInitDMA
+** Description:             Disconnect the DMA engine
+***************************************************************************************/
+void TFT_eSPI::deInitDMA(void)
+{
+  if (!DMA_Enabled) return;
+  dmaWait();
+  DMA_Enabled = false;
+}
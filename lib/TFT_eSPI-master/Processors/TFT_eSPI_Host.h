@@ -0,0 +1,204 @@
+        ////////////////////////////////////////////////////
+        //       TFT_eSPI host framebuffer driver         //
+        ////////////////////////////////////////////////////
+
+// This driver builds the library on a desktop host (Linux, macOS) for rendering tests
+// and benchmarks. There is no display: the bytes the library sends over its 8-bit
+// parallel bus are decoded by a model of a MIPI DCS controller (ST7789 style) that
+// keeps its graphics RAM in memory. The model honours CASET, RASET, RAMWR, RAMRD and
+// MADCTL, so rotation, address offsets and windowing behave as on the real panel, and
+// it counts every byte and transaction on the bus.
+//
+// Selected by defining TFT_HOST_FRAMEBUFFER in the user setup, together with
+// TFT_PARALLEL_8_BIT. The host must supply minimal Arduino.h and Print.h headers.
+
+#ifndef _TFT_eSPI_HOSTH_
+#define _TFT_eSPI_HOSTH_
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Processor ID reported by getSetup()
+#define PROCESSOR_ID 0x0100
+
+#if !defined (TFT_PARALLEL_8_BIT)
+  #error >>>>------>> The host framebuffer driver models an 8-bit parallel bus, define TFT_PARALLEL_8_BIT
+#endif
+
+// Controller graphics RAM, the visible glass is centred in it (e.g. 170x320 in 240x320)
+#ifndef HOST_GRAM_WIDTH
+  #define HOST_GRAM_WIDTH  240
+#endif
+#ifndef HOST_GRAM_HEIGHT
+  #define HOST_GRAM_HEIGHT 320
+#endif
+
+// Time for one write or read strobe, used to turn bus cycles into bus time.
+// 50ns matches the 20MHz LCD_CAM pixel clock used by ESP32_I80_DMA
+#ifndef HOST_BUS_CYCLE_NS
+  #define HOST_BUS_CYCLE_NS 50
+#endif
+
+// Processor specific code used by SPI bus transaction startWrite and endWrite functions
+#define SET_BUS_WRITE_MODE // Not used
+#define SET_BUS_READ_MODE  // Not used
+
+// DMA is modelled by holding each transfer back until it is waited for, see dmaWait()
+#define HOST_DMA
+
+// Code to check if DMA is busy, used by SPI bus transaction startWrite and endWrite functions
+#define DMA_BUSY_CHECK  dmaWait()
+
+#if !defined (SUPPORT_TRANSACTIONS)
+  #define SUPPORT_TRANSACTIONS
+#endif
+
+// Initialise processor specific SPI functions, used by init()
+#define INIT_TFT_DATA_BUS
+#define PARALLEL_INIT_TFT_DATA_BUS
+
+// Anti-aliased fonts can only be loaded from arrays, there is no filing system
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Bus statistics, every byte is one write or read strobe on the 8-bit bus
+////////////////////////////////////////////////////////////////////////////////////////
+typedef struct {
+  uint32_t transactions; // Chip select low edges
+  uint32_t commands;     // Command bytes (DC low)
+  uint32_t windows;      // CASET and RASET commands
+  uint32_t paramBytes;   // Data bytes that are not pixels (command parameters)
+  uint32_t pixelBytes;   // Data bytes written to graphics RAM
+  uint32_t readBytes;    // Bytes read back, including dummy bytes
+} host_bus_stats_t;
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Model of the display controller and its graphics RAM
+////////////////////////////////////////////////////////////////////////////////////////
+class TFT_HostPanel {
+
+ public:
+
+  TFT_HostPanel(void);
+
+           // Power on state: black graphics RAM, default address window, counters cleared
+  void     reset(void);
+
+           // Bus interface, used by the macros below
+  void     select(bool low);
+  void     dataMode(bool data) { _dc = data; }
+  void     write8(uint8_t b);
+  void     write16(uint16_t w) { write8((uint8_t)(w >> 8)); write8((uint8_t)w); }
+  uint8_t  read8(void);
+
+           // Bulk pixel writes, the same bus traffic as write16() per pixel but faster
+  void     writeBlock(uint16_t color, uint32_t len);
+  void     writePixels(const uint16_t* data, uint32_t len, bool swap);
+
+           // Bulk RAMRD after readAddrWindow(): a dummy byte then 2 bytes per pixel,
+           // stored byte swapped as readRect() returns them. stride is the buffer width
+  void     readPixels(uint16_t* data, int32_t w, int32_t h, int32_t stride);
+
+           // The glass as the library sees it with the current MADCTL setting, so the
+           // view matches width() and height() after setRotation()
+  int32_t  viewWidth(void);
+  int32_t  viewHeight(void);
+  uint16_t viewPixel(int32_t x, int32_t y);
+  void     readView(uint16_t* data); // viewWidth() * viewHeight() pixels, RGB565 native order
+  uint32_t viewHash(void);           // FNV-1a over readView(), for golden image tests
+
+           // Write the view as a binary PPM (P6) image, returns false if the file fails
+  bool     savePPM(const char* path);
+
+           // Bus counters, cleared by clearStats() and reset()
+  void     getStats(host_bus_stats_t* stats) { *stats = _stats; }
+  void     clearStats(void);
+  uint32_t busCycles(void);
+  uint64_t busNs(void) { return (uint64_t)busCycles() * HOST_BUS_CYCLE_NS; }
+
+ private:
+
+  void     command(uint8_t cmd);
+  void     parameter(uint8_t b);
+  void     storePixel(uint16_t color);
+  uint16_t loadPixel(void);
+  void     advance(void);
+  uint32_t gramIndex(int32_t col, int32_t row);
+  void     viewOrigin(int32_t* col, int32_t* row);
+
+  uint16_t _gram[HOST_GRAM_WIDTH * HOST_GRAM_HEIGHT];
+
+  bool     _dc;                // Data/command line, true for data
+  bool     _selected;
+  uint8_t  _cmd;               // Last command, its parameters follow
+  uint8_t  _param;             // Parameter bytes received for _cmd
+  uint8_t  _args[4];
+  uint8_t  _madctl;
+  bool     _pixelHigh;         // High byte of a pixel received, waiting for the low byte
+  uint8_t  _pixelByte;
+  int32_t  _xs, _xe, _ys, _ye; // Address window from CASET and RASET
+  int32_t  _col, _row;         // Write or read pointer
+  uint8_t  _readPhase;         // 0 dummy byte, 1 high byte, 2 low byte
+
+  host_bus_stats_t _stats;
+};
+
+extern TFT_HostPanel hostPanel;
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Define the DC (TFT Data/Command or Register Select (RS))pin drive code
+////////////////////////////////////////////////////////////////////////////////////////
+#define DC_C hostPanel.dataMode(false)
+#define DC_D hostPanel.dataMode(true)
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Define the CS (TFT chip select) pin drive code
+////////////////////////////////////////////////////////////////////////////////////////
+#define CS_L hostPanel.select(true)
+#define CS_H hostPanel.select(false)
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Strobes are part of each bus access in the model
+////////////////////////////////////////////////////////////////////////////////////////
+#define WR_L
+#define WR_H
+#define RD_L
+#define RD_H
+
+#ifndef TFT_RD
+  #define TFT_RD -1
+#endif
+
+#define GPIO_DIR_MASK 0
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Define the touch screen chip select pin drive code
+////////////////////////////////////////////////////////////////////////////////////////
+#define T_CS_L // No macro allocated so it generates no code
+#define T_CS_H // No macro allocated so it generates no code
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Macros to write commands/pixel colour data to the modelled 8-bit parallel bus
+////////////////////////////////////////////////////////////////////////////////////////
+// Write 8 bits to TFT
+#define tft_Write_8(C)   hostPanel.write8((uint8_t)(C))
+
+// Write 16 bits to TFT
+#define tft_Write_16(C)  hostPanel.write16((uint16_t)(C))
+#define tft_Write_16N(C) hostPanel.write16((uint16_t)(C))
+
+// 16-bit write with swapped bytes
+#define tft_Write_16S(C) hostPanel.write16((uint16_t)((C) >> 8 | (C) << 8))
+
+// Write 32 bits to TFT
+#define tft_Write_32(C)  hostPanel.write16((uint16_t)((C) >> 16)); hostPanel.write16((uint16_t)(C))
+
+// Write two concatenated 16-bit values to TFT
+#define tft_Write_32C(C,D) hostPanel.write16((uint16_t)(C)); hostPanel.write16((uint16_t)(D))
+
+// Write 16-bit value twice to TFT - used by drawPixel()
+#define tft_Write_32D(C) hostPanel.write16((uint16_t)(C)); hostPanel.write16((uint16_t)(C))
+
+// Read 8 bits from TFT
+#define tft_Read_8() hostPanel.read8()
+
+#endif // Header end
@@ -29,6 +29,8 @@
   #include "Processors/TFT_eSPI_STM32.c"
 #elif defined (ARDUINO_ARCH_RP2040)  || defined (ARDUINO_ARCH_MBED) // Raspberry Pi Pico
   #include "Processors/TFT_eSPI_RP2040.c"
+#elif defined (TFT_HOST_FRAMEBUFFER) // Desktop build for tests, renders into memory
+  #include "Processors/TFT_eSPI_Host.c"
 #else
   #include "Processors/TFT_eSPI_Generic.c"
 #endif
@@ -104,6 +106,7 @@ inline void TFT_eSPI::end_tft_write(void){
       locked = true;        // Flag to show SPI access now locked
       SPI_BUSY_CHECK;       // Check send complete and clean out unused rx data
       CS_H;
+      addr_ptr = -1;        // A RAMWR stream ends with chip select
       SET_BUS_READ_MODE;    // In case bus has been configured for tx only
 #if defined (SPI_HAS_TRANSACTION) && defined (SUPPORT_TRANSACTIONS) && !defined(TFT_PARALLEL_8_BIT) && !defined(RP2040_PIO_INTERFACE)
       spi.endTransaction();
@@ -119,6 +122,7 @@ inline void TFT_eSPI::end_nin_write(void){
       locked = true;        // Flag to show SPI access now locked
       SPI_BUSY_CHECK;       // Check send complete and clean out unused rx data
       CS_H;
+      addr_ptr = -1;        // A RAMWR stream ends with chip select
       SET_BUS_READ_MODE;    // In case SPI has been configured for tx only
 #if defined (SPI_HAS_TRANSACTION) && defined (SUPPORT_TRANSACTIONS) && !defined(TFT_PARALLEL_8_BIT) && !defined(RP2040_PIO_INTERFACE)
       spi.endTransaction();
@@ -134,6 +138,7 @@ inline void TFT_eSPI::end_nin_write(void){
 // Reads require a lower SPI clock rate than writes
 inline void TFT_eSPI::begin_tft_read(void){
   DMA_BUSY_CHECK; // Wait for any DMA transfer to complete before changing SPI settings
+  addr_ptr = -1;  // Reads end a RAMWR stream
 #if defined (SPI_HAS_TRANSACTION) && defined (SUPPORT_TRANSACTIONS) && !defined(TFT_PARALLEL_8_BIT) && !defined(RP2040_PIO_INTERFACE)
   if (locked) {
     locked = false;
@@ -469,6 +474,7 @@ TFT_eSPI::TFT_eSPI(int16_t w, int16_t h)
   _booted   = true;     // Default attributes
   _cp437    = false;    // Legacy GLCD font bug fix disabled by default
   _utf8     = true;     // UTF8 decoding enabled
+  _windowCache = true;  // Unchanged address window commands skipped
 
 #if defined (FONT_FS_AVAILABLE) && defined (SMOOTH_FONT)
   fs_font  = true;     // Smooth font filing system or array (fs_font = false) flag
@@ -482,6 +488,7 @@ TFT_eSPI::TFT_eSPI(int16_t w, int16_t h)
 
   addr_row = 0xFFFF;  // drawPixel command length optimiser
   addr_col = 0xFFFF;  // drawPixel command length optimiser
+  addr_ptr = -1;
 
   _xPivot = 0;
   _yPivot = 0;
@@ -878,6 +885,7 @@ void TFT_eSPI::setRotation(uint8_t m)
 
   addr_row = 0xFFFF;
   addr_col = 0xFFFF;
+  addr_ptr = -1;
 
   // Reset the viewport to the whole screen
   resetViewport();
@@ -979,6 +987,11 @@ void TFT_eSPI::spiwrite(uint8_t c)
 #ifndef RM68120_DRIVER
 void TFT_eSPI::writecommand(uint8_t c)
 {
+  // The command may set the address window, or end a RAMWR stream
+  addr_row = 0xFFFF;
+  addr_col = 0xFFFF;
+  addr_ptr = -1;
+
   begin_tft_write();
 
   DC_C;
@@ -992,6 +1005,11 @@ void TFT_eSPI::writecommand(uint8_t c)
 #else
 void TFT_eSPI::writecommand(uint16_t c)
 {
+  // The command may set the address window, or end a RAMWR stream
+  addr_row = 0xFFFF;
+  addr_col = 0xFFFF;
+  addr_ptr = -1;
+
   begin_tft_write();
 
   DC_C;
@@ -1005,6 +1023,10 @@ void TFT_eSPI::writecommand(uint16_t c)
 }
 void TFT_eSPI::writeRegister8(uint16_t c, uint8_t d)
 {
+  addr_row = 0xFFFF;
+  addr_col = 0xFFFF;
+  addr_ptr = -1;
+
   begin_tft_write();
 
   DC_C;
@@ -1020,6 +1042,10 @@ void TFT_eSPI::writeRegister8(uint16_t c, uint8_t d)
 }
 void TFT_eSPI::writeRegister16(uint16_t c, uint16_t d)
 {
+  addr_row = 0xFFFF;
+  addr_col = 0xFFFF;
+  addr_ptr = -1;
+
   begin_tft_write();
 
   DC_C;
@@ -1143,7 +1169,21 @@ uint16_t TFT_eSPI::readPixel(int32_t x0, int32_t y0)
   // Range checking
   if ((x0 < _vpX) || (y0 < _vpY) ||(x0 >= _vpW) || (y0 >= _vpH)) return 0;
 
-#if defined(TFT_PARALLEL_8_BIT) || defined(RP2040_PIO_INTERFACE)
+#if defined (TFT_HOST_FRAMEBUFFER)
+
+  if (!inTransaction) { CS_L; }
+
+  readAddrWindow(x0, y0, 1, 1);
+
+  // Read back byte swapped, as readRect() returns it
+  uint16_t color;
+  hostPanel.readPixels(&color, 1, 1, 1);
+
+  if (!inTransaction) { CS_H; }
+
+  return (color >> 8) | (color << 8);
+
+#elif defined(TFT_PARALLEL_8_BIT) || defined(RP2040_PIO_INTERFACE)
 
   if (!inTransaction) { CS_L; } // CS_L can be multi-statement
 
@@ -1274,7 +1314,18 @@ void TFT_eSPI::readRect(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *da
 {
   PI_CLIP ;
 
-#if defined(TFT_PARALLEL_8_BIT) || defined(RP2040_PIO_INTERFACE)
+#if defined (TFT_HOST_FRAMEBUFFER)
+
+  if (!inTransaction) { CS_L; }
+
+  readAddrWindow(x, y, dw, dh);
+
+  // Dummy byte then 2 bytes per pixel, stored byte swapped for pushRect()
+  hostPanel.readPixels(data + dx + dy * w, dw, dh, w);
+
+  if (!inTransaction) { CS_H; }
+
+#elif defined(TFT_PARALLEL_8_BIT) || defined(RP2040_PIO_INTERFACE)
 
   CS_L;
 
@@ -3099,7 +3150,7 @@ int16_t TFT_eSPI::textWidth(const char *string, uint8_t font)
 #endif
 
   if (font>1 && font<9) {
-    char *widthtable = (char *)pgm_read_dword( &(fontdata[font].widthtbl ) ) - 32; //subtract the 32 outside the loop
+    char *widthtable = (char *)pgm_read_ptr( &(fontdata[font].widthtbl ) ) - 32; //subtract the 32 outside the loop
 
     while (*string) {
       uniCode = *(string++);
@@ -3117,7 +3168,7 @@ int16_t TFT_eSPI::textWidth(const char *string, uint8_t font)
         uniCode = decodeUTF8(*string++);
         if ((uniCode >= pgm_read_word(&gfxFont->first)) && (uniCode <= pgm_read_word(&gfxFont->last ))) {
           uniCode -= pgm_read_word(&gfxFont->first);
-          GFXglyph *glyph  = &(((GFXglyph *)pgm_read_dword(&gfxFont->glyph))[uniCode]);
+          GFXglyph *glyph  = &(((GFXglyph *)pgm_read_ptr(&gfxFont->glyph))[uniCode]);
           // If this is not the  last character or is a digit then use xAdvance
           if (*string  || isDigits) str_width += pgm_read_byte(&glyph->xAdvance);
           // Else use the offset plus width since this can be bigger than xAdvance
@@ -3191,6 +3242,8 @@ void TFT_eSPI::drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color, uint32
   #endif
 //>>>>>>>>>>>>>>>>>>
 
+  if (drawAtlasChar(1, c, x, y, color, bg, size)) return;
+
   int32_t xd = x + _xDatum;
   int32_t yd = y + _yDatum;
 
@@ -3271,8 +3324,8 @@ void TFT_eSPI::drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color, uint32
 //>>>>>>>>>>>>>>>>>>>>>>>>>>>
 
       c -= pgm_read_word(&gfxFont->first);
-      GFXglyph *glyph  = &(((GFXglyph *)pgm_read_dword(&gfxFont->glyph))[c]);
-      uint8_t  *bitmap = (uint8_t *)pgm_read_dword(&gfxFont->bitmap);
+      GFXglyph *glyph  = &(((GFXglyph *)pgm_read_ptr(&gfxFont->glyph))[c]);
+      uint8_t  *bitmap = (uint8_t *)pgm_read_ptr(&gfxFont->bitmap);
 
       uint32_t bo = pgm_read_word(&glyph->bitmapOffset);
       uint8_t  w  = pgm_read_byte(&glyph->width),
@@ -3360,10 +3413,12 @@ void TFT_eSPI::setAddrWindow(int32_t x0, int32_t y0, int32_t w, int32_t h)
 void TFT_eSPI::setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
 {
   //begin_tft_write(); // Must be called before setWindow
+  addr_ptr = -1; // The pixels that follow are the caller's
+
+#if defined (ILI9225_DRIVER)
   addr_row = 0xFFFF;
   addr_col = 0xFFFF;
 
-#if defined (ILI9225_DRIVER)
   if (rotation & 0x01) { transpose(x0, y0); transpose(x1, y1); }
   SPI_BUSY_CHECK;
   DC_C; tft_Write_8(TFT_CASET1);
@@ -3391,6 +3446,9 @@ void TFT_eSPI::setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
     hw_write_masked(&spi_get_hw(SPI_X)->cr0, (16 - 1) << SPI_SSPCR0_DSS_LSB, SPI_SSPCR0_DSS_BITS);
   #endif
 #elif defined (SSD1351_DRIVER)
+  addr_row = 0xFFFF;
+  addr_col = 0xFFFF;
+
   if (rotation & 1) {
     transpose(x0, y0);
     transpose(x1, y1);
@@ -3416,6 +3474,9 @@ void TFT_eSPI::setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
 
   // Temporary solution is to include the RP2040 optimised code here
   #if (defined(ARDUINO_ARCH_RP2040)  || defined (ARDUINO_ARCH_MBED))
+    addr_row = 0xFFFF;
+    addr_col = 0xFFFF;
+
     #if !defined(RP2040_PIO_INTERFACE)
       // Use hardware SPI port, this code does not swap from 8 to 16-bit
       // to avoid the spi_set_format() call overhead
@@ -3481,11 +3542,31 @@ void TFT_eSPI::setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
       TX_FIFO = TFT_RAMWR;
     #endif
   #else
+    #if defined (MULTI_TFT_SUPPORT) || defined (GC9A01_DRIVER)
+      addr_row = 0xFFFF; // Another TFT may have set its window, or the TFT needs it each time
+      addr_col = 0xFFFF;
+    #else
+      if (!_windowCache) {
+        addr_row = 0xFFFF;
+        addr_col = 0xFFFF;
+      }
+    #endif
+
     SPI_BUSY_CHECK;
-    DC_C; tft_Write_8(TFT_CASET);
-    DC_D; tft_Write_32C(x0, x1);
-    DC_C; tft_Write_8(TFT_PASET);
-    DC_D; tft_Write_32C(y0, y1);
+    // The TFT keeps the column and row ranges, only send those that change.
+    // RAMWR is always sent as it starts the pixel stream at x0, y0
+    if ((addr_col != x0) || (addr_col_end != x1)) {
+      DC_C; tft_Write_8(TFT_CASET);
+      DC_D; tft_Write_32C(x0, x1);
+      addr_col = x0;
+      addr_col_end = x1;
+    }
+    if ((addr_row != y0) || (addr_row_end != y1)) {
+      DC_C; tft_Write_8(TFT_PASET);
+      DC_D; tft_Write_32C(y0, y1);
+      addr_row = y0;
+      addr_row_end = y1;
+    }
     DC_C; tft_Write_8(TFT_RAMWR);
     DC_D;
   #endif // RP2040 SPI
@@ -3504,8 +3585,7 @@ void TFT_eSPI::readAddrWindow(int32_t xs, int32_t ys, int32_t w, int32_t h)
   int32_t xe = xs + w - 1;
   int32_t ye = ys + h - 1;
 
-  addr_col = 0xFFFF;
-  addr_row = 0xFFFF;
+  addr_ptr = -1;
 
 #if defined (SSD1963_DRIVER)
   if ((rotation & 0x1) == 0) { transpose(xs, ys); transpose(xe, ye); }
@@ -3520,6 +3600,9 @@ void TFT_eSPI::readAddrWindow(int32_t xs, int32_t ys, int32_t w, int32_t h)
 
   // Temporary solution is to include the RP2040 optimised code here
 #if (defined(ARDUINO_ARCH_RP2040)  || defined (ARDUINO_ARCH_MBED)) && !defined(RP2040_PIO_INTERFACE)
+  addr_col = 0xFFFF;
+  addr_row = 0xFFFF;
+
   // Use hardware SPI port, this code does not swap from 8 to 16-bit
   // to avoid the spi_set_format() call overhead
   while (spi_get_hw(SPI_X)->sr & SPI_SSPSR_BSY_BITS) {};
@@ -3557,13 +3640,31 @@ void TFT_eSPI::readAddrWindow(int32_t xs, int32_t ys, int32_t w, int32_t h)
   spi_get_hw(SPI_X)->icr = SPI_SSPICR_RORIC_BITS;
 
 #else
-  // Column addr set
-  DC_C; tft_Write_8(TFT_CASET);
-  DC_D; tft_Write_32C(xs, xe);
+  #if defined (MULTI_TFT_SUPPORT) || defined (GC9A01_DRIVER)
+    addr_row = 0xFFFF;
+    addr_col = 0xFFFF;
+  #else
+    if (!_windowCache) {
+      addr_row = 0xFFFF;
+      addr_col = 0xFFFF;
+    }
+  #endif
+
+  // Column addr set, unless the TFT has it
+  if ((addr_col != xs) || (addr_col_end != xe)) {
+    DC_C; tft_Write_8(TFT_CASET);
+    DC_D; tft_Write_32C(xs, xe);
+    addr_col = xs;
+    addr_col_end = xe;
+  }
 
   // Row addr set
-  DC_C; tft_Write_8(TFT_PASET);
-  DC_D; tft_Write_32C(ys, ye);
+  if ((addr_row != ys) || (addr_row_end != ye)) {
+    DC_C; tft_Write_8(TFT_PASET);
+    DC_D; tft_Write_32C(ys, ye);
+    addr_row = ys;
+    addr_row_end = ye;
+  }
 
   // Read CGRAM command
   DC_C; tft_Write_8(TFT_RAMRD);
@@ -3755,24 +3856,42 @@ void TFT_eSPI::drawPixel(int32_t x, int32_t y, uint32_t color)
       DC_D; tft_Write_16(y | (y << 8));
       addr_row = y;
     }
+
+    DC_C; tft_Write_8(TFT_RAMWR);
   #else
-    // No need to send x if it has not changed (speeds things up)
-    if (addr_col != x) {
-      DC_C; tft_Write_8(TFT_CASET);
-      DC_D; tft_Write_32D(x);
-      addr_col = x;
-    }
+    // The window runs to the end of the row, so while chip select stays low the next
+    // pixel along the row follows in the RAMWR stream of this one without any commands
+    if ((addr_ptr != x) || (addr_row != y)) {
+      #if defined (SSD1963_DRIVER)
+        int32_t xe = x; // Columns are screen rows in some rotations
+      #elif defined (CGRAM_OFFSET)
+        int32_t xe = _width - 1 + colstart;
+      #else
+        int32_t xe = _width - 1;
+      #endif
 
-    // No need to send y if it has not changed (speeds things up)
-    if (addr_row != y) {
-      DC_C; tft_Write_8(TFT_PASET);
-      DC_D; tft_Write_32D(y);
-      addr_row = y;
+      // No need to send x if it has not changed (speeds things up)
+      if ((addr_col != x) || (addr_col_end != xe)) {
+        DC_C; tft_Write_8(TFT_CASET);
+        DC_D; tft_Write_32C(x, xe);
+        addr_col = x;
+        addr_col_end = xe;
+      }
+
+      // No need to send y if it has not changed (speeds things up)
+      if ((addr_row != y) || (addr_row_end != y)) {
+        DC_C; tft_Write_8(TFT_PASET);
+        DC_D; tft_Write_32D(y);
+        addr_row = y;
+        addr_row_end = y;
+      }
+
+      DC_C; tft_Write_8(TFT_RAMWR);
+      addr_ptr = (_windowCache && x < xe) ? x + 1 : -1;
     }
+    else addr_ptr++;
   #endif
 
-  DC_C; tft_Write_8(TFT_RAMWR);
-
   #if defined(TFT_PARALLEL_8_BIT) || defined(TFT_PARALLEL_16_BIT) || !defined(ESP32)
     DC_D; tft_Write_16(color);
   #else
@@ -3965,6 +4084,60 @@ uint16_t TFT_eSPI::drawPixel(int32_t x, int32_t y, uint32_t color, uint8_t alpha
 }
 
 
+/***************************************************************************************
+** Function name:           pushSpan
+** Description:             Draw a scanline of edge colours, a run of colour, edge colours
+***************************************************************************************/
+void TFT_eSPI::pushSpan(int32_t x, int32_t y, const uint16_t* lead, int32_t n, int32_t len, uint32_t color, const uint16_t* trail, int32_t m)
+{
+  if (_vpOoB) return;
+
+  x+= _xDatum;
+  y+= _yDatum;
+
+  int32_t w = n + len + m;
+
+  // Clipping
+  if ((y < _vpY) || (x >= _vpW) || (y >= _vpH)) return;
+
+  int32_t dx = 0; // Pixels clipped on the left
+  if (x < _vpX) { dx = _vpX - x; w -= dx; x = _vpX; }
+
+  if ((x + w) > _vpW) w = _vpW - x;
+
+  if (w < 1) return;
+
+  begin_tft_write();
+
+  setWindow(x, y, x + w - 1, y);
+
+  bool swap = _swapBytes;
+  _swapBytes = true; // Edge colours are in processor byte order
+
+  if (dx < n) {
+    int32_t c = n - dx;
+    if (c > w) c = w;
+    pushPixels(lead + dx, c);
+    w -= c; dx = 0;
+  }
+  else dx -= n;
+
+  if (dx < len) {
+    int32_t c = len - dx;
+    if (c > w) c = w;
+    if (c > 0) pushBlock(color, c);
+    w -= c; dx = 0;
+  }
+  else dx -= len;
+
+  if (w > 0) pushPixels(trail + dx, w);
+
+  _swapBytes = swap;
+
+  end_tft_write();
+}
+
+
 /***************************************************************************************
 ** Function name:           drawSmoothArc
 ** Description:             Draw a smooth arc clockwise from 6 o'clock
@@ -4053,6 +4226,50 @@ inline uint8_t TFT_eSPI::sqrt_fraction(uint32_t num) {
   return fpr>>osh;
 }
 
+/***************************************************************************************
+** Function name:           pushRingSpan (private function)
+** Description:             Draw part of an anti-aliased ring scanline
+***************************************************************************************/
+// Start and length of the part of s..s+n-1 within a..b-1
+static inline int32_t ringPart(int32_t s, int32_t n, int32_t a, int32_t b, int32_t* p)
+{
+  *p = s > a ? s : a;
+  int32_t e = (s + n < b) ? s + n : b;
+  return e > *p ? e - *p : 0;
+}
+
+// The outer edge, solid part and inner edge of a scanline follow on from each other so are
+// drawn as one span, unless a pixel between them had to be drawn singly
+void TFT_eSPI::pushRingSpan(smooth_row_t* row, int32_t x, int32_t y, int32_t a, int32_t b, bool mirror, uint32_t color)
+{
+  int32_t o, f, i;
+  int32_t no = ringPart(row->os, row->no, a, b + 1, &o);
+  int32_t nf = ringPart(row->fs, row->nf, a, b + 1, &f);
+  int32_t ni = ringPart(row->is, row->ni, a, b + 1, &i);
+
+  // Edge colours of the part, reversed in the buffer when mirrored
+  const uint16_t* oc = mirror ? row->outer + row->os + row->no - o - no : row->outer + o - row->os;
+  const uint16_t* ic = mirror ? row->inner + row->is + row->ni - i - ni : row->inner + i - row->is;
+
+  int32_t s = no ? o : nf ? f : i;                // First x and the one after the last
+  int32_t e = ni ? i + ni : nf ? f + nf : o + no;
+
+  if (e - s == no + nf + ni) {
+    if (mirror) pushSpan(x - e + 1, y, ic, ni, nf, color, oc, no);
+    else        pushSpan(x + s, y, oc, no, nf, color, ic, ni);
+  }
+  else if (mirror) {
+    pushSpan(x - o - no + 1, y, oc, no, 0, color, nullptr, 0);
+    pushSpan(x - f - nf + 1, y, nullptr, 0, nf, color, nullptr, 0);
+    pushSpan(x - i - ni + 1, y, ic, ni, 0, color, nullptr, 0);
+  }
+  else {
+    pushSpan(x + o, y, oc, no, 0, color, nullptr, 0);
+    pushSpan(x + f, y, nullptr, 0, nf, color, nullptr, 0);
+    pushSpan(x + i, y, ic, ni, 0, color, nullptr, 0);
+  }
+}
+
 /***************************************************************************************
 ** Function name:           drawArc
 ** Description:             Draw an arc clockwise from 6 o'clock position
@@ -4151,11 +4368,20 @@ void TFT_eSPI::drawArc(int32_t x, int32_t y, int32_t r, int32_t ir,
     endSlope[3] =  slope;
   }
 
-  // Scan quadrant
+  // Range of slopes in each quadrant, as the slope table checks above
+  uint32_t minSlope[4] = {endSlope[0], startSlope[1], endSlope[2], startSlope[3]};
+  uint32_t maxSlope[4] = {startSlope[0], endSlope[1], startSlope[2], endSlope[3]};
+
+  // A complete circle needs no slope checks, every pixel is in all quadrants
+  bool full = (startAngle == 0 && endAngle == 360);
+
+  smooth_row_t row;
+
+  // Scan quadrant, holding each scanline's edge pixels to draw it as one span per quadrant
   for (int32_t cy = r - 1; cy > 0; cy--)
   {
-    uint32_t len[4] = { 0,  0,  0,  0}; // Pixel run length
-    int32_t  xst[4] = {-1, -1, -1, -1}; // Pixel run x start
+    int32_t  lo = r, hi = -1; // First and last x held
+    int32_t  os = 0, no = 0, fs = 0, nf = 0, is = 0, ni = 0; // Start and length of each part
     uint32_t dy2 = (r - cy) * (r - cy);
 
     // Find and track arc zone start point
@@ -4165,58 +4391,70 @@ void TFT_eSPI::drawArc(int32_t x, int32_t y, int32_t r, int32_t ir,
     {
       // Calculate radius^2
       uint32_t hyp = (r - cx) * (r - cx) + dy2;
+      uint16_t pcol = fg_color;
+      bool held = true;
 
       // If in outer zone calculate alpha
       if (hyp > r2) {
         alpha = ~sqrt_fraction(hyp); // Outer AA zone
+        if (alpha < 16) continue;  // Skip low alpha pixels
+        pcol = fastBlend(alpha, fg_color, bg_color);
+        if (no == 0) os = cx;
+        held = (os + no == cx && no < smoothEdgeMax);
+        if (held) row.outer[no++] = pcol;
       }
-      // If within arc fill zone, get line start and lengths for each quadrant
+      // If within arc fill zone, extend the solid part
       else if (hyp >= r3) {
-        // Calculate U16.16 slope
-        slope = ((r - cy) << 16)/(r - cx);
-        if (slope <= startSlope[0] && slope >= endSlope[0]) { // slope hi -> lo
-          xst[0] = cx; // Bottom left line end
-          len[0]++;
-        }
-        if (slope >= startSlope[1] && slope <= endSlope[1]) { // slope lo -> hi
-          xst[1] = cx; // Top left line end
-          len[1]++;
-        }
-        if (slope <= startSlope[2] && slope >= endSlope[2]) { // slope hi -> lo
-          xst[2] = cx; // Bottom right line start
-          len[2]++;
-        }
-        if (slope <= endSlope[3] && slope >= startSlope[3]) { // slope lo -> hi
-          xst[3] = cx; // Top right line start
-          len[3]++;
-        }
-        continue; // Next x
+        if (nf == 0) fs = cx;
+        nf++;
       }
       else {
         if (hyp <= r4) break;  // Skip inner pixels
         alpha = sqrt_fraction(hyp); // Inner AA zone
+        if (alpha < 16) continue;  // Skip low alpha pixels
+        pcol = fastBlend(alpha, fg_color, bg_color);
+        if (ni == 0) is = cx;
+        held = (is + ni == cx && ni < smoothEdgeMax);
+        if (held) row.inner[ni++] = pcol;
       }
 
-      if (alpha < 16) continue;  // Skip low alpha pixels
+      if (held) {
+        if (lo > cx) lo = cx;
+        hi = cx;
+        continue; // Next x
+      }
 
-      // If background is read it must be done in each quadrant
-      uint16_t pcol = fastBlend(alpha, fg_color, bg_color);
-      // Check if an AA pixels need to be drawn
-      slope = ((r - cy)<<16)/(r - cx);
-      if (slope <= startSlope[0] && slope >= endSlope[0]) // BL
-        drawPixel(x + cx - r, y - cy + r, pcol);
-      if (slope >= startSlope[1] && slope <= endSlope[1]) // TL
-        drawPixel(x + cx - r, y + cy - r, pcol);
-      if (slope <= startSlope[2] && slope >= endSlope[2]) // TR
-        drawPixel(x - cx + r, y + cy - r, pcol);
-      if (slope <= endSlope[3] && slope >= startSlope[3]) // BR
-        drawPixel(x - cx + r, y - cy + r, pcol);
+      // Edge pixel that could not be held, drawn alone (see smoothEdgeMax)
+      slope = ((r - cy) << 16)/(r - cx);
+      if (full || (slope >= minSlope[0] && slope <= maxSlope[0])) drawPixel(x + cx - r, y - cy + r, pcol); // BL
+      if (full || (slope >= minSlope[1] && slope <= maxSlope[1])) drawPixel(x + cx - r, y + cy - r, pcol); // TL
+      if (full || (slope >= minSlope[2] && slope <= maxSlope[2])) drawPixel(x - cx + r, y + cy - r, pcol); // TR
+      if (full || (slope >= minSlope[3] && slope <= maxSlope[3])) drawPixel(x - cx + r, y - cy + r, pcol); // BR
+    }
+    if (lo > hi) continue;
+    row.os = os; row.no = no; row.fs = fs; row.nf = nf; row.is = is; row.ni = ni;
+
+    // The slope only increases along the scanline, so the arc covers a run of x in each
+    // quadrant: all of it unless the slope at either end is out of the quadrant's range
+    int32_t qlo[4] = {lo, lo, lo, lo};
+    int32_t qhi[4] = {hi, hi, hi, hi};
+    if (!full) {
+      uint32_t slo = ((r - cy) << 16)/(r - lo);
+      uint32_t shi = ((r - cy) << 16)/(r - hi);
+      for (int q = 0; q < 4; q++) {
+        if (shi < minSlope[q] || slo > maxSlope[q]) { qhi[q] = -1; continue; }
+        if (slo < minSlope[q]) while ((uint32_t)(((r - cy) << 16)/(r - qlo[q])) < minSlope[q]) qlo[q]++;
+        if (shi > maxSlope[q]) while ((uint32_t)(((r - cy) << 16)/(r - qhi[q])) > maxSlope[q]) qhi[q]--;
+      }
     }
-    // Add line in inner zone
-    if (len[0]) drawFastHLine(x + xst[0] - len[0] + 1 - r, y - cy + r, len[0], fg_color); // BL
-    if (len[1]) drawFastHLine(x + xst[1] - len[1] + 1 - r, y + cy - r, len[1], fg_color); // TL
-    if (len[2]) drawFastHLine(x - xst[2] + r, y + cy - r, len[2], fg_color); // TR
-    if (len[3]) drawFastHLine(x - xst[3] + r, y - cy + r, len[3], fg_color); // BR
+
+    // Draw the scanline in each quadrant, the right hand ones mirrored
+    if (qlo[0] <= qhi[0]) pushRingSpan(&row, x - r, y - cy + r, qlo[0], qhi[0], false, fg_color); // BL
+    if (qlo[1] <= qhi[1]) pushRingSpan(&row, x - r, y + cy - r, qlo[1], qhi[1], false, fg_color); // TL
+    for (int32_t i = 0, j = row.no - 1; i < j; i++, j--) transpose(row.outer[i], row.outer[j]);
+    for (int32_t i = 0, j = row.ni - 1; i < j; i++, j--) transpose(row.inner[i], row.inner[j]);
+    if (qlo[2] <= qhi[2]) pushRingSpan(&row, x + r, y + cy - r, qlo[2], qhi[2], true, fg_color);  // TR
+    if (qlo[3] <= qhi[3]) pushRingSpan(&row, x + r, y - cy + r, qlo[3], qhi[3], true, fg_color);  // BR
   }
 
   // Fill in centre lines
@@ -4256,10 +4494,14 @@ void TFT_eSPI::fillSmoothCircle(int32_t x, int32_t y, int32_t r, uint32_t color,
   int32_t r1 = r * r;
   r++;
   int32_t r2 = r * r;
-  
+
+  // Edge pixels of a scanline, drawn with the solid run between them as one span
+  uint16_t edge[smoothEdgeMax], mirror[smoothEdgeMax];
+
   for (int32_t cy = r - 1; cy > 0; cy--)
   {
     int32_t dy2 = (r - cy) * (r - cy);
+    int32_t es = 0, n = 0; // First x and count of edge pixels held
     for (cx = xs; cx < r; cx++)
     {
       int32_t hyp2 = (r - cx) * (r - cx) + dy2;
@@ -4278,14 +4520,28 @@ void TFT_eSPI::fillSmoothCircle(int32_t x, int32_t y, int32_t r, uint32_t color,
         drawPixel(x + cx - r, y - cy + r, color, alpha, bg_color);
       }
       else {
-        uint16_t pcol = drawPixel(x + cx - r, y + cy - r, color, alpha, bg_color);
+        uint16_t pcol = fastBlend(alpha, color, bg_color);
+        if (n == 0) es = cx;
+        if (es + n == cx && n < smoothEdgeMax) { edge[n++] = pcol; continue; }
+        // Not next to the held pixels, drawn alone (see smoothEdgeMax)
+        drawPixel(x + cx - r, y + cy - r, pcol);
         drawPixel(x - cx + r, y + cy - r, pcol);
         drawPixel(x - cx + r, y - cy + r, pcol);
         drawPixel(x + cx - r, y - cy + r, pcol);
       }
     }
-    drawFastHLine(x + cx - r, y + cy - r, 2 * (r - cx) + 1, color);
-    drawFastHLine(x + cx - r, y - cy + r, 2 * (r - cx) + 1, color);
+    for (int32_t i = 0; i < n; i++) mirror[i] = edge[n - 1 - i];
+    if (n && es + n != cx) {
+      // Held pixels not next to the run, as some were drawn alone
+      pushSpan(x + es - r, y + cy - r, edge, n, 0, color, nullptr, 0);
+      pushSpan(x + es - r, y - cy + r, edge, n, 0, color, nullptr, 0);
+      pushSpan(x - es - n + 1 + r, y + cy - r, mirror, n, 0, color, nullptr, 0);
+      pushSpan(x - es - n + 1 + r, y - cy + r, mirror, n, 0, color, nullptr, 0);
+      n = 0;
+    }
+    if (n == 0) es = cx;
+    pushSpan(x + es - r, y + cy - r, edge, n, 2 * (r - cx) + 1, color, mirror, n);
+    pushSpan(x + es - r, y - cy + r, edge, n, 2 * (r - cx) + 1, color, mirror, n);
   }
   inTransaction = lockTransaction;
   end_tft_write();
@@ -4337,12 +4593,13 @@ void TFT_eSPI::drawSmoothRoundRect(int32_t x, int32_t y, int32_t r, int32_t ir,
 
   uint8_t alpha = 0;
 
-  // Scan top left quadrant x y r ir fg_color  bg_color
+  smooth_row_t row;
+
+  // Scan top left quadrant, holding each scanline's edge pixels to draw it as one span per corner
   for (int32_t cy = r - 1; cy > 0; cy--)
   {
-    int32_t len = 0;  // Pixel run length
-    int32_t lxst = 0; // Left side run x start
-    int32_t rxst = 0; // Right side run x start
+    int32_t lo = r, hi = -1; // First and last x held
+    int32_t os = 0, no = 0, fs = 0, nf = 0, is = 0, ni = 0; // Start and length of each part
     int32_t dy2 = (r - cy) * (r - cy);
 
     // Find and track arc zone start point
@@ -4352,37 +4609,56 @@ void TFT_eSPI::drawSmoothRoundRect(int32_t x, int32_t y, int32_t r, int32_t ir,
     {
       // Calculate radius^2
       int32_t hyp = (r - cx) * (r - cx) + dy2;
+      uint16_t pcol = fg_color;
+      bool held = true;
 
       // If in outer zone calculate alpha
       if (hyp > r2) {
         alpha = ~sqrt_fraction(hyp); // Outer AA zone
+        if (alpha < 16) continue;  // Skip low alpha pixels
+        pcol = fastBlend(alpha, fg_color, bg_color);
+        if (no == 0) os = cx;
+        held = (os + no == cx && no < smoothEdgeMax);
+        if (held) row.outer[no++] = pcol;
       }
-      // If within arc fill zone, get line lengths for each quadrant
+      // If within arc fill zone, extend the solid part
       else if (hyp >= r3) {
-        rxst = cx; // Right side start
-        len++;     // Line segment length
-        continue;  // Next x
+        if (nf == 0) fs = cx;
+        nf++;
       }
       else {
         if (hyp <= r4) break;  // Skip inner pixels
         alpha = sqrt_fraction(hyp); // Inner AA zone
+        if (alpha < 16) continue;  // Skip low alpha pixels
+        pcol = fastBlend(alpha, fg_color, bg_color);
+        if (ni == 0) is = cx;
+        held = (is + ni == cx && ni < smoothEdgeMax);
+        if (held) row.inner[ni++] = pcol;
       }
 
-      if (alpha < 16) continue;  // Skip low alpha pixels
+      if (held) {
+        if (lo > cx) lo = cx;
+        hi = cx;
+        continue; // Next x
+      }
 
+      // Edge pixel that could not be held, drawn alone (see smoothEdgeMax)
       // If background is read it must be done in each quadrant - TODO
-      uint16_t pcol = fastBlend(alpha, fg_color, bg_color);
       if (quadrants & 0x8) drawPixel(x + cx - r, y - cy + r + h, pcol);     // BL
       if (quadrants & 0x1) drawPixel(x + cx - r, y + cy - r, pcol);         // TL
       if (quadrants & 0x2) drawPixel(x - cx + r + w, y + cy - r, pcol);     // TR
       if (quadrants & 0x4) drawPixel(x - cx + r + w, y - cy + r + h, pcol); // BR
     }
-    // Fill arc inner zone in each quadrant
-    lxst = rxst - len + 1; // Calculate line segment start for left side
-    if (quadrants & 0x8) drawFastHLine(x + lxst - r, y - cy + r + h, len, fg_color);     // BL
-    if (quadrants & 0x1) drawFastHLine(x + lxst - r, y + cy - r, len, fg_color);         // TL
-    if (quadrants & 0x2) drawFastHLine(x - rxst + r + w, y + cy - r, len, fg_color);     // TR
-    if (quadrants & 0x4) drawFastHLine(x - rxst + r + w, y - cy + r + h, len, fg_color); // BR
+    if (lo > hi) continue;
+    row.os = os; row.no = no; row.fs = fs; row.nf = nf; row.is = is; row.ni = ni;
+
+    // Draw the scanline in each corner, the right hand ones mirrored
+    if (quadrants & 0x8) pushRingSpan(&row, x - r, y - cy + r + h, lo, hi, false, fg_color);    // BL
+    if (quadrants & 0x1) pushRingSpan(&row, x - r, y + cy - r, lo, hi, false, fg_color);        // TL
+    for (int32_t i = 0, j = row.no - 1; i < j; i++, j--) transpose(row.outer[i], row.outer[j]);
+    for (int32_t i = 0, j = row.ni - 1; i < j; i++, j--) transpose(row.inner[i], row.inner[j]);
+    if (quadrants & 0x2) pushRingSpan(&row, x + r + w, y + cy - r, lo, hi, true, fg_color);     // TR
+    if (quadrants & 0x4) pushRingSpan(&row, x + r + w, y - cy + r + h, lo, hi, true, fg_color); // BR
   }
 
   // Draw sides
@@ -4423,9 +4699,13 @@ void TFT_eSPI::fillSmoothRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, i
   r++;
   int32_t r2 = r * r;
 
+  // Edge pixels of a scanline, drawn with the solid run between them as one span
+  uint16_t edge[smoothEdgeMax], mirror[smoothEdgeMax];
+
   for (int32_t cy = r - 1; cy > 0; cy--)
   {
     int32_t dy2 = (r - cy) * (r - cy);
+    int32_t es = 0, n = 0; // First x and count of edge pixels held
     for (cx = xs; cx < r; cx++)
     {
       int32_t hyp2 = (r - cx) * (r - cx) + dy2;
@@ -4437,13 +4717,35 @@ void TFT_eSPI::fillSmoothRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, i
       xs = cx;
       if (alpha < 9) continue;
 
-      drawPixel(x + cx - r, y + cy - r, color, alpha, bg_color);
-      drawPixel(x - cx + r + w, y + cy - r, color, alpha, bg_color);
-      drawPixel(x - cx + r + w, y - cy + r + h, color, alpha, bg_color);
-      drawPixel(x + cx - r, y - cy + r + h, color, alpha, bg_color);
+      if (bg_color == 0x00FFFFFF) {
+        drawPixel(x + cx - r, y + cy - r, color, alpha, bg_color);
+        drawPixel(x - cx + r + w, y + cy - r, color, alpha, bg_color);
+        drawPixel(x - cx + r + w, y - cy + r + h, color, alpha, bg_color);
+        drawPixel(x + cx - r, y - cy + r + h, color, alpha, bg_color);
+      }
+      else {
+        uint16_t pcol = fastBlend(alpha, color, bg_color);
+        if (n == 0) es = cx;
+        if (es + n == cx && n < smoothEdgeMax) { edge[n++] = pcol; continue; }
+        // Not next to the held pixels, drawn alone (see smoothEdgeMax)
+        drawPixel(x + cx - r, y + cy - r, pcol);
+        drawPixel(x - cx + r + w, y + cy - r, pcol);
+        drawPixel(x - cx + r + w, y - cy + r + h, pcol);
+        drawPixel(x + cx - r, y - cy + r + h, pcol);
+      }
     }
-    drawFastHLine(x + cx - r, y + cy - r, 2 * (r - cx) + 1 + w, color);
-    drawFastHLine(x + cx - r, y - cy + r + h, 2 * (r - cx) + 1 + w, color);
+    for (int32_t i = 0; i < n; i++) mirror[i] = edge[n - 1 - i];
+    if (n && es + n != cx) {
+      // Held pixels not next to the run, as some were drawn alone
+      pushSpan(x + es - r, y + cy - r, edge, n, 0, color, nullptr, 0);
+      pushSpan(x + es - r, y - cy + r + h, edge, n, 0, color, nullptr, 0);
+      pushSpan(x - es - n + 1 + r + w, y + cy - r, mirror, n, 0, color, nullptr, 0);
+      pushSpan(x - es - n + 1 + r + w, y - cy + r + h, mirror, n, 0, color, nullptr, 0);
+      n = 0;
+    }
+    if (n == 0) es = cx;
+    pushSpan(x + es - r, y + cy - r, edge, n, 2 * (r - cx) + 1 + w, color, mirror, n);
+    pushSpan(x + es - r, y - cy + r + h, edge, n, 2 * (r - cx) + 1 + w, color, mirror, n);
   }
   inTransaction = lockTransaction;
   end_tft_write();
@@ -4486,6 +4788,10 @@ void TFT_eSPI::drawWedgeLine(float ax, float ay, float bx, float by, float ar, f
 
   if (!clipWindow(&x0, &y0, &x1, &y1)) return;
 
+  // The box is clipped in TFT coordinates, scan the line in them too
+  ax += _xDatum; bx += _xDatum;
+  ay += _yDatum; by += _yDatum;
+
   // Establish x start and y start
   int32_t ys = ay;
   if ((ax-ar)>(bx-br)) ys = by;
@@ -4515,7 +4821,7 @@ void TFT_eSPI::drawWedgeLine(float ax, float ay, float bx, float by, float ar, f
       if (!endX) { endX = true; xs = xp; }
       if (alpha > HiAlphaTheshold) {
         #ifdef GC9A01_DRIVER
-          drawPixel(xp, yp, fg_color);
+          drawPixel(xp - _xDatum, yp - _yDatum, fg_color);
         #else
           if (swin) { setWindow(xp, yp, x1, yp); swin = false; }
           pushColor(fg_color);
@@ -4524,12 +4830,12 @@ void TFT_eSPI::drawWedgeLine(float ax, float ay, float bx, float by, float ar, f
       }
       //Blend color with background and plot
       if (bg_color == 0x00FFFFFF) {
-        bg = readPixel(xp, yp); swin = true;
+        bg = readPixel(xp - _xDatum, yp - _yDatum); swin = true;
       }
       #ifdef GC9A01_DRIVER
         uint16_t pcol = fastBlend((uint8_t)(alpha * PixelAlphaGain), fg_color, bg);
-        drawPixel(xp, yp, pcol);
-        swin = swin;
+        drawPixel(xp - _xDatum, yp - _yDatum, pcol);
+        (void)swin; // No window to restart, every pixel is drawn on its own
       #else
         if (swin) { setWindow(xp, yp, x1, yp); swin = false; }
         pushColor(fastBlend((uint8_t)(alpha * PixelAlphaGain), fg_color, bg));
@@ -4553,7 +4859,7 @@ void TFT_eSPI::drawWedgeLine(float ax, float ay, float bx, float by, float ar, f
       if (!endX) { endX = true; xs = xp; }
       if (alpha > HiAlphaTheshold) {
         #ifdef GC9A01_DRIVER
-          drawPixel(xp, yp, fg_color);
+          drawPixel(xp - _xDatum, yp - _yDatum, fg_color);
         #else
           if (swin) { setWindow(xp, yp, x1, yp); swin = false; }
           pushColor(fg_color);
@@ -4562,12 +4868,12 @@ void TFT_eSPI::drawWedgeLine(float ax, float ay, float bx, float by, float ar, f
       }
       //Blend colour with background and plot
       if (bg_color == 0x00FFFFFF) {
-        bg = readPixel(xp, yp); swin = true;
+        bg = readPixel(xp - _xDatum, yp - _yDatum); swin = true;
       }
       #ifdef GC9A01_DRIVER
         uint16_t pcol = fastBlend((uint8_t)(alpha * PixelAlphaGain), fg_color, bg);
-        drawPixel(xp, yp, pcol);
-        swin = swin;
+        drawPixel(xp - _xDatum, yp - _yDatum, pcol);
+        (void)swin; // No window to restart, every pixel is drawn on its own
       #else
         if (swin) { setWindow(xp, yp, x1, yp); swin = false; }
         pushColor(fastBlend((uint8_t)(alpha * PixelAlphaGain), fg_color, bg));
@@ -4867,7 +5173,11 @@ void TFT_eSPI::setAttribute(uint8_t attr_id, uint8_t param) {
 #endif
             _psram_enable = false;
             break;
-        //case 4: // TBD future feature control
+        case WINDOW_CACHE:
+            _windowCache = param;
+            addr_ptr = -1;
+            break;
+        //case 5: // TBD future feature control
         //    _tbd = param;
         //    break;
     }
@@ -4886,7 +5196,9 @@ uint8_t TFT_eSPI::getAttribute(uint8_t attr_id) {
             return _utf8;
         case PSRAM_ENABLE:
             return _psram_enable;
-        //case 3: // TBD future feature control
+        case WINDOW_CACHE: // ON/OFF control of skipping unchanged address window commands
+            return _windowCache;
+        //case 5: // TBD future feature control
         //    return _tbd;
         //    break;
     }
@@ -5112,7 +5424,7 @@ size_t TFT_eSPI::write(uint8_t utf8)
     if ((textfont>2) && (textfont<9)) {
       if (uniCode < 32 || uniCode > 127) return 1;
       // Uses the fontinfo struct array to avoid lots of 'if' or 'switch' statements
-      cwidth = pgm_read_byte( (uint8_t *)pgm_read_dword( &(fontdata[textfont].widthtbl ) ) + uniCode-32 );
+      cwidth = pgm_read_byte( (uint8_t *)pgm_read_ptr( &(fontdata[textfont].widthtbl ) ) + uniCode-32 );
       cheight= pgm_read_byte( &fontdata[textfont].height );
     }
   }
@@ -5154,7 +5466,7 @@ size_t TFT_eSPI::write(uint8_t utf8)
       if (uniCode < pgm_read_word(&gfxFont->first)) return 1;
 
       uint16_t   c2    = uniCode - pgm_read_word(&gfxFont->first);
-      GFXglyph *glyph = &(((GFXglyph *)pgm_read_dword(&gfxFont->glyph))[c2]);
+      GFXglyph *glyph = &(((GFXglyph *)pgm_read_ptr(&gfxFont->glyph))[c2]);
       uint8_t   w     = pgm_read_byte(&glyph->width),
                 h     = pgm_read_byte(&glyph->height);
       if((w > 0) && (h > 0)) { // Is there an associated bitmap?
@@ -5217,7 +5529,7 @@ int16_t TFT_eSPI::drawChar(uint16_t uniCode, int32_t x, int32_t y, uint8_t font)
     else {
       if((uniCode >= pgm_read_word(&gfxFont->first)) && (uniCode <= pgm_read_word(&gfxFont->last) )) {
         uint16_t   c2    = uniCode - pgm_read_word(&gfxFont->first);
-        GFXglyph *glyph = &(((GFXglyph *)pgm_read_dword(&gfxFont->glyph))[c2]);
+        GFXglyph *glyph = &(((GFXglyph *)pgm_read_ptr(&gfxFont->glyph))[c2]);
         return pgm_read_byte(&glyph->xAdvance) * textsize;
       }
       else {
@@ -5229,14 +5541,17 @@ int16_t TFT_eSPI::drawChar(uint16_t uniCode, int32_t x, int32_t y, uint8_t font)
 
   if ((font>1) && (font<9) && ((uniCode < 32) || (uniCode > 127))) return 0;
 
+  int16_t cw = drawAtlasChar(font, uniCode, x, y, textcolor, textbgcolor, textsize);
+  if (cw) return cw;
+
   int32_t width  = 0;
   int32_t height = 0;
-  uint32_t flash_address = 0;
+  uintptr_t flash_address = 0;
   uniCode -= 32;
 
 #ifdef LOAD_FONT2
   if (font == 2) {
-    flash_address = pgm_read_dword(&chrtbl_f16[uniCode]);
+    flash_address = (uintptr_t)pgm_read_ptr(&chrtbl_f16[uniCode]);
     width = pgm_read_byte(widtbl_f16 + uniCode);
     height = chr_hgt_f16;
   }
@@ -5248,8 +5563,8 @@ int16_t TFT_eSPI::drawChar(uint16_t uniCode, int32_t x, int32_t y, uint8_t font)
 #ifdef LOAD_RLE
   {
     if ((font>2) && (font<9)) {
-      flash_address = pgm_read_dword( (const void*)(pgm_read_dword( &(fontdata[font].chartbl ) ) + uniCode*sizeof(void *)) );
-      width = pgm_read_byte( (uint8_t *)pgm_read_dword( &(fontdata[font].widthtbl ) ) + uniCode );
+      flash_address = (uintptr_t)pgm_read_ptr( (const uint8_t *)pgm_read_ptr( &(fontdata[font].chartbl ) ) + uniCode*sizeof(void *) );
+      width = pgm_read_byte( (uint8_t *)pgm_read_ptr( &(fontdata[font].widthtbl ) ) + uniCode );
       height= pgm_read_byte( &fontdata[font].height );
     }
   }
@@ -5614,7 +5929,7 @@ int16_t TFT_eSPI::drawString(const char *string, int32_t poX, int32_t poY, uint8
 
       if((c2 >= pgm_read_word(&gfxFont->first)) && (c2 <= pgm_read_word(&gfxFont->last) )) {
         c2 -= pgm_read_word(&gfxFont->first);
-        GFXglyph *glyph = &(((GFXglyph *)pgm_read_dword(&gfxFont->glyph))[c2]);
+        GFXglyph *glyph = &(((GFXglyph *)pgm_read_ptr(&gfxFont->glyph))[c2]);
         xo = pgm_read_byte(&glyph->xOffset) * textsize;
         // Adjust for negative xOffset
         if (xo > 0) xo = 0;
@@ -5894,7 +6209,7 @@ void TFT_eSPI::setFreeFont(const GFXfont *f)
 
   // Find the biggest above and below baseline offsets
   for (uint16_t c = 0; c < numChars; c++) {
-    GFXglyph *glyph1  = &(((GFXglyph *)pgm_read_dword(&gfxFont->glyph))[c]);
+    GFXglyph *glyph1  = &(((GFXglyph *)pgm_read_ptr(&gfxFont->glyph))[c]);
     int8_t ab = -pgm_read_byte(&glyph1->yOffset);
     if (ab > glyph_ab) glyph_ab = ab;
     int8_t bb = pgm_read_byte(&glyph1->height) - ab;
@@ -6147,6 +6462,12 @@ void TFT_eSPI::getSetup(setup_t &tft_settings)
 
 #include "Extensions/Sprite.cpp"
 
+#include "Extensions/DisplayList.cpp"
+
+#include "Extensions/Strip.cpp"
+
+#include "Extensions/GlyphAtlas.cpp"
+
 #ifdef SMOOTH_FONT
   #include "Extensions/Smooth_font.cpp"
 #endif
@@ -92,6 +92,11 @@
   #endif
 #endif
 
+// Font and glyph tables hold pointers, read them pointer sized so 64-bit hosts work too
+#ifndef pgm_read_ptr
+  #define pgm_read_ptr(addr) (*(const void * const *)(addr))
+#endif
+
 // Include the processor specific drivers
 #if defined(CONFIG_IDF_TARGET_ESP32S3)
   #include "Processors/TFT_eSPI_ESP32_S3.h"
@@ -105,6 +110,8 @@
   #include "Processors/TFT_eSPI_STM32.h"
 #elif defined(ARDUINO_ARCH_RP2040)
   #include "Processors/TFT_eSPI_RP2040.h"
+#elif defined (TFT_HOST_FRAMEBUFFER)
+  #include "Processors/TFT_eSPI_Host.h"
 #else
   #include "Processors/TFT_eSPI_Generic.h"
   #define GENERIC_PROCESSOR
@@ -420,11 +427,17 @@ int16_t tch_spi_freq;// Touch controller read/write SPI frequency
 **                         Section 8: Class member and support functions
 ***************************************************************************************/
 
+#ifdef SMOOTH_FONT
+  #include "Extensions/GlyphCache.h"
+#endif
+
+#include "Extensions/GlyphAtlas.h"
+
 // Callback prototype for smooth font pixel colour read
 typedef uint16_t (*getColorCallback)(uint16_t x, uint16_t y);
 
 // Class functions and variables
-class TFT_eSPI : public Print { friend class TFT_eSprite; // Sprite class has access to protected members
+class TFT_eSPI : public Print { friend class TFT_eSprite; friend class TFT_eDisplayList; // Sprite and display list classes have access to protected members
 
  //--------------------------------------- public ------------------------------------//
  public:
@@ -476,7 +489,8 @@ class TFT_eSPI : public Print { friend class TFT_eSprite; // Sprite class has ac
   void     setAddrWindow(int32_t xs, int32_t ys, int32_t w, int32_t h); // Note: start coordinates + width and height
 
   // Viewport commands, see "Viewport_Demo" sketch
-  void     setViewport(int32_t x, int32_t y, int32_t w, int32_t h, bool vpDatum = true);
+  // setViewport and resetViewport are virtual so the TFT_eStrip class can keep the viewport in its band
+  virtual void setViewport(int32_t x, int32_t y, int32_t w, int32_t h, bool vpDatum = true);
   bool     checkViewport(int32_t x, int32_t y, int32_t w, int32_t h);
   int32_t  getViewportX(void);
   int32_t  getViewportY(void);
@@ -484,7 +498,7 @@ class TFT_eSPI : public Print { friend class TFT_eSprite; // Sprite class has ac
   int32_t  getViewportHeight(void);
   bool     getViewportDatum(void);
   void     frameViewport(uint16_t color, int32_t w);
-  void     resetViewport(void);
+  virtual void resetViewport(void);
 
            // Clip input window to viewport bounds, return false if whole area is out of bounds
   bool     clipAddrWindow(int32_t* x, int32_t* y, int32_t* w, int32_t* h);
@@ -649,6 +663,17 @@ class TFT_eSPI : public Print { friend class TFT_eSprite; // Sprite class has ac
            drawCentreString(const String& string, int32_t x, int32_t y, uint8_t font),// Deprecated, use setTextDatum() and drawString()
            drawRightString(const String& string, int32_t x, int32_t y, uint8_t font); // Deprecated, use setTextDatum() and drawString()
 
+           // Hold a built in font (1, 2, 4, 6, 7 or 8) in RAM at text size size in colours fg
+           // on bg, so characters drawn in them copy a block each rather than being decoded.
+           // digits holds only what numbers are drawn with, for the large fonts. rgb565 holds
+           // pixels rather than bits, faster again but 16 times the RAM. Replaces an atlas of
+           // the same font, size and colours. Returns false if the RAM is not available or
+           // GLYPH_ATLASES are held already
+  bool     createGlyphAtlas(uint8_t font, uint8_t size, uint16_t fg, uint16_t bg, bool digits = false, bool rgb565 = false);
+  void     deleteGlyphAtlas(void);                        // Free every atlas
+  void     getGlyphAtlasStats(glyph_atlas_stats_t *stats);
+  void     clearGlyphAtlasStats(void);
+
 
   // Text rendering and font handling support functions
   void     setCursor(int16_t x, int16_t y),                 // Set cursor for tft.print()
@@ -742,6 +767,9 @@ class TFT_eSPI : public Print { friend class TFT_eSprite; // Sprite class has ac
   // Direct Memory Access (DMA) support functions
   // These can be used for SPI writes when using the ESP32 (original) or STM32 processors.
   // DMA also works on a RP2040 processor with PIO based SPI and parallel (8 and 16-bit) interfaces
+  // and on an ESP32-S3 with an 8-bit parallel interface (LCD_CAM peripheral), where pushBlock()
+  // and pushPixels() also use DMA for large blocks between startWrite() and endWrite(). They
+  // return once the block is sent, only pushImageDMA() and pushPixelsDMA() return before
            // Bear in mind DMA will only be of benefit in particular circumstances and can be tricky
            // to manage by noobs. The functions have however been designed to be noob friendly and
            // avoid a few DMA behaviour "gotchas".
@@ -809,9 +837,11 @@ class TFT_eSPI : public Print { friend class TFT_eSprite; // Sprite class has ac
   //       id = 1: Turn on (a=true) or off (a=false) GLCD cp437 font character error correction
   //       id = 2: Turn on (a=true) or off (a=false) UTF8 decoding
   //       id = 3: Enable or disable use of ESP32 PSRAM (if available)
+  //       id = 4: Turn on (a=true) or off (a=false) skipping address window commands the TFT already has
            #define CP437_SWITCH 1
            #define UTF8_SWITCH  2
            #define PSRAM_ENABLE 3
+           #define WINDOW_CACHE 4
   void     setAttribute(uint8_t id = 0, uint8_t a = 0); // Set attribute value
   uint8_t  getAttribute(uint8_t id = 0);                // Get attribute value
 
@@ -876,6 +906,23 @@ class TFT_eSPI : public Print { friend class TFT_eSprite; // Sprite class has ac
            // Smooth graphics helper
   uint8_t  sqrt_fraction(uint32_t num);
 
+           // Edge pixels of one scanline held to draw an anti-aliased shape a line at a time.
+           // Below a radius of about 1000 no scanline has more, any others are drawn singly
+  static constexpr int32_t smoothEdgeMax = 48;
+
+           // A scanline of an anti-aliased ring, x is the offset from the ring's bounding box
+  typedef struct {
+    int32_t  os, no;                  // Outer edge pixels held: first x and count
+    int32_t  fs, nf;                  // Solid pixels between the edges
+    int32_t  is, ni;                  // Inner edge pixels held
+    uint16_t outer[smoothEdgeMax];    // Edge colours, reversed for the right hand quadrants
+    uint16_t inner[smoothEdgeMax];
+  } smooth_row_t;
+
+           // Draw the part of a ring scanline from offset a to b at y, left edge at x or mirrored
+           // (right edge at x) for the right hand quadrants
+  void     pushRingSpan(smooth_row_t* row, int32_t x, int32_t y, int32_t a, int32_t b, bool mirror, uint32_t color);
+
            // Helper function: calculate distance of a point from a finite length line between two points
   float    wedgeLineDistance(float pax, float pay, float bax, float bay, float dr);
 
@@ -910,6 +957,8 @@ class TFT_eSPI : public Print { friend class TFT_eSprite; // Sprite class has ac
   int32_t  _init_width, _init_height; // Display w/h as input, used by setRotation()
   int32_t  _width, _height;           // Display w/h as modified by current rotation
   int32_t  addr_row, addr_col;        // Window position - used to minimise window commands
+  int32_t  addr_row_end, addr_col_end; // Window end, the TFT has rows addr_row to addr_row_end
+  int32_t  addr_ptr;                  // Column the drawPixel() RAMWR stream is at, -1 if none
 
   int16_t  _xPivot;   // TFT x pivot point coordinate for rotated Sprites
   int16_t  _yPivot;   // TFT x pivot point coordinate for rotated Sprites
@@ -942,9 +991,31 @@ class TFT_eSPI : public Print { friend class TFT_eSprite; // Sprite class has ac
   bool     _cp437;        // If set, use correct CP437 charset (default is OFF)
   bool     _utf8;         // If set, use UTF-8 decoder in print stream 'write()' function (default ON)
   bool     _psram_enable; // Enable PSRAM use for library functions (TBD) and Sprites
+  bool     _windowCache;  // If set, only send the address window commands that change (default ON)
 
   uint32_t _lastColor; // Buffered value of last colour used
 
+           // Draw a scanline of an anti-aliased shape from x,y: n edge colours from lead, len
+           // pixels of color, then m edge colours from trail. Edge colours are in processor
+           // byte order. One window on the TFT, overridden to write Sprite memory directly
+  virtual void pushSpan(int32_t x, int32_t y, const uint16_t* lead, int32_t n, int32_t len, uint32_t color, const uint16_t* trail, int32_t m);
+
+           // Glyph atlases in use, together at the start
+  TFT_GlyphAtlas* glyphAtlas[GLYPH_ATLASES] = {};
+  uint32_t glyphAtlasHits = 0;
+
+  uint8_t  glyphWidth(uint8_t font, uint16_t c);
+  void     rasterGlyph(TFT_GlyphAtlas* atlas, uint8_t fontNumber, uint16_t c);
+
+           // Draw character c from the atlas of font in these colours and size, returning its
+           // width, or 0 if no atlas holds it
+  int16_t  drawAtlasChar(uint8_t font, uint16_t c, int32_t x, int32_t y, uint32_t fg, uint32_t bg, uint8_t size);
+
+           // Draw rows dy to dy + dh - 1 and columns dx to dx + dw - 1 of a cell w pixels wide
+           // of atlas, the first at x,y. One window on the TFT, overridden to write Sprite
+           // memory directly
+  virtual void pushAtlasCell(const TFT_GlyphAtlas* atlas, const uint8_t* cell, uint16_t w, int32_t x, int32_t y, int32_t dx, int32_t dy, int32_t dw, int32_t dh);
+
   bool     _fillbg;    // Fill background flag (just for for smooth fonts at the moment)
 
 #if defined (SSD1963_DRIVER)
@@ -1006,6 +1077,14 @@ fastBlend(A alpha, F fgc, B bgc)
 #include "Extensions/Button.h"
 
 // Load the Sprite Class
+#include "Extensions/DirtyRects.h"
+#include "Extensions/SpanKernels.h"
 #include "Extensions/Sprite.h"
 
+// Load the Display List Class
+#include "Extensions/DisplayList.h"
+
+// Load the Strip Class
+#include "Extensions/Strip.h"
+
 #endif // ends #ifndef _TFT_eSPIH_
@@ -0,0 +1,364 @@
+// Dohyo, robot and opponent physics for the host simulator.
+// The robot is a differential drive with first-order DC motor models; motor A
+// is the right wheel and motor B the left wheel (see move() in Motor.cpp).
+#if !defined(ARDUINO)
+
+#include "Sim.h"
+#include "Motor.h"
+#include "Sensors.h"
+#include "Startup.h"
+#include <math.h>
+
+#define PHYSICS_STEP_NS         100000      // 100 us integration step
+
+// Robot geometry (cm)
+#define ROBOT_RADIUS_CM         7.5f        // Collision disc, used for both robots
+#define TRACK_CM                12.0f
+#define WHEEL_CIRCUMFERENCE_CM  20.4f
+#define CORNER_FORWARD_CM       6.0f
+#define CORNER_LATERAL_CM       5.0f
+#define SONAR_FORWARD_CM        6.0f
+#define SONAR_LATERAL_CM        3.0f
+
+// HC-SR04
+#define SONAR_HALF_ANGLE_RAD    0.21f       // ~12 degrees
+#define SONAR_MAX_RANGE_CM      200.0f
+#define SONAR_NOISE_CM          1.0f
+#define LINE_NOISE_COUNTS       8
+
+// Operator pressing the menu buttons to start a competition run
+#define BUTTON_FIRST_PRESS_MS   100
+#define BUTTON_PRESS_MS         80
+#define BUTTON_PERIOD_MS        200
+
+typedef struct {
+    uint8_t triggerPin, echoPin;
+    bool busy;
+    uint64_t riseNs, fallNs;
+} Sonar_t;
+
+typedef struct {
+    uint8_t in1, in2, pwmPin, encPin;
+    float revPerS;
+    float tickAccumulator;
+} Wheel_t;
+
+static SimConfig_t cfg;
+static uint64_t physicsNs = 0;
+static uint64_t boutStartNs = 0;
+static bool boutStarted = false;
+static BoutResult result = BOUT_RUNNING;
+static uint32_t rngState = 1;
+
+static Pose_t robot, opponent;
+static float robotSpeedCmS = 0.0f;
+static Wheel_t wheelA = {IN1A, IN2A, PWMA, ENCA, 0.0f, 0.0f};   // Right
+static Wheel_t wheelB = {IN1B, IN2B, PWMB, ENCB, 0.0f, 0.0f};   // Left
+static Sonar_t sonars[2] = {
+    {LEFT_TRIGGER, LEFT_ECHO, false, 0, 0},
+    {RIGHT_TRIGGER, RIGHT_ECHO, false, 0, 0},
+};
+
+// Edge reaction: a corner reaching the line until the first change in motor command
+static uint8_t lastCornerCode = 0;
+static bool crossingPending = false;
+static uint64_t crossingNs = 0;
+static SimReactionStats_t reaction;
+
+static int cornerCode(void);
+
+static uint32_t nextRandom(void) {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+// Uniform in [lo, hi)
+static float randomRange(float lo, float hi) {
+    return lo + (hi - lo) * (float)(nextRandom() & 0xFFFFFF) / (float)0x1000000;
+}
+
+static float wrapAngle(float a) {
+    while (a > (float)M_PI) a -= 2.0f * (float)M_PI;
+    while (a < -(float)M_PI) a += 2.0f * (float)M_PI;
+    return a;
+}
+
+static void bodyToWorld(const Pose_t *p, float forward, float lateral, float *x, float *y) {
+    float c = cosf(p->heading), s = sinf(p->heading);
+    *x = p->x + forward * c - lateral * s;
+    *y = p->y + forward * s + lateral * c;
+}
+
+static bool overLine(float x, float y) {
+    return sqrtf(x * x + y * y) >= cfg.arenaRadiusCm - cfg.edgeWidthCm;
+}
+
+void simDefaultConfig(SimConfig_t *config) {
+    config->seed = 1;
+    config->arenaRadiusCm = 72.0f;
+    config->edgeWidthCm = 2.5f;
+    config->opponentSpeedCmS = 15.0f;
+    config->noOpponent = false;
+    config->boutTimeoutMs = 60000;
+}
+
+void simReset(const SimConfig_t *config) {
+    cfg = *config;
+    rngState = cfg.seed ? cfg.seed * 2654435761u : 1;
+    simResetClock();
+    simResetPins();
+    physicsNs = 0;
+    boutStarted = false;
+    result = BOUT_RUNNING;
+
+    wheelA.revPerS = wheelB.revPerS = 0.0f;
+    wheelA.tickAccumulator = wheelB.tickAccumulator = 0.0f;
+    robotSpeedCmS = 0.0f;
+    for (Sonar_t &sonar : sonars) sonar.busy = false;
+    lastCornerCode = 0;
+    crossingPending = false;
+    reaction = SimReactionStats_t();
+
+    float r = randomRange(0.0f, 25.0f), a = randomRange(-(float)M_PI, (float)M_PI);
+    robot.x = r * cosf(a);
+    robot.y = r * sinf(a);
+    robot.heading = randomRange(-(float)M_PI, (float)M_PI);
+    do {
+        r = randomRange(0.0f, cfg.arenaRadiusCm - 20.0f);
+        a = randomRange(-(float)M_PI, (float)M_PI);
+        opponent.x = r * cosf(a);
+        opponent.y = r * sinf(a);
+    } while (hypotf(opponent.x - robot.x, opponent.y - robot.y) < 40.0f);
+    opponent.heading = randomRange(-(float)M_PI, (float)M_PI);
+
+    // Buttons are active low
+    simSetPinLevel(LEFT_BUTTON, HIGH);
+    simSetPinLevel(RIGHT_BUTTON, HIGH);
+}
+
+void simStartBout(void) {
+    boutStarted = true;
+    boutStartNs = simNowNs();
+}
+
+BoutResult simBoutResult(void) { return result; }
+
+unsigned long simBoutElapsedMs(void) {
+    return boutStarted ? (unsigned long)((simNowNs() - boutStartNs) / 1000000) : 0;
+}
+
+void simReactionStats(SimReactionStats_t *stats) {
+    *stats = reaction;
+    stats->unanswered = crossingPending ? 1 : 0;
+}
+
+Pose_t simRobotPose(void) { return robot; }
+Pose_t simOpponentPose(void) { return opponent; }
+
+static void stepOperator(uint64_t nowNs) {
+    // RIGHT scrolls to the competition entry, then LEFT starts it
+    uint64_t ms = nowNs / 1000000;
+    int left = HIGH, right = HIGH;
+    if (ms >= BUTTON_FIRST_PRESS_MS) {
+        uint64_t press = (ms - BUTTON_FIRST_PRESS_MS) / BUTTON_PERIOD_MS;
+        bool held = (ms - BUTTON_FIRST_PRESS_MS) % BUTTON_PERIOD_MS < BUTTON_PRESS_MS;
+        if (held && press < (uint64_t)COMPETITION) right = LOW;
+        else if (held && press == (uint64_t)COMPETITION) left = LOW;
+    }
+    simSetPinLevel(LEFT_BUTTON, left);
+    simSetPinLevel(RIGHT_BUTTON, right);
+}
+
+static void stepWheel(Wheel_t *w, float dt) {
+    int in1 = simPinLevel(w->in1), in2 = simPinLevel(w->in2);
+    float dir = (in1 && !in2) ? 1.0f : (!in1 && in2) ? -1.0f : 0.0f;
+    float u = dir * (float)simPwmDuty(w->pwmPin) / (float)((1 << PWM_RESOLUTION) - 1);
+    w->revPerS += (u * SIM_MOTOR_MAX_REV_S - w->revPerS) * dt / SIM_MOTOR_TAU_S;
+
+    // Single channel encoder, one rising edge per tick regardless of direction
+    w->tickAccumulator += fabsf(w->revPerS) * dt * SIM_ENCODER_TICKS_PER_REV;
+    while (w->tickAccumulator >= 1.0f) {
+        w->tickAccumulator -= 1.0f;
+        simSetPinLevel(w->encPin, HIGH);
+        simSetPinLevel(w->encPin, LOW);
+    }
+}
+
+static void stepOpponent(float dt) {
+    float r = hypotf(opponent.x, opponent.y);
+    float target = (r > cfg.arenaRadiusCm - 15.0f)
+        ? atan2f(-opponent.y, -opponent.x)
+        : atan2f(robot.y - opponent.y, robot.x - opponent.x);
+    float turn = wrapAngle(target - opponent.heading);
+    float maxTurn = 3.0f * dt;
+    opponent.heading = wrapAngle(opponent.heading + constrain(turn, -maxTurn, maxTurn));
+    opponent.x += cfg.opponentSpeedCmS * cosf(opponent.heading) * dt;
+    opponent.y += cfg.opponentSpeedCmS * sinf(opponent.heading) * dt;
+}
+
+static void resolveContact(void) {
+    float dx = opponent.x - robot.x, dy = opponent.y - robot.y;
+    float d = hypotf(dx, dy);
+    float overlap = 2.0f * ROBOT_RADIUS_CM - d;
+    if (overlap <= 0.0f || d <= 0.0f) return;
+
+    // Whoever drives harder along the contact normal gets to move the other
+    float nx = dx / d, ny = dy / d;
+    float pushRobot = max(0.0f, robotSpeedCmS * (cosf(robot.heading) * nx + sinf(robot.heading) * ny));
+    float pushOpponent = max(0.0f, -cfg.opponentSpeedCmS * (cosf(opponent.heading) * nx + sinf(opponent.heading) * ny));
+    float share = (pushRobot + 1.0f) / (pushRobot + pushOpponent + 2.0f);
+
+    opponent.x += nx * overlap * share;
+    opponent.y += ny * overlap * share;
+    robot.x -= nx * overlap * (1.0f - share);
+    robot.y -= ny * overlap * (1.0f - share);
+}
+
+static void stepPhysics(void) {
+    const float dt = PHYSICS_STEP_NS * 1e-9f;
+
+    stepOperator(physicsNs);
+    stepWheel(&wheelA, dt);
+    stepWheel(&wheelB, dt);
+
+    float vRight = wheelA.revPerS * WHEEL_CIRCUMFERENCE_CM;
+    float vLeft = wheelB.revPerS * WHEEL_CIRCUMFERENCE_CM;
+    robotSpeedCmS = 0.5f * (vLeft + vRight);
+    robot.heading = wrapAngle(robot.heading + (vRight - vLeft) / TRACK_CM * dt);
+    robot.x += robotSpeedCmS * cosf(robot.heading) * dt;
+    robot.y += robotSpeedCmS * sinf(robot.heading) * dt;
+
+    if (!boutStarted) return;
+    if (!cfg.noOpponent) {
+        stepOpponent(dt);
+        resolveContact();
+    }
+
+    int code = cornerCode();
+    if (code && !lastCornerCode && !crossingPending) {
+        crossingPending = true;
+        crossingNs = physicsNs;
+    }
+    lastCornerCode = code;
+
+    if (hypotf(robot.x, robot.y) > cfg.arenaRadiusCm) result = BOUT_LOSS;
+    else if (!cfg.noOpponent && hypotf(opponent.x, opponent.y) > cfg.arenaRadiusCm) result = BOUT_WIN;
+    else if (simBoutElapsedMs() > cfg.boutTimeoutMs) result = BOUT_DRAW;
+}
+
+// Earliest pending echo edge, or UINT64_MAX
+static uint64_t nextSonarEventNs(Sonar_t **which) {
+    uint64_t next = UINT64_MAX;
+    for (Sonar_t &sonar : sonars) {
+        if (!sonar.busy) continue;
+        uint64_t t = simPinLevel(sonar.echoPin) ? sonar.fallNs : sonar.riseNs;
+        if (t < next) {
+            next = t;
+            *which = &sonar;
+        }
+    }
+    return next;
+}
+
+void simStepTo(uint64_t nowNs) {
+    while (result == BOUT_RUNNING) {
+        Sonar_t *sonar = NULL;
+        uint64_t eventNs = nextSonarEventNs(&sonar);
+        uint64_t stepNs = physicsNs + PHYSICS_STEP_NS;
+
+        if (eventNs <= nowNs && eventNs < stepNs) {
+            // Fire the echo edge at its exact time so the ISR timestamps it correctly
+            simSetClockNs(eventNs);
+            if (simPinLevel(sonar->echoPin)) {
+                sonar->busy = false;
+                simSetPinLevel(sonar->echoPin, LOW);
+            } else {
+                simSetPinLevel(sonar->echoPin, HIGH);
+            }
+        } else if (stepNs <= nowNs) {
+            simSetClockNs(stepNs);
+            physicsNs = stepNs;
+            stepPhysics();
+        } else {
+            break;
+        }
+    }
+}
+
+static void recordReaction(void) {
+    uint64_t latencyNs = simNowNs() - crossingNs;
+    crossingPending = false;
+    reaction.reactions++;
+    reaction.totalNs += latencyNs;
+    if (latencyNs > reaction.maxNs) reaction.maxNs = latencyNs;
+}
+
+void simPwmWritten(uint8_t channel, uint32_t duty) {
+    uint8_t pin = (channel == PWM_CHANNEL_A) ? wheelA.pwmPin : (channel == PWM_CHANNEL_B) ? wheelB.pwmPin : 0xFF;
+    if (crossingPending && pin != 0xFF && duty == 0 && simPwmDuty(pin) != 0) recordReaction();
+}
+
+void simPinWritten(uint8_t pin, int level) {
+    bool directionPin = pin == wheelA.in1 || pin == wheelA.in2 || pin == wheelB.in1 || pin == wheelB.in2;
+    if (crossingPending && directionPin && level != simPinLevel(pin)) recordReaction();
+
+    for (Sonar_t &sonar : sonars) {
+        // A ping starts on the falling edge of the trigger, unless one is already in flight
+        if (pin != sonar.triggerPin || level != LOW || !simPinLevel(pin) || sonar.busy) continue;
+        unsigned long widthUs = simEchoWidthUs(sonar.echoPin);
+        if (widthUs == 0) widthUs = SIM_ECHO_NO_TARGET_US;
+        sonar.busy = true;
+        sonar.riseNs = simNowNs() + (uint64_t)SIM_ECHO_DELAY_US * 1000;
+        sonar.fallNs = sonar.riseNs + (uint64_t)widthUs * 1000;
+    }
+}
+
+// Corners over the line, in the ladder's bit order
+static int cornerCode(void) {
+    float x, y;
+    int code = 0;
+    bodyToWorld(&robot, CORNER_FORWARD_CM, CORNER_LATERAL_CM, &x, &y);
+    code |= overLine(x, y) << 3;    // Front left
+    bodyToWorld(&robot, CORNER_FORWARD_CM, -CORNER_LATERAL_CM, &x, &y);
+    code |= overLine(x, y) << 2;    // Front right
+    bodyToWorld(&robot, -CORNER_FORWARD_CM, CORNER_LATERAL_CM, &x, &y);
+    code |= overLine(x, y) << 1;    // Rear left
+    bodyToWorld(&robot, -CORNER_FORWARD_CM, -CORNER_LATERAL_CM, &x, &y);
+    code |= overLine(x, y);         // Rear right
+    return code;
+}
+
+int simLineDetectorReading(void) {
+    int code = cornerCode();
+
+    // The ladder output sits midway between the default calibration thresholds
+    int lo = code ? ADCLookupDefaults[code - 1] : 0;
+    int reading = (lo + ADCLookupDefaults[code]) / 2;
+    reading += (int)(nextRandom() % (2 * LINE_NOISE_COUNTS + 1)) - LINE_NOISE_COUNTS;
+    return constrain(reading, 0, 4095);
+}
+
+unsigned long simEchoWidthUs(uint8_t echoPin) {
+    float lateral;
+    if (echoPin == LEFT_ECHO) lateral = SONAR_LATERAL_CM;
+    else if (echoPin == RIGHT_ECHO) lateral = -SONAR_LATERAL_CM;
+    else return 0;
+    if (cfg.noOpponent) return 0;
+
+    float sx, sy;
+    bodyToWorld(&robot, SONAR_FORWARD_CM, lateral, &sx, &sy);
+    float dx = opponent.x - sx, dy = opponent.y - sy;
+    float centre = hypotf(dx, dy);
+    if (centre <= ROBOT_RADIUS_CM) return (unsigned long)(2.0f / 0.0343f);
+
+    float bearing = fabsf(wrapAngle(atan2f(dy, dx) - robot.heading));
+    if (bearing - asinf(ROBOT_RADIUS_CM / centre) > SONAR_HALF_ANGLE_RAD) return 0;
+
+    float distanceCm = centre - ROBOT_RADIUS_CM + randomRange(-SONAR_NOISE_CM, SONAR_NOISE_CM);
+    if (distanceCm > SONAR_MAX_RANGE_CM) return 0;
+    return (unsigned long)(max(distanceCm, 1.0f) * 2.0f / 0.0343f);
+}
+
+#endif // !ARDUINO
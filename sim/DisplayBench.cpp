@@ -0,0 +1,182 @@
+// Display damage bench for the host simulator (--display-bench).
+// Replays HUD frames on a 320x170 RGB565 frame buffer, recording the areas
+// drawn with the TFT_DirtyRects set TFT_eSprite uses for pushDirty(), and
+// copies only those areas to a second buffer standing in for the panel. Checks
+// the panel matches the frame buffer after every frame and reports the pixels
+// sent per frame against a full pushSprite().
+#if !defined(ARDUINO)
+
+#include "Sim.h"
+#include "Hal.h"
+#include "../lib/TFT_eSPI-master/Extensions/DirtyRects.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_WIDTH             320
+#define BENCH_HEIGHT            170
+#define BENCH_FRAMES            2000
+#define BENCH_CELL_W            12      // GLCD font at text size 2
+#define BENCH_CELL_H            16
+#define BENCH_STATE_FRAMES      150     // Mean frames between strategy state changes
+#define BENCH_MIN_SAVING        10.0    // Full frames must cost this many times more
+#define BENCH_RANDOM_ADDS       200000
+
+// One HUD value: drawn at a fixed cell position, redrawn only when its text changes
+typedef struct {
+    const char *label;
+    int column, row;
+    char shown[16];
+} HudField_t;
+
+static uint16_t frame[BENCH_HEIGHT][BENCH_WIDTH];
+static uint16_t panel[BENCH_HEIGHT][BENCH_WIDTH];
+static TFT_DirtyRects dirty;
+
+static uint32_t nextRandom(uint32_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+static void fillArea(int x, int y, int w, int h, uint16_t color) {
+    for (int yp = y; yp < y + h; yp++)
+        for (int xp = x; xp < x + w; xp++) frame[yp][xp] = color;
+    dirty.add(x, y, w, h);
+}
+
+// Stands in for a glyph: a pattern that differs for every character and background
+static void drawCell(int column, int row, char c, uint16_t background) {
+    int x = column * BENCH_CELL_W, y = row * BENCH_CELL_H;
+    for (int yp = 0; yp < BENCH_CELL_H; yp++)
+        for (int xp = 0; xp < BENCH_CELL_W; xp++)
+            frame[y + yp][x + xp] = ((xp * 7 + yp * 3 + c) % 5 == 0) ? 0x0000 : background;
+    dirty.add(x, y, BENCH_CELL_W, BENCH_CELL_H);
+}
+
+static void drawText(int column, int row, const char *text, uint16_t background) {
+    for (; *text; text++, column++) drawCell(column, row, *text, background);
+}
+
+// What pushDirty() sends: every recorded area, then the set is cleared
+static uint32_t pushDirty(uint32_t *windows) {
+    uint32_t pixels = 0;
+    for (uint8_t i = 0; i < dirty.count(); i++) {
+        const dirty_rect_t &r = dirty[i];
+        for (int y = r.y0; y <= r.y1; y++)
+            memcpy(&panel[y][r.x0], &frame[y][r.x0], (r.x1 - r.x0 + 1) * sizeof(uint16_t));
+        pixels += (r.x1 - r.x0 + 1) * (r.y1 - r.y0 + 1);
+    }
+    *windows += dirty.count();
+    dirty.clear();
+    return pixels;
+}
+
+// Random areas against a coverage map: every pixel added must be covered,
+// no pixel covered twice and the set never exceeds its bound
+static int checkRandomAdds(void) {
+    static uint8_t added[BENCH_HEIGHT][BENCH_WIDTH];
+    uint32_t rng = 0x1234567;
+    int failures = 0;
+
+    for (int round = 0; round < BENCH_RANDOM_ADDS / 50; round++) {
+        memset(added, 0, sizeof(added));
+        dirty.clear();
+        for (int n = 0; n < 50; n++) {
+            int w = 1 + nextRandom(&rng) % 40, h = 1 + nextRandom(&rng) % 30;
+            int x = nextRandom(&rng) % (BENCH_WIDTH - w + 1), y = nextRandom(&rng) % (BENCH_HEIGHT - h + 1);
+            dirty.add(x, y, w, h);
+            for (int yp = y; yp < y + h; yp++) memset(&added[yp][x], 1, w);
+        }
+        if (dirty.count() > SPRITE_DIRTY_RECTS) failures++;
+
+        static uint8_t covered[BENCH_HEIGHT][BENCH_WIDTH];
+        memset(covered, 0, sizeof(covered));
+        for (uint8_t i = 0; i < dirty.count(); i++) {
+            const dirty_rect_t &r = dirty[i];
+            for (int y = r.y0; y <= r.y1; y++)
+                for (int x = r.x0; x <= r.x1; x++) covered[y][x]++;
+        }
+        for (int y = 0; y < BENCH_HEIGHT; y++)
+            for (int x = 0; x < BENCH_WIDTH; x++)
+                if ((added[y][x] && !covered[y][x]) || covered[y][x] > 1) failures++;
+    }
+    dirty.clear();
+    return failures;
+}
+
+int simRunDisplayBench(void) {
+    int failures = checkRandomAdds();
+    printf("random areas : %d rounds of 50, %d coverage errors\n", BENCH_RANDOM_ADDS / 50, failures);
+
+    // The fields renderHud() shows, label at column 0 and the value after it
+    HudField_t fields[] = {
+        {"Left :", 6, 0, ""}, {"Right:", 6, 1, ""}, {"Avg  :", 6, 2, ""},
+        {"State:", 7, 3, ""}, {"FL FR:", 7, 4, ""}, {"RL RR:", 7, 5, ""},
+        {"ADC  :", 6, 6, ""}, {"p99  :", 8, 7, ""}, {"max  :", 8, 8, ""},
+    };
+    const int numFields = sizeof(fields) / sizeof(fields[0]);
+    static const char *states[] = {"STARTUP", "SEARCH", "CHASE", "EDGE"};
+    static const uint16_t colors[] = {0x07FF, 0xFFE0, 0x07E0, 0xF800};
+
+    uint32_t rng = 0xC0FFEE;
+    int state = 0, left = 40, right = 40;
+    uint16_t background = 0;
+    bool redrawAll = true;
+    uint64_t dirtyPixels = 0, fullPixels = 0;
+    uint32_t windows = 0, mismatches = 0, fullFrames = 0;
+
+    for (int n = 0; n < BENCH_FRAMES; n++) {
+        // Sensor values walk, the strategy changes state now and then
+        left = constrain(left + (int)(nextRandom(&rng) % 7) - 3, 2, 400);
+        right = constrain(right + (int)(nextRandom(&rng) % 7) - 3, 2, 400);
+        if (nextRandom(&rng) % BENCH_STATE_FRAMES == 0) {
+            state = (state + 1) % 4;
+            redrawAll = true;
+        }
+
+        char values[numFields][16];
+        snprintf(values[0], 16, "%4d", left);
+        snprintf(values[1], 16, "%4d", right);
+        snprintf(values[2], 16, "%4d", (left + right) / 2);
+        snprintf(values[3], 16, "%8s", states[state]);
+        snprintf(values[4], 16, "%d %d", (int)(nextRandom(&rng) % 50 == 0), 0);
+        snprintf(values[5], 16, "%d %d", 0, 0);
+        snprintf(values[6], 16, "%4d", (int)(nextRandom(&rng) % 8) * 256 + 128);
+        snprintf(values[7], 16, "%5d", 1000 + (int)(nextRandom(&rng) % 3));
+        snprintf(values[8], 16, "%5d", 1015);
+
+        // A state change repaints everything in the new colour, as fillSprite() would
+        if (redrawAll) {
+            background = colors[state];
+            fillArea(0, 0, BENCH_WIDTH, BENCH_HEIGHT, background);
+            for (int f = 0; f < numFields; f++) {
+                drawText(0, fields[f].row, fields[f].label, background);
+                fields[f].shown[0] = 0;
+            }
+            fullFrames++;
+            redrawAll = false;
+        }
+        for (int f = 0; f < numFields; f++) {
+            if (!strcmp(fields[f].shown, values[f])) continue;
+            drawText(fields[f].column, fields[f].row, values[f], background);
+            strcpy(fields[f].shown, values[f]);
+        }
+
+        dirtyPixels += pushDirty(&windows);
+        fullPixels += BENCH_WIDTH * BENCH_HEIGHT;
+        if (memcmp(frame, panel, sizeof(frame))) mismatches++;
+    }
+
+    double perFrame = (double)dirtyPixels / BENCH_FRAMES;
+    double saving = (double)fullPixels / dirtyPixels;
+    printf("hud frames   : %d (%u full repaints), %u panel mismatches\n", BENCH_FRAMES, fullFrames, mismatches);
+    printf("pixels/frame : %.0f dirty vs %d full, %.1fx fewer bytes, %.1f windows/frame\n",
+        perFrame, BENCH_WIDTH * BENCH_HEIGHT, saving, (double)windows / BENCH_FRAMES);
+
+    bool ok = failures == 0 && mismatches == 0 && saving >= BENCH_MIN_SAVING;
+    printf("%s\n", ok ? "ok" : "FAIL");
+    return ok ? 0 : 1;
+}
+
+#endif // !ARDUINO
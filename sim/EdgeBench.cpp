@@ -0,0 +1,89 @@
+// Edge reaction bench for the host simulator (--edge-bench).
+// Drives straight at the dohyo edge from random starts on an empty arena and
+// measures, in the arena, the time from a corner reaching the line to the first
+// change in motor command. Run once with the line reflex and once with only the
+// strategy loop polling detectLine(), at the loop period the competition sketch had.
+#if !defined(ARDUINO)
+
+#include "Sim.h"
+#include "Motor.h"
+#include "Sensors.h"
+
+#define BENCH_TRIALS            100
+#define BENCH_TRIAL_TIMEOUT_MS  10000
+#define BENCH_LOOP_PERIOD_US    40000   // Two sonar polls and a display refresh per loop()
+#define BENCH_MAX_REACTION_MS   1.0     // Reflex must beat this on every trial
+
+void lineReflex(uint8_t mask);          // Demo_Comp.cpp
+
+typedef struct {
+    uint32_t trials;
+    uint32_t missed;            // Left the arena or timed out without a reaction
+    uint64_t totalNs;
+    uint64_t maxNs;
+} EdgeStats_t;
+
+static void runTrial(uint32_t seed, bool reflex, EdgeStats_t *stats) {
+    SimConfig_t config;
+    simDefaultConfig(&config);
+    config.seed = seed;
+    config.noOpponent = true;
+    simReset(&config);
+
+    initMotors();
+    initSensors();
+    startMotorControlTask();
+    startLineSampling();
+    setLineReflex(reflex ? lineReflex : NULL);
+    simStartBout();
+
+    Motor_t motor = {};
+    motor.direction = FORWARD;
+    move(&motor);
+
+    // The strategy's own response: back off once detectLine() reports the line
+    Sensors_t sensors = {};
+    while (simBoutResult() == BOUT_RUNNING && simBoutElapsedMs() < BENCH_TRIAL_TIMEOUT_MS) {
+        detectLine(&sensors);
+        if (sensors.lineMask) {
+            motor.direction = REVERSE;
+            move(&motor);
+            break;
+        }
+        halDelayMicroseconds(reflex ? 10 : BENCH_LOOP_PERIOD_US);
+    }
+    // Let the control task apply whatever was posted
+    halDelay(5);
+
+    SimReactionStats_t reaction;
+    simReactionStats(&reaction);
+    stats->trials++;
+    if (reaction.reactions == 0) {
+        stats->missed++;
+        return;
+    }
+    stats->totalNs += reaction.totalNs;
+    stats->maxNs = max(stats->maxNs, reaction.maxNs);
+}
+
+static void report(const char *name, const EdgeStats_t *stats) {
+    uint32_t answered = stats->trials - stats->missed;
+    printf("%-22s: %.2f ms mean, %.2f ms max, %u of %u missed\n", name,
+        answered ? stats->totalNs / 1e6 / answered : 0.0, stats->maxNs / 1e6, stats->missed, stats->trials);
+}
+
+int simRunEdgeBench(void) {
+    EdgeStats_t withReflex = {}, loopOnly = {};
+    for (uint32_t trial = 0; trial < BENCH_TRIALS; trial++) {
+        runTrial(trial + 1, true, &withReflex);
+        runTrial(trial + 1, false, &loopOnly);
+    }
+    report("reflex", &withReflex);
+    report("loop only (40 ms loop)", &loopOnly);
+
+    bool pass = withReflex.missed == 0 && withReflex.maxNs / 1e6 <= BENCH_MAX_REACTION_MS;
+    printf("%-22s: %s\n", "reflex within limit", pass ? "ok" : "FAIL");
+    return pass ? 0 : 1;
+}
+
+#endif // !ARDUINO
@@ -0,0 +1,297 @@
+// Host implementation of the hardware abstraction layer (see Hal.h).
+// Time is virtual: every HAL call charges a nominal cost to the clock and the
+// arena physics is stepped forward whenever the clock moves.
+#if !defined(ARDUINO)
+
+#include "Hal.h"
+#include "Sim.h"
+#include "Sensors.h"
+#include <map>
+#include <string>
+#include <unistd.h>
+
+#define SIM_NUM_PINS        64
+#define SIM_NUM_PWM         16
+
+// Nominal cost of each call on the ESP32-S3, in ns
+#define SIM_GPIO_COST_NS    200
+#define SIM_CLOCK_COST_NS   100
+#define SIM_ADC_COST_NS     40000
+#define SIM_NVS_COST_NS     100000
+
+static uint64_t nowNs = 0;
+// Interrupts and the periodic task run "on another core": their HAL calls cost the loop nothing
+static bool inInterrupt = false;
+
+static void (*periodicFn)(void) = nullptr;
+static uint64_t periodicNs = 0;
+static uint64_t nextPeriodicNs = 0;
+
+typedef struct {
+    void (*fn)(void);
+    uint64_t intervalNs;
+    uint64_t nextNs;
+} BackgroundTask_t;
+
+static BackgroundTask_t backgroundTasks[HAL_MAX_BACKGROUND_TASKS];
+
+static int serialFd = -1;
+
+#define SIM_ADC_MAX_FRAME   256
+static void (*adcFrameFn)(const uint16_t *, size_t) = nullptr;
+static uint16_t adcFrameSamples = 0;
+static uint64_t adcFrameNs = 0;
+static uint64_t nextAdcFrameNs = 0;
+
+static uint8_t pinLevel[SIM_NUM_PINS];
+static uint8_t pinModes[SIM_NUM_PINS];
+static int8_t pinChannel[SIM_NUM_PINS];
+static void (*pinIsr[SIM_NUM_PINS])(void);
+static int pinIsrMode[SIM_NUM_PINS];
+static uint32_t pwmDuty[SIM_NUM_PWM];
+
+static std::map<std::string, int32_t> nvs;
+
+// ===================== VIRTUAL CLOCK =====================
+uint64_t simNowNs(void) { return nowNs; }
+
+// A DMA frame completes: the ladder was sampled throughout it, physics only has 100 us steps
+static void deliverAdcFrame(void) {
+    uint16_t samples[SIM_ADC_MAX_FRAME];
+    for (uint16_t i = 0; i < adcFrameSamples; i++) samples[i] = (uint16_t)simLineDetectorReading();
+    adcFrameFn(samples, adcFrameSamples);
+}
+
+void simAdvanceNs(uint64_t ns) {
+    if (inInterrupt) return;
+    uint64_t target = nowNs + ns;
+    for (;;) {
+        uint64_t periodicAt = periodicFn ? nextPeriodicNs : UINT64_MAX;
+        uint64_t adcAt = adcFrameFn ? nextAdcFrameNs : UINT64_MAX;
+        BackgroundTask_t *background = nullptr;
+        for (int i = 0; i < HAL_MAX_BACKGROUND_TASKS; i++) {
+            BackgroundTask_t *bg = &backgroundTasks[i];
+            if (bg->fn && (!background || bg->nextNs < background->nextNs)) background = bg;
+        }
+        uint64_t backgroundAt = background ? background->nextNs : UINT64_MAX;
+        uint64_t next = min(min(periodicAt, adcAt), backgroundAt);
+        if (next > target) break;
+
+        simStepTo(next);
+        nowNs = next;
+        inInterrupt = true;
+        if (next == periodicAt) {
+            nextPeriodicNs += periodicNs;
+            periodicFn();
+        } else if (next == adcAt) {
+            nextAdcFrameNs += adcFrameNs;
+            deliverAdcFrame();
+        } else {
+            background->nextNs += background->intervalNs;
+            background->fn();
+        }
+        inInterrupt = false;
+    }
+    simStepTo(target);
+    nowNs = target;
+}
+
+void simSetClockNs(uint64_t ns) { nowNs = ns; }
+
+void simResetClock(void) { nowNs = 0; }
+
+void simSetSerialOutput(int fd) { serialFd = fd; }
+
+// ===================== PIN STATE =====================
+int simPinLevel(uint8_t pin) { return (pin < SIM_NUM_PINS) ? pinLevel[pin] : LOW; }
+
+uint32_t simPwmDuty(uint8_t pin) {
+    if (pin >= SIM_NUM_PINS || pinChannel[pin] < 0) return 0;
+    return pwmDuty[pinChannel[pin]];
+}
+
+void simSetPinLevel(uint8_t pin, int level) {
+    if (pin >= SIM_NUM_PINS) return;
+    uint8_t old = pinLevel[pin];
+    pinLevel[pin] = level ? HIGH : LOW;
+    if (old == pinLevel[pin] || !pinIsr[pin]) return;
+
+    bool rising = pinLevel[pin] == HIGH;
+    if (pinIsrMode[pin] == CHANGE || (pinIsrMode[pin] == RISING && rising) || (pinIsrMode[pin] == FALLING && !rising)) {
+        bool nested = inInterrupt;
+        inInterrupt = true;
+        pinIsr[pin]();
+        inInterrupt = nested;
+    }
+}
+
+void simResetPins(void) {
+    for (int i = 0; i < SIM_NUM_PINS; i++) {
+        pinLevel[i] = LOW;
+        pinModes[i] = INPUT;
+        pinChannel[i] = -1;
+        pinIsr[i] = nullptr;
+        pinIsrMode[i] = 0;
+    }
+    for (int i = 0; i < SIM_NUM_PWM; i++) pwmDuty[i] = 0;
+    periodicFn = nullptr;
+    adcFrameFn = nullptr;
+    for (int i = 0; i < HAL_MAX_BACKGROUND_TASKS; i++) backgroundTasks[i].fn = nullptr;
+}
+
+// ===================== GPIO =====================
+void halPinMode(uint8_t pin, uint8_t mode) {
+    if (pin >= SIM_NUM_PINS) return;
+    pinModes[pin] = mode;
+    if (mode == INPUT_PULLUP) pinLevel[pin] = HIGH;
+    simAdvanceNs(SIM_GPIO_COST_NS);
+}
+
+void halDigitalWrite(uint8_t pin, uint8_t level) {
+    simPinWritten(pin, level ? HIGH : LOW);
+    if (pin < SIM_NUM_PINS) pinLevel[pin] = level ? HIGH : LOW;
+    simAdvanceNs(SIM_GPIO_COST_NS);
+}
+
+int halDigitalRead(uint8_t pin) {
+    simAdvanceNs(SIM_GPIO_COST_NS);
+    return simPinLevel(pin);
+}
+
+void halAttachInterrupt(uint8_t pin, void (*isr)(void), int mode) {
+    if (pin >= SIM_NUM_PINS) return;
+    pinIsr[pin] = isr;
+    pinIsrMode[pin] = mode;
+}
+
+// ===================== LEDC PWM =====================
+void halPwmSetup(uint8_t channel, uint32_t freqHz, uint8_t resolutionBits) {
+    (void)freqHz;
+    (void)resolutionBits;
+    if (channel < SIM_NUM_PWM) pwmDuty[channel] = 0;
+}
+
+void halPwmAttachPin(uint8_t pin, uint8_t channel) {
+    if (pin < SIM_NUM_PINS && channel < SIM_NUM_PWM) pinChannel[pin] = channel;
+}
+
+void halPwmWrite(uint8_t channel, uint32_t duty) {
+    simPwmWritten(channel, duty);
+    if (channel < SIM_NUM_PWM) pwmDuty[channel] = duty;
+    simAdvanceNs(SIM_GPIO_COST_NS);
+}
+
+// ===================== ADC =====================
+int halAnalogRead(uint8_t pin) {
+    (void)pin;
+    simAdvanceNs(SIM_ADC_COST_NS);
+    return simLineDetectorReading();
+}
+
+bool halAdcStartContinuous(uint8_t pin, uint32_t sampleRateHz, uint16_t frameSamples,
+                           void (*onFrame)(const uint16_t *samples, size_t count), uint8_t core, uint8_t priority) {
+    (void)core;
+    (void)priority;
+    if (pin != LINEDETECTOR_DAC || adcFrameFn || sampleRateHz == 0) return false;
+    if (frameSamples == 0 || frameSamples > SIM_ADC_MAX_FRAME) return false;
+    adcFrameFn = onFrame;
+    adcFrameSamples = frameSamples;
+    adcFrameNs = 1000000000ull * frameSamples / sampleRateHz;
+    nextAdcFrameNs = nowNs + adcFrameNs;
+    return true;
+}
+
+// ===================== PULSE TIMING =====================
+unsigned long halPulseIn(uint8_t pin, uint8_t level, unsigned long timeoutUs) {
+    (void)level;
+    unsigned long widthUs = simEchoWidthUs(pin);
+    if (widthUs == 0 || SIM_ECHO_DELAY_US + widthUs > timeoutUs) {
+        simAdvanceNs((uint64_t)timeoutUs * 1000);
+        return 0;
+    }
+    simAdvanceNs((uint64_t)(SIM_ECHO_DELAY_US + widthUs) * 1000);
+    return widthUs;
+}
+
+// ===================== CLOCK =====================
+unsigned long halMillis(void) {
+    simAdvanceNs(SIM_CLOCK_COST_NS);
+    return (unsigned long)(nowNs / 1000000);
+}
+
+unsigned long halMicros(void) {
+    simAdvanceNs(SIM_CLOCK_COST_NS);
+    return (unsigned long)(nowNs / 1000);
+}
+void halDelay(unsigned long ms) { simAdvanceNs((uint64_t)ms * 1000000); }
+void halDelayMicroseconds(unsigned int us) { simAdvanceNs((uint64_t)us * 1000); }
+
+// ===================== CRITICAL SECTIONS =====================
+// Interrupts and the periodic task never preempt simulated code mid-statement
+void halCriticalEnter(void) {}
+void halCriticalExit(void) {}
+
+// ===================== TASKS =====================
+void halStartPeriodicTask(const char *name, void (*fn)(void), uint32_t rateHz, uint8_t core, uint8_t priority) {
+    (void)name;
+    (void)core;
+    (void)priority;
+    if (periodicFn || rateHz == 0) return;
+    periodicFn = fn;
+    periodicNs = 1000000000ull / rateHz;
+    nextPeriodicNs = nowNs + periodicNs;
+}
+
+void halStartBackgroundTask(const char *name, void (*fn)(void), uint32_t intervalMs, uint8_t core, uint8_t priority) {
+    (void)name;
+    (void)core;
+    (void)priority;
+    if (intervalMs == 0) return;
+    BackgroundTask_t *slot = nullptr;
+    for (int i = 0; i < HAL_MAX_BACKGROUND_TASKS; i++) {
+        if (backgroundTasks[i].fn == fn) return;
+        if (!slot && !backgroundTasks[i].fn) slot = &backgroundTasks[i];
+    }
+    if (!slot) return;
+    slot->fn = fn;
+    slot->intervalNs = (uint64_t)intervalMs * 1000000;
+    slot->nextNs = nowNs + slot->intervalNs;
+}
+
+// ===================== SERIAL =====================
+void halSerialBegin(uint32_t baud) { (void)baud; }
+
+// Blocks on the output instead, so a slow reader stalls the run rather than losing data
+size_t halSerialWrite(const uint8_t *data, size_t length) {
+    if (serialFd < 0) return length;
+    size_t done = 0;
+    while (done < length) {
+        ssize_t n = write(serialFd, data + done, length - done);
+        if (n <= 0) {
+            serialFd = -1;      // Reader went away, drop the rest of the run
+            return length;
+        }
+        done += n;
+    }
+    return length;
+}
+
+// ===================== NVS =====================
+void halNvsBegin(const char *name) {
+    (void)name;
+    simAdvanceNs(SIM_NVS_COST_NS);
+}
+
+bool halNvsIsKey(const char *key) { return nvs.count(key) != 0; }
+
+int32_t halNvsGetInt(const char *key, int32_t defaultValue) {
+    auto it = nvs.find(key);
+    return (it == nvs.end()) ? defaultValue : it->second;
+}
+
+void halNvsPutInt(const char *key, int32_t value) {
+    nvs[key] = value;
+    simAdvanceNs(SIM_NVS_COST_NS);
+}
+
+#endif // !ARDUINO
@@ -0,0 +1,122 @@
+// Line detector decode bench for the host simulator (--line-bench).
+// Checks the ADCCodeTable decode against the original threshold scan for every
+// 12-bit reading, over the default and a set of recalibrated tables, then times both.
+#if !defined(ARDUINO)
+
+#include "Sim.h"
+#include "Sensors.h"
+#include <chrono>
+#include <string.h>
+
+#define BENCH_TABLES            200
+#define BENCH_DECODES           20000000
+
+// The decode detectLine() used before ADCCodeTable: first threshold above the
+// reading, then one bit per corner. It started from 16 for readings above every
+// threshold, which the bit extraction truncated to 0000 despite meaning 1111.
+static void decodeScan(Sensors_t *sensors, int analogValue)
+{
+    int *ptrs[4] = {&sensors->rearRight, &sensors->rearLeft, &sensors->frontRight, &sensors->frontLeft};
+    int encoding = 15;
+    for (int i = 0; i < 16; i++) {
+        if (analogValue < ADCLookup[i]) {
+            encoding = i;
+            break;
+        }
+    }
+    for (int j = 0; j < 4; j++) {
+        int remainder = encoding % 2;
+        encoding /= 2;
+        *ptrs[j] = remainder;
+    }
+}
+
+static void decodeTable(Sensors_t *sensors, int analogValue)
+{
+    uint8_t mask = lineMaskFromADC(analogValue);
+    sensors->lineMask = mask;
+    sensors->frontLeft = (mask & LINE_FRONT_LEFT) != 0;
+    sensors->frontRight = (mask & LINE_FRONT_RIGHT) != 0;
+    sensors->rearLeft = (mask & LINE_REAR_LEFT) != 0;
+    sensors->rearRight = (mask & LINE_REAR_RIGHT) != 0;
+}
+
+static uint32_t nextRandom(uint32_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+// Thresholds as recalibrateADC_GUI() derives them, from noisy readings that
+// are not always in order, so the table has to cope with unsorted thresholds
+static void randomCalibration(uint32_t *rng) {
+    int readings[16];
+    for (int i = 0; i < 16; i++) {
+        int ideal = 256 * i + 128;
+        readings[i] = constrain(ideal + (int)(nextRandom(rng) % 401) - 200, 0, ADC_CODES - 1);
+    }
+    for (int i = 0; i < 16; i++) {
+        int next = (i + 1 < 16) ? readings[i + 1] : 4096;
+        ADCLookup[i] = (readings[i] + next) / 2;
+    }
+}
+
+// Number of readings where the two decodes disagree
+static int compareAll(void) {
+    int mismatches = 0;
+    for (int value = 0; value < ADC_CODES; value++) {
+        Sensors_t scan = {}, table = {};
+        decodeScan(&scan, value);
+        decodeTable(&table, value);
+        int scanMask = (scan.frontLeft << 3) | (scan.frontRight << 2) | (scan.rearLeft << 1) | scan.rearRight;
+        if (scanMask != table.lineMask || scan.frontLeft != table.frontLeft || scan.frontRight != table.frontRight
+            || scan.rearLeft != table.rearLeft || scan.rearRight != table.rearRight) {
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+static double timeDecode(void (*decode)(Sensors_t *, int)) {
+    Sensors_t sensors = {};
+    volatile int sink = 0;      // Keeps the loop from being optimized away
+    uint32_t rng = 12345;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BENCH_DECODES; i++) {
+        decode(&sensors, nextRandom(&rng) & (ADC_CODES - 1));
+        sink = sink + sensors.frontLeft + sensors.rearRight;
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return ns / BENCH_DECODES;
+}
+
+int simRunLineBench(void) {
+    int failures = 0;
+
+    memcpy(ADCLookup, ADCLookupDefaults, sizeof(ADCLookup));
+    buildADCCodeTable();
+    int mismatches = compareAll();
+    printf("default table      : %d of %d readings differ  %s\n", mismatches, ADC_CODES, mismatches ? "FAIL" : "ok");
+    if (mismatches) failures++;
+
+    uint32_t rng = 1;
+    int badTables = 0;
+    for (int t = 0; t < BENCH_TABLES; t++) {
+        randomCalibration(&rng);
+        buildADCCodeTable();
+        if (compareAll()) badTables++;
+    }
+    printf("recalibrated tables: %d of %d differ  %s\n", badTables, BENCH_TABLES, badTables ? "FAIL" : "ok");
+    if (badTables) failures++;
+
+    memcpy(ADCLookup, ADCLookupDefaults, sizeof(ADCLookup));
+    buildADCCodeTable();
+    double scanNs = timeDecode(decodeScan);
+    double tableNs = timeDecode(decodeTable);
+    printf("decode cost        : scan %.2f ns, table %.2f ns (%.1fx, host)\n", scanNs, tableNs, scanNs / tableNs);
+    return failures ? 1 : 0;
+}
+
+#endif // !ARDUINO
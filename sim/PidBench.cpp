@@ -0,0 +1,154 @@
+// Wheel speed PID bench for the host simulator (--pid-bench).
+// Drives one first-order DC motor with the firmware's speed PID, measuring
+// speed from whole encoder ticks per sample exactly as the control task does,
+// and reports step response figures and the cost of one update.
+#if !defined(ARDUINO)
+
+#include "Sim.h"
+#include "Motor.h"
+#include "Pid.h"
+#include <chrono>
+#include <math.h>
+
+#define BENCH_PHYSICS_STEP_S    0.0001f
+#define BENCH_SETTLE_BAND       0.10f       // Settled once within 10% of the setpoint for good
+#define BENCH_TIMING_UPDATES    2000000
+
+typedef struct {
+    const char *name;
+    float initialSetpoint;      // Held until the plant is steady
+    float setpoint;             // Stepped to at t = 0
+    float maxSettleS;
+    float maxOvershootPct;
+} StepCase_t;
+
+typedef struct {
+    float settleS;              // < 0 if never settled
+    float overshootPct;
+    float meanAbsErrorSettled;  // Over the last half of the run
+    bool outputInRange;
+} StepResult_t;
+
+typedef struct {
+    float revPerS;
+    float tickAccumulator;
+} BenchMotor_t;
+
+// Advances the motor by one sample period at this duty, returns whole ticks counted
+static int stepMotor(BenchMotor_t *motor, int duty, float periodS) {
+    float u = (float)duty / (float)((1 << PWM_RESOLUTION) - 1);
+    int ticks = 0;
+    for (float t = 0.0f; t < periodS; t += BENCH_PHYSICS_STEP_S) {
+        motor->revPerS += (u * SIM_MOTOR_MAX_REV_S - motor->revPerS) * BENCH_PHYSICS_STEP_S / SIM_MOTOR_TAU_S;
+        motor->tickAccumulator += motor->revPerS * BENCH_PHYSICS_STEP_S * SIM_ENCODER_TICKS_PER_REV;
+        while (motor->tickAccumulator >= 1.0f) {
+            motor->tickAccumulator -= 1.0f;
+            ticks++;
+        }
+    }
+    return ticks;
+}
+
+static StepResult_t runStep(const PidConfig_t *config, const StepCase_t *step) {
+    PidController pid(*config);
+    BenchMotor_t motor = {0.0f, 0.0f};
+    float periodS = config->samplePeriodS;
+    float velocity = 0.0f;
+    int duty = 0;
+
+    // Speed in ticks per 100 ms, as motorControlTick() measures it
+    for (float t = 0.0f; t < 1.0f; t += periodS) {
+        duty = q16ToInt(pid.update(q16FromFloat(step->initialSetpoint), q16FromFloat(velocity)));
+        velocity = 0.1f * stepMotor(&motor, duty, periodS) / periodS;
+    }
+
+    StepResult_t result = {-1.0f, 0.0f, 0.0f, true};
+    const float runS = 2.0f;
+    int samples = (int)(runS / periodS), settledSamples = 0;
+    float peak = 0.0f, errorSum = 0.0f;
+    for (int i = 0; i < samples; i++) {
+        float t = i * periodS;
+        duty = q16ToInt(pid.update(q16FromFloat(step->setpoint), q16FromFloat(velocity)));
+        if (duty < (int)config->outMin || duty > (int)config->outMax) result.outputInRange = false;
+        velocity = 0.1f * stepMotor(&motor, duty, periodS) / periodS;
+
+        // The controller sees the quantized speed, judge the response on the true one
+        float trueSpeed = 0.1f * motor.revPerS * SIM_ENCODER_TICKS_PER_REV;
+        float rising = (step->setpoint >= step->initialSetpoint) ? 1.0f : -1.0f;
+        peak = max(peak, rising * (trueSpeed - step->setpoint));
+        if (fabsf(trueSpeed - step->setpoint) > BENCH_SETTLE_BAND * step->setpoint) result.settleS = -1.0f;
+        else if (result.settleS < 0.0f) result.settleS = t + periodS;
+        if (i >= samples / 2) {
+            errorSum += fabsf(trueSpeed - step->setpoint);
+            settledSamples++;
+        }
+    }
+    result.overshootPct = 100.0f * peak / step->setpoint;
+    result.meanAbsErrorSettled = errorSum / settledSamples;
+    return result;
+}
+
+static uint64_t readCycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static void timeUpdate(const PidConfig_t *config, double *nsPerUpdate, double *cyclesPerUpdate) {
+    PidController pid(*config);
+    q16_t setpoint = q16FromFloat(maxTickSpeed * 0.5f), measurement = 0;
+    volatile q16_t sink = 0;     // Keeps the loop from being optimized away
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t startCycles = readCycles();
+    for (uint32_t i = 0; i < BENCH_TIMING_UPDATES; i++) {
+        // Cheap stand-in for the plant so the inputs keep changing
+        q16_t out = pid.update(setpoint, measurement);
+        measurement += (out >> 6) - (measurement >> 4) + (q16_t)(i & 0xFF);
+        sink = sink ^ out;
+    }
+    uint64_t cycles = readCycles() - startCycles;
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    *nsPerUpdate = ns / BENCH_TIMING_UPDATES;
+    *cyclesPerUpdate = (double)cycles / BENCH_TIMING_UPDATES;
+}
+
+int simRunPidBench(void) {
+    PidConfig_t config;
+    getSpeedPidConfig(&config);
+
+    const StepCase_t cases[] = {
+        {"half speed from rest",   0.0f, maxTickSpeed * 0.5f, 0.30f, 15.0f},
+        {"full speed from rest",   0.0f, maxTickSpeed,        0.30f, 15.0f},
+        {"half to full speed",     maxTickSpeed * 0.5f, maxTickSpeed, 0.30f, 15.0f},
+        {"full to half speed",     maxTickSpeed, maxTickSpeed * 0.5f, 0.30f, 15.0f},
+        // Setpoint beyond the free-running speed, the integrator must not wind up
+        {"out of reach, back",     60.0f, maxTickSpeed * 0.5f, 0.40f, 15.0f},
+    };
+
+    int failures = 0;
+    printf("pid sample : %.0f ms, kp %.2f ki %.1f/s kd %.3f s kff %.2f kt %.1f/s\n",
+        config.samplePeriodS * 1000.0f, config.kp, config.ki, config.kd, config.kff, config.kt);
+    for (const StepCase_t &step : cases) {
+        StepResult_t r = runStep(&config, &step);
+        bool pass = r.outputInRange && r.settleS >= 0.0f && r.settleS <= step.maxSettleS
+                 && r.overshootPct <= step.maxOvershootPct;
+        if (!pass) failures++;
+        char settle[16];
+        if (r.settleS >= 0.0f) snprintf(settle, sizeof(settle), "%.0f ms", r.settleS * 1000.0f);
+        else snprintf(settle, sizeof(settle), "never");
+        printf("%-22s: settle %8s, overshoot %5.1f%%, settled error %.2f ticks/100ms  %s\n",
+            step.name, settle, r.overshootPct, r.meanAbsErrorSettled, pass ? "ok" : "FAIL");
+    }
+
+    double ns, cycles;
+    timeUpdate(&config, &ns, &cycles);
+    if (cycles > 0.0) printf("update cost: %.1f ns, %.0f cycles (host)\n", ns, cycles);
+    else printf("update cost: %.1f ns (host)\n", ns);
+    return failures ? 1 : 0;
+}
+
+#endif // !ARDUINO
@@ -0,0 +1,173 @@
+// Screenshot compression bench for the host simulator (--screenshot-bench).
+// Draws HUD frames as renderHud() does, in the GLCD font at text size 2, and
+// encodes them band by band as screenshots are (include/Screenshot.h). Every
+// band is decoded again and compared, and the encoded size of a whole frame is
+// checked against the capture buffer. Reports the compression and encode time.
+#if !defined(ARDUINO)
+
+#include "Sim.h"
+#include "Hal.h"
+#include "Screenshot.h"
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+#define PROGMEM
+#include "../lib/TFT_eSPI-master/Fonts/glcdfont.c"
+
+#define BENCH_WIDTH             320
+#define BENCH_HEIGHT            170
+#define BENCH_ROWS              16      // DISPLAY_STRIP_ROWS
+#define BENCH_FRAMES            500
+#define BENCH_TEXT_SIZE         2
+#define BENCH_MIN_RATIO         8.0     // Whole frames must shrink at least this much
+
+static uint16_t frame[BENCH_HEIGHT][BENCH_WIDTH];
+static uint16_t decoded[BENCH_ROWS * BENCH_WIDTH];
+static uint8_t encoded[BENCH_ROWS * BENCH_WIDTH * 3];
+
+static uint32_t nextRandom(uint32_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+// As drawChar() with the background filled: 5 font columns and a blank one
+static void drawChar(int x, int y, char c, uint16_t fg, uint16_t bg) {
+    for (int i = 0; i < 6; i++) {
+        uint8_t line = (i < 5) ? font[(uint8_t)c * 5 + i] : 0;
+        for (int j = 0; j < 8; j++, line >>= 1) {
+            for (int yp = y + j * BENCH_TEXT_SIZE; yp < y + (j + 1) * BENCH_TEXT_SIZE; yp++)
+                for (int xp = x + i * BENCH_TEXT_SIZE; xp < x + (i + 1) * BENCH_TEXT_SIZE; xp++)
+                    if (xp < BENCH_WIDTH && yp < BENCH_HEIGHT) frame[yp][xp] = (line & 1) ? fg : bg;
+        }
+    }
+}
+
+// Lines wrap at the screen edge like the HUD's printf()
+static void drawLines(const char *text, uint16_t bg) {
+    int x = 0, y = 0;
+    for (; *text; text++) {
+        if (*text == '\n' || x + 6 * BENCH_TEXT_SIZE > BENCH_WIDTH) {
+            x = 0;
+            y += 8 * BENCH_TEXT_SIZE;
+            if (*text == '\n') continue;
+        }
+        drawChar(x, y, *text, 0x0000, bg);
+        x += 6 * BENCH_TEXT_SIZE;
+    }
+}
+
+// The ops of screenshotEncodeBand() back to pixels, false if they do not cover the
+// band exactly
+static bool decodeBand(const uint8_t *in, size_t length, int32_t width, int32_t rows, uint16_t *out) {
+    int32_t n = width * rows, i = 0;
+    size_t p = 0;
+    while (i < n) {
+        if (p >= length) return false;
+        uint8_t op = in[p++];
+        int32_t count = (op < 0x80) ? op + 1 : (op & 0x3F) + 1;
+        if (i + count > n) return false;
+        if (op < 0x80) {
+            if (p + 2 * count > length) return false;
+            memcpy(out + i, in + p, 2 * count);
+            p += 2 * count;
+        } else if (op < 0xC0) {
+            if (p + 2 > length) return false;
+            uint16_t pixel;
+            memcpy(&pixel, in + p, 2);
+            p += 2;
+            for (int32_t k = 0; k < count; k++) out[i + k] = pixel;
+        } else {
+            if (i < width) return false;
+            for (int32_t k = 0; k < count; k++) out[i + k] = out[i + k - width];
+        }
+        i += count;
+    }
+    return p == length;
+}
+
+// Noise does not compress: with no more room than raw pixels the encoder must give
+// up, and never write past the room it was given
+static int checkNoise(void) {
+    uint32_t rng = 0xBADC0DE;
+    for (int i = 0; i < BENCH_ROWS * BENCH_WIDTH; i++) frame[i / BENCH_WIDTH][i % BENCH_WIDTH] = nextRandom(&rng);
+    size_t room = BENCH_ROWS * BENCH_WIDTH * 2;
+    memset(encoded, 0xA5, sizeof(encoded));
+    size_t n = screenshotEncodeBand(&frame[0][0], BENCH_WIDTH, BENCH_ROWS, encoded, room);
+    int failures = (n != 0);
+    for (size_t i = room; i < sizeof(encoded); i++) failures += (encoded[i] != 0xA5);
+
+    n = screenshotEncodeBand(&frame[0][0], BENCH_WIDTH, BENCH_ROWS, encoded, sizeof(encoded));
+    if (n == 0 || !decodeBand(encoded, n, BENCH_WIDTH, BENCH_ROWS, decoded)
+        || memcmp(decoded, &frame[0][0], BENCH_ROWS * BENCH_WIDTH * 2)) failures++;
+    return failures;
+}
+
+int simRunScreenshotBench(void) {
+    int failures = checkNoise();
+    printf("noise band   : %d failures\n", failures);
+
+    static const char *states[] = {"STARTUP", "SEARCH", "CHASE", "EDGE"};
+    static const uint16_t colors[] = {0x07FF, 0xFFE0, 0x07E0, 0xF800};
+    const int bands = (BENCH_HEIGHT + BENCH_ROWS - 1) / BENCH_ROWS;
+
+    uint32_t rng = 0xC0FFEE;
+    int state = 0, left = 40, right = 40;
+    uint32_t lastHash[bands], mismatches = 0;
+    uint64_t keyBytes = 0, deltaBytes = 0, encodeNs = 0;
+    size_t maxKey = 0;
+
+    for (int f = 0; f < BENCH_FRAMES; f++) {
+        left = constrain(left + (int)(nextRandom(&rng) % 7) - 3, 2, 400);
+        right = constrain(right + (int)(nextRandom(&rng) % 7) - 3, 2, 400);
+        if (nextRandom(&rng) % 30 == 0) state = (state + 1) % 4;
+
+        char text[256];
+        snprintf(text, sizeof(text),
+            "Left :%4d cm\nRight:%4d cm\nAvg  :%4d cm\nState: %8s\nFL:%d FR:%d \nRL:%d RR:%d\n%4d\nLoop :%5u Hz\nCtl p99:%4u max:%5u us",
+            left, right, (left + right) / 2, states[state], (int)(nextRandom(&rng) % 50 == 0), 0, 0, 0,
+            (int)(nextRandom(&rng) % 8) * 256 + 128, 9000u + nextRandom(&rng) % 500, 1015u, 1000u + nextRandom(&rng) % 3);
+        for (int y = 0; y < BENCH_HEIGHT; y++)
+            for (int x = 0; x < BENCH_WIDTH; x++) frame[y][x] = colors[state];
+        drawLines(text, colors[state]);
+
+        // A key frame encodes every band, a delta only those that changed
+        size_t key = SCREENSHOT_HEADER, delta = SCREENSHOT_HEADER;
+        for (int b = 0; b < bands; b++) {
+            int32_t rows = min(BENCH_ROWS, BENCH_HEIGHT - b * BENCH_ROWS);
+            const uint16_t *pixels = &frame[b * BENCH_ROWS][0];
+            uint32_t hash = 2166136261u;
+            for (int32_t i = 0; i < BENCH_WIDTH * rows; i++) hash = (hash ^ pixels[i]) * 16777619u;
+
+            auto start = std::chrono::steady_clock::now();
+            size_t n = screenshotEncodeBand(pixels, BENCH_WIDTH, rows, encoded, sizeof(encoded));
+            encodeNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+            if (n == 0 || !decodeBand(encoded, n, BENCH_WIDTH, rows, decoded)
+                || memcmp(decoded, pixels, BENCH_WIDTH * rows * 2)) mismatches++;
+            key += 1 + n;
+            delta += (f > 0 && hash == lastHash[b]) ? 1 : 1 + n;
+            lastHash[b] = hash;
+        }
+        keyBytes += key;
+        deltaBytes += delta;
+        maxKey = max(maxKey, key);
+    }
+
+    double raw = (double)BENCH_WIDTH * BENCH_HEIGHT * 2;
+    double keyMean = (double)keyBytes / BENCH_FRAMES, deltaMean = (double)deltaBytes / BENCH_FRAMES;
+    printf("hud frames   : %d, %u bands decoded wrong\n", BENCH_FRAMES, mismatches);
+    printf("key frame    : %.0f bytes mean, %zu max of %d buffer (%.1fx smaller than %.0f raw)\n",
+        keyMean, maxKey, SCREENSHOT_BUFFER, raw / keyMean, raw);
+    printf("delta frame  : %.0f bytes mean (%.1fx smaller)\n", deltaMean, raw / deltaMean);
+    printf("encode       : %.1f us per frame, %.0f MB/s of pixels on this host\n",
+        encodeNs / 1000.0 / BENCH_FRAMES, raw * BENCH_FRAMES / (encodeNs / 1e9) / 1e6);
+
+    bool ok = failures == 0 && mismatches == 0 && maxKey <= SCREENSHOT_BUFFER && raw / keyMean >= BENCH_MIN_RATIO;
+    printf("%s\n", ok ? "ok" : "FAIL");
+    return ok ? 0 : 1;
+}
+
+#endif // !ARDUINO
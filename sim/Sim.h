@@ -0,0 +1,114 @@
+#ifndef SIM_H
+#define SIM_H
+
+// Host-side simulation of the robot, the dohyo and an opponent.
+// Hal_Native.cpp owns the virtual clock and pin state, Arena.cpp owns the physics.
+
+#include <stdint.h>
+
+#define SIM_ECHO_DELAY_US       450         // HC-SR04 raises echo this long after the trigger
+#define SIM_ECHO_NO_TARGET_US   38000       // and holds it this long when nothing answers
+
+// Drive train, shared by the arena and the PID bench
+#define SIM_MOTOR_MAX_REV_S         3.5f        // Free-running wheel speed at full duty
+#define SIM_MOTOR_TAU_S             0.06f
+#define SIM_ENCODER_TICKS_PER_REV   120.0f
+
+enum BoutResult {
+    BOUT_RUNNING,
+    BOUT_WIN,
+    BOUT_LOSS,
+    BOUT_DRAW
+};
+
+typedef struct {
+    uint32_t seed;
+    float arenaRadiusCm;        // Outer radius of the dohyo, the edge line lies just inside it
+    float edgeWidthCm;          // Width of the edge line seen by the line detector
+    float opponentSpeedCmS;
+    bool noOpponent;            // Empty dohyo, for benches that only drive the robot
+    unsigned long boutTimeoutMs;
+} SimConfig_t;
+
+// Time from a corner of the robot reaching the edge line to the first change in
+// motor command (a duty dropping to 0 or a direction pin flipping)
+typedef struct {
+    uint32_t reactions;
+    uint32_t unanswered;        // Crossing still waiting when the bout ended
+    uint64_t totalNs;
+    uint64_t maxNs;
+} SimReactionStats_t;
+
+typedef struct {
+    float x, y;                 // cm, arena centre is the origin
+    float heading;              // rad, counter-clockwise from +x
+} Pose_t;
+
+void simDefaultConfig(SimConfig_t *config);
+
+// ===================== VIRTUAL CLOCK (Hal_Native.cpp) =====================
+uint64_t simNowNs(void);
+void simAdvanceNs(uint64_t ns);
+// Used by the arena to timestamp events that fall inside an advance
+void simSetClockNs(uint64_t ns);
+void simResetClock(void);
+
+// ===================== SERIAL (Hal_Native.cpp) =====================
+// Where halSerialWrite() output goes, -1 (the default) discards it
+void simSetSerialOutput(int fd);
+
+// ===================== PIN STATE (Hal_Native.cpp) =====================
+int simPinLevel(uint8_t pin);
+uint32_t simPwmDuty(uint8_t pin);
+// Drive an input pin from the outside world, fires any attached interrupt
+void simSetPinLevel(uint8_t pin, int level);
+// Clears pins, PWM, interrupts, the periodic and background tasks and continuous ADC sampling
+void simResetPins(void);
+
+// ===================== ARENA (Arena.cpp) =====================
+void simReset(const SimConfig_t *config);
+void simStartBout(void);
+// Integrate physics and fire pin events up to the given time, called by the clock as it advances
+void simStepTo(uint64_t nowNs);
+// Notification of an output pin about to be written by the firmware
+void simPinWritten(uint8_t pin, int level);
+// Notification of a PWM channel duty about to be written by the firmware
+void simPwmWritten(uint8_t channel, uint32_t duty);
+BoutResult simBoutResult(void);
+unsigned long simBoutElapsedMs(void);
+
+// Raw ADC reading the R-2R line detector would produce right now
+int simLineDetectorReading(void);
+// Echo pulse width in us for the sensor on this echo pin, 0 if nothing is in range
+unsigned long simEchoWidthUs(uint8_t echoPin);
+
+void simReactionStats(SimReactionStats_t *stats);
+Pose_t simRobotPose(void);
+Pose_t simOpponentPose(void);
+
+// ===================== PID BENCH (PidBench.cpp) =====================
+// Steps the wheel speed PID against a single motor model and times it.
+// Returns non-zero if the response misses its limits.
+int simRunPidBench(void);
+
+// ===================== LINE BENCH (LineBench.cpp) =====================
+// Checks the line detector code table against the threshold scan it replaced
+// for every ADC reading and times both. Returns non-zero on any mismatch.
+int simRunLineBench(void);
+
+// ===================== EDGE BENCH (EdgeBench.cpp) =====================
+// Drives the robot at the edge from random starts, with and without the line
+// reflex, and reports the time from crossing to the first motor command change.
+int simRunEdgeBench(void);
+
+// ===================== DISPLAY BENCH (DisplayBench.cpp) =====================
+// Replays HUD frames through the sprite damage tracking and checks only the
+// damaged areas need sending. Returns non-zero on a stale pixel or too little saving.
+int simRunDisplayBench(void);
+
+// ===================== SCREENSHOT BENCH (ScreenshotBench.cpp) =====================
+// Encodes HUD frames as screenshots and decodes them again. Returns non-zero if a
+// band comes back different or a frame does not fit the capture buffer.
+int simRunScreenshotBench(void);
+
+#endif // SIM_H
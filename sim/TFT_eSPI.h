@@ -0,0 +1,128 @@
+#ifndef SIM_TFT_ESPI_H
+#define SIM_TFT_ESPI_H
+
+// Headless stand-in for TFT_eSPI used by [env:native].
+// Only the calls made by the robot sources are provided and they draw nothing,
+// but the panel writes charge the virtual clock what the 8-bit parallel bus
+// would take, so drawing from loop() shows up in its period. Calls from a
+// background task, like the display service, cost loop() nothing.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include "Sim.h"
+
+#define SIM_TFT_PIXEL_NS        100     // Two bus writes per pixel at about 20 MHz
+#define SIM_TFT_WINDOW_NS       2000    // Address window and transaction set-up per primitive
+#define SIM_TFT_GLCD_PIXELS     (12 * 16)   // One GLCD character at text size 2
+
+#define TL_DATUM 0
+#define CC_DATUM 4
+
+#define TFT_BLACK       0x0000
+#define TFT_DARKGREY    0x7BEF
+#define TFT_GREEN       0x07E0
+#define TFT_CYAN        0x07FF
+#define TFT_RED         0xF800
+#define TFT_YELLOW      0xFFE0
+#define TFT_WHITE       0xFFFF
+#define TFT_GOLD        0xFEA0
+#define TFT_SILVER      0xC618
+
+class TFT_eSPI {
+public:
+    TFT_eSPI(int16_t w = 170, int16_t h = 320) : _width(w), _height(h) {}
+
+    void init(uint8_t tc = 0) { (void)tc; }
+    bool initDMA(bool ctrl_cs = false) { (void)ctrl_cs; return false; }
+    void setRotation(uint8_t r) { (void)r; }
+    void fillScreen(uint32_t color) { _fill = color; simAdvanceNs(SIM_TFT_WINDOW_NS + (uint64_t)_width * _height * SIM_TFT_PIXEL_NS); }
+
+    void setCursor(int16_t x, int16_t y) { (void)x; (void)y; }
+    void setTextSize(uint8_t size) { (void)size; }
+    void setTextFont(uint8_t font) { (void)font; }
+    void setTextDatum(uint8_t datum) { (void)datum; }
+    void setTextColor(uint16_t color) { (void)color; }
+    void setTextColor(uint16_t fgcolor, uint16_t bgcolor, bool bgfill = false) { (void)fgcolor; (void)bgcolor; (void)bgfill; }
+    bool createGlyphAtlas(uint8_t font, uint8_t size, uint16_t fg, uint16_t bg, bool digits = false, bool rgb565 = false) {
+        (void)font; (void)size; (void)fg; (void)bg; (void)digits; (void)rgb565;
+        return true;
+    }
+    void deleteGlyphAtlas(void) {}
+
+    int16_t drawString(const char *string, int32_t x, int32_t y) { (void)string; (void)x; (void)y; return 0; }
+    int16_t drawNumber(long intNumber, int32_t x, int32_t y) { (void)intNumber; (void)x; (void)y; return 0; }
+    size_t printf(const char *format, ...) {
+        char text[128];
+        va_list args;
+        va_start(args, format);
+        int n = vsnprintf(text, sizeof(text), format, args);
+        va_end(args);
+        if (n < 0) return 0;
+        simAdvanceNs((uint64_t)n * (SIM_TFT_WINDOW_NS + SIM_TFT_GLCD_PIXELS * SIM_TFT_PIXEL_NS));
+        return n;
+    }
+
+    int16_t width(void) const { return _width; }
+    int16_t height(void) const { return _height; }
+
+protected:
+    int16_t _width, _height;
+    uint16_t _fill = 0;         // Last fillScreen() colour, all a strip band holds
+};
+
+#define STRIP_ROWS      16
+
+typedef void (*drawSceneCallback)(TFT_eSPI *canvas, void *data);
+typedef void (*stripBandCallback)(const uint16_t *pixels, int32_t y, int32_t width, int32_t rows, uint32_t hash, void *data);
+
+// Calls the scene for every band like the real strip, but nothing drawn lands
+// anywhere, so after the first frame sending only changed bands sends nothing.
+// The band callback sees each band filled with the scene's fillScreen() colour.
+class TFT_eStrip : public TFT_eSPI {
+public:
+    explicit TFT_eStrip(TFT_eSPI *tft) : TFT_eSPI(0, 0), _tft(tft) {}
+    ~TFT_eStrip(void) { free(_pixels); }
+
+    bool createStrip(uint16_t rows = STRIP_ROWS) {
+        _width = _tft->width();
+        _height = _tft->height();
+        _rows = rows < 1 ? 1 : rows;
+        _pixels = (uint16_t *)realloc(_pixels, (size_t)_width * _rows * sizeof(uint16_t));
+        _created = _pixels != NULL;
+        return _created;
+    }
+    void deleteStrip(void) { _created = false; _sent = false; }
+
+    void setBandCallback(stripBandCallback band, void *data = NULL) { _band = band; _bandData = data; }
+
+    uint32_t pushFrame(drawSceneCallback scene, void *data, bool changedOnly = false) {
+        if (!_created) return 0;
+        for (int32_t y = 0; y < _height; y += _rows) {
+            scene(this, data);
+            if (!_band) continue;
+            int32_t rows = (_height - y < _rows) ? _height - y : _rows;
+            uint16_t swapped = (uint16_t)(_fill >> 8 | _fill << 8);
+            for (int32_t i = 0; i < _width * rows; i++) _pixels[i] = swapped;
+            _band(_pixels, y, _width, rows, swapped * 2654435761u + rows, _bandData);
+        }
+        if (changedOnly && _sent) return 0;
+        _sent = true;
+        uint32_t pixels = (uint32_t)_width * _height;
+        simAdvanceNs((uint64_t)((_height + _rows - 1) / _rows) * SIM_TFT_WINDOW_NS + (uint64_t)pixels * SIM_TFT_PIXEL_NS);
+        return pixels;
+    }
+
+private:
+    TFT_eSPI *_tft;
+    int32_t _rows = STRIP_ROWS;
+    bool _created = false;
+    bool _sent = false;         // A frame was sent, the panel shows what would be drawn
+    uint16_t *_pixels = NULL;
+    stripBandCallback _band = NULL;
+    void *_bandData = NULL;
+};
+
+#endif // SIM_TFT_ESPI_H
@@ -0,0 +1,87 @@
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+// Just enough of the Arduino core to build TFT_eSPI for the host (see tft_setup.h).
+// Pins do nothing and time comes from the host clock.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include <string>
+
+#define HIGH        1
+#define LOW         0
+#define INPUT       0
+#define OUTPUT      1
+#define DEC         10
+#define HEX         16
+#define PI          3.1415926535897932384626433832795
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+using std::min;
+using std::max;
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// Flash is ordinary memory, the reads may be unaligned and of any type
+#define PROGMEM
+inline uint8_t pgm_read_byte(const void *addr) { return *(const uint8_t *)addr; }
+inline uint16_t pgm_read_word(const void *addr) { uint16_t v; memcpy(&v, addr, sizeof(v)); return v; }
+inline uint32_t pgm_read_dword(const void *addr) { uint32_t v; memcpy(&v, addr, sizeof(v)); return v; }
+
+inline void pinMode(int pin, int mode) { (void)pin; (void)mode; }
+inline void digitalWrite(int pin, int level) { (void)pin; (void)level; }
+inline int digitalRead(int pin) { (void)pin; return LOW; }
+inline void yield(void) {}
+
+unsigned long millis(void);
+unsigned long micros(void);
+// Panel reset and power up waits are not worth sleeping through on the host
+inline void delay(unsigned long ms) { (void)ms; }
+inline void delayMicroseconds(unsigned int us) { (void)us; }
+
+// Arduino's random() takes bounds, the C library one does not
+inline long random(long howbig) { return howbig > 0 ? ::random() % howbig : 0; }
+inline long random(long howsmall, long howbig) { return howsmall < howbig ? howsmall + random(howbig - howsmall) : howsmall; }
+
+inline char *ltoa(long value, char *str, int base) {
+  if (base == 16) sprintf(str, "%lx", value);
+  else sprintf(str, "%ld", value);
+  return str;
+}
+
+class String {
+ public:
+  String(const char *s = "") : _s(s ? s : "") {}
+  String(const std::string &s) : _s(s) {}
+  String(char c) : _s(1, c) {}
+  String(int v, int base = DEC) : _s(base == HEX ? hex(v) : std::to_string(v)) {}
+  String(unsigned int v, int base = DEC) : _s(base == HEX ? hex(v) : std::to_string(v)) {}
+  String(long v) : _s(std::to_string(v)) {}
+  String(unsigned long v) : _s(std::to_string(v)) {}
+  String(double v, int decimals = 2) { char b[32]; snprintf(b, sizeof(b), "%.*f", decimals, v); _s = b; }
+
+  const char *c_str(void) const { return _s.c_str(); }
+  unsigned int length(void) const { return _s.length(); }
+  char charAt(unsigned int i) const { return i < _s.length() ? _s[i] : 0; }
+  char operator[](unsigned int i) const { return charAt(i); }
+  void toCharArray(char *buf, unsigned int size) const { if (size) { strncpy(buf, _s.c_str(), size - 1); buf[size - 1] = 0; } }
+  String &operator+=(const String &o) { _s += o._s; return *this; }
+  friend String operator+(const String &a, const String &b) { return String(a._s + b._s); }
+  bool operator==(const String &o) const { return _s == o._s; }
+
+ private:
+  static std::string hex(unsigned long v) { char b[16]; snprintf(b, sizeof(b), "%lX", v); return b; }
+  std::string _s;
+};
+
+#include "Print.h"
+
+extern Print Serial;
+
+#endif // ARDUINO_H
@@ -0,0 +1,428 @@
+// Rendering micro-benchmarks, see RenderBench.h.
+// Plain Arduino code so the same measurements run on the host and on the T-Display-S3.
+#include "RenderBench.h"
+#include "../../lib/TFT_eSPI-master/examples/Smooth Fonts/FLASH_Array/Font_Demo_1_Array/NotoSansBold15.h"
+
+#define BENCH_IMAGE_SIZE        64      // Images, rotated and pushed sprites are this square
+#define BENCH_BLEND_PIXELS      1024    // Pixels blended per alphaBlend call
+#define BENCH_SPAN_PIXELS       320     // One line of the landscape screen for the span kernels
+#define BENCH_TEXT              "Sumo 123 cm"
+#define BENCH_GLYPH_CACHE       16384   // Bytes of smooth font glyph cache for the cached text
+#define BENCH_LOOKUP_CODES      256     // Different codes looked up in the generated fonts
+
+typedef struct {
+    TFT_eSPI *canvas;           // What the primitive draws on
+    TFT_eSprite *sprite;        // The same canvas when it is a sprite, NULL for the panel
+    const char *target;
+    int32_t size;               // Square side, radius or font
+    Print *out;
+    uint32_t minUs;
+    const char *filter;
+    int count;
+} BenchContext_t;
+
+typedef void (*BenchFn_t)(BenchContext_t *ctx, uint32_t i);
+
+static uint16_t image16[BENCH_IMAGE_SIZE * BENCH_IMAGE_SIZE];
+static uint8_t image8[BENCH_IMAGE_SIZE * BENCH_IMAGE_SIZE];
+static uint8_t image4[BENCH_IMAGE_SIZE * BENCH_IMAGE_SIZE / 2];
+static uint16_t cmap[16];
+static uint16_t blended[BENCH_BLEND_PIXELS];
+static TFT_eSprite *rotated = NULL;                   // 16 bpp source for pushRotated/Transformed
+static TFT_eSprite *sources[4];                       // 16, 8, 4 and 1 bpp sources for pushToSprite
+static const uint8_t sourceDepths[4] = {16, 8, 4, 1};
+static uint16_t lookupCodes[BENCH_LOOKUP_CODES];
+
+// Spreads successive calls over the canvas so they do not all hit the same pixels
+static int32_t spread(int32_t span, int32_t size, uint32_t i, uint32_t step) {
+    int32_t room = span - size + 1;
+    return room > 1 ? (int32_t)((i * step) % room) : 0;
+}
+
+static uint16_t benchColor(uint32_t i) {
+    return (uint16_t)(0x1234 + i * 0x0841);
+}
+
+// ===================== MEASUREMENT =====================
+// Doubles the batch until one takes minUs, then reports that batch
+static void measure(BenchContext_t *ctx, const char *op, const char *param, uint32_t pixels, BenchFn_t fn) {
+    if (ctx->filter && !strstr(op, ctx->filter)) return;
+
+    fn(ctx, 0);
+    uint32_t calls = 1;
+    unsigned long elapsed = 0;
+#ifdef TFT_HOST_FRAMEBUFFER
+    host_bus_stats_t bus = {};
+    uint64_t busNs = 0;
+#endif
+    for (;;) {
+#ifdef TFT_HOST_FRAMEBUFFER
+        hostPanel.clearStats();
+#endif
+        unsigned long start = micros();
+        for (uint32_t i = 0; i < calls; i++) fn(ctx, i);
+        elapsed = micros() - start;
+#ifdef TFT_HOST_FRAMEBUFFER
+        hostPanel.getStats(&bus);
+        busNs = hostPanel.busNs();
+#endif
+        if (elapsed >= ctx->minUs || calls >= 0x40000000) break;
+        calls *= 2;
+        yield();
+    }
+
+    double nsCall = elapsed * 1000.0 / calls;
+    double nsPixel = pixels ? nsCall / pixels : 0.0;
+    ctx->out->printf("{\"target\":\"%s\",\"op\":\"%s\",\"param\":\"%s\",\"calls\":%lu,\"px\":%lu,"
+        "\"ns_call\":%.1f,\"ns_px\":%.3f,\"mpx_s\":%.2f",
+        ctx->target, op, param, (unsigned long)calls, (unsigned long)pixels,
+        nsCall, nsPixel, nsPixel > 0.0 ? 1000.0 / nsPixel : 0.0);
+#ifdef TFT_HOST_FRAMEBUFFER
+    if (!ctx->sprite && busNs) {
+        ctx->out->printf(",\"bus_bytes_call\":%.1f,\"cmd_bytes_call\":%.1f,\"bus_ns_call\":%.1f",
+            (double)hostPanel.busCycles() / calls, (double)(bus.commands + bus.paramBytes) / calls, (double)busNs / calls);
+    }
+#endif
+    ctx->out->printf("}\n");
+    ctx->count++;
+}
+
+// ===================== PRIMITIVES =====================
+static void benchDrawPixel(BenchContext_t *ctx, uint32_t i) {
+    TFT_eSPI *c = ctx->canvas;
+    c->drawPixel(spread(c->width(), 1, i, 7), spread(c->height(), 1, i, 13), benchColor(i));
+}
+
+static void benchFillRect(BenchContext_t *ctx, uint32_t i) {
+    TFT_eSPI *c = ctx->canvas;
+    int32_t s = ctx->size;
+    c->fillRect(spread(c->width(), s, i, 7), spread(c->height(), s, i, 13), s, s, benchColor(i));
+}
+
+static void benchDrawString(BenchContext_t *ctx, uint32_t i) {
+    TFT_eSPI *c = ctx->canvas;
+    c->drawString(BENCH_TEXT, spread(c->width(), c->width() / 2, i, 7), spread(c->height(), 40, i, 13));
+}
+
+static void benchSmoothCircle(BenchContext_t *ctx, uint32_t i) {
+    TFT_eSPI *c = ctx->canvas;
+    int32_t r = ctx->size;
+    c->fillSmoothCircle(r + spread(c->width(), 2 * r + 1, i, 7), r + spread(c->height(), 2 * r + 1, i, 13), r,
+        benchColor(i), TFT_BLACK);
+}
+
+static void benchSmoothArc(BenchContext_t *ctx, uint32_t i) {
+    TFT_eSPI *c = ctx->canvas;
+    int32_t r = ctx->size;
+    c->drawSmoothArc(r + spread(c->width(), 2 * r + 1, i, 7), r + spread(c->height(), 2 * r + 1, i, 13), r, r - 8,
+        45, 315, benchColor(i), TFT_BLACK, true);
+}
+
+static void benchPushRotated(BenchContext_t *ctx, uint32_t i) {
+    TFT_eSPI *c = ctx->canvas;
+    c->setPivot(c->width() / 2, c->height() / 2);
+    if (ctx->sprite) rotated->pushRotated(ctx->sprite, (i * 7) % 360);
+    else rotated->pushRotated((i * 7) % 360);
+}
+
+static void benchPushTransformed(BenchContext_t *ctx, uint32_t i) {
+    TFT_eSPI *c = ctx->canvas;
+    c->setPivot(c->width() / 2, c->height() / 2);
+    if (ctx->sprite) rotated->pushTransformed(ctx->sprite, (i * 7) % 360, 1.5f, 0x00FFFFFF, ctx->size);
+    else rotated->pushTransformed((i * 7) % 360, 1.5f, 0x00FFFFFF, ctx->size);
+}
+
+static void benchPushImage16(BenchContext_t *ctx, uint32_t i) {
+    int32_t s = ctx->size;
+    int32_t x = spread(ctx->canvas->width(), s, i, 7), y = spread(ctx->canvas->height(), s, i, 13);
+    // TFT_eSprite::pushImage() hides the panel one rather than overriding it
+    if (ctx->sprite) ctx->sprite->pushImage(x, y, s, s, image16);
+    else ctx->canvas->pushImage(x, y, s, s, image16);
+}
+
+static void benchPushImage8(BenchContext_t *ctx, uint32_t i) {
+    int32_t s = ctx->size;
+    ctx->canvas->pushImage(spread(ctx->canvas->width(), s, i, 7), spread(ctx->canvas->height(), s, i, 13), s, s, image8, true);
+}
+
+static void benchPushImageCmap(BenchContext_t *ctx, uint32_t i) {
+    int32_t s = ctx->size;
+    ctx->canvas->pushImage(spread(ctx->canvas->width(), s, i, 7), spread(ctx->canvas->height(), s, i, 13), s, s, image4, false, cmap);
+}
+
+static void benchPushToSprite(BenchContext_t *ctx, uint32_t i) {
+    TFT_eSprite *source = sources[ctx->size];
+    source->pushToSprite(ctx->sprite, spread(ctx->sprite->width(), BENCH_IMAGE_SIZE, i, 7),
+        spread(ctx->sprite->height(), BENCH_IMAGE_SIZE, i, 13));
+}
+
+static void benchAlphaBlend(BenchContext_t *ctx, uint32_t i) {
+    TFT_eSPI *c = ctx->canvas;
+    for (uint32_t n = 0; n < BENCH_BLEND_PIXELS; n++) {
+        blended[n] = c->alphaBlend((uint8_t)(n + i), image16[n], blended[n]);
+    }
+}
+
+// Span kernels (Extensions/SpanKernels.h), ctx->size is 1 for the scalar reference.
+// The source starts half a word out so the copies take their unaligned path.
+static void benchSpanFill(BenchContext_t *ctx, uint32_t i) {
+    if (ctx->size) spanFill16Ref(blended, benchColor(i), BENCH_SPAN_PIXELS);
+    else spanFill16(blended, benchColor(i), BENCH_SPAN_PIXELS);
+}
+
+static void benchSpanCopySwap(BenchContext_t *ctx, uint32_t i) {
+    if (ctx->size) spanCopySwap16Ref(blended, image16 + 1 + (i & 1), BENCH_SPAN_PIXELS);
+    else spanCopySwap16(blended, image16 + 1 + (i & 1), BENCH_SPAN_PIXELS);
+}
+
+static void benchSpanCopyKey(BenchContext_t *ctx, uint32_t i) {
+    if (ctx->size) spanCopyKey16Ref(blended, image16 + 1 + (i & 1), BENCH_SPAN_PIXELS, image16[0]);
+    else spanCopyKey16(blended, image16 + 1 + (i & 1), BENCH_SPAN_PIXELS, image16[0]);
+}
+
+static void benchSpanBlend(BenchContext_t *ctx, uint32_t i) {
+    if (ctx->size) spanBlend16Ref(blended, image16 + 1 + (i & 1), BENCH_SPAN_PIXELS, (uint8_t)(i | 1));
+    else spanBlend16(blended, image16 + 1 + (i & 1), BENCH_SPAN_PIXELS, (uint8_t)(i | 1));
+}
+
+// Glyph lookup in a generated font, ctx->size is 1 for the linear search the library
+// used to make
+static void benchGlyphIndex(BenchContext_t *ctx, uint32_t i) {
+    TFT_eSPI *c = ctx->canvas;
+    uint16_t code = lookupCodes[i % BENCH_LOOKUP_CODES], index = 0;
+    if (ctx->size) {
+        for (uint16_t g = 0; g < c->gFont.gCount; g++) {
+            if (c->gUnicode[g] == code) { index = g; break; }
+        }
+    }
+    else c->getUnicodeIndex(code, &index);
+    blended[0] += index;
+}
+
+// ===================== SWEEPS =====================
+typedef struct {
+    const char *name;
+    uint8_t font;               // 0 for the free font, 0xFF for the smooth font
+    uint8_t textSize;
+} BenchFont_t;
+
+static const BenchFont_t fonts[] = {
+    {"glcd",     1, 1},
+    {"glcd_x2",  1, 2},
+    {"font2",    2, 1},
+    {"font4",    4, 1},
+    {"free9",    0, 1},
+    {"smooth15", 0xFF, 1},
+};
+
+static void benchText(BenchContext_t *ctx) {
+    TFT_eSPI *c = ctx->canvas;
+    for (size_t f = 0; f < sizeof(fonts) / sizeof(fonts[0]); f++) {
+        if (fonts[f].font == 0xFF) c->loadFont(NotoSansBold15);
+        else if (fonts[f].font == 0) c->setFreeFont(&FreeSans9pt7b);
+        else c->setTextFont(fonts[f].font);
+        c->setTextSize(fonts[f].textSize);
+        c->setTextColor(TFT_WHITE, TFT_BLACK, true);
+
+        uint32_t pixels = (uint32_t)c->textWidth(BENCH_TEXT) * c->fontHeight();
+        measure(ctx, "drawString", fonts[f].name, pixels, benchDrawString);
+
+        // Atlases are drawn from on the panel and into 16 bpp sprites
+        bool atlas = !ctx->sprite || ctx->sprite->getColorDepth() == 16;
+        if (atlas && fonts[f].font != 0 && fonts[f].font != 0xFF &&
+            c->createGlyphAtlas(fonts[f].font, fonts[f].textSize, TFT_WHITE, TFT_BLACK)) {
+            // Again with the characters held in RAM as bits, copied a block each
+            char param[24];
+            snprintf(param, sizeof(param), "%s_atlas", fonts[f].name);
+            measure(ctx, "drawString", param, pixels, benchDrawString);
+            c->deleteGlyphAtlas();
+        }
+        if (fonts[f].font == 0xFF) {
+            // Again with the glyphs held in RAM, pre-blended as the background is filled
+            c->setGlyphCache(BENCH_GLYPH_CACHE);
+            measure(ctx, "drawString", "smooth15_cached", pixels, benchDrawString);
+            c->unloadFont();
+            c->setGlyphCache(0);
+        }
+    }
+    c->setTextFont(1);
+    c->setTextSize(1);
+}
+
+// A smooth font (.vlw layout) of count 1x1 glyphs: printable ASCII then codes spaced out
+// through the rest of the plane, as a CJK font would be. When shuffled the glyphs are
+// not listed in code order. Returns NULL if there is no memory.
+static uint8_t *makeFont(uint16_t count, bool shuffled) {
+    uint32_t size = 24 + count * 29;
+    uint8_t *font = (uint8_t *)malloc(size);
+    if (!font) return NULL;
+
+    uint8_t *p = font;
+    auto put = [&p](uint32_t v) { p[0] = v >> 24; p[1] = v >> 16; p[2] = v >> 8; p[3] = v; p += 4; };
+    put(count); put(11); put(15); put(0); put(12); put(3);
+    for (uint32_t g = 0; g < count; g++) {
+        uint32_t n = shuffled ? (g * 7919) % count : g;  // 7919 is prime, so a permutation
+        put(n < 95 ? 0x20 + n : 0xA0 + (n - 95) * 6);
+        put(1); put(1); put(8); put(10); put(0); put(0);
+    }
+    memset(p, 0xFF, count);
+    return font;
+}
+
+static void benchGlyphLookup(BenchContext_t *ctx) {
+    static const uint16_t counts[] = {100, 1000, 10000};
+    char param[24];
+    if (ctx->filter && !strstr("glyphIndex", ctx->filter)) return;
+
+    for (size_t n = 0; n < sizeof(counts) / sizeof(counts[0]); n++) {
+        for (int shuffled = 0; shuffled < 2; shuffled++) {
+            uint8_t *font = makeFont(counts[n], shuffled);
+            if (!font) {
+                ctx->out->printf("{\"target\":\"%s\",\"op\":\"glyphIndex\",\"skipped\":\"no memory\"}\n", ctx->target);
+                continue;
+            }
+            ctx->canvas->loadFont(font);
+            for (uint32_t i = 0; i < BENCH_LOOKUP_CODES; i++) {
+                lookupCodes[i] = ctx->canvas->gUnicode[(i * 40503u) % counts[n]];
+            }
+            for (ctx->size = 0; ctx->size < 2; ctx->size++) {
+                snprintf(param, sizeof(param), "%u%s%s", counts[n], shuffled ? "_shuffled" : "", ctx->size ? "_linear" : "");
+                measure(ctx, "glyphIndex", param, 0, benchGlyphIndex);
+            }
+            ctx->canvas->unloadFont();
+            free(font);
+        }
+    }
+}
+
+static void benchTarget(BenchContext_t *ctx) {
+    char param[24];
+    static const int32_t squares[] = {4, 16, 64, 160};
+    static const int32_t radii[] = {8, 32, 64};
+    static const int32_t arcs[] = {32, 64};
+    static const int32_t images[] = {16, BENCH_IMAGE_SIZE};
+
+    ctx->canvas->fillScreen(TFT_BLACK);
+    measure(ctx, "drawPixel", "1x1", 1, benchDrawPixel);
+    for (size_t n = 0; n < sizeof(squares) / sizeof(squares[0]); n++) {
+        ctx->size = min(squares[n], (int32_t)ctx->canvas->height());
+        snprintf(param, sizeof(param), "%dx%d", (int)ctx->size, (int)ctx->size);
+        measure(ctx, "fillRect", param, ctx->size * ctx->size, benchFillRect);
+    }
+    benchText(ctx);
+    for (size_t n = 0; n < sizeof(radii) / sizeof(radii[0]); n++) {
+        ctx->size = radii[n];
+        snprintf(param, sizeof(param), "r%d", (int)ctx->size);
+        measure(ctx, "fillSmoothCircle", param, (uint32_t)(PI * ctx->size * ctx->size), benchSmoothCircle);
+    }
+    for (size_t n = 0; n < sizeof(arcs) / sizeof(arcs[0]); n++) {
+        ctx->size = arcs[n];
+        snprintf(param, sizeof(param), "r%d_w8_270deg", (int)ctx->size);
+        uint32_t pixels = (uint32_t)(PI * (ctx->size * ctx->size - (ctx->size - 8) * (ctx->size - 8)) * 0.75);
+        measure(ctx, "drawSmoothArc", param, pixels, benchSmoothArc);
+    }
+    // Sprites cannot be rotated into a 4 bpp sprite
+    snprintf(param, sizeof(param), "%dx%d", BENCH_IMAGE_SIZE, BENCH_IMAGE_SIZE);
+    if (!ctx->sprite || rotated->pushRotated(ctx->sprite, 0)) {
+        measure(ctx, "pushRotated", param, BENCH_IMAGE_SIZE * BENCH_IMAGE_SIZE, benchPushRotated);
+        for (ctx->size = 0; ctx->size < 2; ctx->size++) {
+            snprintf(param, sizeof(param), "%dx%d_x1.5%s", BENCH_IMAGE_SIZE, BENCH_IMAGE_SIZE, ctx->size ? "_smooth" : "");
+            measure(ctx, "pushTransformed", param, BENCH_IMAGE_SIZE * BENCH_IMAGE_SIZE * 9 / 4, benchPushTransformed);
+        }
+    }
+    for (size_t n = 0; n < sizeof(images) / sizeof(images[0]); n++) {
+        ctx->size = images[n];
+        snprintf(param, sizeof(param), "%dx%d", (int)ctx->size, (int)ctx->size);
+        measure(ctx, "pushImage16", param, ctx->size * ctx->size, benchPushImage16);
+        // The 8 bpp and colour map versions only draw on the panel
+        if (ctx->sprite) continue;
+        measure(ctx, "pushImage8", param, ctx->size * ctx->size, benchPushImage8);
+        measure(ctx, "pushImageCmap", param, ctx->size * ctx->size, benchPushImageCmap);
+    }
+    if (ctx->sprite) {
+        for (int n = 0; n < 4; n++) {
+            // pushToSprite() only copies between equal depths, or from 16 to 8 bpp
+            if (!sources[n]->pushToSprite(ctx->sprite, 0, 0)) continue;
+            ctx->size = n;
+            snprintf(param, sizeof(param), "%dbpp_%dx%d", sourceDepths[n], BENCH_IMAGE_SIZE, BENCH_IMAGE_SIZE);
+            measure(ctx, "pushToSprite", param, BENCH_IMAGE_SIZE * BENCH_IMAGE_SIZE, benchPushToSprite);
+        }
+    }
+}
+
+static void makeImages(TFT_eSPI *tft) {
+    for (int y = 0; y < BENCH_IMAGE_SIZE; y++) {
+        for (int x = 0; x < BENCH_IMAGE_SIZE; x++) {
+            int i = y * BENCH_IMAGE_SIZE + x;
+            image16[i] = tft->color565(x * 4, y * 4, (x ^ y) * 4);
+            image8[i] = (uint8_t)(x * 3 + y * 5);
+            if (i & 1) image4[i >> 1] |= (x + y) & 0x0F;
+            else image4[i >> 1] = ((x + y) & 0x0F) << 4;
+        }
+    }
+    for (int i = 0; i < 16; i++) cmap[i] = default_4bit_palette[i];
+
+    rotated = new TFT_eSprite(tft);
+    rotated->createSprite(BENCH_IMAGE_SIZE, BENCH_IMAGE_SIZE);
+    rotated->pushImage(0, 0, BENCH_IMAGE_SIZE, BENCH_IMAGE_SIZE, image16);
+    for (int n = 0; n < 4; n++) {
+        sources[n] = new TFT_eSprite(tft);
+        sources[n]->setColorDepth(sourceDepths[n]);
+        sources[n]->createSprite(BENCH_IMAGE_SIZE, BENCH_IMAGE_SIZE);
+        if (sourceDepths[n] == 4) sources[n]->createPalette(default_4bit_palette);
+        sources[n]->fillSprite(TFT_NAVY);
+        sources[n]->fillCircle(BENCH_IMAGE_SIZE / 2, BENCH_IMAGE_SIZE / 2, BENCH_IMAGE_SIZE / 3, TFT_YELLOW);
+    }
+}
+
+static void freeImages(void) {
+    rotated->deleteSprite();
+    delete rotated;
+    for (int n = 0; n < 4; n++) {
+        sources[n]->deleteSprite();
+        delete sources[n];
+    }
+}
+
+int runRenderBench(TFT_eSPI *tft, Print *out, uint32_t minMs, const char *filter) {
+    BenchContext_t ctx = {tft, NULL, "panel", 0, out, minMs * 1000, filter, 0};
+    tft->setRotation(RENDER_BENCH_ROTATION);
+    makeImages(tft);
+
+    // Full screen sprites first, as the display task would draw the HUD
+    static const uint8_t depths[] = {1, 4, 8, 16};
+    static const char *names[] = {"sprite1", "sprite4", "sprite8", "sprite16"};
+    for (int d = 0; d < 4; d++) {
+        TFT_eSprite canvas(tft);
+        canvas.setColorDepth(depths[d]);
+        if (!canvas.createSprite(tft->width(), tft->height())) {
+            out->printf("{\"target\":\"%s\",\"skipped\":\"no memory\"}\n", names[d]);
+            continue;
+        }
+        if (depths[d] == 4) canvas.createPalette(default_4bit_palette);
+        ctx.canvas = &canvas;
+        ctx.sprite = &canvas;
+        ctx.target = names[d];
+        benchTarget(&ctx);
+        canvas.deleteSprite();
+    }
+
+    ctx.canvas = tft;
+    ctx.sprite = NULL;
+    ctx.target = "panel";
+    benchTarget(&ctx);
+
+    ctx.target = "cpu";
+    measure(&ctx, "alphaBlend", "1024px", BENCH_BLEND_PIXELS, benchAlphaBlend);
+    benchGlyphLookup(&ctx);
+    for (ctx.size = 0; ctx.size < 2; ctx.size++) {
+        const char *param = ctx.size ? "320px_ref" : "320px";
+        measure(&ctx, "spanFill16", param, BENCH_SPAN_PIXELS, benchSpanFill);
+        measure(&ctx, "spanCopySwap16", param, BENCH_SPAN_PIXELS, benchSpanCopySwap);
+        measure(&ctx, "spanCopyKey16", param, BENCH_SPAN_PIXELS, benchSpanCopyKey);
+        measure(&ctx, "spanBlend16", param, BENCH_SPAN_PIXELS, benchSpanBlend);
+    }
+
+    freeImages();
+    return ctx.count;
+}
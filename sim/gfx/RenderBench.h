@@ -0,0 +1,27 @@
+#ifndef RENDER_BENCH_H
+#define RENDER_BENCH_H
+#include <TFT_eSPI.h>
+
+// Rendering micro-benchmarks for TFT_eSPI.
+// Runs each primitive over a sweep of sizes and fonts against full screen sprites of
+// 1, 4, 8 and 16 bpp and against the panel itself, and prints one JSON object per
+// line for every measurement:
+//
+//   {"target":"sprite16","op":"fillRect","param":"64x64","calls":4096,"px":4096,
+//    "ns_call":812.4,"ns_px":0.198,"mpx_s":5042.1}
+//
+// Built for the host with the framebuffer driver (sim/gfx/main.cpp --bench), where
+// panel lines also carry the modelled bus bytes and bus time per call, and for the
+// T-Display-S3 ([env:render-bench], test/Render_Bench.cpp).
+
+// ===================== CONFIGURATION =====================
+#define RENDER_BENCH_MIN_MS         20      // Each measurement runs at least this long
+#define RENDER_BENCH_ROTATION       1       // Landscape, as the HUD uses
+
+// ===================== FUNCTION PROTOTYPES =====================
+// Runs the measurements whose op contains filter (all when NULL), each for at least
+// minMs, drawing on tft and writing the results to out. Returns the number of
+// measurements made.
+int runRenderBench(TFT_eSPI *tft, Print *out, uint32_t minMs, const char *filter);
+
+#endif // RENDER_BENCH_H
@@ -0,0 +1,2 @@
+// TFT_eSPI.h includes SPI.h before the setup says the bus is parallel, the host
+// framebuffer driver models the parallel bus and never uses SPI
@@ -0,0 +1,103 @@
+// Span kernel equivalence checks, see SpanCheck.h.
+#include "SpanCheck.h"
+
+#define SPAN_GUARD      4                   // Pixels either side that must not change
+#define SPAN_BUF_WORDS  ((SPAN_CHECK_MAX_LEN + 2 * SPAN_GUARD + 4) / 2 + 1)
+
+typedef enum {
+    SPAN_FILL,
+    SPAN_COPY_SWAP,
+    SPAN_COPY_KEY,
+    SPAN_BLEND,
+    SPAN_KERNELS
+} SpanKernel_t;
+
+static const char *kernelNames[SPAN_KERNELS] = {"spanFill16", "spanCopySwap16", "spanCopyKey16", "spanBlend16"};
+
+static uint32_t rngState = 0x2545F491;
+
+static uint16_t randomPixel(void) {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return (uint16_t)rngState;
+}
+
+static void runKernel(SpanKernel_t kernel, bool reference, uint16_t *dst, const uint16_t *src, uint32_t len,
+                      uint16_t value) {
+    switch (kernel) {
+        case SPAN_FILL:
+            reference ? spanFill16Ref(dst, value, len) : spanFill16(dst, value, len);
+            break;
+        case SPAN_COPY_SWAP:
+            reference ? spanCopySwap16Ref(dst, src, len) : spanCopySwap16(dst, src, len);
+            break;
+        case SPAN_COPY_KEY:
+            reference ? spanCopyKey16Ref(dst, src, len, value) : spanCopyKey16(dst, src, len, value);
+            break;
+        default:
+            reference ? spanBlend16Ref(dst, src, len, (uint8_t)value) : spanBlend16(dst, src, len, (uint8_t)value);
+            break;
+    }
+}
+
+static int checkKernel(SpanKernel_t kernel, Print *out) {
+    // Word aligned buffers so the offsets below give every alignment
+    uint32_t srcWords[SPAN_BUF_WORDS], refWords[SPAN_BUF_WORDS], fastWords[SPAN_BUF_WORDS];
+    uint16_t *src = (uint16_t *)srcWords, *ref = (uint16_t *)refWords, *fast = (uint16_t *)fastWords;
+    int errors = 0;
+
+    for (uint32_t len = 0; len <= SPAN_CHECK_MAX_LEN; len++) {
+        for (int dstOffset = 0; dstOffset < 4; dstOffset++) {
+            for (int srcOffset = 0; srcOffset < 4; srcOffset++) {
+                for (int round = 0; round < SPAN_CHECK_ROUNDS; round++) {
+                    for (int i = 0; i < SPAN_BUF_WORDS * 2; i++) {
+                        src[i] = randomPixel();
+                        ref[i] = fast[i] = randomPixel();
+                    }
+                    uint16_t value = randomPixel();
+                    if (kernel == SPAN_COPY_KEY && len) {
+                        // Make about half the pixels transparent, in runs and singly
+                        for (uint32_t i = 0; i < len; i++) {
+                            if (randomPixel() & 1) src[SPAN_GUARD + srcOffset + i] = value;
+                        }
+                    }
+                    if (kernel == SPAN_BLEND) value = (uint16_t)((len * 7 + round * 64 + dstOffset + srcOffset) & 0xFF);
+
+                    runKernel(kernel, true, ref + SPAN_GUARD + dstOffset, src + SPAN_GUARD + srcOffset, len, value);
+                    runKernel(kernel, false, fast + SPAN_GUARD + dstOffset, src + SPAN_GUARD + srcOffset, len, value);
+
+                    if (memcmp(ref, fast, sizeof(refWords)) != 0) {
+                        if (errors++ < 4) {
+                            out->printf("%s: len %u dst +%d src +%d value %04x differs from the reference\n",
+                                kernelNames[kernel], (unsigned)len, dstOffset, srcOffset, value);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return errors;
+}
+
+// The reference blend must be alphaBlend() on byte swapped sprite pixels
+static int checkBlendReference(TFT_eSPI *tft, Print *out) {
+    int errors = 0;
+    for (int alpha = 0; alpha < 256; alpha++) {
+        for (int n = 0; n < 64; n++) {
+            uint16_t fg = randomPixel(), bg = randomPixel(), dst = bg;
+            spanBlend16Ref(&dst, &fg, 1, (uint8_t)alpha);
+            uint16_t expect = tft->alphaBlend((uint8_t)alpha, fg << 8 | fg >> 8, bg << 8 | bg >> 8);
+            if ((uint16_t)(dst << 8 | dst >> 8) != expect && errors++ < 4) {
+                out->printf("spanBlend16Ref: alpha %d fg %04x bg %04x differs from alphaBlend()\n", alpha, fg, bg);
+            }
+        }
+    }
+    return errors;
+}
+
+int checkSpanKernels(TFT_eSPI *tft, Print *out) {
+    int errors = checkBlendReference(tft, out);
+    for (int k = 0; k < SPAN_KERNELS; k++) errors += checkKernel((SpanKernel_t)k, out);
+    return errors;
+}
@@ -0,0 +1,22 @@
+#ifndef SPAN_CHECK_H
+#define SPAN_CHECK_H
+#include <TFT_eSPI.h>
+
+// Equivalence checks for the sprite span kernels (Extensions/SpanKernels.h).
+// Every kernel runs over all alignments of source and destination, lengths from 0 to
+// SPAN_CHECK_MAX_LEN and random pixels, keys and alphas, and must leave exactly the
+// same buffer as its scalar ...Ref() version, without touching the guard pixels either
+// side. spanBlend16Ref() itself is checked against TFT_eSPI::alphaBlend().
+//
+// Run by the host rendering tests (sim/gfx/main.cpp) and before the benchmarks on the
+// T-Display-S3 (test/Render_Bench.cpp), where the PIE fill is built.
+
+// ===================== CONFIGURATION =====================
+#define SPAN_CHECK_MAX_LEN          67      // Longest span, covers every head/tail split
+#define SPAN_CHECK_ROUNDS           4       // Random fills per length and alignment
+
+// ===================== FUNCTION PROTOTYPES =====================
+// Returns the number of mismatches, each is reported on out
+int checkSpanKernels(TFT_eSPI *tft, Print *out);
+
+#endif // SPAN_CHECK_H
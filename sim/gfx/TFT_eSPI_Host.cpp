@@ -0,0 +1,14 @@
+// The library itself, built as one translation unit the way TFT_eSPI.cpp includes its
+// processor driver and extensions
+#include <TFT_eSPI.cpp>
+#include <time.h>
+
+Print Serial;
+
+unsigned long millis(void) { return micros() / 1000; }
+
+unsigned long micros(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long)(ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000);
+}
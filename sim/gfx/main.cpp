@@ -0,0 +1,1037 @@
+// Host rendering tests for [env:native_gfx].
+// Builds the real TFT_eSPI with the host framebuffer driver (Processors/TFT_eSPI_Host.h),
+// draws a set of scenes and compares a hash of each frame with sim/gfx/golden.txt.
+// Also checks readRect() and pushSprite() against the panel model, smooth text through
+// the glyph cache, smooth font glyph lookup against a linear search, the display list
+// and the strip renderer against drawing directly, the address window cache against
+// sending every window, text from glyph atlases against the fonts and the sprite span
+// kernels against their scalar versions, and reports the bus traffic and CPU time of
+// every scene.
+//
+//   .pio/build/native_gfx/program                    check against the golden hashes
+//   .pio/build/native_gfx/program --update           rewrite the golden hashes
+//   .pio/build/native_gfx/program --dump /tmp/gfx    also save every frame as a PPM
+//   .pio/build/native_gfx/program --bench [OP]       run the rendering micro-benchmarks
+//                                                    (RenderBench.h), JSON lines on stdout
+//   .pio/build/native_gfx/program --bench-ms 100     run each measurement for longer
+//
+// A scene that no longer matches is saved as <scene>.ppm in the dump directory (the
+// current directory by default) so the change can be looked at.
+#if !defined(ARDUINO)
+
+#include <TFT_eSPI.h>
+#include "RenderBench.h"
+#include "SpanCheck.h"
+#include "../../lib/TFT_eSPI-master/examples/Smooth Fonts/FLASH_Array/Font_Demo_1_Array/NotoSansBold15.h"
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+#define GFX_GOLDEN_PATH     "sim/gfx/golden.txt"
+#define GFX_MAX_SCENES      16
+#define GFX_NAME_LEN        24
+
+typedef struct {
+    const char *goldenPath;
+    const char *dumpDir;
+    bool update;
+    bool bench;
+    const char *benchFilter;    // Only ops containing this, all when NULL
+    uint32_t benchMs;
+} GfxOptions_t;
+
+typedef struct {
+    const char *name;
+    uint8_t rotation;
+    void (*draw)(TFT_eSPI *tft);
+    bool usesSprites;           // Cannot itself be drawn into a sprite
+} Scene_t;
+
+typedef struct {
+    char name[GFX_NAME_LEN];
+    uint32_t hash;
+} Golden_t;
+
+static TFT_eSPI tft;
+
+// ===================== SCENES =====================
+static void drawPrimitives(TFT_eSPI *t) {
+    t->fillScreen(TFT_NAVY);
+    t->fillRect(8, 8, 60, 40, TFT_RED);
+    t->drawRect(76, 8, 60, 40, TFT_YELLOW);
+    t->fillRoundRect(144, 8, 60, 40, 8, TFT_GREEN);
+    t->drawRoundRect(212, 8, 60, 40, 12, TFT_CYAN);
+    t->drawLine(0, 60, 319, 169, TFT_WHITE);
+    t->drawLine(319, 60, 0, 169, TFT_ORANGE);
+    t->drawCircle(60, 110, 40, TFT_MAGENTA);
+    t->fillCircle(160, 110, 30, TFT_PINK);
+    t->fillTriangle(230, 70, 300, 150, 200, 160, TFT_OLIVE);
+    t->drawTriangle(230, 70, 300, 150, 200, 160, TFT_WHITE);
+    for (int x = 0; x < 320; x += 4) t->drawFastVLine(x, 164, 6, x & 8 ? TFT_WHITE : TFT_BLACK);
+    for (int y = 52; y < 58; y++) t->drawFastHLine(0, y, 320, t->color565(y * 40, 255 - y * 4, 128));
+    for (int i = 0; i < 64; i++) t->drawPixel(280 + (i & 7) * 4, 60 + (i >> 3) * 4, i * 1024 + i);
+}
+
+static void drawText(TFT_eSPI *t) {
+    t->fillScreen(TFT_BLACK);
+    t->setTextColor(TFT_WHITE, TFT_BLACK);
+    t->setTextFont(1);
+    t->setTextSize(1);
+    t->setCursor(0, 0);
+    t->print("GLCD font 1 size 1 !\"#$%&'()*+,-./0123456789");
+    t->setTextSize(2);
+    t->setCursor(0, 10);
+    t->printf("Left :%4d cm", 123);
+    t->setTextSize(1);
+    t->setTextColor(TFT_YELLOW, TFT_DARKGREY);
+    t->drawString("Font 2 mixed Case", 0, 28, 2);
+    t->setTextColor(TFT_GREEN);
+    t->drawString("Font 4 Text", 0, 46, 4);
+    t->setTextColor(TFT_CYAN, TFT_BLACK);
+    t->drawString("12:34", 160, 46, 6);
+    t->setTextColor(TFT_RED, TFT_BLACK);
+    t->drawString("5.67", 0, 76, 7);
+    t->setTextDatum(BR_DATUM);
+    t->setTextColor(TFT_ORANGE);
+    t->drawString("89", 319, 169, 8);
+    t->setTextDatum(TL_DATUM);
+    t->setFreeFont(&FreeSans9pt7b);
+    t->setTextColor(TFT_WHITE);
+    t->drawString("FreeSans 9pt", 0, 130);
+    t->setTextFont(1);
+}
+
+static void drawSmooth(TFT_eSPI *t) {
+    t->fillScreen(TFT_DARKGREY);
+    t->fillSmoothCircle(50, 50, 40, TFT_RED, TFT_DARKGREY);
+    t->drawSmoothArc(150, 85, 70, 55, 40, 320, TFT_GREEN, TFT_DARKGREY, true);
+    t->drawSmoothArc(150, 85, 50, 40, 0, 230, TFT_YELLOW, TFT_DARKGREY);
+    t->drawSmoothRoundRect(230, 10, 20, 14, 80, 70, TFT_CYAN, TFT_DARKGREY);
+    t->fillSmoothRoundRect(235, 95, 75, 65, 12, TFT_MAGENTA, TFT_DARKGREY);
+    t->drawWideLine(10, 160, 120, 100, 5, TFT_WHITE, TFT_DARKGREY);
+    t->drawSpot(20, 130, 6, TFT_ORANGE, TFT_DARKGREY);
+}
+
+// Glyph cache budget given to the sprites drawSmoothText() makes, see checkGlyphCache()
+static uint32_t spriteGlyphCache = 0;
+
+static void drawSmoothTextOn(TFT_eSPI *t, int y) {
+    t->setTextColor(TFT_WHITE, TFT_NAVY, true);
+    t->drawString("Left 123 cm", 2, y);
+    t->setTextColor(TFT_YELLOW, TFT_NAVY, true);
+    t->drawString("Right 45 cm", 120, y);
+    t->setTextColor(TFT_GREEN);
+    t->drawString("Speed 0.87 m/s", 2, y + 20);
+}
+
+// Anti-aliased text, opaque and transparent, on the panel and in sprites. Loads the font
+// unless it already is, so the glyph cache check can keep it loaded between frames
+static void drawSmoothText(TFT_eSPI *t) {
+    t->fillScreen(TFT_NAVY);
+    bool loaded = t->fontLoaded;
+    if (!loaded) t->loadFont(NotoSansBold15);
+    drawSmoothTextOn(t, 4);
+    t->setTextColor(TFT_ORANGE, TFT_NAVY, true);
+    t->drawString("0123456789", 230, 4);
+    t->drawString("0123456789", 232, 24);   // Overlapping background left of each glyph
+    if (!loaded) t->unloadFont();
+
+    for (int depth = 16; depth >= 8; depth -= 8) {
+        TFT_eSprite s(t);
+        s.setColorDepth(depth);
+        s.createSprite(240, 44);
+        s.fillSprite(TFT_NAVY);
+        s.setGlyphCache(spriteGlyphCache);
+        s.loadFont(NotoSansBold15);
+        drawSmoothTextOn(&s, 2);
+        s.pushSprite(0, depth == 16 ? 60 : 110);
+        s.unloadFont();
+        s.deleteSprite();
+    }
+}
+
+// HUD style gauges and a sweep of anti-aliased shapes over every radius up to 48 at
+// odd angles, some clipped by the screen edges and a viewport
+static void drawGauges(TFT_eSPI *t) {
+    t->fillScreen(TFT_BLACK);
+    t->drawSmoothArc(60, 60, 56, 46, 0, 360, TFT_DARKGREY, TFT_BLACK);
+    t->drawSmoothArc(60, 60, 56, 46, 30, 250, TFT_GREEN, TFT_BLACK, true);
+    t->drawSmoothArc(60, 60, 40, 37, 300, 60, TFT_RED, TFT_BLACK);  // Through 6 o'clock
+    t->fillSmoothCircle(60, 60, 8, TFT_WHITE, TFT_BLACK);
+    t->drawSmoothCircle(60, 60, 26, TFT_CYAN, TFT_BLACK);
+    t->drawArc(160, 60, 50, 30, 45, 315, TFT_ORANGE, TFT_BLACK, false);
+    t->drawSmoothArc(160, 60, 28, 0, 90, 200, TFT_YELLOW, TFT_BLACK);
+    t->drawSmoothRoundRect(214, 6, 16, 10, 100, 50, TFT_SKYBLUE, TFT_BLACK);
+    t->drawSmoothRoundRect(214, 62, 12, 9, 100, 50, TFT_PINK, TFT_BLACK, 0x5);
+    t->fillSmoothRoundRect(220, 120, 90, 44, 20, TFT_BLUE, TFT_BLACK);
+    t->fillSmoothCircle(250, 142, 14, TFT_YELLOW, 0x00FFFFFF);      // Blended with the screen
+    t->fillSmoothCircle(-10, 160, 30, TFT_MAGENTA, TFT_BLACK);      // Clipped by the edges
+    t->drawSmoothArc(320, 0, 40, 20, 0, 360, TFT_GREEN, TFT_BLACK);
+
+    t->setViewport(0, 120, 200, 50);
+    uint32_t seed = 1;
+    for (int r = 1; r <= 48; r++) {
+        seed = seed * 1103515245 + 12345;
+        int32_t x = (seed >> 8) % 220 - 10, y = (seed >> 16) % 70 - 10;
+        uint16_t color = (uint16_t)(seed >> 4);
+        switch (r % 4) {
+            case 0: t->fillSmoothCircle(x, y, r, color, TFT_BLACK); break;
+            case 1: t->drawSmoothArc(x, y, r, r * 2 / 3, (seed >> 3) % 361, (seed >> 12) % 361, color, TFT_BLACK, r & 2); break;
+            case 2: t->drawSmoothCircle(x, y, r, color, TFT_BLACK); break;
+            default: t->fillSmoothRoundRect(x, y, r * 2, r + 6, r / 2, color, TFT_BLACK); break;
+        }
+    }
+    t->resetViewport();
+}
+
+static void drawSprites(TFT_eSPI *t) {
+    t->fillScreen(TFT_BLACK);
+
+    TFT_eSprite s16(t);
+    s16.createSprite(100, 60);
+    s16.fillSprite(TFT_BLUE);
+    s16.fillCircle(50, 30, 25, TFT_YELLOW);
+    s16.drawString("16bpp", 4, 4, 2);
+    s16.pushSprite(4, 4);
+    s16.pushSprite(110, 4, TFT_BLUE);       // Transparent background
+    t->setPivot(260, 50);
+    s16.pushRotated(30);
+    s16.deleteSprite();
+
+    TFT_eSprite s8(t);
+    s8.setColorDepth(8);
+    s8.createSprite(80, 50);
+    s8.fillSprite(TFT_DARKGREEN);
+    s8.fillTriangle(0, 49, 40, 0, 79, 49, TFT_ORANGE);
+    s8.pushSprite(4, 110);
+    s8.deleteSprite();
+
+    TFT_eSprite s4(t);
+    s4.setColorDepth(4);
+    s4.createSprite(64, 48);
+    s4.createPalette(default_4bit_palette);
+    for (int i = 0; i < 16; i++) s4.fillRect((i & 3) * 16, (i >> 2) * 12, 16, 12, i);
+    s4.pushSprite(100, 110);
+    s4.deleteSprite();
+
+    TFT_eSprite s1(t);
+    s1.setColorDepth(1);
+    s1.createSprite(100, 40);
+    s1.setBitmapColor(TFT_WHITE, TFT_MAROON);
+    s1.fillSprite(0);
+    s1.drawString("1 bit", 10, 10, 4);
+    s1.pushSprite(180, 120);
+    s1.deleteSprite();
+}
+
+// Sprite to sprite composites through the span kernels, clipped at the edges
+static void drawComposite(TFT_eSPI *t) {
+    t->fillScreen(TFT_BLACK);
+
+    TFT_eSprite back(t);
+    back.createSprite(t->width(), 120);
+    for (int y = 0; y < 120; y++) back.drawFastHLine(0, y, back.width(), t->color565(0, y * 2, 255 - y * 2));
+    uint16_t stripes[33 * 9];
+    for (int i = 0; i < 33 * 9; i++) stripes[i] = (i % 33) & 4 ? TFT_ORANGE : TFT_PURPLE;
+    back.setSwapBytes(true);
+    back.pushImage(201, 3, 33, 9, stripes);
+    back.setSwapBytes(false);
+
+    TFT_eSprite icon(t);
+    icon.createSprite(41, 31);
+    icon.fillSprite(TFT_MAGENTA);
+    icon.fillCircle(20, 15, 14, TFT_YELLOW);
+    icon.fillRect(8, 12, 25, 7, TFT_RED);
+    for (int i = 0; i < 4; i++) icon.pushToSprite(&back, -10 + i * 53, 5 + i * 3, TFT_MAGENTA);
+    icon.pushToSprite(&back, back.width() - 20, 100, TFT_MAGENTA);
+    for (int i = 0; i < 4; i++) icon.blendToSprite(&back, 15 + i * 61, 60 + i, 48 + i * 64);
+    icon.blendToSprite(&back, -7, 95, 128);
+    back.pushSprite(0, 10);
+    icon.deleteSprite();
+    back.deleteSprite();
+}
+
+// Sprites of every colour depth rotated onto the panel and into sprites, some transparent
+// and clipped by the edges or a viewport
+static void drawRotated(TFT_eSPI *t) {
+    t->fillScreen(TFT_NAVY);
+
+    TFT_eSprite src[4] = {TFT_eSprite(t), TFT_eSprite(t), TFT_eSprite(t), TFT_eSprite(t)};
+    const uint8_t depth[4] = {16, 8, 4, 1};
+    for (int i = 0; i < 4; i++) {
+        TFT_eSprite *s = &src[i];
+        s->setColorDepth(depth[i]);
+        s->createSprite(32 + i * 3, 20 - i);
+        if (depth[i] == 4) s->createPalette(default_4bit_palette);
+        if (depth[i] == 1) s->setBitmapColor(TFT_WHITE, TFT_MAROON);
+        uint16_t bg = depth[i] == 4 ? 0 : depth[i] == 1 ? 0 : TFT_BLACK;
+        uint16_t fg = depth[i] == 4 ? 14 : depth[i] == 1 ? 1 : TFT_YELLOW;
+        s->fillSprite(bg);
+        s->fillRect(0, 0, 8, 8, fg);
+        s->fillTriangle(4, s->height() - 2, s->width() / 2, 2, s->width() - 1, s->height() - 4, depth[i] == 4 ? 9 : fg);
+        s->drawRect(0, 0, s->width(), s->height(), depth[i] == 4 ? 12 : depth[i] == 1 ? 1 : TFT_RED);
+        s->setPivot(s->width() / 4, s->height() / 2);
+    }
+
+    const int16_t angles[] = {0, 30, 90, 135, 200, 333};
+    for (int i = 0; i < 4; i++) {
+        for (int a = 0; a < 6; a++) {
+            t->setPivot(26 + a * 46, 20 + i * 30);
+            src[i].pushRotated(angles[a], (a & 1) ? (i == 2 ? 0 : i == 3 ? TFT_MAROON : TFT_BLACK) : 0x00FFFFFF);
+        }
+    }
+
+    t->setPivot(-4, 150);                       // Clipped by the edges
+    src[0].pushRotated(70);
+    t->setPivot(318, 166);
+    src[1].pushRotated(250, TFT_BLACK);
+    t->setViewport(100, 150, 120, 14);          // And by a viewport, the pivot is not moved
+    t->setPivot(150, 158);
+    src[0].pushRotated(10);
+    t->setPivot(210, 154);
+    src[2].pushRotated(300, 0);
+    t->resetViewport();
+
+    TFT_eSprite dst(t);
+    for (int d = 0; d < 2; d++) {
+        dst.setColorDepth(d ? 8 : 16);
+        dst.createSprite(60, 40);
+        dst.fillSprite(TFT_DARKGREEN);
+        dst.setPivot(20 + d * 10, 18);
+        src[0].pushRotated(&dst, 45 + d * 100, TFT_BLACK);
+        dst.setPivot(58, 38);
+        src[1].pushRotated(&dst, 190 + d * 40);
+        dst.pushSprite(130 + d * 64, 150 - 40);
+        dst.deleteSprite();
+    }
+    for (int i = 0; i < 4; i++) src[i].deleteSprite();
+}
+
+// Needles and a dial face rotated and scaled, nearest pixel and filtered, onto the panel
+// and into a sprite
+static void drawTransformed(TFT_eSPI *t) {
+    t->fillScreen(TFT_DARKGREY);
+
+    TFT_eSprite needle(t);
+    needle.createSprite(40, 9);
+    needle.fillSprite(TFT_BLACK);
+    needle.fillTriangle(0, 4, 30, 0, 30, 8, TFT_RED);
+    needle.fillRect(30, 2, 10, 5, TFT_WHITE);
+    needle.setPivot(35, 4);
+
+    TFT_eSprite face(t);
+    face.setColorDepth(8);
+    face.createSprite(32, 32);
+    face.fillSprite(TFT_NAVY);
+    face.drawCircle(16, 16, 14, TFT_WHITE);
+    face.setTextFont(1);
+    face.setTextColor(TFT_YELLOW);
+    face.drawString("12", 11, 4);
+    face.setPivot(16, 16);
+
+    const float scales[] = {0.5f, 1.0f, 1.6f, 2.2f};
+    for (int i = 0; i < 4; i++) {
+        t->setPivot(24 + i * 62, 44);
+        face.pushTransformed(i * 20, scales[i], 0x00FFFFFF, i & 1);
+        needle.pushTransformed(i * 37 + 10, scales[i], TFT_BLACK, false);
+        t->setPivot(24 + i * 62, 130);
+        needle.pushTransformed(i * 37 + 10, scales[i], TFT_BLACK, true);
+    }
+    t->setPivot(300, 160);                      // Clipped by the edges
+    face.pushTransformed(45, 2.5f, 0x00FFFFFF, true);
+
+    TFT_eSprite dst(t);
+    dst.createSprite(60, 40);
+    dst.fillSprite(TFT_DARKGREEN);
+    dst.setPivot(30, 20);
+    needle.pushTransformed(&dst, 200, 1.3f, TFT_BLACK, true);
+    face.pushTransformed(&dst, -30, 0.8f, TFT_NAVY);
+    dst.pushSprite(250, 4);
+    dst.deleteSprite();
+    face.deleteSprite();
+    needle.deleteSprite();
+}
+
+// The elements of a robot HUD over a plain background: labels in every font, opaque and
+// transparent, bars, sensor tiles, a gauge and a trace, some clipped by a viewport
+static void drawHudElements(TFT_eSPI *t) {
+    static const char *names[] = {"Left", "Right", "Avg", "Line"};
+    static const int values[] = {123, 45, 84, 197};
+
+    t->fillRect(0, 0, 320, 22, TFT_NAVY);
+    t->setTextFont(1);
+    t->setTextSize(2);
+    t->setTextColor(TFT_WHITE, TFT_NAVY);
+    t->setCursor(4, 4);
+    t->printf("State: %8s", "SEARCH");
+    t->setTextSize(1);
+    t->setTextColor(TFT_BLACK, TFT_DARKGREEN);
+    for (int i = 0; i < 4; i++) {
+        int y = 28 + i * 18;
+        t->setCursor(4, y + 2);
+        t->printf("%-5s %4d cm", names[i], values[i]);
+        t->drawRect(96, y, 102, 12, TFT_WHITE);
+        t->fillRect(97, y + 1, values[i] / 2, 10, values[i] > 100 ? TFT_YELLOW : TFT_ORANGE);
+        for (int x = 107; x < 197; x += 10) t->drawFastVLine(x, y + 1, 3, TFT_BLACK);
+    }
+
+    t->setTextColor(TFT_WHITE);
+    for (int i = 0; i < 4; i++) {
+        int x = 208 + (i & 1) * 56, y = 28 + (i >> 1) * 36;
+        t->fillRoundRect(x, y, 50, 30, 6, i == 1 ? TFT_RED : TFT_DARKGREY);
+        t->drawString(i & 1 ? (i & 2 ? "RR" : "FR") : (i & 2 ? "RL" : "FL"), x + 17, y + 7, 2);
+    }
+
+    t->setTextColor(TFT_CYAN, TFT_BLACK);
+    t->drawString("987 Hz", 4, 98, 4);
+    t->setTextColor(TFT_YELLOW);
+    t->drawString("p99 412", 110, 98, 4);
+    t->setTextColor(TFT_GREEN, TFT_DARKGREEN);
+    t->drawString("-0.87", 4, 124, 7);                              // Clipped by the bottom edge
+
+    t->drawSmoothArc(272, 128, 30, 22, 60, 300, TFT_DARKGREY, TFT_DARKGREEN);
+    t->drawSmoothArc(272, 128, 30, 22, 60, 210, TFT_ORANGE, TFT_DARKGREEN, true);
+    t->fillSmoothCircle(272, 128, 6, TFT_WHITE, 0x00FFFFFF);        // Blended with what is below
+    t->setTextColor(TFT_WHITE, TFT_DARKGREEN);
+    t->drawString("m/s", 262, 150, 2);
+
+    t->setViewport(152, 130, 86, 38);
+    t->drawRect(0, 0, 86, 38, TFT_LIGHTGREY);
+    int32_t py = 18;
+    for (int x = 0; x < 96; x += 6) {
+        int32_t y = 18 + (int32_t)(14 * sin(x * 0.11));
+        t->drawLine(x - 6, py, x, y, TFT_WHITE);
+        t->drawPixel(x, 34 - (x * 7) % 32, TFT_RED);
+        py = y;
+    }
+    t->loadFont(NotoSansBold15);
+    t->setTextColor(TFT_MAGENTA);
+    t->drawString("trace", 40, 8);                                  // Anti-aliased over the trace
+    t->unloadFont();
+    t->resetViewport();
+    t->setTextFont(1);
+}
+
+static void drawHud(TFT_eSPI *t) {
+    t->fillScreen(TFT_DARKGREEN);
+    drawHudElements(t);
+}
+
+// Arena of the display list the HUD is recorded into, see checkDisplayList()
+static uint32_t hudListBytes = 16384;
+static display_list_stats_t hudListStats;
+
+// The same HUD recorded into a display list and pushed in one transaction
+static void drawHudList(TFT_eSPI *t) {
+    t->fillScreen(TFT_DARKGREEN);
+    TFT_eDisplayList list(t);
+    if (!list.createList(hudListBytes)) return;
+    drawHudElements(&list);
+    list.pushList();
+    list.getListStats(&hudListStats);
+}
+
+// Rows of the strip the HUD is drawn through, see checkStrip()
+static uint16_t hudStripRows = STRIP_ROWS;
+
+static void drawHudScene(TFT_eSPI *t, void *data) {
+    (void)data;
+    drawHud(t);
+}
+
+// The same HUD drawn a band at a time through a strip of a few rows
+static void drawHudStrip(TFT_eSPI *t) {
+    TFT_eStrip strip(t);
+    if (!strip.createStrip(hudStripRows)) return;
+    strip.pushFrame(drawHudScene, nullptr);
+}
+
+// The same arrow and label in every orientation, the frame shows it upright each time
+static void drawOriented(TFT_eSPI *t) {
+    t->fillScreen(TFT_BLACK);
+    t->drawRect(0, 0, t->width(), t->height(), TFT_WHITE);
+    t->fillTriangle(10, 10, 40, 10, 10, 40, TFT_RED);
+    t->setTextColor(TFT_WHITE, TFT_BLACK);
+    t->setTextFont(2);
+    t->setCursor(14, 44);
+    t->printf("rotation %d %dx%d", t->getRotation(), (int)t->width(), (int)t->height());
+    t->setTextFont(1);
+}
+
+static const Scene_t scenes[] = {
+    {"primitives",  3, drawPrimitives,  false},
+    {"text",        3, drawText,        false},
+    {"smooth",      3, drawSmooth,      false},
+    {"sprites",     3, drawSprites,     true},
+    {"composite",   3, drawComposite,   true},
+    {"smoothtext",  3, drawSmoothText,  true},
+    {"gauges",      3, drawGauges,      false},
+    {"rotated",     3, drawRotated,     true},
+    {"transformed", 3, drawTransformed, true},
+    {"hud",         3, drawHud,         false},
+    {"hudlist",     3, drawHudList,     true},
+    {"hudstrip",    3, drawHudStrip,    true},
+    {"rotation0",   0, drawOriented,    false},
+    {"rotation1",   1, drawOriented,    false},
+    {"rotation2",   2, drawOriented,    false},
+    {"rotation3",   3, drawOriented,    false},
+};
+static const int numScenes = sizeof(scenes) / sizeof(scenes[0]);
+
+// ===================== CHECKS =====================
+// readRect() of the whole screen must return what the panel model shows
+static int checkReadRect(void) {
+    int32_t w = tft.width(), h = tft.height();
+    static uint16_t shown[TFT_WIDTH * TFT_HEIGHT], read[TFT_WIDTH * TFT_HEIGHT];
+    hostPanel.readView(shown);
+    tft.readRect(0, 0, w, h, read);
+
+    int errors = 0;
+    for (int32_t i = 0; i < w * h; i++) {
+        if ((uint16_t)(read[i] >> 8 | read[i] << 8) != shown[i]) errors++;
+    }
+    for (int n = 0; n < 16; n++) {
+        int32_t x = (n * 37) % w, y = (n * 53) % h;
+        if (tft.readPixel(x, y) != shown[y * w + x]) errors++;
+    }
+    return errors;
+}
+
+// A full screen sprite of the scene pushed to the panel must arrive unchanged
+static int checkPushSprite(const Scene_t *scene) {
+    if (scene->usesSprites) return 0;
+    TFT_eSprite frame(&tft);
+    if (!frame.createSprite(tft.width(), tft.height())) return 1;
+    scene->draw(&frame);
+    frame.pushSprite(0, 0);
+
+    int errors = 0;
+    for (int32_t y = 0; y < frame.height(); y++) {
+        for (int32_t x = 0; x < frame.width(); x++) {
+            if (frame.readPixel(x, y) != hostPanel.viewPixel(x, y)) errors++;
+        }
+    }
+    frame.deleteSprite();
+    return errors;
+}
+
+// ===================== GOLDEN FILE =====================
+static int loadGolden(const char *path, Golden_t *golden) {
+    FILE *f = fopen(path, "r");
+    if (!f) return 0;
+    int n = 0;
+    char line[80];
+    while (n < GFX_MAX_SCENES && fgets(line, sizeof(line), f)) {
+        unsigned hash;
+        if (line[0] == '#' || sscanf(line, "%23s %x", golden[n].name, &hash) != 2) continue;
+        golden[n++].hash = hash;
+    }
+    fclose(f);
+    return n;
+}
+
+static bool saveGolden(const char *path, const uint32_t *hashes) {
+    FILE *f = fopen(path, "w");
+    if (!f) return false;
+    fprintf(f, "# FNV-1a hash of each sim/gfx scene, regenerate with --update after checking the images\n");
+    for (int i = 0; i < numScenes; i++) fprintf(f, "%-12s %08x\n", scenes[i].name, hashes[i]);
+    return fclose(f) == 0;
+}
+
+static const Golden_t *findGolden(const Golden_t *golden, int n, const char *name) {
+    for (int i = 0; i < n; i++) {
+        if (!strcmp(golden[i].name, name)) return &golden[i];
+    }
+    return NULL;
+}
+
+static bool saveFrame(const char *dir, const char *name) {
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s.ppm", dir, name);
+    if (hostPanel.savePPM(path)) return true;
+    perror(path);
+    return false;
+}
+
+static void parseArgs(int argc, char **argv, GfxOptions_t *opts) {
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--golden") && hasValue) opts->goldenPath = argv[++i];
+        else if (!strcmp(argv[i], "--dump") && hasValue) opts->dumpDir = argv[++i];
+        else if (!strcmp(argv[i], "--update")) opts->update = true;
+        else if (!strcmp(argv[i], "--bench")) {
+            opts->bench = true;
+            if (hasValue && argv[i + 1][0] != '-') opts->benchFilter = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--bench-ms") && hasValue) opts->benchMs = (uint32_t)atoi(argv[++i]);
+        else {
+            fprintf(stderr, "usage: %s [--golden PATH] [--dump DIR] [--update] [--bench [OP]] [--bench-ms N]\n", argv[0]);
+            exit(2);
+        }
+    }
+}
+
+// Smooth text must look the same drawn through the glyph cache, however small, and with
+// room for every glyph the second frame must not read the font at all
+static int checkGlyphCache(void) {
+    static const uint32_t budgets[] = {65536, 1024};
+    int errors = 0;
+
+    tft.setRotation(3);
+    drawSmoothText(&tft);
+    uint32_t expected = hostPanel.viewHash();
+
+    for (size_t b = 0; b < sizeof(budgets) / sizeof(budgets[0]); b++) {
+        tft.setGlyphCache(budgets[b]);
+        spriteGlyphCache = budgets[b];
+        tft.loadFont(NotoSansBold15);
+        drawSmoothText(&tft);
+        uint32_t first = hostPanel.viewHash();
+        tft.clearGlyphCacheStats();
+        drawSmoothText(&tft);
+        uint32_t second = hostPanel.viewHash();
+
+        glyph_cache_stats_t stats;
+        tft.getGlyphCacheStats(&stats);
+        bool roomy = b == 0;
+        if (first != expected || second != expected) {
+            printf("glyph cache %u bytes: frames %08x %08x, expected %08x\n", budgets[b], first, second, expected);
+            errors++;
+        }
+        if (roomy ? (stats.misses != 0 || stats.hits == 0) : stats.evictions == 0) {
+            printf("glyph cache %u bytes: %u hits %u misses %u evictions\n", budgets[b],
+                stats.hits, stats.misses, stats.evictions);
+            errors++;
+        }
+        tft.unloadFont();
+    }
+    tft.setGlyphCache(0);
+    spriteGlyphCache = 0;
+    return errors;
+}
+
+// getUnicodeIndex() must find the glyph the old linear search did for every code: in
+// a font listed in code order, and in one out of order with a code listed twice
+static int checkGlyphIndex(void) {
+    static const uint16_t codes[] = {0x41, 0x20, 0x7E, 0x4E00, 0x41, 0x21, 0xFFFF, 0x00A0, 0x30};
+    const uint16_t count = sizeof(codes) / sizeof(codes[0]);
+    uint8_t unordered[24 + count * 29];
+    uint8_t *p = unordered;
+    auto put = [&p](uint32_t v) { p[0] = v >> 24; p[1] = v >> 16; p[2] = v >> 8; p[3] = v; p += 4; };
+    put(count); put(11); put(15); put(0); put(12); put(3);
+    for (uint16_t g = 0; g < count; g++) { put(codes[g]); put(1); put(1); put(8); put(10); put(0); put(0); }
+    memset(p, 0xFF, count);
+
+    const uint8_t *fonts[] = {NotoSansBold15, unordered};
+    int errors = 0;
+    for (int f = 0; f < 2; f++) {
+        tft.loadFont(fonts[f]);
+        for (uint32_t code = 0; code <= 0xFFFF; code++) {
+            int32_t expected = -1;
+            for (uint16_t g = 0; g < tft.gFont.gCount && expected < 0; g++) {
+                if (tft.gUnicode[g] == code) expected = g;
+            }
+            uint16_t index = 0;
+            int32_t found = tft.getUnicodeIndex(code, &index) ? index : -1;
+            if (found != expected && errors++ < 8) {
+                printf("glyph index font %d code %04x: found %d, expected %d\n", f, code, found, expected);
+            }
+        }
+        tft.unloadFont();
+    }
+    return errors;
+}
+
+// The HUD recorded into a display list must look the same as drawn directly, also when
+// the list is too small for the frame and is pushed in parts, and so must images. Prints
+// the bus bytes spent on windows and on pixels each way
+static int checkDisplayList(void) {
+    static const uint32_t arenas[] = {16384, 1024};
+    int errors = 0;
+
+    tft.setRotation(3);
+    host_bus_stats_t direct, listed;
+    hostPanel.clearStats();
+    drawHud(&tft);
+    hostPanel.getStats(&direct);
+    uint32_t expected = hostPanel.viewHash();
+
+    for (size_t a = 0; a < sizeof(arenas) / sizeof(arenas[0]); a++) {
+        hudListBytes = arenas[a];
+        hostPanel.clearStats();
+        drawHudList(&tft);
+        hostPanel.getStats(&listed);
+        uint32_t hash = hostPanel.viewHash();
+        bool flushed = hudListStats.flushes > 0;
+        if (hash != expected || flushed != (a > 0)) {
+            printf("display list %u bytes: frame %08x, expected %08x, %u flushes\n", arenas[a], hash, expected,
+                hudListStats.flushes);
+            errors++;
+        }
+        printf("display list %5u bytes: %u commands, %u windows %u cmd+par B %u pixel B, directly %u windows %u cmd+par B %u pixel B\n",
+            arenas[a], hudListStats.commands, listed.windows, listed.commands + listed.paramBytes, listed.pixelBytes,
+            direct.windows, direct.commands + direct.paramBytes, direct.pixelBytes);
+    }
+    hudListBytes = arenas[0];
+
+    // Clipped by the edges and larger than the list
+    static uint16_t image[37 * 23];
+    for (int i = 0; i < 37 * 23; i++) image[i] = (uint16_t)(i * 0x0841 + (i % 37) * 0x20);
+    for (int swap = 0; swap < 2; swap++) {
+        tft.fillScreen(TFT_BLACK);
+        tft.setSwapBytes(swap);
+        tft.pushImage(-5, 150, 37, 23, image);
+        tft.pushImage(300, -4, 37, 23, (const uint16_t *)image);
+        tft.setSwapBytes(false);
+        expected = hostPanel.viewHash();
+
+        tft.fillScreen(TFT_BLACK);
+        TFT_eDisplayList list(&tft);
+        list.createList(1024);
+        list.setSwapBytes(swap);
+        list.pushImage(-5, 150, 37, 23, image);
+        list.pushImage(300, -4, 37, 23, (const uint16_t *)image);
+        list.pushList();
+        if (hostPanel.viewHash() != expected) {
+            printf("display list image swap %d: frame differs\n", swap);
+            errors++;
+        }
+    }
+    return errors;
+}
+
+// The HUD with a value that changes from frame to frame in the title bar
+static void drawHudRate(TFT_eSPI *t, void *data) {
+    drawHud(t);
+    t->setTextColor(TFT_WHITE, TFT_NAVY);
+    t->drawNumber(*(const int *)data, 262, 4, 2);
+}
+
+// Bands given to the strip's band callback, back in native byte order
+static uint16_t capturedFrame[320 * 170];
+static uint32_t capturedBands;
+
+static void captureBand(const uint16_t* pixels, int32_t y, int32_t width, int32_t rows, uint32_t hash, void* data) {
+    (void)hash;
+    (void)data;
+    for (int32_t i = 0; i < width * rows; i++) capturedFrame[y * width + i] = pixels[i] >> 8 | pixels[i] << 8;
+    capturedBands++;
+}
+
+// Bands of STRIP_ROWS rows, every other one changing colour with the frame number in data
+static uint16_t alternateBandColor(int32_t band, int frame) {
+    return (band & 1) ? (uint16_t)(0x1082 * band) : (uint16_t)(0xF800 + 0x0841 * (band + 3 * frame));
+}
+
+static void drawAlternateBands(TFT_eSPI *t, void *data) {
+    for (int32_t y = 0, band = 0; y < t->height(); y += STRIP_ROWS, band++)
+        t->fillRect(0, y, t->width(), STRIP_ROWS, alternateBandColor(band, *(const int *)data));
+}
+
+// With DMA the strip has two frames and each band is sent while the next is drawn. When
+// a band that has not changed is skipped, the next one must not be drawn into the frame
+// still being sent. The host holds every DMA transfer back until it is waited for
+static int checkStripDma(void) {
+    int errors = 0;
+    tft.initDMA();
+    TFT_eStrip strip(&tft);
+    if (!strip.createStrip()) errors++;
+    for (int frame = 0; frame < 3 && !errors; frame++) {
+        uint32_t sent = strip.pushFrame(drawAlternateBands, &frame, true);
+        uint32_t wrong = 0;
+        for (int32_t y = 0; y < tft.height(); y++)
+            for (int32_t x = 0; x < tft.width(); x++)
+                wrong += hostPanel.viewPixel(x, y) != alternateBandColor(y / STRIP_ROWS, frame);
+        if (wrong) {
+            printf("strip dma frame %d: %u pixels sent, %u pixels wrong\n", frame, sent, wrong);
+            errors++;
+        }
+    }
+    strip.deleteStrip();
+    tft.deInitDMA();
+    return errors;
+}
+
+// The HUD drawn through a strip must look the same for any strip height, and a strip sending
+// only changed bands must send none for the same frame and leave the panel showing the new
+// frame after a change. A frame captured through the band callback, sent or not, must be
+// what the panel shows. The reference is a strip of one band rather than the HUD drawn
+// directly, as transparent smooth text blends with the pixels under it in a Sprite but with
+// its background colour on the TFT. Prints the RAM and pixels each way
+static int checkStrip(void) {
+    static const uint16_t rows[] = {1, 7, STRIP_ROWS};
+    int errors = 0;
+
+    tft.setRotation(3);
+    hudStripRows = tft.height();
+    drawHudStrip(&tft);
+    uint32_t expected = hostPanel.viewHash();
+    for (size_t r = 0; r < sizeof(rows) / sizeof(rows[0]); r++) {
+        tft.fillScreen(TFT_BLACK);
+        hudStripRows = rows[r];
+        drawHudStrip(&tft);
+        if (hostPanel.viewHash() != expected) {
+            printf("strip %u rows: frame %08x, expected %08x\n", rows[r], hostPanel.viewHash(), expected);
+            errors++;
+        }
+    }
+    hudStripRows = STRIP_ROWS;
+
+    TFT_eStrip strip(&tft);
+    if (!strip.createStrip()) return errors + 1;
+    int rate = 987;
+    uint32_t first = strip.pushFrame(drawHudRate, &rate, true);
+    uint32_t same = strip.pushFrame(drawHudRate, &rate, true);
+    rate = 1003;
+    uint32_t changed = strip.pushFrame(drawHudRate, &rate, true);
+    uint32_t hash = hostPanel.viewHash();
+    strip.pushFrame(drawHudRate, &rate);
+    if (same != 0 || changed == 0 || changed >= first || hash != hostPanel.viewHash()) {
+        printf("strip changed bands: %u, %u and %u pixels sent, frame %08x, expected %08x\n", first, same, changed,
+            hash, hostPanel.viewHash());
+        errors++;
+    }
+
+    capturedBands = 0;
+    strip.setBandCallback(captureBand);
+    strip.pushFrame(drawHudRate, &rate, true);
+    strip.setBandCallback(nullptr);
+    uint32_t wrong = 0;
+    for (int32_t y = 0; y < tft.height(); y++)
+        for (int32_t x = 0; x < tft.width(); x++) wrong += capturedFrame[y * tft.width() + x] != hostPanel.viewPixel(x, y);
+    if (wrong || capturedBands != (uint32_t)(tft.height() + STRIP_ROWS - 1) / STRIP_ROWS) {
+        printf("strip capture: %u bands, %u pixels differ from the panel\n", capturedBands, wrong);
+        errors++;
+    }
+    printf("strip %u rows: %u B of RAM (two full screen sprites %u B), pixels sent %u first frame, %u same, %u changed\n",
+        STRIP_ROWS, (unsigned)(2 * tft.width() * STRIP_ROWS * 2), (unsigned)(2 * tft.width() * tft.height() * 2),
+        first, same, changed);
+    return errors + checkStripDma();
+}
+
+// Pixel by pixel, as a sketch copying an image or plotting a function without a sprite
+// does, then scattered pixels each in its own transaction
+static void drawPixels(TFT_eSPI *t) {
+    t->fillScreen(TFT_BLACK);
+    t->startWrite();
+    for (int32_t y = 0; y < 64; y++)
+        for (int32_t x = 0; x < 96; x++) t->drawPixel(8 + x, 8 + y, (uint16_t)(x * 0x0841 ^ y * 0x1003));
+    for (int32_t x = 0; x < 300; x++) t->drawPixel(10 + x, 120 + (int32_t)(30 * sin(x * 0.05)), TFT_YELLOW);
+    t->endWrite();
+    for (int32_t i = 0; i < 200; i++) t->drawPixel((i * 37) % 320, 80 + (i * 11) % 40, TFT_CYAN);
+}
+
+// Text and pixel heavy drawing with the window cache off and on must give the same frame,
+// with fewer address window bytes when on. Prints the bus bytes each way
+static int checkWindowCache(void) {
+    static const struct { const char *name; void (*draw)(TFT_eSPI *t); } loads[] = {
+        {"text", drawText}, {"smoothtext", drawSmoothText}, {"hud", drawHud}, {"pixels", drawPixels},
+    };
+    int errors = 0;
+
+    tft.setRotation(3);
+    for (size_t i = 0; i < sizeof(loads) / sizeof(loads[0]); i++) {
+        host_bus_stats_t bus[2];
+        uint32_t hash[2];
+        for (int on = 0; on < 2; on++) {
+            tft.setAttribute(WINDOW_CACHE, on);
+            loads[i].draw(&tft);
+            hostPanel.clearStats();
+            loads[i].draw(&tft);
+            hostPanel.getStats(&bus[on]);
+            hash[on] = hostPanel.viewHash();
+        }
+        uint32_t off = bus[0].commands + bus[0].paramBytes, on = bus[1].commands + bus[1].paramBytes;
+        printf("window cache %-10s %5u -> %5u windows, %6u -> %6u cmd+par B (%.0f%% fewer bus bytes)\n",
+            loads[i].name, bus[0].windows, bus[1].windows, off, on,
+            100.0 * (off - on) / (off + bus[0].pixelBytes));
+        if (hash[0] != hash[1] || on >= off) {
+            printf("window cache %s: frame %08x, %08x without the cache\n", loads[i].name, hash[1], hash[0]);
+            errors++;
+        }
+    }
+    tft.setAttribute(WINDOW_CACHE, true);
+    return errors;
+}
+
+// The TFT_Char_times example: every number 0 to 999 in the same place, 2890 characters
+static void drawCharTimes(TFT_eSPI *t, uint8_t font) {
+    t->fillScreen(TFT_BLACK);
+    t->setTextColor(TFT_WHITE, TFT_BLACK);
+    for (int i = 0; i < 1000; i++) t->drawNumber(i, 100, 80, font);
+}
+
+// Draws on t, directly or through a full screen sprite, and returns the frame hash and
+// the CPU time. fillScreen() covers the TFT's unrotated size in a sprite, so the sprite
+// is cleared first for nothing of the last frame to remain
+static uint32_t timeFrame(TFT_eSPI *t, TFT_eSprite *sprite, void (*draw)(TFT_eSPI *t, uint8_t font), uint8_t font,
+    double *us) {
+    if (sprite) sprite->fillSprite(TFT_BLACK);
+    auto start = std::chrono::steady_clock::now();
+    draw(sprite ? sprite : t, font);
+    *us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    if (sprite) sprite->pushSprite(0, 0);
+    return hostPanel.viewHash();
+}
+
+// The HUD for timeFrame(), it picks its own fonts
+static void drawHudFont(TFT_eSPI *t, uint8_t) {
+    drawHud(t);
+}
+
+// Text drawn from glyph atlases, of bits and of pixels, must look the same as decoded from
+// the fonts, on the panel and in a sprite, also when clipped. Prints the characters a second
+// of the TFT_Char_times example each way
+static int checkGlyphAtlas(void) {
+    static const uint8_t fonts[] = {1, 2, 4, 6, 7, 8};
+    static const char *modes[] = {"font", "atlas", "rgb565"};
+    int errors = 0;
+
+    tft.setRotation(1);
+    TFT_eSprite sprite(&tft);
+    if (!sprite.createSprite(tft.width(), tft.height())) return 1;
+
+    for (int onSprite = 0; onSprite < 2; onSprite++) {
+        TFT_eSPI *canvas = onSprite ? (TFT_eSPI *)&sprite : &tft;
+        for (size_t f = 0; f < sizeof(fonts) / sizeof(fonts[0]); f++) {
+            double us[3];
+            uint32_t hash[3];
+            glyph_atlas_stats_t stats[3];
+            for (int m = 0; m < 3; m++) {
+                // The large fonts only hold what numbers are drawn with
+                if (m && !canvas->createGlyphAtlas(fonts[f], 1, TFT_WHITE, TFT_BLACK, fonts[f] > 4, m == 2)) errors++;
+                canvas->clearGlyphAtlasStats();
+                hash[m] = timeFrame(&tft, onSprite ? &sprite : NULL, drawCharTimes, fonts[f], &us[m]);
+                canvas->getGlyphAtlasStats(&stats[m]);
+                canvas->deleteGlyphAtlas();
+                if (hash[m] != hash[0] || stats[m].hits != (m ? 2890u : 0u)) {
+                    printf("glyph atlas %s font %u %s: frame %08x, expected %08x, %u from the atlas\n",
+                        onSprite ? "sprite" : "panel", fonts[f], modes[m], hash[m], hash[0], stats[m].hits);
+                    errors++;
+                }
+            }
+            printf("glyph atlas %-6s font %u: %6.2f -> %6.2f M chars/s, %6.2f M rgb565 (%u B, %u B)\n",
+                onSprite ? "sprite" : "panel", fonts[f], 2890 / us[0], 2890 / us[1], 2890 / us[2],
+                stats[1].bytes, stats[2].bytes);
+        }
+    }
+
+    // The HUD with atlases for its opaque labels, the font 7 one clipped by the bottom edge
+    tft.setRotation(3);
+    for (int onSprite = 0; onSprite < 2; onSprite++) {
+        TFT_eSPI *canvas = onSprite ? (TFT_eSPI *)&sprite : &tft;
+        double us;
+        uint32_t expected = timeFrame(&tft, onSprite ? &sprite : NULL, drawHudFont, 0, &us);
+        canvas->createGlyphAtlas(1, 2, TFT_WHITE, TFT_NAVY);
+        canvas->createGlyphAtlas(1, 1, TFT_BLACK, TFT_DARKGREEN);
+        canvas->createGlyphAtlas(4, 1, TFT_CYAN, TFT_BLACK, true);
+        canvas->createGlyphAtlas(7, 1, TFT_GREEN, TFT_DARKGREEN, true, true);
+        canvas->clearGlyphAtlasStats();
+        uint32_t hash = timeFrame(&tft, onSprite ? &sprite : NULL, drawHudFont, 0, &us);
+        glyph_atlas_stats_t stats;
+        canvas->getGlyphAtlasStats(&stats);
+        canvas->deleteGlyphAtlas();
+        if (hash != expected || stats.atlases != 4 || stats.hits == 0) {
+            printf("glyph atlas %s hud: frame %08x, expected %08x, %u atlases %u from them\n",
+                onSprite ? "sprite" : "panel", hash, expected, stats.atlases, stats.hits);
+            errors++;
+        }
+    }
+    sprite.deleteSprite();
+    return errors;
+}
+
+int main(int argc, char **argv) {
+    GfxOptions_t opts = {GFX_GOLDEN_PATH, NULL, false, false, NULL, RENDER_BENCH_MIN_MS};
+    parseArgs(argc, argv, &opts);
+
+    if (opts.bench) {
+        hostPanel.reset();
+        tft.init();
+        return runRenderBench(&tft, &Serial, opts.benchMs, opts.benchFilter) > 0 ? 0 : 1;
+    }
+
+    Golden_t golden[GFX_MAX_SCENES];
+    int numGolden = loadGolden(opts.goldenPath, golden);
+    if (!numGolden && !opts.update) fprintf(stderr, "%s: no golden hashes, run with --update\n", opts.goldenPath);
+
+    hostPanel.reset();
+    tft.init();
+
+    uint32_t hashes[GFX_MAX_SCENES];
+    int mismatches = 0, errors = 0;
+    printf("%-12s %8s %6s %7s %7s %8s %9s %9s  %s\n",
+        "scene", "hash", "trans", "windows", "cmd+par", "pixel B", "cpu us", "bus us", "result");
+
+    for (int i = 0; i < numScenes; i++) {
+        const Scene_t *scene = &scenes[i];
+        tft.setRotation(scene->rotation);
+        hostPanel.clearStats();
+
+        auto start = std::chrono::steady_clock::now();
+        scene->draw(&tft);
+        double cpuUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+        host_bus_stats_t bus;
+        hostPanel.getStats(&bus);
+        uint64_t busNs = hostPanel.busNs();
+        hashes[i] = hostPanel.viewHash();
+
+        const Golden_t *expected = findGolden(golden, numGolden, scene->name);
+        bool match = expected && expected->hash == hashes[i];
+        if (!opts.update && !match) {
+            mismatches++;
+            saveFrame(opts.dumpDir ? opts.dumpDir : ".", scene->name);
+        } else if (opts.dumpDir) {
+            saveFrame(opts.dumpDir, scene->name);
+        }
+
+        int readErrors = checkReadRect();
+        int spriteErrors = checkPushSprite(scene);
+        errors += readErrors + spriteErrors;
+
+        printf("%-12s %08x %6u %7u %7u %8u %9.1f %9.1f  %s%s%s\n", scene->name, hashes[i],
+            bus.transactions, bus.windows, bus.commands + bus.paramBytes, bus.pixelBytes, cpuUs, busNs / 1000.0,
+            opts.update ? "updated" : match ? "ok" : expected ? "CHANGED" : "NEW",
+            readErrors ? " readRect errors" : "", spriteErrors ? " pushSprite errors" : "");
+    }
+
+    int glyphErrors = checkGlyphCache();
+    printf("glyph cache %s\n", glyphErrors ? "FAIL" : "ok");
+    errors += glyphErrors;
+
+    int indexErrors = checkGlyphIndex();
+    printf("glyph index %s\n", indexErrors ? "FAIL" : "ok");
+    errors += indexErrors;
+
+    int listErrors = checkDisplayList();
+    printf("display list %s\n", listErrors ? "FAIL" : "ok");
+    errors += listErrors;
+
+    int stripErrors = checkStrip();
+    printf("strip %s\n", stripErrors ? "FAIL" : "ok");
+    errors += stripErrors;
+
+    int cacheErrors = checkWindowCache();
+    printf("window cache %s\n", cacheErrors ? "FAIL" : "ok");
+    errors += cacheErrors;
+
+    int atlasErrors = checkGlyphAtlas();
+    printf("glyph atlas %s\n", atlasErrors ? "FAIL" : "ok");
+    errors += atlasErrors;
+
+    int spanErrors = checkSpanKernels(&tft, &Serial);
+    printf("span kernels %s\n", spanErrors ? "FAIL" : "ok");
+    errors += spanErrors;
+
+    if (opts.update && !saveGolden(opts.goldenPath, hashes)) {
+        perror(opts.goldenPath);
+        return 2;
+    }
+
+    bool ok = mismatches == 0 && errors == 0;
+    printf("%s\n", ok ? "ok" : "FAIL");
+    return ok ? 0 : 1;
+}
+
+#endif // !ARDUINO
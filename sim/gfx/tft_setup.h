@@ -0,0 +1,7 @@
+// TFT_eSPI setup for the host build, picked up by TFT_eSPI.h through __has_include.
+// The T-Display-S3 setup the firmware uses, drawn into the host framebuffer driver
+// (Processors/TFT_eSPI_Host.h) instead of the ESP32-S3 parallel bus.
+#include <User_Setups/Setup206_LilyGo_T_Display_S3.h>
+
+#define TFT_HOST_FRAMEBUFFER
+#define DISABLE_ALL_LIBRARY_WARNINGS
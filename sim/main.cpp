@@ -0,0 +1,222 @@
+// Host simulator entry point for [env:native].
+// Runs the unmodified setup()/loop() against the simulated arena for a number
+// of bouts and reports outcomes and control loop timing.
+//
+//   .pio/build/native/program --bouts 1000 --seed 7
+//   .pio/build/native/program --pid-bench
+//   .pio/build/native/program --line-bench
+//   .pio/build/native/program --edge-bench
+//   .pio/build/native/program --screenshot-bench
+//   .pio/build/native/program --telemetry /dev/pts/3     (see datalogger/telemetry.py, screenshot.py)
+#if !defined(ARDUINO)
+
+#include "Hal.h"
+#include "Sim.h"
+#include "Motor.h"
+#include "StateMachine.h"
+#include "Telemetry.h"
+#include "Display.h"
+#include "Screenshot.h"
+#include <chrono>
+#include <string.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#define SIM_LOOP_COST_NS    2000
+#define SIM_MAX_STATES      16
+#define SIM_TRACE_SHOWN     8
+
+void setup();
+void loop();
+// Demo_Comp.cpp
+size_t getStrategyTrace(StateTrace_t *out, size_t max);
+size_t getStrategyDwell(StateDwell_t *out, size_t max);
+const char *getStrategyStateName(uint8_t state);
+
+typedef struct {
+    unsigned long bouts;
+    bool verbose;
+    bool pidBench;
+    bool lineBench;
+    bool edgeBench;
+    bool displayBench;
+    bool screenshotBench;
+    const char *telemetryPath;
+} RunOptions_t;
+
+typedef struct {
+    unsigned long wins, losses, draws;
+    uint64_t loops;
+    uint64_t loopNsTotal;
+    uint64_t loopNsMax;
+    uint64_t boutMsTotal;
+    uint32_t controlMinUs, controlMaxUs, controlP99Us;
+    SimReactionStats_t reaction;
+    StateDwell_t dwell[SIM_MAX_STATES];
+    size_t numStates;
+} RunStats_t;
+
+static const char *resultName(BoutResult result) {
+    switch (result) {
+        case BOUT_WIN:  return "WIN";
+        case BOUT_LOSS: return "LOSS";
+        case BOUT_DRAW: return "DRAW";
+        default:        return "RUNNING";
+    }
+}
+
+static void parseArgs(int argc, char **argv, RunOptions_t *opts, SimConfig_t *config) {
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--bouts") && hasValue) opts->bouts = strtoul(argv[++i], NULL, 10);
+        else if (!strcmp(argv[i], "--seed") && hasValue) config->seed = strtoul(argv[++i], NULL, 10);
+        else if (!strcmp(argv[i], "--timeout-ms") && hasValue) config->boutTimeoutMs = strtoul(argv[++i], NULL, 10);
+        else if (!strcmp(argv[i], "--opponent-speed") && hasValue) config->opponentSpeedCmS = strtof(argv[++i], NULL);
+        else if (!strcmp(argv[i], "--telemetry") && hasValue) opts->telemetryPath = argv[++i];
+        else if (!strcmp(argv[i], "--verbose")) opts->verbose = true;
+        else if (!strcmp(argv[i], "--pid-bench")) opts->pidBench = true;
+        else if (!strcmp(argv[i], "--line-bench")) opts->lineBench = true;
+        else if (!strcmp(argv[i], "--edge-bench")) opts->edgeBench = true;
+        else if (!strcmp(argv[i], "--display-bench")) opts->displayBench = true;
+        else if (!strcmp(argv[i], "--screenshot-bench")) opts->screenshotBench = true;
+        else {
+            fprintf(stderr, "usage: %s [--bouts N] [--seed S] [--timeout-ms MS] [--opponent-speed CM_S] [--telemetry PATH] [--verbose] [--pid-bench] [--line-bench] [--edge-bench] [--display-bench] [--screenshot-bench]\n", argv[0]);
+            exit(2);
+        }
+    }
+}
+
+// Last few strategy transitions of the bout just run
+static void printTrace(void) {
+    StateTrace_t trace[SIM_TRACE_SHOWN];
+    size_t n = getStrategyTrace(trace, SIM_TRACE_SHOWN);
+    for (size_t i = 0; i < n; i++) {
+        printf("    %6u ms  %-8s -> %s\n", (unsigned)trace[i].atMs,
+            getStrategyStateName(trace[i].from), getStrategyStateName(trace[i].to));
+    }
+}
+
+static BoutResult runBout(const SimConfig_t *config, RunStats_t *stats) {
+    // The reset stops the writer task, setup() starts it again
+    stopTelemetry();
+    simReset(config);
+    setup();
+    simStartBout();
+
+    while (simBoutResult() == BOUT_RUNNING) {
+        uint64_t start = simNowNs();
+        loop();
+        // HAL calls charge their own cost, this stands in for the code between them
+        simAdvanceNs(SIM_LOOP_COST_NS);
+        uint64_t elapsed = simNowNs() - start;
+        stats->loops++;
+        stats->loopNsTotal += elapsed;
+        if (elapsed > stats->loopNsMax) stats->loopNsMax = elapsed;
+    }
+    stats->boutMsTotal += simBoutElapsedMs();
+
+    SimReactionStats_t reaction;
+    simReactionStats(&reaction);
+    stats->reaction.reactions += reaction.reactions;
+    stats->reaction.unanswered += reaction.unanswered;
+    stats->reaction.totalNs += reaction.totalNs;
+    stats->reaction.maxNs = max(stats->reaction.maxNs, reaction.maxNs);
+
+    StateDwell_t dwell[SIM_MAX_STATES];
+    stats->numStates = getStrategyDwell(dwell, SIM_MAX_STATES);
+    for (size_t i = 0; i < stats->numStates; i++) {
+        stats->dwell[i].name = dwell[i].name;
+        stats->dwell[i].entries += dwell[i].entries;
+        stats->dwell[i].dwellMs += dwell[i].dwellMs;
+    }
+
+    MotorTaskStats_t control;
+    getMotorTaskStats(&control);
+    if (control.periods > 0) {
+        stats->controlMinUs = min(stats->controlMinUs, control.minPeriodUs);
+        stats->controlMaxUs = max(stats->controlMaxUs, control.maxPeriodUs);
+        stats->controlP99Us = max(stats->controlP99Us, control.p99PeriodUs);
+    }
+    return simBoutResult();
+}
+
+int main(int argc, char **argv) {
+    RunOptions_t opts = {100, false, false, false, false, false, false, NULL};
+    SimConfig_t config;
+    simDefaultConfig(&config);
+    parseArgs(argc, argv, &opts, &config);
+    if (opts.pidBench) return simRunPidBench();
+    if (opts.lineBench) return simRunLineBench();
+    if (opts.edgeBench) return simRunEdgeBench();
+    if (opts.displayBench) return simRunDisplayBench();
+    if (opts.screenshotBench) return simRunScreenshotBench();
+
+    if (opts.telemetryPath) {
+        int fd = open(opts.telemetryPath, O_WRONLY | O_CREAT | O_TRUNC | O_NOCTTY, 0644);
+        if (fd < 0) {
+            perror(opts.telemetryPath);
+            return 2;
+        }
+        // A pty would otherwise turn 0x0A into 0x0D 0x0A
+        struct termios tio;
+        if (isatty(fd) && tcgetattr(fd, &tio) == 0) {
+            cfmakeraw(&tio);
+            tcsetattr(fd, TCSANOW, &tio);
+        }
+        simSetSerialOutput(fd);
+    }
+
+    RunStats_t stats = {};
+    stats.controlMinUs = UINT32_MAX;
+    uint32_t baseSeed = config.seed;
+    auto wallStart = std::chrono::steady_clock::now();
+
+    for (unsigned long bout = 0; bout < opts.bouts; bout++) {
+        config.seed = baseSeed + bout;
+        BoutResult result = runBout(&config, &stats);
+        if (result == BOUT_WIN) stats.wins++;
+        else if (result == BOUT_LOSS) stats.losses++;
+        else stats.draws++;
+        if (opts.verbose) {
+            printf("bout %4lu seed %6u: %-4s after %6lu ms\n", bout, config.seed, resultName(result), simBoutElapsedMs());
+            printTrace();
+        }
+    }
+
+    double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    double simS = stats.boutMsTotal / 1000.0;
+    double meanLoopUs = stats.loops ? stats.loopNsTotal / 1000.0 / stats.loops : 0.0;
+
+    printf("bouts      : %lu (win %lu, loss %lu, draw %lu)\n", opts.bouts, stats.wins, stats.losses, stats.draws);
+    printf("bout time  : %.2f s mean\n", opts.bouts ? simS / opts.bouts : 0.0);
+    printf("loop period: %.1f us mean, %.1f us max (%.1f Hz)\n",
+        meanLoopUs, stats.loopNsMax / 1000.0, meanLoopUs > 0.0 ? 1e6 / meanLoopUs : 0.0);
+    printf("control    : %u us min, %u us p99, %u us max period (worst bout)\n",
+        stats.controlMinUs == UINT32_MAX ? 0 : stats.controlMinUs, stats.controlP99Us, stats.controlMaxUs);
+    printf("edge react : %u crossings, %.2f ms mean, %.2f ms max to a motor command change (%u unanswered)\n",
+        stats.reaction.reactions,
+        stats.reaction.reactions ? stats.reaction.totalNs / 1e6 / stats.reaction.reactions : 0.0,
+        stats.reaction.maxNs / 1e6, stats.reaction.unanswered);
+    for (size_t i = 0; i < stats.numStates; i++) {
+        const StateDwell_t &d = stats.dwell[i];
+        printf("%-11s: %-8s %5.1f%% of bout time, %5.1f entries/bout, %5.0f ms mean visit\n",
+            i == 0 ? "states" : "", d.name, stats.boutMsTotal ? 100.0 * d.dwellMs / stats.boutMsTotal : 0.0,
+            opts.bouts ? (double)d.entries / opts.bouts : 0.0, d.entries ? (double)d.dwellMs / d.entries : 0.0);
+    }
+    TelemetryStats_t telemetry;
+    getTelemetryStats(&telemetry);
+    printf("telemetry  : %u records, %u bytes, %u dropped\n", telemetry.records, telemetry.bytes, telemetry.dropped);
+    DisplayStats_t display;
+    getDisplayStats(&display);
+    printf("display    : %u snapshots posted, %u frames rendered\n", display.posted, display.frames);
+    ScreenshotStats_t screenshots;
+    getScreenshotStats(&screenshots);
+    printf("screenshots: %u captures (%u key), %u bytes, %u skipped\n",
+        screenshots.captures, screenshots.keys, screenshots.bytes, screenshots.skipped);
+    printf("wall clock : %.2f s, %.0f bouts/min, %.0fx real time\n",
+        wallS, wallS > 0.0 ? opts.bouts * 60.0 / wallS : 0.0, wallS > 0.0 ? simS / wallS : 0.0);
+    return 0;
+}
+
+#endif // !ARDUINO
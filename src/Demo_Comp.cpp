@@ -1,6 +1,10 @@
+#include "Display.h"
 #include "Motor.h"
+#include "Screenshot.h"
 #include "Sensors.h"
 #include "Startup.h"
+#include "StateMachine.h"
+#include "Telemetry.h"
 
 TFT_eSPI tft = TFT_eSPI();
 Sensors_t sensor;
@@ -11,48 +15,30 @@ Motor_t motor;
 #define TRACK_OPPONENT_THRESHOLD 25
 #define LOST_REQUIRED            6
 #define EDGE_AVOID_TIME_MS       350
-#define STARTUP_ROTATE_DELAY_MS  200   // delay between rotation checks during startup
 
 int distanceBuf[BUF_SIZE] = {0};
 int bufIdx = 0;
 bool bufferFilled = false;
 
-enum RobotState { STARTUP_ROTATE, SEARCHING, CHASING, AVOID_EDGE };
-RobotState currentState = STARTUP_ROTATE;
-RobotState prevState = CHASING;
+enum RobotState : uint8_t { STARTUP_ROTATE, SEARCHING, CHASING, AVOID_EDGE, NUM_STATES };
+
+// Inputs gathered once per loop() for the guards
+typedef struct {
+  bool newPair;     // A fresh left/right sonar pair arrived this loop
+} StrategyInput_t;
 
 Direction lastSeenDirection = ROTATE_CCW;
-unsigned long lastPIUpdate = 0;
-unsigned long lastDisplayUpdate = 0;
-unsigned long edgeAvoidStart = 0;
+unsigned long lastPairSampleUs = 0;
 static int detectConfirmCount = 0;
 
-void setup() {
-  pinMode(LEFT_BUTTON, INPUT);
-  pinMode(RIGHT_BUTTON, INPUT);
-  pinMode(15,OUTPUT);
-  digitalWrite(15,HIGH);
-
-  initMotors();
-  initSensors();
-
-  tft.init();
-  tft.setRotation(3);
-  tft.fillScreen(TFT_BLACK);
-  userSelectFunction(&tft, &sensor, &motor);
-
-  tft.setTextSize(2);
-  tft.fillScreen(TFT_BLACK);
-  tft.setTextColor(TFT_WHITE, TFT_BLACK);
-
-  for (int i = 0; i < BUF_SIZE; ++i) distanceBuf[i] = 1000;
-  bufIdx = 0;
-  bufferFilled = false;
-  lastPIUpdate = millis();
-
-  currentState = STARTUP_ROTATE;
-  motor.direction = ROTATE_CW;
-  move(&motor);
+// Runs in the line sampling task: back off the edge before loop() even sees it,
+// the state machine then picks the recovery direction as usual.
+// Not static, the simulator's edge bench drives it too.
+void lineReflex(uint8_t mask) {
+  bool front = mask & LINE_FRONT, rear = mask & LINE_REAR;
+  if (front && rear) motorReflex(REVERSE, true);
+  else if (front) motorReflex(REVERSE, false);
+  else motorReflex(FORWARD, false);
 }
 
 static inline int normaliseDistanceForBuffer(int d) {
@@ -86,21 +72,6 @@ static bool detectOpponent() {
   return (detectConfirmCount >= 2);
 }
 
-static void updateMotorControl() {
-  static int encoderCountOldA = 0, encoderCountOldB = 0;
-  unsigned long now = millis();
-  unsigned long elapsedMs = now - lastPIUpdate;
-  if (elapsedMs < PI_UPDATE_INTERVAL_MS) return;
-  if (elapsedMs == 0) elapsedMs = 1;
-
-  float velA = 100.0f * (encoderCountA - encoderCountOldA) / (float)elapsedMs;
-  float velB = 100.0f * (encoderCountB - encoderCountOldB) / (float)elapsedMs;
-  updatePIController(&motor, velA, velB);
-  encoderCountOldA = encoderCountA;
-  encoderCountOldB = encoderCountB;
-  lastPIUpdate = now;
-}
-
 static void chaseMode() {
   bool haveBoth = (sensor.leftCm != OUT_OF_RANGE && sensor.rightCm != OUT_OF_RANGE);
   bool opponentLeft = haveBoth && (sensor.leftCm < sensor.rightCm - TRACK_OPPONENT_THRESHOLD);
@@ -120,112 +91,185 @@ static void chaseMode() {
 }
 
 static bool lineDetected() {
-  return (sensor.frontLeft || sensor.frontRight || sensor.rearLeft || sensor.rearRight);
+  return sensor.lineMask != 0;
 }
 
 static Direction edgeAvoidDirection() {
-  if (sensor.frontLeft)  return RIGHT;
-  if (sensor.frontRight) return LEFT;
-  if (sensor.rearLeft)   return RIGHT;
-  if (sensor.rearRight)  return LEFT;
+  if (sensor.lineMask & LINE_FRONT_LEFT)  return RIGHT;
+  if (sensor.lineMask & LINE_FRONT_RIGHT) return LEFT;
+  if (sensor.lineMask & LINE_REAR_LEFT)   return RIGHT;
+  if (sensor.lineMask & LINE_REAR_RIGHT)  return LEFT;
   return ROTATE_CW;
 }
 
-static void updateDisplay(int left, int right, int avg) {
-  unsigned long now = millis();
-  if (now - lastDisplayUpdate < 100) return;
-  lastDisplayUpdate = now;
-  static int statusColor = TFT_BLACK;
-
-  switch (currentState) {
-    case STARTUP_ROTATE:
-      statusColor = TFT_CYAN;
-      break;
-    case SEARCHING:
-      statusColor = TFT_YELLOW;
-      break;
-    case CHASING:
-      statusColor = TFT_GREEN;
-      break;
-    case AVOID_EDGE:
-    default:
-      statusColor = TFT_RED;
-      break;
-  }
-  if (currentState != prevState) {
-    tft.fillScreen(statusColor);
-    tft.setTextColor(TFT_BLACK, statusColor);
+// ===================== STRATEGY =====================
+// No state may block, time spent in a state comes from the engine
+static void tickStartupRotate(StrategyInput_t &) {
+  motor.direction = ROTATE_CW;
+  move(&motor);
+}
+
+static void tickSearching(StrategyInput_t &) {
+  motor.direction = lastSeenDirection;
+  move(&motor);
+}
+
+static void tickChasing(StrategyInput_t &) {
+  chaseMode();
+}
+
+static void enterAvoidEdge(StrategyInput_t &) {
+  motor.direction = edgeAvoidDirection();
+  move(&motor);
+}
+
+static void tickAvoidEdge(StrategyInput_t &) {
+  move(&motor);
+}
+
+static bool opponentFound(StrategyInput_t &input, uint32_t) {
+  return input.newPair && detectOpponent();
+}
+
+static bool lineFound(StrategyInput_t &, uint32_t) {
+  return lineDetected();
+}
+
+static bool opponentLost(StrategyInput_t &, uint32_t) {
+  return sensor.leftCm == OUT_OF_RANGE && sensor.rightCm == OUT_OF_RANGE;
+}
+
+static bool edgeAvoided(StrategyInput_t &, uint32_t inStateMs) {
+  return inStateMs > EDGE_AVOID_TIME_MS;
+}
+
+static void resetConfirmCount(StrategyInput_t &) {
+  detectConfirmCount = 0;
+}
+
+static const SmState<StrategyInput_t> strategyStates[NUM_STATES] = {
+  {"STARTUP", NULL,           tickStartupRotate},
+  {"SEARCH",  NULL,           tickSearching},
+  {"CHASE",   NULL,           tickChasing},
+  {"EDGE",    enterAvoidEdge, tickAvoidEdge},
+};
+
+// Grouped by source state, first matching guard wins
+static constexpr SmTransition<StrategyInput_t> strategyTransitions[] = {
+  {STARTUP_ROTATE, CHASING,    opponentFound, resetConfirmCount},
+  {SEARCHING,      AVOID_EDGE, lineFound,     NULL},
+  {SEARCHING,      CHASING,    opponentFound, resetConfirmCount},
+  {CHASING,        AVOID_EDGE, lineFound,     NULL},
+  {CHASING,        SEARCHING,  opponentLost,  NULL},
+  {AVOID_EDGE,     SEARCHING,  edgeAvoided,   NULL},
+};
+#define NUM_TRANSITIONS (sizeof(strategyTransitions) / sizeof(strategyTransitions[0]))
+static_assert(smTransitionsSorted(strategyTransitions, NUM_TRANSITIONS), "Transitions must be grouped by source state");
+static_assert(smTransitionsInRange(strategyTransitions, NUM_TRANSITIONS, NUM_STATES), "Transition to an unknown state");
+
+static StateMachine<StrategyInput_t, NUM_STATES, NUM_TRANSITIONS> strategy(strategyStates, strategyTransitions);
+
+// For the simulator's bout report
+size_t getStrategyTrace(StateTrace_t *out, size_t max) { return strategy.trace(out, max); }
+const char *getStrategyStateName(uint8_t state) { return strategy.stateName(state); }
+size_t getStrategyDwell(StateDwell_t *out, size_t max) {
+  if (max < NUM_STATES) return 0;
+  strategy.dwell(out, halMillis());
+  return NUM_STATES;
+}
+
+static void logSensors(void) {
+  TelemetrySensors_t record;
+  record.leftCm = (int16_t)sensor.leftCm;
+  record.rightCm = (int16_t)sensor.rightCm;
+  record.lineAdc = (uint16_t)sensor.analogReading;
+  record.lineMask = sensor.lineMask;
+  record.state = strategy.state();
+  telemetryPush(TLM_CHANNEL_LOOP, TLM_SENSORS, &record, sizeof(record));
+}
+
+// HUD background for each state
+static const uint16_t stateColors[NUM_STATES] = {TFT_CYAN, TFT_YELLOW, TFT_GREEN, TFT_RED};
+
+// The display task renders and flushes, loop() only hands it a copy of what to show
+static void postHud(int left, int right, int avg) {
+  static unsigned long loops = 0, rateStartMs = 0, lastPostMs = 0;
+  static uint16_t loopHz = 0;
+  unsigned long now = halMillis();
+  loops++;
+  if (now - rateStartMs >= 1000) {
+    loopHz = (uint16_t)min(loops * 1000 / (now - rateStartMs), 65535UL);
+    loops = 0;
+    rateStartMs = now;
   }
+  if (now == lastPostMs) return;
+  lastPostMs = now;
+
+  HudSnapshot_t hud;
+  hud.leftCm = (int16_t)left;
+  hud.rightCm = (int16_t)right;
+  hud.avgCm = (int16_t)avg;
+  hud.lineAdc = (uint16_t)sensor.analogReading;
+  hud.lineMask = sensor.lineMask;
+  hud.state = strategy.state();
+  hud.stateName = strategy.stateName(hud.state);
+  hud.statusColor = stateColors[hud.state];
+  hud.loopHz = loopHz;
+  displayPost(&hud);
+}
 
-  tft.setCursor(0, 0);
-  tft.printf("Left :%4d cm\n", left);
-  tft.printf("Right:%4d cm\n", right);
-  tft.printf("Avg  :%4d cm\n", avg);
-  tft.printf("State: %8s\n",
-    (currentState == STARTUP_ROTATE) ? "STARTUP" :
-    (currentState == SEARCHING) ? "SEARCH" :
-    (currentState == CHASING)  ? "CHASE" : "EDGE");
-  tft.printf("FL:%d FR:%d \nRL:%d RR:%d\n%4d",
-    sensor.frontLeft, sensor.frontRight, sensor.rearLeft, sensor.rearRight, sensor.analogReading);
+void setup() {
+  halPinMode(LEFT_BUTTON, INPUT);
+  halPinMode(RIGHT_BUTTON, INPUT);
+  halPinMode(15,OUTPUT);
+  halDigitalWrite(15,HIGH);
+
+  initMotors();
+  initSensors();
+  startMotorControlTask();
+
+  tft.init();
+  tft.setRotation(3);
+  tft.fillScreen(TFT_BLACK);
+  userSelectFunction(&tft, &sensor, &motor);
+  // After the menu, which may recalibrate the line detector with single reads
+  startLineSampling();
+  setLineReflex(lineReflex);
+  startTelemetry();
+  startScreenshots();
+
+  // From here on only the display task draws
+  startDisplay(&tft);
+
+  for (int i = 0; i < BUF_SIZE; ++i) distanceBuf[i] = 1000;
+  bufIdx = 0;
+  bufferFilled = false;
+
+  StrategyInput_t input = {false};
+  strategy.reset(input, STARTUP_ROTATE, halMillis());
 }
 
 void loop() {
-  pollDistance(&sensor);
-  delay(5);
   pollDistance(&sensor);
   detectLine(&sensor);
 
   int left = normaliseDistanceForBuffer(sensor.leftCm);
   int right = normaliseDistanceForBuffer(sensor.rightCm);
   int avg = (left + right) / 2;
-  updateDistanceBuf(avg);
-
-  switch (currentState) {
-    case STARTUP_ROTATE:
-      motor.direction = ROTATE_CW;
-      move(&motor);
-      if (detectOpponent()) {
-        currentState = CHASING;
-        detectConfirmCount = 0;
-      }
-      delay(STARTUP_ROTATE_DELAY_MS);
-      break;
-
-    case SEARCHING:
-      motor.direction = lastSeenDirection;
-      move(&motor);
-      if (lineDetected()) {
-        currentState = AVOID_EDGE;
-        edgeAvoidStart = millis();
-        motor.direction = edgeAvoidDirection();
-        move(&motor);
-      } else if (detectOpponent()) {
-        currentState = CHASING;
-        detectConfirmCount = 0;
-      }
-      break;
-
-    case CHASING:
-      chaseMode();
-      if (lineDetected()) {
-        currentState = AVOID_EDGE;
-        edgeAvoidStart = millis();
-        motor.direction = edgeAvoidDirection();
-        move(&motor);
-      } else if (sensor.leftCm == OUT_OF_RANGE && sensor.rightCm == OUT_OF_RANGE) {
-        currentState = SEARCHING;
-      }
-      break;
-
-    case AVOID_EDGE:
-      move(&motor);
-      if (millis() - edgeAvoidStart > EDGE_AVOID_TIME_MS) {
-        currentState = SEARCHING;
-      }
-      break;
+
+  // Ranging runs in the background, only feed the detector once per left/right pair
+  StrategyInput_t input;
+  input.newPair = (sensor.rightSampleUs != lastPairSampleUs);
+  if (input.newPair) {
+    lastPairSampleUs = sensor.rightSampleUs;
+    updateDistanceBuf(avg);
   }
 
-  updateMotorControl();
-  updateDisplay(sensor.leftCm, sensor.rightCm, avg);
-  prevState = currentState;
+  static uint8_t loggedMask = 0;
+  bool changed = strategy.step(input, halMillis());
+  if (input.newPair || changed || sensor.lineMask != loggedMask) {
+    logSensors();
+    loggedMask = sensor.lineMask;
+  }
+  postHud(sensor.leftCm, sensor.rightCm, avg);
 }
@@ -0,0 +1,138 @@
+#include "Display.h"
+#include "Motor.h"
+#include "Screenshot.h"
+#include "Sensors.h"
+#include <atomic>
+#include <string.h>
+
+// ===================== MAILBOX =====================
+// Three slots: loop() fills its own, then swaps it with the middle one and marks
+// it fresh; the task swaps the middle one with its own only when it is fresh.
+// Neither side waits and the task never sees a half written snapshot.
+#define MAILBOX_INDEX   0x03
+#define MAILBOX_FRESH   0x04
+
+static HudSnapshot_t slots[3];
+static std::atomic<uint8_t> middle(1);
+static uint8_t postSlot = 0;            // Owned by loop()
+static uint8_t renderSlot = 2;          // Owned by the display task
+static std::atomic<uint32_t> posted(0);
+
+void displayPost(const HudSnapshot_t *snapshot) {
+    slots[postSlot] = *snapshot;
+    postSlot = middle.exchange(postSlot | MAILBOX_FRESH, std::memory_order_acq_rel) & MAILBOX_INDEX;
+    posted.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Latest snapshot, or NULL if nothing new was posted since the last take
+static const HudSnapshot_t *takeSnapshot(void) {
+    if (!(middle.load(std::memory_order_acquire) & MAILBOX_FRESH)) return NULL;
+    renderSlot = middle.exchange(renderSlot, std::memory_order_acq_rel) & MAILBOX_INDEX;
+    return &slots[renderSlot];
+}
+
+// ===================== RENDERING =====================
+static TFT_eSPI *panel = NULL;
+static TFT_eStrip *strip = NULL;
+static bool stripTried = false;         // createStrip() ran since startDisplay()
+static bool panelValid = false;         // Panel shows the last frame pushed
+
+static uint32_t frames = 0, pixelsSent = 0, maxFrameUs = 0;
+static MotorTaskStats_t motorStats;     // Read once a frame, every band shows the same
+
+static void renderHud(TFT_eSPI *canvas, const HudSnapshot_t *hud) {
+    canvas->setTextFont(1);
+    canvas->setTextSize(2);
+    canvas->setTextColor(TFT_BLACK, hud->statusColor);
+    canvas->setCursor(0, 0);
+    canvas->printf("Left :%4d cm\n", hud->leftCm);
+    canvas->printf("Right:%4d cm\n", hud->rightCm);
+    canvas->printf("Avg  :%4d cm\n", hud->avgCm);
+    canvas->printf("State: %8s\n", hud->stateName);
+    canvas->printf("FL:%d FR:%d \nRL:%d RR:%d\n%4d\n",
+        (hud->lineMask & LINE_FRONT_LEFT) != 0, (hud->lineMask & LINE_FRONT_RIGHT) != 0,
+        (hud->lineMask & LINE_REAR_LEFT) != 0, (hud->lineMask & LINE_REAR_RIGHT) != 0, hud->lineAdc);
+    canvas->printf("Loop :%5u Hz\n", hud->loopHz);
+    canvas->printf("Ctl p99:%4lu max:%5lu us", (unsigned long)motorStats.p99PeriodUs, (unsigned long)motorStats.maxPeriodUs);
+}
+
+// The whole HUD, drawn once for every band of the strip
+static void drawHud(TFT_eSPI *canvas, void *data) {
+    const HudSnapshot_t *hud = (const HudSnapshot_t *)data;
+    canvas->fillScreen(hud->statusColor);
+    renderHud(canvas, hud);
+}
+
+// With DMA the strip takes two bands of DISPLAY_STRIP_ROWS, 20 KB at 320 wide, and
+// sends each while the next is drawn. Run from the display task: the DMA completion
+// interrupt is allocated on the core that calls initDMA(), which must be the one
+// queueing the transfers.
+static void createStrip(void) {
+    stripTried = true;
+    if (strip) return;
+    panel->initDMA();
+    strip = new TFT_eStrip(panel);
+    if (!strip->createStrip(DISPLAY_STRIP_ROWS)) {
+        delete strip;
+        strip = NULL;
+    }
+}
+
+static void displayTask(void) {
+    if (!stripTried) createStrip();
+    // Queue more of the last screenshot, whether or not there is a new frame
+    screenshotFlush();
+    const HudSnapshot_t *hud = takeSnapshot();
+    if (!hud) return;
+    unsigned long start = halMicros();
+    getMotorTaskStats(&motorStats);
+
+    if (strip) {
+        // The HUD text is copied from an atlas of the font in the colours of the state,
+        // made again when the state colour changes
+        static uint16_t atlasColor = 0;
+        static bool atlasValid = false;
+        if (!atlasValid || hud->statusColor != atlasColor) {
+            strip->deleteGlyphAtlas();
+            atlasValid = strip->createGlyphAtlas(1, 2, TFT_BLACK, hud->statusColor);
+            atlasColor = hud->statusColor;
+        }
+        // Redraw the whole HUD band by band, sending the bands that changed. A
+        // screenshot takes the bands from the strip as they are drawn
+        bool capture = screenshotBegin(strip->width(), strip->height(), DISPLAY_STRIP_ROWS);
+        strip->setBandCallback(capture ? screenshotBand : NULL);
+        pixelsSent += strip->pushFrame(drawHud, (void *)hud, panelValid);
+        panelValid = true;
+        if (capture) {
+            screenshotEnd();
+            screenshotFlush();
+        }
+    } else {
+        // Straight on the panel, repainting only when the background changes
+        static uint16_t shownColor = 0;
+        if (!panelValid || hud->statusColor != shownColor) {
+            panel->fillScreen(hud->statusColor);
+            shownColor = hud->statusColor;
+            panelValid = true;
+        }
+        renderHud(panel, hud);
+    }
+
+    frames++;
+    maxFrameUs = max(maxFrameUs, (uint32_t)(halMicros() - start));
+}
+
+void startDisplay(TFT_eSPI *tft) {
+    panel = tft;
+    panelValid = false;
+    stripTried = false;         // The task makes the strip on its first run
+    halStartBackgroundTask("display", displayTask, DISPLAY_REFRESH_MS, DISPLAY_CORE, DISPLAY_PRIORITY);
+}
+
+void getDisplayStats(DisplayStats_t *stats) {
+    stats->posted = posted.load(std::memory_order_relaxed);
+    stats->frames = frames;
+    stats->pixelsSent = pixelsSent;
+    stats->maxFrameUs = maxFrameUs;
+    stats->buffered = strip != NULL;
+}
@@ -0,0 +1,192 @@
+// ESP32 implementation of the hardware abstraction layer (see Hal.h)
+#if defined(ARDUINO)
+
+#include "Hal.h"
+#include <Preferences.h>
+#include "driver/adc.h"
+
+#define PERIODIC_TIMER_NUM          0
+#define PERIODIC_TIMER_DIVIDER      80      // 80 MHz APB clock / 80 = 1 us per tick
+#define PERIODIC_TASK_STACK         4096
+#define BACKGROUND_TASK_STACK       6144    // The display task renders text with printf
+#define ADC_TASK_STACK              3072
+#define ADC_MAX_FRAME_SAMPLES       256
+#define ADC_DMA_POOL_FRAMES         8       // Frames the driver can hold before it drops the oldest
+
+static Preferences nvs;
+static portMUX_TYPE halMux = portMUX_INITIALIZER_UNLOCKED;
+
+static TaskHandle_t periodicTask = NULL;
+static void (*periodicFn)(void) = NULL;
+static uint32_t periodicRateHz = 0;
+
+typedef struct {
+    TaskHandle_t task;
+    void (*fn)(void);
+    uint32_t intervalMs;
+} BackgroundTask_t;
+
+static BackgroundTask_t backgroundTasks[HAL_MAX_BACKGROUND_TASKS];
+
+// With CDC on boot undefined Serial is UART0, which the board does not bring out
+#if ARDUINO_USB_MODE && !ARDUINO_USB_CDC_ON_BOOT
+#define HAL_SERIAL  USBSerial
+#else
+#define HAL_SERIAL  Serial
+#endif
+
+static TaskHandle_t adcTask = NULL;
+static void (*adcFrameFn)(const uint16_t *, size_t) = NULL;
+static uint32_t adcFrameBytes = 0;
+static uint8_t adcUnit = 0, adcChannel = 0;
+
+void halPinMode(uint8_t pin, uint8_t mode) { pinMode(pin, mode); }
+void halDigitalWrite(uint8_t pin, uint8_t level) { digitalWrite(pin, level); }
+int halDigitalRead(uint8_t pin) { return digitalRead(pin); }
+
+void halAttachInterrupt(uint8_t pin, void (*isr)(void), int mode) {
+    attachInterrupt(digitalPinToInterrupt(pin), isr, mode);
+}
+
+void halPwmSetup(uint8_t channel, uint32_t freqHz, uint8_t resolutionBits) {
+    ledcSetup(channel, freqHz, resolutionBits);
+}
+
+void halPwmAttachPin(uint8_t pin, uint8_t channel) { ledcAttachPin(pin, channel); }
+void halPwmWrite(uint8_t channel, uint32_t duty) { ledcWrite(channel, duty); }
+
+int halAnalogRead(uint8_t pin) { return analogRead(pin); }
+
+static void adcTaskLoop(void *arg) {
+    static uint8_t frame[ADC_MAX_FRAME_SAMPLES * SOC_ADC_DIGI_RESULT_BYTES];
+    static uint16_t samples[ADC_MAX_FRAME_SAMPLES];
+
+    for (;;) {
+        uint32_t length = 0;
+        if (adc_digi_read_bytes(frame, adcFrameBytes, &length, ADC_MAX_DELAY) != ESP_OK) continue;
+        size_t count = 0;
+        for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= length; i += SOC_ADC_DIGI_RESULT_BYTES) {
+            adc_digi_output_data_t *result = (adc_digi_output_data_t *)&frame[i];
+            if (result->type2.unit == adcUnit && result->type2.channel == adcChannel) {
+                samples[count++] = result->type2.data;
+            }
+        }
+        if (count > 0) adcFrameFn(samples, count);
+    }
+}
+
+bool halAdcStartContinuous(uint8_t pin, uint32_t sampleRateHz, uint16_t frameSamples,
+                           void (*onFrame)(const uint16_t *samples, size_t count), uint8_t core, uint8_t priority) {
+    int8_t analogChannel = digitalPinToAnalogChannel(pin);
+    if (adcTask || analogChannel < 0 || frameSamples == 0 || frameSamples > ADC_MAX_FRAME_SAMPLES) return false;
+    adcUnit = analogChannel / SOC_ADC_MAX_CHANNEL_NUM;
+    adcChannel = analogChannel % SOC_ADC_MAX_CHANNEL_NUM;
+    adcFrameBytes = frameSamples * SOC_ADC_DIGI_RESULT_BYTES;
+
+    adc_digi_init_config_t init = {};
+    init.max_store_buf_size = adcFrameBytes * ADC_DMA_POOL_FRAMES;
+    init.conv_num_each_intr = adcFrameBytes;
+    init.adc1_chan_mask = (adcUnit == 0) ? BIT(adcChannel) : 0;
+    init.adc2_chan_mask = (adcUnit == 1) ? BIT(adcChannel) : 0;
+    if (adc_digi_initialize(&init) != ESP_OK) return false;
+
+    // Same attenuation and width analogRead() uses, so ADCLookup stays valid
+    adc_digi_pattern_config_t pattern = {};
+    pattern.atten = ADC_ATTEN_DB_11;
+    pattern.channel = adcChannel;
+    pattern.unit = adcUnit;
+    pattern.bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+
+    adc_digi_configuration_t config = {};
+    config.conv_limit_en = false;
+    config.pattern_num = 1;
+    config.adc_pattern = &pattern;
+    config.sample_freq_hz = sampleRateHz;
+    config.conv_mode = (adcUnit == 0) ? ADC_CONV_SINGLE_UNIT_1 : ADC_CONV_SINGLE_UNIT_2;
+    config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+
+    // Some chips cannot run ADC2 from the digital controller, the caller keeps analogRead()
+    if (adc_digi_controller_configure(&config) != ESP_OK || adc_digi_start() != ESP_OK) {
+        adc_digi_deinitialize();
+        return false;
+    }
+
+    adcFrameFn = onFrame;
+    xTaskCreatePinnedToCore(adcTaskLoop, "adcContinuous", ADC_TASK_STACK, NULL, priority, &adcTask, core);
+    return true;
+}
+
+unsigned long halPulseIn(uint8_t pin, uint8_t level, unsigned long timeoutUs) {
+    return pulseIn(pin, level, timeoutUs);
+}
+
+unsigned long halMillis(void) { return millis(); }
+unsigned long halMicros(void) { return micros(); }
+void halDelay(unsigned long ms) { delay(ms); }
+void halDelayMicroseconds(unsigned int us) { delayMicroseconds(us); }
+
+void IRAM_ATTR halCriticalEnter(void) { portENTER_CRITICAL_SAFE(&halMux); }
+void IRAM_ATTR halCriticalExit(void) { portEXIT_CRITICAL_SAFE(&halMux); }
+
+static void IRAM_ATTR onPeriodicTimer() {
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(periodicTask, &woken);
+    if (woken) portYIELD_FROM_ISR();
+}
+
+static void periodicTaskLoop(void *arg) {
+    // Allocate the timer interrupt from inside the task so it lands on the same core
+    hw_timer_t *timer = timerBegin(PERIODIC_TIMER_NUM, PERIODIC_TIMER_DIVIDER, true);
+    timerAttachInterrupt(timer, onPeriodicTimer, true);
+    timerAlarmWrite(timer, 1000000 / periodicRateHz, true);
+    timerAlarmEnable(timer);
+
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        periodicFn();
+    }
+}
+
+void halStartPeriodicTask(const char *name, void (*fn)(void), uint32_t rateHz, uint8_t core, uint8_t priority) {
+    if (periodicTask || rateHz == 0) return;
+    periodicFn = fn;
+    periodicRateHz = rateHz;
+    xTaskCreatePinnedToCore(periodicTaskLoop, name, PERIODIC_TASK_STACK, NULL, priority, &periodicTask, core);
+}
+
+static void backgroundTaskLoop(void *arg) {
+    BackgroundTask_t *bg = (BackgroundTask_t *)arg;
+    TickType_t wake = xTaskGetTickCount();
+    for (;;) {
+        bg->fn();
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(bg->intervalMs));
+    }
+}
+
+void halStartBackgroundTask(const char *name, void (*fn)(void), uint32_t intervalMs, uint8_t core, uint8_t priority) {
+    if (intervalMs == 0) return;
+    BackgroundTask_t *slot = NULL;
+    for (int i = 0; i < HAL_MAX_BACKGROUND_TASKS; i++) {
+        if (backgroundTasks[i].fn == fn) return;
+        if (!slot && !backgroundTasks[i].fn) slot = &backgroundTasks[i];
+    }
+    if (!slot) return;
+    slot->fn = fn;
+    slot->intervalMs = intervalMs;
+    xTaskCreatePinnedToCore(backgroundTaskLoop, name, BACKGROUND_TASK_STACK, slot, priority, &slot->task, core);
+}
+
+void halSerialBegin(uint32_t baud) { HAL_SERIAL.begin(baud); }
+
+size_t halSerialWrite(const uint8_t *data, size_t length) {
+    int room = HAL_SERIAL.availableForWrite();
+    if (room <= 0) return 0;
+    return HAL_SERIAL.write(data, min(length, (size_t)room));
+}
+
+void halNvsBegin(const char *name) { nvs.begin(name, false); }
+bool halNvsIsKey(const char *key) { return nvs.isKey(key); }
+int32_t halNvsGetInt(const char *key, int32_t defaultValue) { return nvs.getInt(key, defaultValue); }
+void halNvsPutInt(const char *key, int32_t value) { nvs.putInt(key, value); }
+
+#endif // ARDUINO
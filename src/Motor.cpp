@@ -1,50 +1,159 @@
 #include "Motor.h"
+#include "Telemetry.h"
+#include <atomic>
 
-volatile long encoderCountA = 0;
-volatile long encoderCountB = 0;
+#if defined(ENCODER_USE_PCNT)
+#include "driver/pcnt.h"
+
+// PCNT counters are 16-bit, the unit resets at the limit and the event ISR carries the wrap
+#define ENCODER_PCNT_LIMIT      32767
+#define ENCODER_PCNT_FILTER     100     // Ignore glitches shorter than 100 APB cycles (1.25 us)
+#endif
 
 int rMotNewA = 0;
 int rMotNewB = 0;
 
-void IRAM_ATTR handleEncoderA() {
-    encoderCountA++;
+// ===================== ENCODERS =====================
+typedef struct {
+    uint8_t pulsePin;
+    int8_t phasePin;
+    volatile int32_t raw;       // ISR: edge count; PCNT: number of counter wraps
+    int32_t lastRaw;            // Raw position folded into count so far
+    int64_t count;              // Signed accumulated ticks
+    int8_t sign;                // Commanded direction, used when there is no phase input
+#if defined(ENCODER_USE_PCNT)
+    pcnt_unit_t unit;
+#endif
+} Encoder_t;
+
+#if defined(ENCODER_USE_PCNT)
+static Encoder_t encoderA = {ENCA, ENCA_PHASE, 0, 0, 0, 1, PCNT_UNIT_0};
+static Encoder_t encoderB = {ENCB, ENCB_PHASE, 0, 0, 0, 1, PCNT_UNIT_1};
+#else
+static Encoder_t encoderA = {ENCA, ENCA_PHASE, 0, 0, 0, 1};
+static Encoder_t encoderB = {ENCB, ENCB_PHASE, 0, 0, 0, 1};
+#endif
+
+#if defined(ENCODER_USE_PCNT)
+static void IRAM_ATTR onPcntLimit(void *arg) {
+    Encoder_t *enc = (Encoder_t *)arg;
+    uint32_t status = 0;
+    pcnt_get_event_status(enc->unit, &status);
+    if (status & PCNT_EVT_H_LIM) enc->raw++;
+    if (status & PCNT_EVT_L_LIM) enc->raw--;
 }
 
-void IRAM_ATTR handleEncoderB() {
-    encoderCountB++;
+static void initEncoder(Encoder_t *enc) {
+    static bool serviceInstalled = false;
+
+    pcnt_config_t config = {};
+    config.pulse_gpio_num = enc->pulsePin;
+    config.ctrl_gpio_num = (enc->phasePin >= 0) ? enc->phasePin : PCNT_PIN_NOT_USED;
+    config.channel = PCNT_CHANNEL_0;
+    config.unit = enc->unit;
+    config.pos_mode = PCNT_COUNT_INC;       // Rising edges, as the interrupt backend
+    config.neg_mode = PCNT_COUNT_DIS;
+    config.lctrl_mode = PCNT_MODE_REVERSE;  // Phase low counts down
+    config.hctrl_mode = PCNT_MODE_KEEP;
+    config.counter_h_lim = ENCODER_PCNT_LIMIT;
+    config.counter_l_lim = -ENCODER_PCNT_LIMIT;
+    pcnt_unit_config(&config);
+
+    pcnt_set_filter_value(enc->unit, ENCODER_PCNT_FILTER);
+    pcnt_filter_enable(enc->unit);
+    pcnt_event_enable(enc->unit, PCNT_EVT_H_LIM);
+    pcnt_event_enable(enc->unit, PCNT_EVT_L_LIM);
+    pcnt_counter_pause(enc->unit);
+    pcnt_counter_clear(enc->unit);
+
+    if (!serviceInstalled) {
+        pcnt_isr_service_install(0);
+        serviceInstalled = true;
+    }
+    pcnt_isr_handler_add(enc->unit, onPcntLimit, enc);
+    pcnt_counter_resume(enc->unit);
+}
+
+// Wrapping 32-bit position, consistent even if the counter wraps while it is read
+static int32_t readRaw(Encoder_t *enc) {
+    int32_t wraps;
+    int16_t value;
+    do {
+        wraps = enc->raw;
+        pcnt_get_counter_value(enc->unit, &value);
+    } while (wraps != enc->raw);
+    return (int32_t)((uint32_t)wraps * ENCODER_PCNT_LIMIT + (uint32_t)(int32_t)value);
+}
+#else
+static inline void IRAM_ATTR countEdge(Encoder_t *enc) {
+    enc->raw += (enc->phasePin >= 0 && !halDigitalRead(enc->phasePin)) ? -1 : 1;
+}
+
+void IRAM_ATTR handleEncoderA() { countEdge(&encoderA); }
+void IRAM_ATTR handleEncoderB() { countEdge(&encoderB); }
+
+static void initEncoder(Encoder_t *enc) {
+    halPinMode(enc->pulsePin, INPUT_PULLUP);
+    if (enc->phasePin >= 0) halPinMode(enc->phasePin, INPUT_PULLUP);
+    halAttachInterrupt(enc->pulsePin, (enc == &encoderA) ? handleEncoderA : handleEncoderB, RISING);
 }
 
-void initEncoderA() {
-    pinMode(ENCA, INPUT_PULLUP);
-    attachInterrupt(digitalPinToInterrupt(ENCA), handleEncoderA, RISING);
+static inline int32_t readRaw(Encoder_t *enc) { return enc->raw; }
+#endif
+
+// Fold the ticks seen since the last call into the signed count. Must be called
+// before the commanded direction of a single-channel encoder changes.
+static int64_t foldEncoder(Encoder_t *enc) {
+    halCriticalEnter();
+    int32_t raw = readRaw(enc);
+    int32_t delta = (int32_t)((uint32_t)raw - (uint32_t)enc->lastRaw);
+#if defined(ENCODER_USE_PCNT)
+    // The counter has hit its limit but the wrap ISR has not run yet, pick it up next time
+    if (delta > ENCODER_PCNT_LIMIT / 2 || delta < -ENCODER_PCNT_LIMIT / 2) delta = 0;
+    else enc->lastRaw = raw;
+#else
+    enc->lastRaw = raw;
+#endif
+    enc->count += (enc->phasePin >= 0) ? delta : delta * enc->sign;
+    int64_t count = enc->count;
+    halCriticalExit();
+    return count;
 }
 
-void initEncoderB() {
-    pinMode(ENCB, INPUT_PULLUP);
-    attachInterrupt(digitalPinToInterrupt(ENCB), handleEncoderB, RISING);
+static void setEncoderSign(Encoder_t *enc, int8_t sign) {
+    if (sign == 0 || sign == enc->sign) return;   // Coasting wheels keep turning the same way
+    foldEncoder(enc);
+    enc->sign = sign;
 }
 
-long getEncoderCountA() { return encoderCountA; }
-long getEncoderCountB() { return encoderCountB; }
+void initEncoderA() { initEncoder(&encoderA); }
+void initEncoderB() { initEncoder(&encoderB); }
+
+int64_t getEncoderCountA() { return foldEncoder(&encoderA); }
+int64_t getEncoderCountB() { return foldEncoder(&encoderB); }
 
 void resetEncoders() {
-    encoderCountA = 0;
-    encoderCountB = 0;
+    foldEncoder(&encoderA);
+    foldEncoder(&encoderB);
+    halCriticalEnter();
+    encoderA.count = 0;
+    encoderB.count = 0;
+    halCriticalExit();
 }
 
 void initMotors(void) {
-    pinMode(IN1A, OUTPUT);
-    pinMode(IN2A, OUTPUT);
-    pinMode(IN1B, OUTPUT);
-    pinMode(IN2B, OUTPUT);
+    halPinMode(IN1A, OUTPUT);
+    halPinMode(IN2A, OUTPUT);
+    halPinMode(IN1B, OUTPUT);
+    halPinMode(IN2B, OUTPUT);
     
-    pinMode(PWMA, OUTPUT);
-    pinMode(PWMB, OUTPUT);
+    halPinMode(PWMA, OUTPUT);
+    halPinMode(PWMB, OUTPUT);
 
-    ledcSetup(PWM_CHANNEL_A, PWM_FREQ, PWM_RESOLUTION);
-    ledcSetup(PWM_CHANNEL_B, PWM_FREQ, PWM_RESOLUTION);
-    ledcAttachPin(PWMA, PWM_CHANNEL_A);
-    ledcAttachPin(PWMB, PWM_CHANNEL_B);
+    halPwmSetup(PWM_CHANNEL_A, PWM_FREQ, PWM_RESOLUTION);
+    halPwmSetup(PWM_CHANNEL_B, PWM_FREQ, PWM_RESOLUTION);
+    halPwmAttachPin(PWMA, PWM_CHANNEL_A);
+    halPwmAttachPin(PWMB, PWM_CHANNEL_B);
 
     stopMotors();
     initEncoderA();
@@ -52,88 +161,362 @@ void initMotors(void) {
 }
 
 
-void move(Motor_t *motor) {
-    switch (motor->direction) {
+// ===================== SETPOINT MAILBOX =====================
+// Single writer (strategy loop) / single reader (control task) seqlock: the
+// writer makes the sequence odd while it updates the slot, the reader retries
+// until it copies the slot with the same even sequence before and after.
+typedef struct {
+    Direction direction;
+    bool stop;
+    float desiredSpeedA;
+    float desiredSpeedB;
+} MotorSetpoint_t;
+
+static std::atomic<uint32_t> setpointSeq(0);
+static MotorSetpoint_t setpointSlot = {FORWARD, true, 0.0f, 0.0f};
+static bool controlTaskRunning = false;
+
+static void applySetpoint(const MotorSetpoint_t *setpoint);
+
+static void postSetpoint(const MotorSetpoint_t *setpoint) {
+    uint32_t seq = setpointSeq.load(std::memory_order_relaxed);
+    setpointSeq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    setpointSlot = *setpoint;
+    setpointSeq.store(seq + 2, std::memory_order_release);
+
+    // Without the task (e.g. bench sketches) act immediately as before
+    if (!controlTaskRunning) applySetpoint(setpoint);
+}
+
+static uint32_t readSetpoint(MotorSetpoint_t *setpoint) {
+    uint32_t before, after;
+    do {
+        before = setpointSeq.load(std::memory_order_acquire);
+        *setpoint = setpointSlot;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = setpointSeq.load(std::memory_order_relaxed);
+    } while ((before & 1) || before != after);
+    return after;
+}
+
+// Sign of each wheel for a direction: +1 forward, -1 reverse, 0 coasting
+static void directionSigns(Direction direction, int8_t *signA, int8_t *signB) {
+    switch (direction) {
+        case FORWARD:       *signA = 1;  *signB = 1;  break;
+        case REVERSE:       *signA = -1; *signB = -1; break;
+        case RIGHT:         *signA = 0;  *signB = 1;  break;
+        case LEFT:          *signA = 1;  *signB = 0;  break;
+        case ROTATE_CW:     *signA = -1; *signB = 1;  break;
+        case ROTATE_CCW:    *signA = 1;  *signB = -1; break;
+        default:            *signA = 0;  *signB = 0;  break;
+    }
+}
+
+static void writeDirectionPins(Direction direction) {
+    int8_t signA = 0, signB = 0;
+    directionSigns(direction, &signA, &signB);
+    setEncoderSign(&encoderA, signA);
+    setEncoderSign(&encoderB, signB);
+
+    switch (direction) {
         case FORWARD:
-            digitalWrite(IN1A, HIGH);   digitalWrite(IN2A, LOW);
-            digitalWrite(IN1B, HIGH);   digitalWrite(IN2B, LOW);
+            halDigitalWrite(IN1A, HIGH);   halDigitalWrite(IN2A, LOW);
+            halDigitalWrite(IN1B, HIGH);   halDigitalWrite(IN2B, LOW);
+            break;
 
-            motor->desiredSpeedA = maxTickSpeed * 0.5f; // half speed is temporary...
-            motor->desiredSpeedB = maxTickSpeed * 0.5f;
+        case REVERSE:
+            halDigitalWrite(IN1A, LOW);    halDigitalWrite(IN2A, HIGH);
+            halDigitalWrite(IN1B, LOW);    halDigitalWrite(IN2B, HIGH);
+            break;
+
+        case RIGHT:
+            halDigitalWrite(IN1A, LOW);    halDigitalWrite(IN2A, LOW);
+            halDigitalWrite(IN1B, HIGH);   halDigitalWrite(IN2B, LOW);
+            break;
+
+        case LEFT:
+            halDigitalWrite(IN1A, HIGH);   halDigitalWrite(IN2A, LOW);
+            halDigitalWrite(IN1B, LOW);    halDigitalWrite(IN2B, LOW);
             break;
 
+        case ROTATE_CW:
+            halDigitalWrite(IN1A, LOW);    halDigitalWrite(IN2A, HIGH);
+            halDigitalWrite(IN1B, HIGH);   halDigitalWrite(IN2B, LOW);
+            break;
+
+        case ROTATE_CCW:
+            halDigitalWrite(IN1A, HIGH);   halDigitalWrite(IN2A, LOW);
+            halDigitalWrite(IN1B, LOW);    halDigitalWrite(IN2B, HIGH);
+            break;
+    }
+}
+
+static void applySetpoint(const MotorSetpoint_t *setpoint) {
+    if (setpoint->stop) {
+        resetPIController();
+        halPwmWrite(PWM_CHANNEL_A, 0);
+        halPwmWrite(PWM_CHANNEL_B, 0);
+        halDigitalWrite(IN1A, LOW);
+        halDigitalWrite(IN2A, LOW);
+        halDigitalWrite(IN1B, LOW);
+        halDigitalWrite(IN2B, LOW);
+    } else {
+        writeDirectionPins(setpoint->direction);
+    }
+}
+
+// ===================== REFLEX =====================
+// Raised by the line sampling task, run by the control task, which holds posted
+// setpoints back until the pulse is over
+static std::atomic<bool> reflexActive(false);
+static Direction reflexDirection = REVERSE;
+static bool reflexStop = false;
+static bool reflexRunning = false;      // Control task side
+static unsigned long reflexStartUs = 0;
+
+void motorReflex(Direction direction, bool stop) {
+    if (reflexActive.load(std::memory_order_acquire)) return;
+    reflexDirection = direction;
+    reflexStop = stop;
+    reflexActive.store(true, std::memory_order_release);
+
+    // The control task sets the direction pins on its next period, stop pushing now
+    halPwmWrite(PWM_CHANNEL_A, 0);
+    halPwmWrite(PWM_CHANNEL_B, 0);
+}
+
+bool motorReflexActive(void) {
+    return reflexActive.load(std::memory_order_acquire);
+}
+
+// Returns true while the reflex owns the motors
+static bool runReflex(unsigned long now) {
+    if (!reflexActive.load(std::memory_order_acquire)) return false;
+    if (!reflexRunning) {
+        reflexRunning = true;
+        reflexStartUs = now;
+        MotorSetpoint_t pulse = {reflexDirection, reflexStop, 0.0f, 0.0f};
+        applySetpoint(&pulse);
+        resetPIController();
+        uint32_t duty = reflexStop ? 0 : (1 << PWM_RESOLUTION) - 1;
+        halPwmWrite(PWM_CHANNEL_A, duty);
+        halPwmWrite(PWM_CHANNEL_B, duty);
+        return true;
+    }
+    if (now - reflexStartUs < MOTOR_REFLEX_PULSE_MS * 1000) return true;
+
+    reflexRunning = false;
+    reflexActive.store(false, std::memory_order_release);
+    return false;
+}
+
+void move(Motor_t *motor) {
+    switch (motor->direction) {
+        case FORWARD:
         case REVERSE:
-            digitalWrite(IN1A, LOW);    digitalWrite(IN2A, HIGH);
-            digitalWrite(IN1B, LOW);    digitalWrite(IN2B, HIGH);
-            motor->desiredSpeedA = maxTickSpeed * 0.5f;
+            motor->desiredSpeedA = maxTickSpeed * 0.5f; // half speed is temporary...
             motor->desiredSpeedB = maxTickSpeed * 0.5f;
             break;
 
         case RIGHT:
-            digitalWrite(IN1A, LOW);    digitalWrite(IN2A, LOW);
-            digitalWrite(IN1B, HIGH);   digitalWrite(IN2B, LOW);
             motor->desiredSpeedA = maxTickSpeed;
             motor->desiredSpeedB = 0.0f;
             break;
 
         case LEFT:
-            digitalWrite(IN1A, HIGH);   digitalWrite(IN2A, LOW);
-            digitalWrite(IN1B, LOW);    digitalWrite(IN2B, LOW);
             motor->desiredSpeedA = 0.0f;
             motor->desiredSpeedB = maxTickSpeed;
             break;
 
         case ROTATE_CW:
-            digitalWrite(IN1A, LOW);    digitalWrite(IN2A, HIGH);
-            digitalWrite(IN1B, HIGH);   digitalWrite(IN2B, LOW);
-            motor->desiredSpeedA = maxTickSpeed * 0.5f;
-            motor->desiredSpeedB = maxTickSpeed * 0.5f;
-            break;
-
         case ROTATE_CCW:
-            digitalWrite(IN1A, HIGH);   digitalWrite(IN2A, LOW);
-            digitalWrite(IN1B, LOW);    digitalWrite(IN2B, HIGH);
             motor->desiredSpeedA = maxTickSpeed * 0.5f;
             motor->desiredSpeedB = maxTickSpeed * 0.5f;
             break;
     }
-  
+
+    MotorSetpoint_t setpoint = {motor->direction, false, motor->desiredSpeedA, motor->desiredSpeedB};
+    postSetpoint(&setpoint);
 }
 
 void stopMotors(void) {
-    ledcWrite(PWM_CHANNEL_A, 0);
-    ledcWrite(PWM_CHANNEL_B, 0);
-    digitalWrite(IN1A, LOW);
-    digitalWrite(IN2A, LOW);
-    digitalWrite(IN1B, LOW);
-    digitalWrite(IN2B, LOW);
+    MotorSetpoint_t setpoint = {FORWARD, true, 0.0f, 0.0f};
+    postSetpoint(&setpoint);
 }
 
+// ===================== SPEED CONTROL =====================
+static PidController pidA, pidB;
+static bool pidConfigured = false;
+
+void getSpeedPidConfig(PidConfig_t *config) {
+    config->kp = kp;
+    config->ki = ki;
+    config->kd = kd;
+    config->kff = kff;
+    config->kt = kt;
+    config->derivativeTauS = derivativeTauS;
+    config->samplePeriodS = PI_UPDATE_INTERVAL_MS / 1000.0f;
+    config->outMin = 0.0f;
+    config->outMax = (float)((1 << PWM_RESOLUTION) - 1);
+}
+
+void resetPIController(void) {
+    pidA.reset();
+    pidB.reset();
+}
 
 void updatePIController(Motor_t *motor, float velA, float velB) {
-    static long encOldA = 0, encOldB = 0;
-    static int rOldA = 0, rOldB = 0;
-    static int errOldA = 0, errOldB = 0;
+    if (!pidConfigured) {
+        PidConfig_t config;
+        getSpeedPidConfig(&config);
+        pidA.configure(config);
+        pidB.configure(config);
+        pidConfigured = true;
+    }
+
+    rMotNewA = q16ToInt(pidA.update(q16FromFloat(motor->desiredSpeedA), q16FromFloat(velA)));
+    rMotNewB = q16ToInt(pidB.update(q16FromFloat(motor->desiredSpeedB), q16FromFloat(velB)));
+
+    halPwmWrite(PWM_CHANNEL_A, rMotNewA);
+    halPwmWrite(PWM_CHANNEL_B, rMotNewB);
+}
 
-    int errA = motor->desiredSpeedA - velA;
-    int errB = motor->desiredSpeedB - velB;
 
-    rMotNewA = rOldA + (int)(kp * (errA - errOldA)) + (int)(ki * ((errA + errOldA) / 2));
-    rMotNewB = rOldB + (int)(kp * (errB - errOldB)) + (int)(ki * ((errB + errOldB) / 2));
+// ===================== CONTROL TASK =====================
+// Period histogram: 256 buckets spanning 0 to 4x the nominal period
+#define PERIOD_HIST_BUCKETS     256
+#define PERIOD_HIST_SPAN        4
 
-    rMotNewA = constrain(rMotNewA, 0, 255);
-    rMotNewB = constrain(rMotNewB, 0, 255);
-    rOldA = constrain(rOldA, 0, 255);
-    rOldB = constrain(rOldB, 0, 255);
+static uint32_t nominalPeriodUs = 1000000 / MOTOR_CONTROL_RATE_HZ;
+static uint32_t periodHist[PERIOD_HIST_BUCKETS];
+static volatile uint32_t periodCount = 0, periodMinUs = UINT32_MAX, periodMaxUs = 0, periodOverruns = 0;
+static bool resetStatsRequested = false;
+static bool firstTick = true;
 
-    rOldA = rMotNewA;
-    rOldB = rMotNewB;
+static void recordPeriod(uint32_t periodUs) {
+    if (resetStatsRequested) {
+        for (int i = 0; i < PERIOD_HIST_BUCKETS; i++) periodHist[i] = 0;
+        periodCount = periodOverruns = periodMaxUs = 0;
+        periodMinUs = UINT32_MAX;
+        resetStatsRequested = false;
+    }
+    uint32_t bucket = periodUs * (PERIOD_HIST_BUCKETS / PERIOD_HIST_SPAN) / nominalPeriodUs;
+    periodHist[min(bucket, (uint32_t)PERIOD_HIST_BUCKETS - 1)]++;
+    if (periodUs < periodMinUs) periodMinUs = periodUs;
+    if (periodUs > periodMaxUs) periodMaxUs = periodUs;
+    if (2 * periodUs > 3 * nominalPeriodUs) periodOverruns++;
+    periodCount++;
+}
+
+// Last speed fed to the PID, for telemetry
+static float measuredSpeedA = 0.0f, measuredSpeedB = 0.0f;
+
+static void runControlPeriod(unsigned long now) {
+    static unsigned long lastTickUs = 0, lastPIUpdateUs = 0;
+    static int64_t encoderCountOldA = 0, encoderCountOldB = 0;
+    static uint32_t appliedSeq = 0;
+    static bool reflexRan = false;
+
+    if (!firstTick) recordPeriod(now - lastTickUs);
+    lastTickUs = now;
+
+    if (runReflex(now)) {
+        reflexRan = true;
+        return;
+    }
+
+    MotorSetpoint_t setpoint;
+    uint32_t seq = readSetpoint(&setpoint);
+    if (firstTick || reflexRan || seq != appliedSeq) {
+        applySetpoint(&setpoint);
+        appliedSeq = seq;
+    }
+    // (Re)start the speed loop, also from the end of a reflex pulse
+    if (firstTick || reflexRan) {
+        lastPIUpdateUs = now;
+        encoderCountOldA = getEncoderCountA();
+        encoderCountOldB = getEncoderCountB();
+        firstTick = false;
+        reflexRan = false;
+    }
+    if (setpoint.stop) return;
+
+    unsigned long elapsedUs = now - lastPIUpdateUs;
+    if (elapsedUs < PI_UPDATE_INTERVAL_MS * 1000) return;
+
+    int64_t countA = getEncoderCountA(), countB = getEncoderCountB();
+    float elapsedMs = elapsedUs / 1000.0f;
+    Motor_t target = {};
+    target.desiredSpeedA = setpoint.desiredSpeedA;
+    target.desiredSpeedB = setpoint.desiredSpeedB;
+
+    // Speed along the commanded direction, negative while a wheel is still spinning the other way
+    measuredSpeedA = 100.0f * (countA - encoderCountOldA) * encoderA.sign / elapsedMs;
+    measuredSpeedB = 100.0f * (countB - encoderCountOldB) * encoderB.sign / elapsedMs;
+    updatePIController(&target, measuredSpeedA, measuredSpeedB);
+    encoderCountOldA = countA;
+    encoderCountOldB = countB;
+    lastPIUpdateUs = now;
+}
+
+static int16_t centiSpeed(float speed) {
+    return (int16_t)constrain(speed * 100.0f, -32767.0f, 32767.0f);
+}
 
-    errOldA = errA;
-    errOldB = errB;
+static void logControlPeriod(void) {
+    MotorSetpoint_t setpoint;
+    readSetpoint(&setpoint);
 
-    ledcWrite(PWM_CHANNEL_A, rMotNewA);
-    ledcWrite(PWM_CHANNEL_B, rMotNewB);
-} 
+    TelemetryMotor_t record;
+    record.encoderA = (int32_t)getEncoderCountA();
+    record.encoderB = (int32_t)getEncoderCountB();
+    record.speedA = centiSpeed(measuredSpeedA);
+    record.speedB = centiSpeed(measuredSpeedB);
+    record.setpointA = centiSpeed(setpoint.desiredSpeedA);
+    record.setpointB = centiSpeed(setpoint.desiredSpeedB);
+    record.pwmA = (uint16_t)rMotNewA;
+    record.pwmB = (uint16_t)rMotNewB;
+    record.flags = (setpoint.stop ? TLM_MOTOR_STOPPED : 0) | (reflexRunning ? TLM_MOTOR_REFLEX : 0);
+    telemetryPush(TLM_CHANNEL_CONTROL, TLM_MOTOR, &record, sizeof(record));
+}
 
+static void motorControlTick(void) {
+    runControlPeriod(halMicros());
+    if (telemetryRunning()) logControlPeriod();
+}
+
+void startMotorControlTask(uint32_t rateHz) {
+    nominalPeriodUs = 1000000 / rateHz;
+    firstTick = true;
+    reflexRunning = false;
+    reflexActive.store(false);
+    resetMotorTaskStats();
+    controlTaskRunning = true;
+    halStartPeriodicTask("motorControl", motorControlTick, rateHz, MOTOR_CONTROL_CORE, MOTOR_CONTROL_PRIORITY);
+}
 
+// Buckets are read without locking, a snapshot taken mid-update may be off by one period
+void getMotorTaskStats(MotorTaskStats_t *stats) {
+    stats->periods = periodCount;
+    stats->minPeriodUs = (periodCount > 0) ? periodMinUs : 0;
+    stats->maxPeriodUs = periodMaxUs;
+    stats->overruns = periodOverruns;
+    stats->p99PeriodUs = 0;
+
+    uint32_t seen = 0, target = periodCount - periodCount / 100;
+    for (int i = 0; i < PERIOD_HIST_BUCKETS && periodCount > 0; i++) {
+        seen += periodHist[i];
+        if (seen >= target) {
+            // Report the upper edge of the bucket, no period in it was longer than the max
+            stats->p99PeriodUs = min((i + 1) * nominalPeriodUs * PERIOD_HIST_SPAN / PERIOD_HIST_BUCKETS,
+                                     stats->maxPeriodUs);
+            break;
+        }
+    }
+}
+
+// Applied by the control task on its next period so it never races the histogram
+void resetMotorTaskStats(void) {
+    resetStatsRequested = true;
+}
@@ -0,0 +1,65 @@
+#include "Pid.h"
+
+PidController::PidController() {
+    PidConfig_t config = {};
+    config.samplePeriodS = 1.0f;
+    config.outMax = 1.0f;
+    configure(config);
+}
+
+PidController::PidController(const PidConfig_t &config) {
+    configure(config);
+}
+
+void PidController::configure(const PidConfig_t &config) {
+    float ts = config.samplePeriodS;
+    kp = q16FromFloat(config.kp);
+    kiTs = q16FromFloat(config.ki * ts);
+    kdOverTs = q16FromFloat(config.kd / ts);
+    kff = q16FromFloat(config.kff);
+    ktTs = q16FromFloat(config.kt * ts);
+    derivAlpha = q16FromFloat(ts / (config.derivativeTauS + ts));
+    outMin = q16FromFloat(config.outMin);
+    outMax = q16FromFloat(config.outMax);
+    reset();
+}
+
+void PidController::reset(void) {
+    integ = 0;
+    deriv = 0;
+    lastMeasurement = 0;
+    out = 0;
+    primed = false;
+}
+
+q16_t IRAM_ATTR PidController::update(q16_t setpoint, q16_t measurement) {
+    q16_t error = setpoint - measurement;
+
+    // The first sample has no previous measurement to differentiate against
+    if (!primed) {
+        lastMeasurement = measurement;
+        primed = true;
+    }
+    q16_t rawDeriv = -q16Mul(kdOverTs, measurement - lastMeasurement);
+    deriv += q16Mul(derivAlpha, rawDeriv - deriv);
+    lastMeasurement = measurement;
+
+    // Summed in 64 bits, a large error with a large gain may not fit Q16.16
+    int64_t unclamped = (int64_t)q16Mul(kff, setpoint) + q16Mul(kp, error) + integ + deriv;
+    q16_t clamped = (q16_t)constrain(unclamped, (int64_t)outMin, (int64_t)outMax);
+
+    // Bleed the integrator by the amount the output was clipped
+    int64_t excess = (int64_t)clamped - unclamped;
+    int64_t next = (int64_t)integ + q16Mul(kiTs, error)
+                 + (((int64_t)ktTs * excess + (Q16_ONE >> 1)) >> Q16_SHIFT);
+    // Hard bound as well, for kt = 0 and so the state always fits Q16.16
+    int64_t span = (int64_t)outMax - outMin;
+    integ = (q16_t)constrain(next, (int64_t)outMin - span, (int64_t)outMax + span);
+
+    out = clamped;
+    return out;
+}
+
+float PidController::update(float setpoint, float measurement) {
+    return q16ToFloat(update(q16FromFloat(setpoint), q16FromFloat(measurement)));
+}
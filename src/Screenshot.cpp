@@ -0,0 +1,182 @@
+#include "Screenshot.h"
+#include "Telemetry.h"
+#include <string.h>
+
+#define OP_LITERAL      0x00
+#define OP_RUN          0x80
+#define OP_ABOVE        0xC0
+#define OP_MAX_LITERAL  128
+#define OP_MAX_REPEAT   64
+
+#define BAND_SAME       0x00
+#define BAND_OPS        0x01
+
+static_assert(SCREENSHOT_BUFFER <= 0xFFFF, "Offsets in TelemetryScreen_t are 16 bits");
+
+// ===================== BAND COMPRESSION =====================
+// Pixels held back for a literal op, written once something else is worth an op
+static bool flushLiteral(const uint16_t *pixels, int32_t start, int32_t count, uint8_t *out, size_t *o, size_t room) {
+    while (count > 0) {
+        int32_t n = min(count, (int32_t)OP_MAX_LITERAL);
+        if (*o + 1 + 2 * n > room) return false;
+        out[(*o)++] = OP_LITERAL + (n - 1);
+        memcpy(out + *o, pixels + start, 2 * n);
+        *o += 2 * n;
+        start += n;
+        count -= n;
+    }
+    return true;
+}
+
+size_t screenshotEncodeBand(const uint16_t *pixels, int32_t width, int32_t rows, uint8_t *out, size_t room) {
+    int32_t n = width * rows;
+    int32_t literalStart = 0, literalCount = 0;
+    size_t o = 0;
+
+    int32_t i = 0;
+    while (i < n) {
+        // Greedy: the longer of a copy of the row above (one byte) and a run of one
+        // pixel (three bytes), if either covers two pixels
+        int32_t limit = min(n - i, (int32_t)OP_MAX_REPEAT);
+        int32_t above = 0, run = 1;
+        if (i >= width) while (above < limit && pixels[i + above] == pixels[i + above - width]) above++;
+        while (run < limit && pixels[i + run] == pixels[i]) run++;
+
+        if (above < 2 && run < 2) {
+            if (literalCount == 0) literalStart = i;
+            literalCount++;
+            i++;
+            continue;
+        }
+        if (!flushLiteral(pixels, literalStart, literalCount, out, &o, room)) return 0;
+        literalCount = 0;
+
+        if (above >= run) {
+            if (o + 1 > room) return 0;
+            out[o++] = OP_ABOVE + (above - 1);
+            i += above;
+        } else {
+            if (o + 3 > room) return 0;
+            out[o++] = OP_RUN + (run - 1);
+            memcpy(out + o, pixels + i, 2);
+            o += 2;
+            i += run;
+        }
+    }
+    if (!flushLiteral(pixels, literalStart, literalCount, out, &o, room)) return 0;
+    return o;
+}
+
+// ===================== CAPTURE =====================
+// All owned by the display task, apart from the enable flag
+static volatile bool enabled = false;
+
+static uint8_t buffer[SCREENSHOT_BUFFER];
+static size_t encoded = 0;              // Bytes of the capture in buffer
+static size_t queued = 0;               // Of them pushed as records
+static uint16_t captureNumber = 0;
+
+static bool capturing = false;          // Bands of this frame go into buffer
+static bool overflow = false;
+static bool key = true;                 // The next capture sends every band
+static uint8_t sinceKey = 0;
+static uint8_t band = 0;
+static uint32_t sentHash[SCREENSHOT_MAX_BANDS];     // Bands of the last capture queued
+static uint32_t newHash[SCREENSHOT_MAX_BANDS];
+static uint32_t capturePixels = 0;
+static unsigned long lastCaptureMs = 0;
+
+static ScreenshotStats_t stats;
+
+void startScreenshots(void) { enabled = true; }
+
+void stopScreenshots(void) { enabled = false; }
+
+bool screenshotBegin(int16_t width, int16_t height, uint16_t rows) {
+    unsigned long now = halMillis();
+    if (!enabled || !telemetryRunning() || queued < encoded) return false;
+    if (stats.captures > 0 && now - lastCaptureMs < SCREENSHOT_INTERVAL_MS) return false;
+    if (rows == 0 || (height + rows - 1) / rows > SCREENSHOT_MAX_BANDS) return false;
+    lastCaptureMs = now;
+
+    if (sinceKey >= SCREENSHOT_KEY_EVERY) key = true;
+    buffer[0] = width & 0xFF;
+    buffer[1] = width >> 8;
+    buffer[2] = height & 0xFF;
+    buffer[3] = height >> 8;
+    buffer[4] = rows & 0xFF;
+    buffer[5] = rows >> 8;
+    buffer[6] = key ? SCREENSHOT_KEY : 0;
+    encoded = SCREENSHOT_HEADER;
+    queued = 0;
+    band = 0;
+    capturePixels = 0;
+    overflow = false;
+    capturing = true;
+    return true;
+}
+
+void screenshotBand(const uint16_t *pixelData, int32_t y, int32_t width, int32_t rows, uint32_t hash, void *data) {
+    (void)y;
+    (void)data;
+    if (!capturing || overflow || band >= SCREENSHOT_MAX_BANDS) return;
+    newHash[band] = hash;
+    capturePixels += width * rows;
+
+    if (!key && sentHash[band] == hash) {
+        if (encoded + 1 > SCREENSHOT_BUFFER) overflow = true;
+        else buffer[encoded++] = BAND_SAME;
+    } else {
+        size_t n = (encoded + 1 < SCREENSHOT_BUFFER)
+            ? screenshotEncodeBand(pixelData, width, rows, buffer + encoded + 1, SCREENSHOT_BUFFER - encoded - 1) : 0;
+        if (n == 0) overflow = true;
+        else {
+            buffer[encoded] = BAND_OPS;
+            encoded += 1 + n;
+        }
+    }
+    band++;
+}
+
+void screenshotEnd(void) {
+    if (!capturing) return;
+    capturing = false;
+    if (overflow) {
+        // The reader keeps the last screenshot, the next one must not depend on it
+        stats.skipped++;
+        encoded = queued = 0;
+        key = true;
+        return;
+    }
+    memcpy(sentHash, newHash, band * sizeof(uint32_t));
+    captureNumber++;
+    stats.captures++;
+    stats.pixels += capturePixels;
+    stats.bytes += encoded;
+    if (key) stats.keys++;
+    sinceKey = key ? 0 : sinceKey + 1;
+    key = false;
+}
+
+void screenshotFlush(void) {
+    if (queued >= encoded) return;
+    if (!telemetryRunning()) {
+        // Part of the capture never went out, start again from a key
+        encoded = queued = 0;
+        key = true;
+        return;
+    }
+
+    TelemetryScreen_t record;
+    record.capture = captureNumber;
+    record.length = encoded;
+    for (uint32_t room = telemetryRoom(TLM_CHANNEL_DISPLAY); room > 0 && queued < encoded; room--) {
+        uint8_t n = min(encoded - queued, (size_t)TLM_SCREEN_CHUNK);
+        record.offset = queued;
+        memcpy(record.data, buffer + queued, n);
+        if (!telemetryPush(TLM_CHANNEL_DISPLAY, TLM_SCREEN, &record, sizeof(record) - TLM_SCREEN_CHUNK + n)) break;
+        queued += n;
+    }
+}
+
+void getScreenshotStats(ScreenshotStats_t *out) { *out = stats; }
@@ -2,16 +2,15 @@
 // Author: Allan Wu (23810308)
 
 #include "Sensors.h"
-#include <Arduino.h>
+#include "Hal.h"
 #include <TFT_eSPI.h>
-#include <Preferences.h>
 #include "Startup.h"
-
-Preferences botSettings; 
+#include <atomic>
 
 // Convert between analog voltage reading and binary codes 0000 to 1111
 // (frontLeft, frontRight, rearLeft, rearRight): 0 = WHITE, 1 = BLACK
 int ADCLookup[16];
+uint8_t ADCCodeTable[ADC_CODES];
 
 int ADCLookupDefaults[16] = {
     370, // 0000
@@ -59,33 +58,47 @@ const char *ADCStrings[16] = {
 
 void initSensors() // Please note that the Line Detector pin must support ADC
 {
-    pinMode(LEFT_TRIGGER, OUTPUT);
-    pinMode(LEFT_ECHO, INPUT);
-    pinMode(RIGHT_TRIGGER, OUTPUT);
-    pinMode(RIGHT_ECHO, INPUT);
-    pinMode(LINEDETECTOR_DAC, INPUT);
-
-	botSettings.begin("botSettings", false);
+    halPinMode(LEFT_TRIGGER, OUTPUT);
+    halPinMode(LEFT_ECHO, INPUT);
+    halPinMode(RIGHT_TRIGGER, OUTPUT);
+    halPinMode(RIGHT_ECHO, INPUT);
+    halPinMode(LINEDETECTOR_DAC, INPUT);
+    halAttachInterrupt(LEFT_ECHO, handleLeftEcho, CHANGE);
+    halAttachInterrupt(RIGHT_ECHO, handleRightEcho, CHANGE);
+
+	halNvsBegin("botSettings");
     for (int i = 0; i < 16; i++) {
-	    if (!botSettings.isKey(ADCStrings[i])) {
+	    if (!halNvsIsKey(ADCStrings[i])) {
             ADCLookup[i] = ADCLookupDefaults[i];
-		    botSettings.putInt(ADCStrings[i], ADCLookup[i]);
+		    halNvsPutInt(ADCStrings[i], ADCLookup[i]);
         } else {
-		    ADCLookup[i] = botSettings.getInt(ADCStrings[i]);
+		    ADCLookup[i] = halNvsGetInt(ADCStrings[i]);
         }
     }
+    buildADCCodeTable();
+}
+
+// A reading maps to the first code whose threshold lies above it, readings
+// above every threshold are 1111 (all corners over the line)
+void buildADCCodeTable()
+{
+    int code = 0;
+    for (int value = 0; value < ADC_CODES; value++) {
+        while (code < 15 && value >= ADCLookup[code]) code++;
+        ADCCodeTable[value] = code;
+    }
 }
 
 void waitForButtonPress()
 {
     int currLeft, currRight, prevLeft, prevRight;
     while (true) {
-        currLeft = !digitalRead(LEFT_BUTTON);
-        currRight = !digitalRead(RIGHT_BUTTON);
+        currLeft = !halDigitalRead(LEFT_BUTTON);
+        currRight = !halDigitalRead(RIGHT_BUTTON);
         if (prevLeft && !currLeft || prevRight && !currRight) break;
         prevLeft = currLeft;
         prevRight = currRight;
-    delay(100);
+    halDelay(100);
     }
 }
 
@@ -97,7 +110,7 @@ void printADCLookup(TFT_eSPI *tft, uint32_t colour)
     for (int i = 0; i < 16; i++) {
         tft->setCursor(0, i*10);
         tft->printf("%s: ADCLookup[%2d] = %d ", ADCStrings[i], i, ADCLookup[i]);
-        delay(100);
+        halDelay(100);
     };
     waitForButtonPress();
     tft->setTextColor(TFT_WHITE, TFT_BLACK);
@@ -109,8 +122,9 @@ void resetADCLookup(TFT_eSPI *tft)
 {
     for (int i = 0; i < 16; i++) {
         ADCLookup[i] = ADCLookupDefaults[i];
-        botSettings.putInt(ADCStrings[i], ADCLookup[i]);
+        halNvsPutInt(ADCStrings[i], ADCLookup[i]);
     }
+    buildADCCodeTable();
 
     printADCLookup(tft, TFT_RED);
 }
@@ -125,9 +139,9 @@ void recalibrateADC_GUI(TFT_eSPI *tft)
     tft->setTextSize(2);
 
     while (calibrationStage < 16) {
-        currLeft = !digitalRead(LEFT_BUTTON);
-        currRight = !digitalRead(RIGHT_BUTTON);
-        currentReading = analogRead(LINEDETECTOR_DAC);
+        currLeft = !halDigitalRead(LEFT_BUTTON);
+        currRight = !halDigitalRead(RIGHT_BUTTON);
+        currentReading = halAnalogRead(LINEDETECTOR_DAC);
         tft->setTextColor(TFT_WHITE, TFT_BLACK);
 
         tft->setCursor(5,10);
@@ -153,13 +167,13 @@ void recalibrateADC_GUI(TFT_eSPI *tft)
         if (!prevLeft && currLeft || !prevRight && currRight) {
             if (calibrationStage == 6 || calibrationStage == 9) {
                 analogReadings[calibrationStage] = analogReadings[calibrationStage-1];
-                delay(100);
+                halDelay(100);
             } else {
                 analogReadings[calibrationStage] = currentReading;
                 tft->setTextColor(TFT_GREEN, TFT_BLACK);
                 tft->setCursor(5,85);
                 tft->printf("Recorded value: %d      ", currentReading);
-                delay(400);
+                halDelay(400);
                 tft->setTextColor(TFT_WHITE, TFT_BLACK);
             }
             calibrationStage++;
@@ -167,7 +181,7 @@ void recalibrateADC_GUI(TFT_eSPI *tft)
 
         prevLeft = currLeft;
         prevRight = currRight;
-        delay(100);
+        halDelay(100);
     }
 
     analogReadings[6] = (analogReadings[5] + analogReadings[7])/2;
@@ -181,74 +195,161 @@ void recalibrateADC_GUI(TFT_eSPI *tft)
         curr = analogReadings[i];
         next = (i+1 < 16) ? analogReadings[i+1] : 4096;
         ADCLookup[i] = (curr + next)/2;
-		botSettings.putInt(ADCStrings[i], ADCLookup[i]);
+		halNvsPutInt(ADCStrings[i], ADCLookup[i]);
         tft->setCursor(0, i*10);
     };
+    buildADCCodeTable();
     printADCLookup(tft, TFT_GREEN);
     tft->setTextColor(TFT_WHITE, TFT_BLACK);
 	tft->fillScreen(TFT_BLACK);
 }
 
-void detectLine(Sensors_t *sensors)
+// Written by the sampling task, read by detectLine() without blocking
+static bool lineSampling = false;
+static std::atomic<uint8_t> lineFiltered(0);
+static std::atomic<uint8_t> lineLatched(0);
+static std::atomic<int> lineLastReading(0);
+static volatile unsigned long lineCrossedUs = 0;
+static void (*volatile lineReflexFn)(uint8_t mask) = NULL;
+
+// Per-corner majority vote over the last LINE_FILTER_TAPS decoded samples
+static uint8_t lineWindow[LINE_FILTER_TAPS];
+static uint8_t lineWindowIdx = 0;
+static uint8_t lineVotes[4];
+
+static void onLineFrame(const uint16_t *samples, size_t count)
 {
-    int analogValue = analogRead(LINEDETECTOR_DAC);
-	sensors->analogReading = analogValue;
-	int *ptrs[4] = {&sensors->rearRight, &sensors->rearLeft, &sensors->frontRight, &sensors->frontLeft};
-    int encoding = 16; // Defaults to '1111'
-    for (int i = 0; i < 16; i++) {
-        if (analogValue < ADCLookup[i]) {
-            encoding = i;
-            break;
+    uint8_t filtered = lineFiltered.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < count; i++) {
+        uint8_t previous = filtered;
+        uint8_t mask = lineMaskFromADC(samples[i]);
+        uint8_t leaving = lineWindow[lineWindowIdx];
+        lineWindow[lineWindowIdx] = mask;
+        lineWindowIdx = (lineWindowIdx + 1) % LINE_FILTER_TAPS;
+
+        filtered = 0;
+        for (int bit = 0; bit < 4; bit++) {
+            lineVotes[bit] += ((mask >> bit) & 1) - ((leaving >> bit) & 1);
+            if (lineVotes[bit] > LINE_FILTER_TAPS / 2) filtered |= 1 << bit;
+        }
+        // First crossing since the strategy last looked, kept until it does
+        if (filtered && lineLatched.fetch_or(filtered, std::memory_order_relaxed) == 0) {
+            lineCrossedUs = halMicros();
         }
+        if (filtered && !previous && lineReflexFn) lineReflexFn(filtered);
     }
-    for (int j = 0; j < 4; j++) {
-        int remainder = encoding % 2;
-        encoding /= 2;
-        *ptrs[j] = remainder;
+    lineFiltered.store(filtered, std::memory_order_relaxed);
+    lineLastReading.store(samples[count - 1], std::memory_order_relaxed);
+}
+
+bool startLineSampling()
+{
+    for (int i = 0; i < LINE_FILTER_TAPS; i++) lineWindow[i] = 0;
+    for (int bit = 0; bit < 4; bit++) lineVotes[bit] = 0;
+    lineWindowIdx = 0;
+    lineFiltered.store(0);
+    lineLatched.store(0);
+    lineSampling = halAdcStartContinuous(LINEDETECTOR_DAC, LINE_SAMPLE_RATE_HZ, LINE_FRAME_SAMPLES,
+                                         onLineFrame, LINE_SAMPLING_CORE, LINE_SAMPLING_PRIORITY);
+    return lineSampling;
+}
+
+void setLineReflex(void (*onCross)(uint8_t mask))
+{
+    lineReflexFn = onCross;
+}
+
+void detectLine(Sensors_t *sensors)
+{
+    uint8_t mask;
+    if (lineSampling) {
+        mask = lineFiltered.load(std::memory_order_relaxed) | lineLatched.exchange(0, std::memory_order_relaxed);
+        sensors->analogReading = lineLastReading.load(std::memory_order_relaxed);
+        sensors->lineCrossedUs = lineCrossedUs;
+    } else {
+        int analogValue = halAnalogRead(LINEDETECTOR_DAC);
+        sensors->analogReading = analogValue;
+        mask = lineMaskFromADC(analogValue);
+        sensors->lineCrossedUs = halMicros();
     }
+    sensors->lineMask = mask;
+    sensors->frontLeft = (mask & LINE_FRONT_LEFT) != 0;
+    sensors->frontRight = (mask & LINE_FRONT_RIGHT) != 0;
+    sensors->rearLeft = (mask & LINE_REAR_LEFT) != 0;
+    sensors->rearRight = (mask & LINE_REAR_RIGHT) != 0;
 }
 
-void pollDistance(Sensors_t *sensors)
+// Echo edges are timestamped in ISRs so ranging never busy-waits on the echo pin
+typedef struct {
+    uint8_t triggerPin;
+    uint8_t echoPin;
+    volatile unsigned long riseUs;
+    volatile unsigned long widthUs;
+    volatile bool complete;
+} Ultrasonic_t;
+
+static Ultrasonic_t ultrasonics[2] = {
+    {LEFT_TRIGGER, LEFT_ECHO, 0, 0, false},
+    {RIGHT_TRIGGER, RIGHT_ECHO, 0, 0, false},
+};
+
+static inline void IRAM_ATTR handleEcho(Ultrasonic_t *u)
 {
-    static int currSensor = LEFT_ULTRASONIC; // LEFT = 0, RIGHT = 1
-	double ultrasonicDistanceCm;
-	unsigned long durationMicroseconds;
-	int echoPin, triggerPin;
-	int *sensorPtr;
-
-	switch (currSensor) {
-        case LEFT_ULTRASONIC:
-            echoPin = LEFT_ECHO;
-            triggerPin = LEFT_TRIGGER;
-            sensorPtr = &sensors->leftCm;
-            break;
-        case RIGHT_ULTRASONIC:
-            echoPin = RIGHT_ECHO;
-            triggerPin = RIGHT_TRIGGER;
-            sensorPtr = &sensors->rightCm;
-	}
-
-	// Send trigger pulse
-    digitalWrite(triggerPin, LOW); 
-    delayMicroseconds(2);
-    digitalWrite(triggerPin, HIGH); 
-    delayMicroseconds(10);
-    digitalWrite(triggerPin, LOW);
-
-    // Call pulseIn() to read the echo pulse duration, if timeout occurs duration is instead set to 0
-    durationMicroseconds = pulseIn(echoPin, HIGH, ULTRASONIC_TIMEOUT_US);
-
-    if (durationMicroseconds > 0) {
-        // Calculation: distance = v*t = (343 m/s) * (100 c/m) * (time in us) * (0.000001 s / us) / 2
-        ultrasonicDistanceCm = (durationMicroseconds * 0.0343) / 2;
-		// Round to nearest centimetre
-    	*sensorPtr = (int)(ultrasonicDistanceCm + 0.5); 
+    unsigned long now = halMicros();
+    if (halDigitalRead(u->echoPin)) {
+        u->riseUs = now;
     } else {
-        *sensorPtr = OUT_OF_RANGE;
+        u->widthUs = now - u->riseUs;
+        u->complete = true;
     }
-    // Alternate between the left and right ultrasonic sensor
-    currSensor = !currSensor;
-    return;
+}
+
+void IRAM_ATTR handleLeftEcho() { handleEcho(&ultrasonics[LEFT_ULTRASONIC]); }
+void IRAM_ATTR handleRightEcho() { handleEcho(&ultrasonics[RIGHT_ULTRASONIC]); }
+
+bool pollDistance(Sensors_t *sensors)
+{
+    static int currSensor = LEFT_ULTRASONIC; // LEFT = 0, RIGHT = 1
+    static bool pinging = false;
+    static unsigned long triggerUs = 0;
+    Ultrasonic_t *u = &ultrasonics[currSensor];
+    unsigned long now = halMicros();
+    bool published = false;
+
+    if (pinging) {
+        // Ignore the tail of an echo that started before this trigger
+        bool fresh = u->complete && (long)(u->riseUs - triggerUs) >= 0;
+        if (!fresh && now - triggerUs < ULTRASONIC_ECHO_DELAY_US + ULTRASONIC_TIMEOUT_US) return false;
+
+        int *sensorPtr = (currSensor == LEFT_ULTRASONIC) ? &sensors->leftCm : &sensors->rightCm;
+        unsigned long *stampPtr = (currSensor == LEFT_ULTRASONIC) ? &sensors->leftSampleUs : &sensors->rightSampleUs;
+
+        if (fresh && u->widthUs > 0 && u->widthUs <= ULTRASONIC_TIMEOUT_US) {
+            // Calculation: distance = v*t = (343 m/s) * (100 c/m) * (time in us) * (0.000001 s / us) / 2
+            // Round to nearest centimetre
+            *sensorPtr = (int)((u->widthUs * 0.0343) / 2 + 0.5);
+        } else {
+            *sensorPtr = OUT_OF_RANGE;
+        }
+        *stampPtr = now;
+        published = true;
+
+        // Alternate between the left and right ultrasonic sensor so their pings never overlap
+        pinging = false;
+        currSensor = !currSensor;
+        u = &ultrasonics[currSensor];
+    }
+
+    // Send trigger pulse, the echo is picked up by handleEcho()
+    u->complete = false;
+    halDigitalWrite(u->triggerPin, LOW);
+    halDelayMicroseconds(2);
+    halDigitalWrite(u->triggerPin, HIGH);
+    halDelayMicroseconds(10);
+    halDigitalWrite(u->triggerPin, LOW);
+    triggerUs = halMicros();
+    pinging = true;
+    return published;
 }
 
 void sensorsDemo(TFT_eSPI *tft, Sensors_t *sensors)
@@ -267,15 +368,14 @@ void sensorsDemo(TFT_eSPI *tft, Sensors_t *sensors)
     const static uint32_t longRangeColour = TFT_GREEN;
     const static uint32_t mediumRangeColour = TFT_GOLD;
     const static uint32_t shortRangeColour = TFT_RED;
-    static unsigned long lastUpdateTime = millis();
+    static unsigned long lastUpdateTime = halMillis();
 
     while (true) {
         // Determine line values from analog pin (R-2R DAC)
         pollDistance(sensors);
         detectLine(sensors);
         tft->setTextColor(TFT_SILVER, TFT_BLACK);
-        int encoding = (sensors->frontLeft << 3)+(sensors->frontRight << 2)+(sensors->rearLeft << 1)+(sensors->rearRight);
-        sprintf(buffer, "  ADC: %d -> %d ", sensors->analogReading, encoding);
+        sprintf(buffer, "  ADC: %d -> %d ", sensors->analogReading, sensors->lineMask);
         tft->setTextDatum(CC_DATUM);
         tft->drawString(buffer, 160, 105);
         tft->setTextDatum(TL_DATUM);
@@ -327,6 +427,6 @@ void sensorsDemo(TFT_eSPI *tft, Sensors_t *sensors)
             tft->drawString("Left  : ", 20, 15);
             tft->drawString("Right : ", 20, 45);
         }
-        delay(250);
+        halDelay(250);
     }
 }
@@ -21,22 +21,22 @@ void userSelectFunction(TFT_eSPI *tft, Sensors_t *s, Motor_t *mot)
   int currLeft = 0, currRight = 0;
   int prevChoice = -1, currChoice = 0;
   bool startOperation = false;
-  unsigned long lastUpdateTime = millis();
+  unsigned long lastUpdateTime = halMillis();
   float delaySeconds = 9.9;
   tft->setTextFont(2);
 
   while (!startOperation) {
     tft->setCursor(MENU_X_DATUM, MENU_Y_DATUM-5);
     tft->printf("[^] START ROUTINE   [v] SCROLL OPTIONS");
-    currLeft = !digitalRead(LEFT_BUTTON);
-    currRight = !digitalRead(RIGHT_BUTTON);
+    currLeft = !halDigitalRead(LEFT_BUTTON);
+    currRight = !halDigitalRead(RIGHT_BUTTON);
 
     if (prevLeft && !currLeft) {
       tft->setTextFont(0);
       startOperation = true;
     } else if (prevRight && !currRight) {
       currChoice = (currChoice + 1) % 5; // Must update this whenever we add/remove robotModes
-      lastUpdateTime = millis();
+      lastUpdateTime = halMillis();
     }
 
     if (prevChoice != currChoice) {
@@ -91,10 +91,10 @@ void competitionCountdownTimer(TFT_eSPI *tft, int seconds)
   while (seconds > 0) {
     tft->drawNumber(seconds, 170, 85);
     seconds -= 1;
-    delay(1000);
+    halDelay(1000);
   }
   tft->drawString("GO", 170, 85);
-  delay(500);
+  halDelay(500);
   tft->setTextSize(1);
   tft->setTextFont(0);
   tft->setTextDatum(TL_DATUM);
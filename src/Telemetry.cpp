@@ -0,0 +1,139 @@
+#include "Telemetry.h"
+#include <atomic>
+#include <string.h>
+
+#define TELEMETRY_FRAME_MAX     (TELEMETRY_MAX_RECORD + 4)
+
+// ===================== RINGS =====================
+// Single producer, single consumer: head is only written by the producer, tail
+// only by the writer task, so neither side needs a lock
+typedef struct {
+    std::atomic<uint32_t> head;
+    std::atomic<uint32_t> tail;
+    uint16_t seq;
+    uint32_t dropped;
+    uint8_t size[TELEMETRY_RING_RECORDS];
+    uint8_t slot[TELEMETRY_RING_RECORDS][TELEMETRY_MAX_RECORD];
+} TelemetryRing_t;
+
+static_assert((TELEMETRY_RING_RECORDS & (TELEMETRY_RING_RECORDS - 1)) == 0, "TELEMETRY_RING_RECORDS must be a power of two");
+
+static TelemetryRing_t rings[TLM_CHANNELS];
+static volatile bool running = false;
+
+// Written by the writer task only
+static uint32_t recordsWritten = 0, bytesWritten = 0;
+static uint8_t pending[TELEMETRY_FRAME_MAX];
+static size_t pendingLength = 0, pendingSent = 0;
+
+bool IRAM_ATTR telemetryPush(TelemetryChannel channel, uint8_t type, void *record, uint8_t size) {
+    if (!running || channel >= TLM_CHANNELS || size > TELEMETRY_MAX_RECORD) return false;
+    TelemetryRing_t *ring = &rings[channel];
+
+    TelemetryHeader_t *header = (TelemetryHeader_t *)record;
+    header->type = type;
+    header->version = TELEMETRY_VERSION;
+    header->seq = ring->seq++;
+    header->timeUs = halMicros();
+
+    uint32_t head = ring->head.load(std::memory_order_relaxed);
+    if (head - ring->tail.load(std::memory_order_acquire) >= TELEMETRY_RING_RECORDS) {
+        ring->dropped++;
+        return false;
+    }
+    uint32_t index = head & (TELEMETRY_RING_RECORDS - 1);
+    memcpy(ring->slot[index], record, size);
+    ring->size[index] = size;
+    ring->head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+uint32_t telemetryRoom(TelemetryChannel channel) {
+    if (!running || channel >= TLM_CHANNELS) return 0;
+    TelemetryRing_t *ring = &rings[channel];
+    return TELEMETRY_RING_RECORDS - (ring->head.load(std::memory_order_relaxed) - ring->tail.load(std::memory_order_acquire));
+}
+
+// ===================== FRAMING =====================
+uint16_t telemetryCrc16(const uint8_t *data, size_t length) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int bit = 0; bit < 8; bit++) crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
+size_t telemetryEncodeFrame(const uint8_t *record, size_t length, uint8_t *out) {
+    uint16_t crc = telemetryCrc16(record, length);
+    size_t codeAt = 0, o = 1;
+    uint8_t code = 1;
+
+    // Frames stay under 254 bytes, so one code byte never has to be split
+    for (size_t i = 0; i < length + 2; i++) {
+        uint8_t byte = (i < length) ? record[i] : (i == length) ? (crc & 0xFF) : (crc >> 8);
+        if (byte == 0) {
+            out[codeAt] = code;
+            codeAt = o++;
+            code = 1;
+        } else {
+            out[o++] = byte;
+            code++;
+        }
+    }
+    out[codeAt] = code;
+    out[o++] = 0x00;
+    return o;
+}
+
+// ===================== WRITER TASK =====================
+// Finishes the frame the port could not take last time, false if it still cannot
+static bool flushPending(void) {
+    while (pendingSent < pendingLength) {
+        size_t n = halSerialWrite(pending + pendingSent, pendingLength - pendingSent);
+        if (n == 0) return false;
+        pendingSent += n;
+        bytesWritten += n;
+    }
+    return true;
+}
+
+static void telemetryFlush(void) {
+    bool more = true;
+    while (more && flushPending()) {
+        more = false;
+        for (int c = 0; c < TLM_CHANNELS; c++) {
+            TelemetryRing_t *ring = &rings[c];
+            uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+            if (tail == ring->head.load(std::memory_order_acquire)) continue;
+
+            uint32_t index = tail & (TELEMETRY_RING_RECORDS - 1);
+            pendingLength = telemetryEncodeFrame(ring->slot[index], ring->size[index], pending);
+            pendingSent = 0;
+            ring->tail.store(tail + 1, std::memory_order_release);
+            recordsWritten++;
+            more = true;
+            if (!flushPending()) return;
+        }
+    }
+}
+
+void startTelemetry(void) {
+    if (!running) {
+        halSerialBegin(TELEMETRY_BAUD);
+        running = true;
+    }
+    // Ignored if the writer already runs
+    halStartBackgroundTask("telemetry", telemetryFlush, TELEMETRY_FLUSH_MS, TELEMETRY_CORE, TELEMETRY_PRIORITY);
+}
+
+void stopTelemetry(void) { running = false; }
+
+bool telemetryRunning(void) { return running; }
+
+void getTelemetryStats(TelemetryStats_t *stats) {
+    stats->records = recordsWritten;
+    stats->bytes = bytesWritten;
+    stats->dropped = 0;
+    for (int c = 0; c < TLM_CHANNELS; c++) stats->dropped += rings[c].dropped;
+}
@@ -95,11 +95,11 @@ static void updateMotorControl() {
     unsigned long elapsedMs = now - lastPIUpdate;
     if (elapsedMs < PI_UPDATE_INTERVAL_MS) return;
     if (elapsedMs == 0) elapsedMs = 1;
-    float velA = 1000.0f * (encoderCountA - encoderCountOldA) / (float)elapsedMs;
-    float velB = 1000.0f * (encoderCountB - encoderCountOldB) / (float)elapsedMs;
+    float velA = 1000.0f * (getEncoderCountA() - encoderCountOldA) / (float)elapsedMs;
+    float velB = 1000.0f * (getEncoderCountB() - encoderCountOldB) / (float)elapsedMs;
     updatePIController(&motor, velA, velB);
-    encoderCountOldA = encoderCountA;
-    encoderCountOldB = encoderCountB;
+    encoderCountOldA = getEncoderCountA();
+    encoderCountOldB = getEncoderCountB();
     lastPIUpdate = now;
 }
 
@@ -0,0 +1,34 @@
+/**
+ * @file Render_Bench.cpp
+ * @brief Rendering micro-benchmarks on the T-Display-S3 (see sim/gfx/RenderBench.h)
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include <TFT_eSPI.h>
+#include "../sim/gfx/RenderBench.h"
+#include "../sim/gfx/SpanCheck.h"
+
+// pio run -e render-bench -t upload && pio device monitor > bench.jsonl
+// Prints one JSON line per measurement, the same format as the host build
+// (.pio/build/native_gfx/program --bench), so the two can be compared directly.
+// The sprite span kernels, with the PIE fill, are checked against their scalar
+// versions first.
+
+TFT_eSPI tft = TFT_eSPI();
+
+void setup() {
+  Serial.begin(115200);
+  delay(2000);  // Time to open the serial monitor
+
+  tft.init();
+  int spanErrors = checkSpanKernels(&tft, &Serial);
+  Serial.printf("{\"span_kernels\":\"%s\"}\n", spanErrors ? "FAIL" : "ok");
+
+  int count = runRenderBench(&tft, &Serial, RENDER_BENCH_MIN_MS, NULL);
+  Serial.printf("{\"done\":%d}\n", count);
+}
+
+void loop() {
+  delay(1000);
+}
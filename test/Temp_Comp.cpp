@@ -107,13 +107,13 @@ static void updateMotorControl() {
     static int encoderCountOldA = 0;
     static int encoderCountOldB = 0;
     
-    velA = 1000.0f * (encoderCountA - encoderCountOldA) / elapsedMs;
-    velB = 1000.0f * (encoderCountB - encoderCountOldB) / elapsedMs;
+    velA = 1000.0f * (getEncoderCountA() - encoderCountOldA) / elapsedMs;
+    velB = 1000.0f * (getEncoderCountB() - encoderCountOldB) / elapsedMs;
     
     updatePIController(&motor, velA, velB);
     
-    encoderCountOldA = encoderCountA;
-    encoderCountOldB = encoderCountB;
+    encoderCountOldA = getEncoderCountA();
+    encoderCountOldB = getEncoderCountB();
     lastPIUpdate = millis();
 }
 